@@ -333,6 +333,9 @@ typedef enum spv_binary_to_text_options_t {
   SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES = SPV_BIT(6),
   // Add some comments to the generated assembly
   SPV_BINARY_TO_TEXT_OPTION_COMMENT = SPV_BIT(7),
+  // Format the instructions on several threads.  The text is the same as
+  // without this option.  Ignored when printing to standard output.
+  SPV_BINARY_TO_TEXT_OPTION_PARALLEL = SPV_BIT(8),
   SPV_FORCE_32_BIT_ENUM(spv_binary_to_text_options_t)
 } spv_binary_to_text_options_t;
 
@@ -510,6 +513,18 @@ typedef enum {
   spv_validator_limit_max_id_bound,
 } spv_validator_limit;
 
+// The sets of checks the SPIR-V Validator can run.
+typedef enum {
+  // Every check.  This is the default.
+  spv_validator_profile_full,
+  // The checks of the structure of the module: its header and layout, its
+  // ids, types and control flow, and the rules of the opcodes on their
+  // operands, including the declarations of image types and extensions.
+  // The checks of image operations, of extended instructions, and of
+  // built-in variables are skipped.
+  spv_validator_profile_structural,
+} spv_validator_profile;
+
 // Returns a string describing the given SPIR-V target environment.
 SPIRV_TOOLS_EXPORT const char* spvTargetEnvDescription(spv_target_env env);
 
@@ -636,6 +651,17 @@ SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetWorkgroupScalarBlockLayout(
 SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetSkipBlockLayout(
     spv_validator_options options, bool val);
 
+// Records whether or not the validator should check different functions on
+// several threads.  The diagnostics are the same as when checking on a
+// single thread.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetParallel(
+    spv_validator_options options, bool val);
+
+// Records the set of checks the validator should run.  A module that passes
+// the full checks passes the checks of every other profile.
+SPIRV_TOOLS_EXPORT void spvValidatorOptionsSetProfile(
+    spv_validator_options options, spv_validator_profile profile);
+
 // Creates an optimizer options object with default options. Returns a valid
 // options object. The object remains valid until it is passed into
 // |spvOptimizerOptionsDestroy|.
@@ -668,6 +694,16 @@ SPIRV_TOOLS_EXPORT void spvOptimizerOptionsSetPreserveBindings(
 SPIRV_TOOLS_EXPORT void spvOptimizerOptionsSetPreserveSpecConstants(
     spv_optimizer_options options, bool val);
 
+// Records the number of threads passes may use to process the functions of a
+// module at the same time.  The default, 1, processes them one at a time, and
+// 0 uses one thread per hardware thread.  The optimized binary is the same for
+// any number of threads.  Only vector DCE and local single block load/store
+// elimination use more than one thread at present, to find what to change in
+// each function; the changes, and all other passes, are made one function at a
+// time.
+SPIRV_TOOLS_EXPORT void spvOptimizerOptionsSetNumThreads(
+    spv_optimizer_options options, uint32_t val);
+
 // Creates a reducer options object with default options. Returns a valid
 // options object. The object remains valid until it is passed into
 // |spvReducerOptionsDestroy|.
@@ -862,6 +898,17 @@ SPIRV_TOOLS_EXPORT spv_result_t spvBinaryParse(
     const size_t num_words, spv_parsed_header_fn_t parse_header,
     spv_parsed_instruction_fn_t parse_instruction, spv_diagnostic* diagnostic);
 
+// Like spvBinaryParse, but only splits the instructions apart, which is much
+// faster when only the opcodes are of interest.  The parsed instructions given
+// to the parsed-instruction callback only have their opcode, words and
+// num_words members set: the other members are zero, and no operands are
+// decoded or checked.  If the parsed-instruction callback is null, then only
+// the header is parsed.
+SPIRV_TOOLS_EXPORT spv_result_t spvBinaryParseOpcodes(
+    const spv_const_context context, void* user_data, const uint32_t* words,
+    const size_t num_words, spv_parsed_header_fn_t parse_header,
+    spv_parsed_instruction_fn_t parse_instruction, spv_diagnostic* diagnostic);
+
 #ifdef __cplusplus
 }
 #endif
@@ -140,6 +140,17 @@ class ValidatorOptions {
     spvValidatorOptionsSetBeforeHlslLegalization(options_, val);
   }
 
+  // Records whether or not the validator should check different functions on
+  // several threads.  The diagnostics are the same as when checking on a
+  // single thread.
+  void SetParallel(bool val) { spvValidatorOptionsSetParallel(options_, val); }
+
+  // Records the set of checks the validator should run.  See
+  // spv_validator_profile.
+  void SetProfile(spv_validator_profile profile) {
+    spvValidatorOptionsSetProfile(options_, profile);
+  }
+
  private:
   spv_validator_options options_;
 };
@@ -182,6 +193,12 @@ class OptimizerOptions {
                                                 preserve_spec_constants);
   }
 
+  // Records the number of threads passes may use to process the functions of
+  // a module at the same time.  See spvOptimizerOptionsSetNumThreads.
+  void set_num_threads(uint32_t num_threads) {
+    spvOptimizerOptionsSetNumThreads(options_, num_threads);
+  }
+
  private:
   spv_optimizer_options options_;
 };
@@ -260,6 +277,76 @@ class FuzzerOptions {
   spv_fuzzer_options options_;
 };
 
+// A bounded cache of validation results.
+//
+// Each entry is keyed by a hash of the words of a module, the target
+// environment, the validator options and the version of this library, and
+// records whether the module is valid and, if it is not, the diagnostic the
+// validator reported for it.  When the cache is full, the least recently used
+// entry is evicted.  The hash is a fast 64-bit non-cryptographic one, so the
+// cache must not be trusted with modules crafted to collide.
+//
+// Instances of this class are thread-safe.
+class ValidationCache {
+ public:
+  // The verdict of the validator on one module.
+  struct Result {
+    // SPV_SUCCESS if the module is valid, and the error code otherwise.
+    spv_result_t status;
+    // The position and text of the error for an invalid module.  Warnings
+    // are not kept.
+    spv_position_t position;
+    std::string message;
+  };
+
+  // The number of entries kept by a cache constructed without a capacity.
+  static const size_t kDefaultCapacity = 4096;
+
+  // Constructs an empty cache which keeps at most |capacity| entries.
+  explicit ValidationCache(size_t capacity = kDefaultCapacity);
+
+  ValidationCache(const ValidationCache&) = delete;
+  ValidationCache& operator=(const ValidationCache&) = delete;
+
+  ~ValidationCache();
+
+  // Returns the number of entries in the cache.
+  size_t size() const;
+
+  // Returns the maximum number of entries in the cache.
+  size_t capacity() const;
+
+  // Looks up the result of validating the |binary_size| words of |binary|
+  // for |env| with |options|, which may be null for the default options.
+  // Returns true and writes the result to |result| on a hit, and returns false
+  // otherwise.  A hit makes the entry the most recently used.
+  bool Lookup(spv_target_env env, const uint32_t* binary, size_t binary_size,
+              spv_validator_options options, Result* result);
+
+  // Records |result| as the result of validating the |binary_size| words of
+  // |binary| for |env| with |options|, evicting the least recently used entry
+  // if the cache is full.
+  void Insert(spv_target_env env, const uint32_t* binary, size_t binary_size,
+              spv_validator_options options, const Result& result);
+
+  // Removes all the entries.
+  void Clear();
+
+  // Adds the entries stored in the file |filename| by Save(), as the most
+  // recently used ones and in the order they had when saved.  Returns false,
+  // leaving the cache unchanged, if the file cannot be read or was not written
+  // by Save() on a machine of the same endianness.
+  bool Load(const std::string& filename);
+
+  // Writes all the entries to the file |filename|, replacing it.  Returns
+  // false if the file cannot be written.
+  bool Save(const std::string& filename) const;
+
+ private:
+  struct Impl;  // Opaque struct for holding the data fields used by this class.
+  std::unique_ptr<Impl> impl_;  // Unique pointer to implementation data.
+};
+
 // C++ interface for SPIRV-Tools functionalities. It wraps the context
 // (including target environment and the corresponding SPIR-V grammar) and
 // provides methods for assembling, disassembling, and validating.
@@ -348,6 +435,14 @@ class SpirvTools {
   // binary itself, or in the validator options.
   bool Validate(const uint32_t* binary, size_t binary_size,
                 spv_validator_options options) const;
+  // Like the previous overload, but first looks the result up in |cache|, and
+  // records it there after validating on a miss.  As with the previous
+  // overload, the message consumer only receives the error that makes the
+  // binary invalid, and not the warnings, which the cache does not keep.  A
+  // result from the cache is reported the same way.  If |cache| is null, this
+  // is the previous overload.
+  bool Validate(const uint32_t* binary, size_t binary_size,
+                spv_validator_options options, ValidationCache* cache) const;
 
   // Was this object successfully constructed.
   bool IsValid() const;
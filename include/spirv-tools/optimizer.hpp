@@ -49,6 +49,7 @@ class Optimizer {
     // below; for out-of-tree passes, use this constructor instead.
     // Note that this API isn't guaranteed to be stable and may change without
     // preserving source or binary compatibility in the future.
+    // An optimizer with a pass registered this way can only be run once.
     PassToken(std::unique_ptr<opt::Pass>&& pass);
 
     // Tokens can only be moved. Copying is disabled.
@@ -170,6 +171,12 @@ class Optimizer {
   // that it is verifiable from data in the binary itself.
   //
   // It's allowed to alias |original_binary| to the start of |optimized_binary|.
+  //
+  // If all the registered passes were created by the Create*Pass functions,
+  // then every call runs fresh instances of the passes, so the same optimizer
+  // can be used to optimize any number of modules, and can be run from several
+  // threads at the same time as long as the message consumer is thread-safe.
+  // Otherwise, the registered passes are consumed by the first call.
   bool Run(const uint32_t* original_binary, size_t original_binary_size,
            std::vector<uint32_t>* optimized_binary) const;
 
@@ -196,6 +203,48 @@ class Optimizer {
            std::vector<uint32_t>* optimized_binary,
            const spv_optimizer_options opt_options) const;
 
+  // A message emitted while optimizing one module of a batch.  The fields
+  // match the arguments of |MessageConsumer|.
+  struct BatchMessage {
+    spv_message_level_t level;
+    std::string source;
+    spv_position_t position;
+    std::string message;
+  };
+
+  // The outcome of optimizing one module of a batch.
+  struct BatchResult {
+    // Whether the module was optimized successfully.  See Run().
+    bool success = false;
+    // The optimized binary.  Only meaningful if |success| is true.
+    std::vector<uint32_t> binary;
+    // The messages emitted while optimizing the module, in emission order.
+    std::vector<BatchMessage> messages;
+  };
+
+  // Optimizes each module of |binaries| as Run() does, using up to
+  // |num_threads| worker threads.  If |num_threads| is 0, one thread per
+  // hardware thread is used.  The grammar tables are shared by all the modules.
+  //
+  // Returns one result per module, in the same order as |binaries|.  The
+  // messages of each module are collected in its result instead of being sent
+  // to the message consumer of this optimizer, so that the diagnostics of
+  // different modules are not interleaved.
+  //
+  // All the registered passes must have been created by the Create*Pass
+  // functions; otherwise every module fails with an error message.  The
+  // streams set by SetPrintAll() and SetTimeReport() are shared by all the
+  // modules, so they should only be used with a single thread.
+  std::vector<BatchResult> RunBatch(
+      const std::vector<std::vector<uint32_t>>& binaries,
+      uint32_t num_threads) const;
+
+  // Same as above, except it takes an options object.  See the documentation
+  // for |OptimizerOptions| to see which options can be set.
+  std::vector<BatchResult> RunBatch(
+      const std::vector<std::vector<uint32_t>>& binaries, uint32_t num_threads,
+      const spv_optimizer_options opt_options) const;
+
   // Returns a vector of strings with all the pass names added to this
   // optimizer's pass manager. These strings are valid until the associated
   // pass manager is destroyed.
@@ -214,6 +263,12 @@ class Optimizer {
   // Sets the option to validate the module after each pass.
   Optimizer& SetValidateAfterAll(bool validate);
 
+  // Sets the cache of results for the validation of the input module done
+  // before optimizing it.  A module found in |cache| is not validated again.
+  // If |cache| is null, which is the default, the input is always validated.
+  // The cache must outlive the calls to Run().
+  Optimizer& SetValidationCache(ValidationCache* cache);
+
  private:
   struct Impl;                  // Opaque struct for holding internal data.
   std::unique_ptr<Impl> impl_;  // Unique pointer to internal data.
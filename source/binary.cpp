@@ -64,19 +64,27 @@ spv_result_t spvBinaryHeaderGet(const spv_const_binary binary,
 
 namespace {
 
+// Marks ids that are not defined in Parser::State::dense_id_to_type_id.  Since
+// ids are smaller than the id bound, no id has this value.
+const uint32_t kUndefinedId = 0xFFFFFFFFu;
+
 // A SPIR-V binary parser.  A parser instance communicates detailed parse
 // results via callbacks.
 class Parser {
  public:
   // The user_data value is provided to the callbacks as context.
+  // If |opcodes_only| is true, the instructions are only split apart, and
+  // their operands are not decoded.  See spvBinaryParseOpcodes().
   Parser(const spv_const_context context, void* user_data,
          spv_parsed_header_fn_t parsed_header_fn,
-         spv_parsed_instruction_fn_t parsed_instruction_fn)
+         spv_parsed_instruction_fn_t parsed_instruction_fn,
+         bool opcodes_only = false)
       : grammar_(context),
         consumer_(context->consumer),
         user_data_(user_data),
         parsed_header_fn_(parsed_header_fn),
-        parsed_instruction_fn_(parsed_instruction_fn) {}
+        parsed_instruction_fn_(parsed_instruction_fn),
+        opcodes_only_(opcodes_only) {}
 
   // Parses the specified binary SPIR-V module, issuing callbacks on a parsed
   // header and for each parsed instruction.  Returns SPV_SUCCESS on success.
@@ -98,6 +106,10 @@ class Parser {
   // On failure, returns an error code and issues a diagnostic.
   spv_result_t parseInstruction();
 
+  // Like parseInstruction, but only decodes the opcode and word count of the
+  // instruction.  The parsed-instruction callback gets no operands.
+  spv_result_t parseInstructionOpcode();
+
   // Parses an instruction operand with the given type, for an instruction
   // starting at inst_offset words into the SPIR-V binary.
   // If the SPIR-V binary is the same endianness as the host, then the
@@ -128,6 +140,15 @@ class Parser {
   void recordNumberType(size_t inst_offset,
                         const spv_parsed_instruction_t* inst);
 
+  // Records that |id| is defined with the given |type_id|, following the
+  // conventions of State::id_to_type_id.  Returns false if |id| is already
+  // defined.
+  bool recordTypeId(uint32_t id, uint32_t type_id);
+
+  // Returns a pointer to the type Id recorded for |id|, or nullptr if |id| is
+  // not defined.
+  const uint32_t* findTypeId(uint32_t id) const;
+
   // Returns a diagnostic stream object initialized with current position in
   // the input stream, and for the given error code. Any data written to the
   // returned object will be propagated to the current parse's diagnostic
@@ -174,6 +195,7 @@ class Parser {
   const spv_parsed_header_fn_t parsed_header_fn_;  // Parsed header callback
   const spv_parsed_instruction_fn_t
       parsed_instruction_fn_;  // Parsed instruction callback
+  const bool opcodes_only_;    // Skip decoding the operands?
 
   // Describes the format of a typed literal number.
   struct NumberType {
@@ -212,6 +234,12 @@ class Parser {
     // Maps a result ID to its type ID.  By convention:
     //  - a result ID that is a type definition maps to itself.
     //  - a result ID without a type maps to 0.  (E.g. for OpLabel)
+    // Ids smaller than both the id bound and the number of words in the module
+    // are kept in |dense_id_to_type_id|, indexed by id, with kUndefinedId for
+    // ids that are not defined.  It is allocated once for the whole module, so
+    // that defining an id does not allocate.  Other ids, which only occur in
+    // invalid modules, are kept in |id_to_type_id|.
+    std::vector<uint32_t> dense_id_to_type_id;
     std::unordered_map<uint32_t, uint32_t> id_to_type_id;
     // Maps a type ID to its number type description.
     std::unordered_map<uint32_t, NumberType> type_id_to_number_type_info;
@@ -271,6 +299,16 @@ spv_result_t Parser::parseModule() {
 
   // Process the instructions.
   _.word_index = SPV_INDEX_INSTRUCTION;
+  if (opcodes_only_) {
+    // Without a callback, there is nothing to do past the header.
+    if (!parsed_instruction_fn_) return SPV_SUCCESS;
+    while (_.word_index < _.num_words)
+      if (auto error = parseInstructionOpcode()) return error;
+    return SPV_SUCCESS;
+  }
+
+  _.dense_id_to_type_id.assign(
+      std::min(static_cast<size_t>(header.bound), _.num_words), kUndefinedId);
   while (_.word_index < _.num_words)
     if (auto error = parseInstruction()) return error;
 
@@ -402,6 +440,64 @@ spv_result_t Parser::parseInstruction() {
   return SPV_SUCCESS;
 }
 
+spv_result_t Parser::parseInstructionOpcode() {
+  _.instruction_count++;
+
+  spv_parsed_instruction_t inst = {};
+  const uint32_t first_word = peek();
+  uint16_t inst_word_count = 0;
+  spvOpcodeSplit(first_word, &inst_word_count, &inst.opcode);
+  if (inst_word_count < 1) {
+    return diagnostic() << "Invalid instruction word count: "
+                        << inst_word_count;
+  }
+  spv_opcode_desc opcode_desc;
+  if (grammar_.lookupOpcode(static_cast<SpvOp>(inst.opcode), &opcode_desc))
+    return diagnostic() << "Invalid opcode: " << inst.opcode;
+
+  const size_t inst_offset = _.word_index;
+  if (_.num_words - inst_offset < inst_word_count) {
+    return diagnostic() << "End of input reached while decoding Op"
+                        << opcode_desc->name << " starting at word "
+                        << inst_offset << ": expected " << inst_word_count
+                        << " words, but found " << _.num_words - inst_offset
+                        << " words.";
+  }
+  _.word_index += inst_word_count;
+
+  if (_.requires_endian_conversion) {
+    _.endian_converted_words.clear();
+    for (size_t i = inst_offset; i < _.word_index; ++i) {
+      _.endian_converted_words.push_back(peekAt(i));
+    }
+    inst.words = _.endian_converted_words.data();
+  } else {
+    inst.words = _.words + inst_offset;
+  }
+  inst.num_words = inst_word_count;
+
+  return parsed_instruction_fn_(user_data_, &inst);
+}
+
+bool Parser::recordTypeId(uint32_t id, uint32_t type_id) {
+  if (id < _.dense_id_to_type_id.size()) {
+    uint32_t& slot = _.dense_id_to_type_id[id];
+    if (slot != kUndefinedId) return false;
+    slot = type_id;
+    return true;
+  }
+  return _.id_to_type_id.emplace(id, type_id).second;
+}
+
+const uint32_t* Parser::findTypeId(uint32_t id) const {
+  if (id < _.dense_id_to_type_id.size()) {
+    const uint32_t& slot = _.dense_id_to_type_id[id];
+    return slot != kUndefinedId ? &slot : nullptr;
+  }
+  const auto iter = _.id_to_type_id.find(id);
+  return iter != _.id_to_type_id.end() ? &iter->second : nullptr;
+}
+
 spv_result_t Parser::parseOperand(size_t inst_offset,
                                   spv_parsed_instruction_t* inst,
                                   const spv_operand_type_t type,
@@ -447,15 +543,14 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
       inst->result_id = word;
       // Save the result ID to type ID mapping.
       // In the grammar, type ID always appears before result ID.
-      if (_.id_to_type_id.find(inst->result_id) != _.id_to_type_id.end())
-        return diagnostic(SPV_ERROR_INVALID_ID)
-               << "Id " << inst->result_id << " is defined more than once";
-      // Record it.
       // A regular value maps to its type.  Some instructions (e.g. OpLabel)
       // have no type Id, and will map to 0.  The result Id for a
       // type-generating instruction (e.g. OpTypeInt) maps to itself.
-      _.id_to_type_id[inst->result_id] =
-          spvOpcodeGeneratesType(opcode) ? inst->result_id : inst->type_id;
+      if (!recordTypeId(inst->result_id, spvOpcodeGeneratesType(opcode)
+                                             ? inst->result_id
+                                             : inst->type_id))
+        return diagnostic(SPV_ERROR_INVALID_ID)
+               << "Id " << inst->result_id << " is defined more than once";
       break;
 
     case SPV_OPERAND_TYPE_ID:
@@ -542,13 +637,12 @@ spv_result_t Parser::parseOperand(size_t inst_offset,
         // The literal operands have the same type as the value
         // referenced by the selector Id.
         const uint32_t selector_id = peekAt(inst_offset + 1);
-        const auto type_id_iter = _.id_to_type_id.find(selector_id);
-        if (type_id_iter == _.id_to_type_id.end() ||
-            type_id_iter->second == 0) {
+        const uint32_t* selector_type_id = findTypeId(selector_id);
+        if (selector_type_id == nullptr || *selector_type_id == 0) {
           return diagnostic() << "Invalid OpSwitch: selector id " << selector_id
                               << " has no type";
         }
-        uint32_t type_id = type_id_iter->second;
+        uint32_t type_id = *selector_type_id;
 
         if (selector_id == type_id) {
           // Recall that by convention, a result ID that is a type definition
@@ -813,6 +907,21 @@ spv_result_t spvBinaryParse(const spv_const_context context, void* user_data,
   return parser.parse(code, num_words, diagnostic);
 }
 
+spv_result_t spvBinaryParseOpcodes(
+    const spv_const_context context, void* user_data, const uint32_t* code,
+    const size_t num_words, spv_parsed_header_fn_t parsed_header,
+    spv_parsed_instruction_fn_t parsed_instruction,
+    spv_diagnostic* diagnostic) {
+  spv_context_t hijack_context = *context;
+  if (diagnostic) {
+    *diagnostic = nullptr;
+    spvtools::UseDiagnosticAsMessageConsumer(&hijack_context, diagnostic);
+  }
+  Parser parser(&hijack_context, user_data, parsed_header, parsed_instruction,
+                /* opcodes_only = */ true);
+  return parser.parse(code, num_words, diagnostic);
+}
+
 // TODO(dneto): This probably belongs in text.cpp since that's the only place
 // that a spv_binary_t value is created.
 void spvBinaryDestroy(spv_binary binary) {
@@ -20,10 +20,12 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
-#include <iomanip>
+#include <iostream>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "source/assembly_grammar.h"
 #include "source/binary.h"
@@ -38,10 +40,37 @@
 #include "source/spirv_endian.h"
 #include "source/util/hex_float.h"
 #include "source/util/make_unique.h"
+#include "source/util/string_utils.h"
+#include "source/util/thread_pool.h"
 #include "spirv-tools/libspirv.h"
 
 namespace {
 
+// The state of a disassembly that carries over from one instruction to the
+// next, apart from the text itself.
+struct Position {
+  Position()
+      : byte_offset(0),
+        inserted_decoration_space(false),
+        inserted_debug_space(false),
+        inserted_type_space(false) {}
+
+  // Moves past |inst|.
+  void Advance(const spv_parsed_instruction_t& inst) {
+    const SpvOp opcode = static_cast<SpvOp>(inst.opcode);
+    byte_offset += inst.num_words * sizeof(uint32_t);
+    inserted_decoration_space |= spvOpcodeIsDecoration(opcode);
+    inserted_debug_space |= spvOpcodeIsDebug(opcode);
+    inserted_type_space |= spvOpcodeGeneratesType(opcode);
+  }
+
+  size_t byte_offset;  // The byte offset of the next instruction.
+  // Whether the comments introducing each section have been emitted.
+  bool inserted_decoration_space;
+  bool inserted_debug_space;
+  bool inserted_type_space;
+};
+
 // A Disassembler instance converts a SPIR-V binary to its assembly
 // representation.
 class Disassembler {
@@ -56,12 +85,10 @@ class Disassembler {
                     : 0),
         comment_(spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_COMMENT, options)),
         text_(),
-        out_(print_ ? out_stream() : out_stream(text_)),
-        stream_(out_.get()),
         header_(!spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_NO_HEADER, options)),
         show_byte_offset_(spvIsInBitfield(
             SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET, options)),
-        byte_offset_(0),
+        position_(),
         name_mapper_(std::move(name_mapper)) {}
 
   // Emits the assembly header for the module, and sets up internal state
@@ -77,11 +104,18 @@ class Disassembler {
   // Returns SPV_SUCCESS on success.
   spv_result_t SaveTextResult(spv_text* text_result) const;
 
+  // Returns the state after the instructions handled so far.
+  const Position& position() const { return position_; }
+  // Continues the disassembly from |position|, as if the instructions before
+  // it had been handled.
+  void set_position(const Position& position) { position_ = position; }
+
+  // Returns the text accumulated so far, when not printing.
+  std::string& text() { return text_; }
+
  private:
   enum { kStandardIndent = 15 };
 
-  using out_stream = spvtools::out_stream;
-
   // Emits an operand for the given instruction, where the instruction
   // is at offset words from the start of the binary.
   void EmitOperand(const spv_parsed_instruction_t& inst,
@@ -90,30 +124,45 @@ class Disassembler {
   // Emits a mask expression for the given mask word of the specified type.
   void EmitMaskOperand(const spv_operand_type_t type, const uint32_t word);
 
-  // Resets the output color, if color is turned on.
-  void ResetColor() {
-    if (color_) out_.get() << spvtools::clr::reset{print_};
+  // Emits a comment line that starts a new section of the module.
+  void EmitSectionComment(const std::string& comment) {
+    text_ += '\n';
+    text_.append(indent_, ' ');
+    text_ += "; ";
+    text_ += comment;
+    text_ += '\n';
   }
-  // Sets the output to grey, if color is turned on.
-  void SetGrey() {
-    if (color_) out_.get() << spvtools::clr::grey{print_};
+
+  // When printing, writes the accumulated text to the standard output.
+  void Flush() {
+    if (print_) {
+      std::cout.write(text_.data(), text_.size());
+      text_.clear();
+    }
   }
-  // Sets the output to blue, if color is turned on.
-  void SetBlue() {
-    if (color_) out_.get() << spvtools::clr::blue{print_};
+
+  // Changes the output color.  On some platforms the console itself changes
+  // color when printing, so the text before the change is printed first.
+  template <typename Color>
+  void SetColor(Color color) {
+    if (color_) {
+      Flush();
+      text_ += color;
+    }
   }
+
+  // Resets the output color, if color is turned on.
+  void ResetColor() { SetColor(spvtools::clr::reset{print_}); }
+  // Sets the output to grey, if color is turned on.
+  void SetGrey() { SetColor(spvtools::clr::grey{print_}); }
+  // Sets the output to blue, if color is turned on.
+  void SetBlue() { SetColor(spvtools::clr::blue{print_}); }
   // Sets the output to yellow, if color is turned on.
-  void SetYellow() {
-    if (color_) out_.get() << spvtools::clr::yellow{print_};
-  }
+  void SetYellow() { SetColor(spvtools::clr::yellow{print_}); }
   // Sets the output to red, if color is turned on.
-  void SetRed() {
-    if (color_) out_.get() << spvtools::clr::red{print_};
-  }
+  void SetRed() { SetColor(spvtools::clr::red{print_}); }
   // Sets the output to green, if color is turned on.
-  void SetGreen() {
-    if (color_) out_.get() << spvtools::clr::green{print_};
-  }
+  void SetGreen() { SetColor(spvtools::clr::green{print_}); }
 
   const spvtools::AssemblyGrammar& grammar_;
   const bool print_;  // Should we also print to the standard output stream?
@@ -121,116 +170,117 @@ class Disassembler {
   const int indent_;  // How much to indent. 0 means don't indent
   const int comment_;        // Should we comment the source
   spv_endianness_t endian_;  // The detected endianness of the binary.
-  std::stringstream text_;   // Captures the text, if not printing.
-  out_stream out_;  // The Output stream.  Either to text_ or standard output.
-  std::ostream& stream_;  // The output std::stream.
-  const bool header_;     // Should we output header as the leading comment?
+  // The text not yet printed, or all of the text if not printing.
+  std::string text_;
+  const bool header_;  // Should we output header as the leading comment?
   const bool show_byte_offset_;  // Should we print byte offset, in hex?
-  size_t byte_offset_;           // The number of bytes processed so far.
+  Position position_;            // Where the next instruction starts.
   spvtools::NameMapper name_mapper_;
-  bool inserted_decoration_space_ = false;
-  bool inserted_debug_space_ = false;
-  bool inserted_type_space_ = false;
 };
 
 spv_result_t Disassembler::HandleHeader(spv_endianness_t endian,
                                         uint32_t version, uint32_t generator,
                                         uint32_t id_bound, uint32_t schema) {
+  using spvtools::utils::AppendUnsigned;
   endian_ = endian;
 
   if (header_) {
     const char* generator_tool =
         spvGeneratorStr(SPV_GENERATOR_TOOL_PART(generator));
-    stream_ << "; SPIR-V\n"
-            << "; Version: " << SPV_SPIRV_VERSION_MAJOR_PART(version) << "."
-            << SPV_SPIRV_VERSION_MINOR_PART(version) << "\n"
-            << "; Generator: " << generator_tool;
+    text_ += "; SPIR-V\n; Version: ";
+    AppendUnsigned(SPV_SPIRV_VERSION_MAJOR_PART(version), &text_);
+    text_ += '.';
+    AppendUnsigned(SPV_SPIRV_VERSION_MINOR_PART(version), &text_);
+    text_ += "\n; Generator: ";
+    text_ += generator_tool;
     // For unknown tools, print the numeric tool value.
     if (0 == strcmp("Unknown", generator_tool)) {
-      stream_ << "(" << SPV_GENERATOR_TOOL_PART(generator) << ")";
+      text_ += '(';
+      AppendUnsigned(SPV_GENERATOR_TOOL_PART(generator), &text_);
+      text_ += ')';
     }
     // Print the miscellaneous part of the generator word on the same
     // line as the tool name.
-    stream_ << "; " << SPV_GENERATOR_MISC_PART(generator) << "\n"
-            << "; Bound: " << id_bound << "\n"
-            << "; Schema: " << schema << "\n";
+    text_ += "; ";
+    AppendUnsigned(SPV_GENERATOR_MISC_PART(generator), &text_);
+    text_ += "\n; Bound: ";
+    AppendUnsigned(id_bound, &text_);
+    text_ += "\n; Schema: ";
+    AppendUnsigned(schema, &text_);
+    text_ += '\n';
   }
 
-  byte_offset_ = SPV_INDEX_INSTRUCTION * sizeof(uint32_t);
+  position_.byte_offset = SPV_INDEX_INSTRUCTION * sizeof(uint32_t);
 
+  Flush();
   return SPV_SUCCESS;
 }
 
 spv_result_t Disassembler::HandleInstruction(
     const spv_parsed_instruction_t& inst) {
   auto opcode = static_cast<SpvOp>(inst.opcode);
+  const Position before = position_;
+  position_.Advance(inst);
+
   if (comment_ && opcode == SpvOpFunction) {
-    stream_ << std::endl;
-    stream_ << std::string(indent_, ' ');
-    stream_ << "; Function " << name_mapper_(inst.result_id) << std::endl;
+    EmitSectionComment("Function " + name_mapper_(inst.result_id));
   }
-  if (comment_ && !inserted_decoration_space_ &&
-      spvOpcodeIsDecoration(opcode)) {
-    inserted_decoration_space_ = true;
-    stream_ << std::endl;
-    stream_ << std::string(indent_, ' ');
-    stream_ << "; Annotations" << std::endl;
+  if (comment_ && !before.inserted_decoration_space &&
+      position_.inserted_decoration_space) {
+    EmitSectionComment("Annotations");
   }
-  if (comment_ && !inserted_debug_space_ && spvOpcodeIsDebug(opcode)) {
-    inserted_debug_space_ = true;
-    stream_ << std::endl;
-    stream_ << std::string(indent_, ' ');
-    stream_ << "; Debug Information" << std::endl;
+  if (comment_ && !before.inserted_debug_space &&
+      position_.inserted_debug_space) {
+    EmitSectionComment("Debug Information");
   }
-  if (comment_ && !inserted_type_space_ && spvOpcodeGeneratesType(opcode)) {
-    inserted_type_space_ = true;
-    stream_ << std::endl;
-    stream_ << std::string(indent_, ' ');
-    stream_ << "; Types, variables and constants" << std::endl;
+  if (comment_ && !before.inserted_type_space &&
+      position_.inserted_type_space) {
+    EmitSectionComment("Types, variables and constants");
   }
 
   if (inst.result_id) {
     SetBlue();
     const std::string id_name = name_mapper_(inst.result_id);
-    if (indent_)
-      stream_ << std::setw(std::max(0, indent_ - 3 - int(id_name.size())));
-    stream_ << "%" << id_name;
+    // Right-align the result id so that the '=' lines up with the indent.
+    if (indent_) {
+      const int padding = indent_ - 4 - int(id_name.size());
+      if (padding > 0) text_.append(padding, ' ');
+    }
+    text_ += '%';
+    text_ += id_name;
     ResetColor();
-    stream_ << " = ";
+    text_ += " = ";
   } else {
-    stream_ << std::string(indent_, ' ');
+    text_.append(indent_, ' ');
   }
 
-  stream_ << "Op" << spvOpcodeString(opcode);
+  text_ += "Op";
+  text_ += spvOpcodeString(opcode);
 
   for (uint16_t i = 0; i < inst.num_operands; i++) {
     const spv_operand_type_t type = inst.operands[i].type;
     assert(type != SPV_OPERAND_TYPE_NONE);
     if (type == SPV_OPERAND_TYPE_RESULT_ID) continue;
-    stream_ << " ";
+    text_ += ' ';
     EmitOperand(inst, i);
   }
 
   if (comment_ && opcode == SpvOpName) {
     const spv_parsed_operand_t& operand = inst.operands[0];
     const uint32_t word = inst.words[operand.offset];
-    stream_ << "  ; id %" << word;
+    text_ += "  ; id %";
+    spvtools::utils::AppendUnsigned(word, &text_);
   }
 
   if (show_byte_offset_) {
     SetGrey();
-    auto saved_flags = stream_.flags();
-    auto saved_fill = stream_.fill();
-    stream_ << " ; 0x" << std::setw(8) << std::hex << std::setfill('0')
-            << byte_offset_;
-    stream_.flags(saved_flags);
-    stream_.fill(saved_fill);
+    text_ += " ; 0x";
+    spvtools::utils::AppendHex(before.byte_offset, 8, &text_);
     ResetColor();
   }
 
-  byte_offset_ += inst.num_words * sizeof(uint32_t);
-
-  stream_ << "\n";
+  text_ += '\n';
+  Flush();
   return SPV_SUCCESS;
 }
 
@@ -243,27 +293,29 @@ void Disassembler::EmitOperand(const spv_parsed_instruction_t& inst,
     case SPV_OPERAND_TYPE_RESULT_ID:
       assert(false && "<result-id> is not supposed to be handled here");
       SetBlue();
-      stream_ << "%" << name_mapper_(word);
+      text_ += '%';
+      text_ += name_mapper_(word);
       break;
     case SPV_OPERAND_TYPE_ID:
     case SPV_OPERAND_TYPE_TYPE_ID:
     case SPV_OPERAND_TYPE_SCOPE_ID:
     case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
       SetYellow();
-      stream_ << "%" << name_mapper_(word);
+      text_ += '%';
+      text_ += name_mapper_(word);
       break;
     case SPV_OPERAND_TYPE_EXTENSION_INSTRUCTION_NUMBER: {
       spv_ext_inst_desc ext_inst;
       SetRed();
       if (grammar_.lookupExtInst(inst.ext_inst_type, word, &ext_inst) ==
           SPV_SUCCESS) {
-        stream_ << ext_inst->name;
+        text_ += ext_inst->name;
       } else {
         if (!spvExtInstIsNonSemantic(inst.ext_inst_type)) {
           assert(false && "should have caught this earlier");
         } else {
           // for non-semantic instruction sets we can just print the number
-          stream_ << word;
+          spvtools::utils::AppendUnsigned(word, &text_);
         }
       }
     } break;
@@ -272,27 +324,27 @@ void Disassembler::EmitOperand(const spv_parsed_instruction_t& inst,
       if (grammar_.lookupOpcode(SpvOp(word), &opcode_desc))
         assert(false && "should have caught this earlier");
       SetRed();
-      stream_ << opcode_desc->name;
+      text_ += opcode_desc->name;
     } break;
     case SPV_OPERAND_TYPE_LITERAL_INTEGER:
     case SPV_OPERAND_TYPE_TYPED_LITERAL_NUMBER: {
       SetRed();
-      spvtools::EmitNumericLiteral(&stream_, inst, operand);
+      spvtools::EmitNumericLiteral(&text_, inst, operand);
       ResetColor();
     } break;
     case SPV_OPERAND_TYPE_LITERAL_STRING: {
-      stream_ << "\"";
+      text_ += '"';
       SetGreen();
       // Strings are always little-endian, and null-terminated.
       // Write out the characters, escaping as needed, and without copying
       // the entire string.
       auto c_str = reinterpret_cast<const char*>(inst.words + operand.offset);
       for (auto p = c_str; *p; ++p) {
-        if (*p == '"' || *p == '\\') stream_ << '\\';
-        stream_ << *p;
+        if (*p == '"' || *p == '\\') text_ += '\\';
+        text_ += *p;
       }
       ResetColor();
-      stream_ << '"';
+      text_ += '"';
     } break;
     case SPV_OPERAND_TYPE_CAPABILITY:
     case SPV_OPERAND_TYPE_SOURCE_LANGUAGE:
@@ -332,7 +384,7 @@ void Disassembler::EmitOperand(const spv_parsed_instruction_t& inst,
       spv_operand_desc entry;
       if (grammar_.lookupOperand(operand.type, word, &entry))
         assert(false && "should have caught this earlier");
-      stream_ << entry->name;
+      text_ += entry->name;
     } break;
     case SPV_OPERAND_TYPE_FP_FAST_MATH_MODE:
     case SPV_OPERAND_TYPE_FUNCTION_CONTROL:
@@ -363,8 +415,8 @@ void Disassembler::EmitMaskOperand(const spv_operand_type_t type,
       spv_operand_desc entry;
       if (grammar_.lookupOperand(type, mask, &entry))
         assert(false && "should have caught this earlier");
-      if (num_emitted) stream_ << "|";
-      stream_ << entry->name;
+      if (num_emitted) text_ += '|';
+      text_ += entry->name;
       num_emitted++;
     }
   }
@@ -373,42 +425,177 @@ void Disassembler::EmitMaskOperand(const spv_operand_type_t type,
     // of the 0 value. In many cases, that's "None".
     spv_operand_desc entry;
     if (SPV_SUCCESS == grammar_.lookupOperand(type, 0, &entry))
-      stream_ << entry->name;
+      text_ += entry->name;
+  }
+}
+
+// Creates a text object holding the concatenation of |parts|.
+spv_result_t CreateText(const std::vector<const std::string*>& parts,
+                        spv_text* text_result) {
+  size_t length = 0;
+  for (const std::string* part : parts) length += part->size();
+  char* str = new char[length + 1];
+  if (!str) return SPV_ERROR_OUT_OF_MEMORY;
+  char* end = str;
+  for (const std::string* part : parts) {
+    memcpy(end, part->data(), part->size());
+    end += part->size();
   }
+  *end = '\0';
+  spv_text text = new spv_text_t();
+  if (!text) {
+    delete[] str;
+    return SPV_ERROR_OUT_OF_MEMORY;
+  }
+  text->str = str;
+  text->length = length;
+  *text_result = text;
+  return SPV_SUCCESS;
 }
 
 spv_result_t Disassembler::SaveTextResult(spv_text* text_result) const {
-  if (!print_) {
-    size_t length = text_.str().size();
-    char* str = new char[length + 1];
-    if (!str) return SPV_ERROR_OUT_OF_MEMORY;
-    strncpy(str, text_.str().c_str(), length + 1);
-    spv_text text = new spv_text_t();
-    if (!text) {
-      delete[] str;
-      return SPV_ERROR_OUT_OF_MEMORY;
-    }
-    text->str = str;
-    text->length = length;
-    *text_result = text;
+  if (!print_) return CreateText({&text_}, text_result);
+  return SPV_SUCCESS;
+}
+
+// Disassembles a module on several threads.  The instructions are copied out
+// of the parser as they arrive, and split into chunks at function
+// boundaries.  Once the whole module is parsed, each chunk is turned into
+// text by its own Disassembler, and the pieces of text are concatenated.  The
+// result is the same as that of a single Disassembler.  Printing is not
+// supported.
+class ParallelDisassembler {
+ public:
+  ParallelDisassembler(const spvtools::AssemblyGrammar& grammar,
+                       uint32_t options, spvtools::NameMapper name_mapper)
+      : grammar_(grammar),
+        options_(options),
+        name_mapper_(std::move(name_mapper)) {
+    assert(!spvIsInBitfield(SPV_BINARY_TO_TEXT_OPTION_PRINT, options));
   }
+
+  // Emits the assembly header for the module.
+  spv_result_t HandleHeader(spv_endianness_t endian, uint32_t version,
+                            uint32_t generator, uint32_t id_bound,
+                            uint32_t schema);
+  // Saves a copy of the given instruction, to be disassembled later.
+  spv_result_t HandleInstruction(const spv_parsed_instruction_t& inst);
+
+  // Disassembles the saved instructions, and populates text_result with the
+  // text of the module.  Returns SPV_SUCCESS on success.
+  spv_result_t SaveTextResult(spv_text* text_result);
+
+ private:
+  // A chunk is not split at the next function until it has this many words.
+  enum { kMinChunkWords = 4096 };
+
+  // A run of instructions that are disassembled together.
+  struct Chunk {
+    // The state of the disassembly before the first instruction.
+    Position start;
+    // The instructions.  Their words and operands are not set; they are
+    // stored one after the other in the vectors below.
+    std::vector<spv_parsed_instruction_t> instructions;
+    std::vector<uint32_t> words;
+    std::vector<spv_parsed_operand_t> operands;
+    // The text of the instructions.
+    std::string text;
+  };
+
+  // Disassembles the instructions of |chunk| into its text.
+  void Disassemble(Chunk* chunk) const;
+
+  const spvtools::AssemblyGrammar& grammar_;
+  const uint32_t options_;
+  const spvtools::NameMapper name_mapper_;
+  std::string header_;      // The text of the header.
+  Position position_;       // The state after the instructions saved so far.
+  std::vector<Chunk> chunks_;
+};
+
+spv_result_t ParallelDisassembler::HandleHeader(spv_endianness_t endian,
+                                                uint32_t version,
+                                                uint32_t generator,
+                                                uint32_t id_bound,
+                                                uint32_t schema) {
+  Disassembler disassembler(grammar_, options_, name_mapper_);
+  if (auto error = disassembler.HandleHeader(endian, version, generator,
+                                             id_bound, schema))
+    return error;
+  header_.swap(disassembler.text());
+  position_ = disassembler.position();
   return SPV_SUCCESS;
 }
 
+spv_result_t ParallelDisassembler::HandleInstruction(
+    const spv_parsed_instruction_t& inst) {
+  if (chunks_.empty() || (inst.opcode == SpvOpFunction &&
+                          chunks_.back().words.size() >= kMinChunkWords)) {
+    chunks_.emplace_back();
+    chunks_.back().start = position_;
+  }
+  Chunk& chunk = chunks_.back();
+  chunk.instructions.push_back(inst);
+  chunk.instructions.back().words = nullptr;
+  chunk.instructions.back().operands = nullptr;
+  chunk.words.insert(chunk.words.end(), inst.words,
+                     inst.words + inst.num_words);
+  chunk.operands.insert(chunk.operands.end(), inst.operands,
+                        inst.operands + inst.num_operands);
+  position_.Advance(inst);
+  return SPV_SUCCESS;
+}
+
+void ParallelDisassembler::Disassemble(Chunk* chunk) const {
+  Disassembler disassembler(grammar_, options_, name_mapper_);
+  disassembler.set_position(chunk->start);
+  // Most instructions take fewer than 8 characters per byte of binary.
+  disassembler.text().reserve(chunk->words.size() * sizeof(uint32_t) * 8);
+  const uint32_t* words = chunk->words.data();
+  const spv_parsed_operand_t* operands = chunk->operands.data();
+  for (spv_parsed_instruction_t inst : chunk->instructions) {
+    inst.words = words;
+    inst.operands = operands;
+    disassembler.HandleInstruction(inst);
+    words += inst.num_words;
+    operands += inst.num_operands;
+  }
+  chunk->text.swap(disassembler.text());
+}
+
+spv_result_t ParallelDisassembler::SaveTextResult(spv_text* text_result) {
+  if (chunks_.size() > 1) {
+    spvtools::utils::ThreadPool pool(static_cast<uint32_t>(std::min<size_t>(
+        chunks_.size(), spvtools::utils::ThreadPool::DefaultNumThreads())));
+    for (Chunk& chunk : chunks_) {
+      pool.Submit([this, &chunk]() { Disassemble(&chunk); });
+    }
+    pool.Wait();
+  } else if (!chunks_.empty()) {
+    Disassemble(&chunks_[0]);
+  }
+
+  std::vector<const std::string*> parts(1, &header_);
+  for (const Chunk& chunk : chunks_) parts.push_back(&chunk.text);
+  return CreateText(parts, text_result);
+}
+
+template <typename DisassemblerType>
 spv_result_t DisassembleHeader(void* user_data, spv_endianness_t endian,
                                uint32_t /* magic */, uint32_t version,
                                uint32_t generator, uint32_t id_bound,
                                uint32_t schema) {
   assert(user_data);
-  auto disassembler = static_cast<Disassembler*>(user_data);
+  auto disassembler = static_cast<DisassemblerType*>(user_data);
   return disassembler->HandleHeader(endian, version, generator, id_bound,
                                     schema);
 }
 
+template <typename DisassemblerType>
 spv_result_t DisassembleInstruction(
     void* user_data, const spv_parsed_instruction_t* parsed_instruction) {
   assert(user_data);
-  auto disassembler = static_cast<Disassembler*>(user_data);
+  auto disassembler = static_cast<DisassemblerType*>(user_data);
   return disassembler->HandleInstruction(*parsed_instruction);
 }
 
@@ -483,10 +670,23 @@ spv_result_t spvBinaryToText(const spv_const_context context,
   }
 
   // Now disassemble!
+  if ((options & SPV_BINARY_TO_TEXT_OPTION_PARALLEL) &&
+      !(options & SPV_BINARY_TO_TEXT_OPTION_PRINT)) {
+    ParallelDisassembler disassembler(grammar, options, name_mapper);
+    if (auto error = spvBinaryParse(
+            &hijack_context, &disassembler, code, wordCount,
+            DisassembleHeader<ParallelDisassembler>,
+            DisassembleInstruction<ParallelDisassembler>, pDiagnostic)) {
+      return error;
+    }
+    return disassembler.SaveTextResult(pText);
+  }
+
   Disassembler disassembler(grammar, options, name_mapper);
   if (auto error = spvBinaryParse(&hijack_context, &disassembler, code,
-                                  wordCount, DisassembleHeader,
-                                  DisassembleInstruction, pDiagnostic)) {
+                                  wordCount, DisassembleHeader<Disassembler>,
+                                  DisassembleInstruction<Disassembler>,
+                                  pDiagnostic)) {
     return error;
   }
 
@@ -499,12 +699,9 @@ std::string spvtools::spvInstructionBinaryToText(const spv_target_env env,
                                                  const uint32_t* code,
                                                  const size_t wordCount,
                                                  const uint32_t options) {
-  spv_context context = spvContextCreate(env);
+  spv_const_context context = spvtools::GetSharedContext(env);
   const spvtools::AssemblyGrammar grammar(context);
-  if (!grammar.isValid()) {
-    spvContextDestroy(context);
-    return "";
-  }
+  if (!grammar.isValid()) return "";
 
   // Generate friendly names for Ids if requested.
   std::unique_ptr<spvtools::FriendlyNameMapper> friendly_mapper;
@@ -529,7 +726,6 @@ std::string spvtools::spvInstructionBinaryToText(const spv_target_env env,
     while (!output.empty() && output.back() == '\n') output.pop_back();
   }
   spvTextDestroy(text);
-  spvContextDestroy(context);
 
   return output;
 }
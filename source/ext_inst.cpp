@@ -39,25 +39,36 @@
 #include "spv-amd-shader-trinary-minmax.insts.inc"
 
 static const spv_ext_inst_group_t kGroups_1_0[] = {
-    {SPV_EXT_INST_TYPE_GLSL_STD_450, ARRAY_SIZE(glsl_entries), glsl_entries},
-    {SPV_EXT_INST_TYPE_OPENCL_STD, ARRAY_SIZE(opencl_entries), opencl_entries},
+    {SPV_EXT_INST_TYPE_GLSL_STD_450, ARRAY_SIZE(glsl_entries), glsl_entries,
+     &glsl_name_index, &glsl_value_index},
+    {SPV_EXT_INST_TYPE_OPENCL_STD, ARRAY_SIZE(opencl_entries), opencl_entries,
+     &opencl_name_index, &opencl_value_index},
     {SPV_EXT_INST_TYPE_SPV_AMD_SHADER_EXPLICIT_VERTEX_PARAMETER,
      ARRAY_SIZE(spv_amd_shader_explicit_vertex_parameter_entries),
-     spv_amd_shader_explicit_vertex_parameter_entries},
+     spv_amd_shader_explicit_vertex_parameter_entries,
+     &spv_amd_shader_explicit_vertex_parameter_name_index,
+     &spv_amd_shader_explicit_vertex_parameter_value_index},
     {SPV_EXT_INST_TYPE_SPV_AMD_SHADER_TRINARY_MINMAX,
      ARRAY_SIZE(spv_amd_shader_trinary_minmax_entries),
-     spv_amd_shader_trinary_minmax_entries},
+     spv_amd_shader_trinary_minmax_entries,
+     &spv_amd_shader_trinary_minmax_name_index,
+     &spv_amd_shader_trinary_minmax_value_index},
     {SPV_EXT_INST_TYPE_SPV_AMD_GCN_SHADER,
-     ARRAY_SIZE(spv_amd_gcn_shader_entries), spv_amd_gcn_shader_entries},
+     ARRAY_SIZE(spv_amd_gcn_shader_entries), spv_amd_gcn_shader_entries,
+     &spv_amd_gcn_shader_name_index, &spv_amd_gcn_shader_value_index},
     {SPV_EXT_INST_TYPE_SPV_AMD_SHADER_BALLOT,
-     ARRAY_SIZE(spv_amd_shader_ballot_entries), spv_amd_shader_ballot_entries},
+     ARRAY_SIZE(spv_amd_shader_ballot_entries), spv_amd_shader_ballot_entries,
+     &spv_amd_shader_ballot_name_index, &spv_amd_shader_ballot_value_index},
     {SPV_EXT_INST_TYPE_DEBUGINFO, ARRAY_SIZE(debuginfo_entries),
-     debuginfo_entries},
+     debuginfo_entries, &debuginfo_name_index, &debuginfo_value_index},
     {SPV_EXT_INST_TYPE_OPENCL_DEBUGINFO_100,
-     ARRAY_SIZE(opencl_debuginfo_100_entries), opencl_debuginfo_100_entries},
+     ARRAY_SIZE(opencl_debuginfo_100_entries), opencl_debuginfo_100_entries,
+     &opencl_debuginfo_100_name_index, &opencl_debuginfo_100_value_index},
     {SPV_EXT_INST_TYPE_NONSEMANTIC_CLSPVREFLECTION,
      ARRAY_SIZE(nonsemantic_clspvreflection_entries),
-     nonsemantic_clspvreflection_entries},
+     nonsemantic_clspvreflection_entries,
+     &nonsemantic_clspvreflection_name_index,
+     &nonsemantic_clspvreflection_value_index},
 };
 
 static const spv_ext_inst_table_t kTable_1_0 = {ARRAY_SIZE(kGroups_1_0),
@@ -160,15 +171,14 @@ spv_result_t spvExtInstTableNameLookup(const spv_ext_inst_table table,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!pEntry) return SPV_ERROR_INVALID_POINTER;
 
+  const size_t nameLength = strlen(name);
   for (uint32_t groupIndex = 0; groupIndex < table->count; groupIndex++) {
     const auto& group = table->groups[groupIndex];
     if (type != group.type) continue;
-    for (uint32_t index = 0; index < group.count; index++) {
-      const auto& entry = group.entries[index];
-      if (!strcmp(name, entry.name)) {
-        *pEntry = &entry;
-        return SPV_SUCCESS;
-      }
+    const uint32_t index = spvNameIndexFind(group.name_index, name, nameLength);
+    if (index < group.count && !strcmp(name, group.entries[index].name)) {
+      *pEntry = &group.entries[index];
+      return SPV_SUCCESS;
     }
   }
 
@@ -185,12 +195,10 @@ spv_result_t spvExtInstTableValueLookup(const spv_ext_inst_table table,
   for (uint32_t groupIndex = 0; groupIndex < table->count; groupIndex++) {
     const auto& group = table->groups[groupIndex];
     if (type != group.type) continue;
-    for (uint32_t index = 0; index < group.count; index++) {
-      const auto& entry = group.entries[index];
-      if (value == entry.ext_inst) {
-        *pEntry = &entry;
-        return SPV_SUCCESS;
-      }
+    const uint32_t index = spvValueIndexFind(group.value_index, value);
+    if (index < group.count) {
+      *pEntry = &group.entries[index];
+      return SPV_SUCCESS;
     }
   }
 
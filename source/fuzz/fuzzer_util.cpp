@@ -523,10 +523,9 @@ bool IsValidAndWellFormed(const opt::IRContext* ir_context,
 }
 
 std::unique_ptr<opt::IRContext> CloneIRContext(opt::IRContext* context) {
-  std::vector<uint32_t> binary;
-  context->module()->ToBinary(&binary, false);
-  return BuildModule(context->grammar().target_env(), nullptr, binary.data(),
-                     binary.size());
+  std::unique_ptr<opt::IRContext> clone = context->Clone();
+  clone->SetMessageConsumer(nullptr);
+  return clone;
 }
 
 bool IsNonFunctionTypeId(opt::IRContext* ir_context, uint32_t id) {
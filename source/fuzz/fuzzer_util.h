@@ -187,8 +187,7 @@ bool IsValidAndWellFormed(const opt::IRContext* context,
                           spv_validator_options validator_options,
                           MessageConsumer consumer);
 
-// Returns a clone of |context|, by writing |context| to a binary and then
-// parsing it again.
+// Returns a clone of |context|, without a message consumer.
 std::unique_ptr<opt::IRContext> CloneIRContext(opt::IRContext* context);
 
 // Returns true if and only if |id| is the id of a type that is not a function
@@ -130,6 +130,35 @@ bool SpirvTools::Validate(const uint32_t* binary, const size_t binary_size,
   return valid;
 }
 
+bool SpirvTools::Validate(const uint32_t* binary, const size_t binary_size,
+                          spv_validator_options options,
+                          ValidationCache* cache) const {
+  if (!cache) return Validate(binary, binary_size, options);
+  const spv_target_env env = impl_->context->target_env;
+  ValidationCache::Result result;
+  if (!cache->Lookup(env, binary, binary_size, options, &result)) {
+    spv_const_binary_t the_binary{binary, binary_size};
+    spv_diagnostic diagnostic = nullptr;
+    result.status = spvValidateWithOptions(impl_->context, options,
+                                           &the_binary, &diagnostic);
+    result.position = {0, 0, 0};
+    if (diagnostic) {
+      result.position = diagnostic->position;
+      result.message = diagnostic->error;
+    }
+    spvDiagnosticDestroy(diagnostic);
+    cache->Insert(env, binary, binary_size, options, result);
+  }
+
+  const bool valid = result.status == SPV_SUCCESS;
+  if (!valid && impl_->context->consumer) {
+    impl_->context->consumer.operator()(SPV_MSG_ERROR, nullptr,
+                                        result.position,
+                                        result.message.c_str());
+  }
+  return valid;
+}
+
 bool SpirvTools::IsValid() const { return impl_->context != nullptr; }
 
 }  // namespace spvtools
@@ -37,8 +37,9 @@ struct OpcodeDescPtrLen {
 
 #include "core.insts-unified1.inc"
 
-static const spv_opcode_table_t kOpcodeTable = {ARRAY_SIZE(kOpcodeTableEntries),
-                                                kOpcodeTableEntries};
+static const spv_opcode_table_t kOpcodeTable = {
+    ARRAY_SIZE(kOpcodeTableEntries), kOpcodeTableEntries,
+    &kOpcodeTableNameIndex, &kOpcodeTableValueIndex};
 
 // Represents a vendor tool entry in the SPIR-V XML Regsitry.
 struct VendorTool {
@@ -95,29 +96,29 @@ spv_result_t spvOpcodeTableNameLookup(spv_target_env env,
   if (!name || !pEntry) return SPV_ERROR_INVALID_POINTER;
   if (!table) return SPV_ERROR_INVALID_TABLE;
 
-  // TODO: This lookup of the Opcode table is suboptimal! Binary sort would be
-  // preferable but the table requires sorting on the Opcode name, but it's
-  // static const initialized and matches the order of the spec.
+  // Opcode names are unique, so the name index gives the only candidate.
   const size_t nameLength = strlen(name);
+  const uint32_t opcodeIndex =
+      spvNameIndexFind(table->name_index, name, nameLength);
+  if (opcodeIndex >= table->count) return SPV_ERROR_INVALID_LOOKUP;
+
+  const spv_opcode_desc_t& entry = table->entries[opcodeIndex];
   const auto version = spvVersionForTargetEnv(env);
-  for (uint64_t opcodeIndex = 0; opcodeIndex < table->count; ++opcodeIndex) {
-    const spv_opcode_desc_t& entry = table->entries[opcodeIndex];
-    // We considers the current opcode as available as long as
-    // 1. The target environment satisfies the minimal requirement of the
-    //    opcode; or
-    // 2. There is at least one extension enabling this opcode.
-    //
-    // Note that the second rule assumes the extension enabling this instruction
-    // is indeed requested in the SPIR-V code; checking that should be
-    // validator's work.
-    if (((version >= entry.minVersion && version <= entry.lastVersion) ||
-         entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
-        nameLength == strlen(entry.name) &&
-        !strncmp(name, entry.name, nameLength)) {
-      // NOTE: Found out Opcode!
-      *pEntry = &entry;
-      return SPV_SUCCESS;
-    }
+  // We considers the current opcode as available as long as
+  // 1. The target environment satisfies the minimal requirement of the
+  //    opcode; or
+  // 2. There is at least one extension enabling this opcode.
+  //
+  // Note that the second rule assumes the extension enabling this instruction
+  // is indeed requested in the SPIR-V code; checking that should be
+  // validator's work.
+  if (((version >= entry.minVersion && version <= entry.lastVersion) ||
+       entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
+      nameLength == strlen(entry.name) &&
+      !strncmp(name, entry.name, nameLength)) {
+    // NOTE: Found out Opcode!
+    *pEntry = &entry;
+    return SPV_SUCCESS;
   }
 
   return SPV_ERROR_INVALID_LOOKUP;
@@ -130,15 +131,9 @@ spv_result_t spvOpcodeTableValueLookup(spv_target_env env,
   if (!table) return SPV_ERROR_INVALID_TABLE;
   if (!pEntry) return SPV_ERROR_INVALID_POINTER;
 
-  const auto beg = table->entries;
   const auto end = table->entries + table->count;
-
-  spv_opcode_desc_t needle = {"",    opcode, 0, nullptr, 0,   {},
-                              false, false,  0, nullptr, ~0u, ~0u};
-
-  auto comp = [](const spv_opcode_desc_t& lhs, const spv_opcode_desc_t& rhs) {
-    return lhs.opcode < rhs.opcode;
-  };
+  const uint32_t first = spvValueIndexFind(table->value_index, opcode);
+  if (first >= table->count) return SPV_ERROR_INVALID_LOOKUP;
 
   // We need to loop here because there can exist multiple symbols for the same
   // opcode value, and they can be introduced in different target environments,
@@ -146,8 +141,8 @@ spv_result_t spvOpcodeTableValueLookup(spv_target_env env,
   // Assumes the underlying table is already sorted ascendingly according to
   // opcode value.
   const auto version = spvVersionForTargetEnv(env);
-  for (auto it = std::lower_bound(beg, end, needle, comp);
-       it != end && it->opcode == opcode; ++it) {
+  for (auto it = table->entries + first; it != end && it->opcode == opcode;
+       ++it) {
     // We considers the current opcode as available as long as
     // 1. The target environment satisfies the minimal requirement of the
     //    opcode; or
@@ -184,20 +179,9 @@ void spvInstructionCopy(const uint32_t* words, const SpvOp opcode,
 }
 
 const char* spvOpcodeString(const uint32_t opcode) {
-  const auto beg = kOpcodeTableEntries;
-  const auto end = kOpcodeTableEntries + ARRAY_SIZE(kOpcodeTableEntries);
-  spv_opcode_desc_t needle = {"",    static_cast<SpvOp>(opcode),
-                              0,     nullptr,
-                              0,     {},
-                              false, false,
-                              0,     nullptr,
-                              ~0u,   ~0u};
-  auto comp = [](const spv_opcode_desc_t& lhs, const spv_opcode_desc_t& rhs) {
-    return lhs.opcode < rhs.opcode;
-  };
-  auto it = std::lower_bound(beg, end, needle, comp);
-  if (it != end && it->opcode == opcode) {
-    return it->name;
+  const uint32_t index = spvValueIndexFind(&kOpcodeTableValueIndex, opcode);
+  if (index < ARRAY_SIZE(kOpcodeTableEntries)) {
+    return kOpcodeTableEntries[index].name;
   }
 
   assert(0 && "Unreachable!");
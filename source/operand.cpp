@@ -61,24 +61,26 @@ spv_result_t spvOperandTableNameLookup(spv_target_env env,
   for (uint64_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
     const auto& group = table->types[typeIndex];
     if (type != group.type) continue;
-    for (uint64_t index = 0; index < group.count; ++index) {
-      const auto& entry = group.entries[index];
-      // We consider the current operand as available as long as
-      // 1. The target environment satisfies the minimal requirement of the
-      //    operand; or
-      // 2. There is at least one extension enabling this operand; or
-      // 3. There is at least one capability enabling this operand.
-      //
-      // Note that the second rule assumes the extension enabling this operand
-      // is indeed requested in the SPIR-V code; checking that should be
-      // validator's work.
-      if (((version >= entry.minVersion && version <= entry.lastVersion) ||
-           entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
-          nameLength == strlen(entry.name) &&
-          !strncmp(entry.name, name, nameLength)) {
-        *pEntry = &entry;
-        return SPV_SUCCESS;
-      }
+    // Enumerant names are unique within an operand kind, so the name index
+    // gives the only candidate.
+    const uint32_t index = spvNameIndexFind(group.name_index, name, nameLength);
+    if (index >= group.count) continue;
+    const auto& entry = group.entries[index];
+    // We consider the current operand as available as long as
+    // 1. The target environment satisfies the minimal requirement of the
+    //    operand; or
+    // 2. There is at least one extension enabling this operand; or
+    // 3. There is at least one capability enabling this operand.
+    //
+    // Note that the second rule assumes the extension enabling this operand
+    // is indeed requested in the SPIR-V code; checking that should be
+    // validator's work.
+    if (((version >= entry.minVersion && version <= entry.lastVersion) ||
+         entry.numExtensions > 0u || entry.numCapabilities > 0u) &&
+        nameLength == strlen(entry.name) &&
+        !strncmp(entry.name, name, nameLength)) {
+      *pEntry = &entry;
+      return SPV_SUCCESS;
     }
   }
 
@@ -105,6 +107,13 @@ spv_result_t spvOperandTableValueLookup(spv_target_env env,
 
     const auto beg = group.entries;
     const auto end = group.entries + group.count;
+    auto first = end;
+    if (group.value_index) {
+      const uint32_t index = spvValueIndexFind(group.value_index, value);
+      if (index < group.count) first = beg + index;
+    } else {
+      first = std::lower_bound(beg, end, needle, comp);
+    }
 
     // We need to loop here because there can exist multiple symbols for the
     // same operand value, and they can be introduced in different target
@@ -117,8 +126,7 @@ spv_result_t spvOperandTableValueLookup(spv_target_env env,
     // Assumes the underlying table is already sorted ascendingly according to
     // opcode value.
     const auto version = spvVersionForTargetEnv(env);
-    for (auto it = std::lower_bound(beg, end, needle, comp);
-         it != end && it->value == value; ++it) {
+    for (auto it = first; it != end && it->value == value; ++it) {
       // We consider the current operand as available as long as
       // 1. The target environment satisfies the minimal requirement of the
       //    operand; or
@@ -690,7 +690,11 @@ Pass::Status AggressiveDCEPass::ProcessImpl() {
   InitializeModuleScopeLiveInstructions();
 
   // Process all entry point functions.
-  ProcessFunction pfn = [this](Function* fp) { return AggressiveDCE(fp); };
+  ProcessFunction pfn = [this](Function* fp) {
+    if (!AggressiveDCE(fp)) return false;
+    MarkFunctionModified(fp);
+    return true;
+  };
   modified |= context()->ProcessEntryPointCallTree(pfn);
 
   // If the decoration manager is kept live then the context will try to keep it
@@ -717,7 +721,11 @@ Pass::Status AggressiveDCEPass::ProcessImpl() {
   }
 
   // Cleanup all CFG including all unreachable blocks.
-  ProcessFunction cleanup = [this](Function* f) { return CFGCleanup(f); };
+  ProcessFunction cleanup = [this](Function* f) {
+    if (!CFGCleanup(f)) return false;
+    MarkFunctionModified(f);
+    return true;
+  };
   modified |= context()->ProcessEntryPointCallTree(cleanup);
 
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
@@ -739,6 +747,7 @@ bool AggressiveDCEPass::EliminateDeadFunctions() {
        funcIter != get_module()->end();) {
     if (live_function_set.count(&*funcIter) == 0) {
       modified = true;
+      MarkFunctionModified(&*funcIter);
       funcIter =
           eliminatedeadfunctionsutil::EliminateFunction(context(), &funcIter);
     } else {
@@ -54,6 +54,8 @@ class AggressiveDCEPass : public MemPass {
            IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
   }
 
+  bool TracksModifiedFunctions() const override { return true; }
+
  private:
   // Return true if |varId| is a variable of |storageClass|. |varId| must either
   // be 0 or the result of an instruction.
@@ -28,6 +28,7 @@
 
 #include "source/opt/instruction.h"
 #include "source/opt/instruction_list.h"
+#include "source/opt/ir_allocator.h"
 #include "source/opt/iterator.h"
 
 namespace spvtools {
@@ -50,6 +51,10 @@ class BasicBlock {
 
   explicit BasicBlock(const BasicBlock& bb) = delete;
 
+  // Basic blocks are allocated from the IRAllocator current on this thread.
+  static void* operator new(size_t size) { return IRAllocator::Allocate(size); }
+  static void operator delete(void* object) { IRAllocator::Free(object); }
+
   // Creates a clone of the basic block in the given |context|
   //
   // The parent function will default to null and needs to be explicitly set by
@@ -58,19 +58,29 @@ std::unique_ptr<opt::IRContext> BuildModule(spv_target_env env,
                                             const uint32_t* binary,
                                             const size_t size,
                                             bool extra_line_tracking) {
-  auto context = spvContextCreate(env);
-  SetContextMessageConsumer(context, consumer);
+  return BuildModule(GetSharedContext(env), consumer, binary, size,
+                     extra_line_tracking);
+}
 
-  auto irContext = MakeUnique<opt::IRContext>(env, consumer);
+std::unique_ptr<opt::IRContext> BuildModule(spv_const_context context,
+                                            MessageConsumer consumer,
+                                            const uint32_t* binary,
+                                            const size_t size,
+                                            bool extra_line_tracking) {
+  // Use a copy of |context| so that its consumer can be replaced without
+  // affecting other users of the shared tables.
+  spv_context_t hijack_context = *context;
+  SetContextMessageConsumer(&hijack_context, consumer);
+
+  auto irContext = MakeUnique<opt::IRContext>(context->target_env, consumer);
+  opt::IRAllocator::Scope allocator_scope(irContext->allocator());
   opt::IrLoader loader(consumer, irContext->module());
   loader.SetExtraLineTracking(extra_line_tracking);
 
-  spv_result_t status = spvBinaryParse(context, &loader, binary, size,
+  spv_result_t status = spvBinaryParse(&hijack_context, &loader, binary, size,
                                        SetSpvHeader, SetSpvInst, nullptr);
   loader.EndModule();
 
-  spvContextDestroy(context);
-
   return status == SPV_SUCCESS ? std::move(irContext) : nullptr;
 }
 
@@ -41,6 +41,15 @@ std::unique_ptr<opt::IRContext> BuildModule(spv_target_env env,
                                             const uint32_t* binary,
                                             size_t size);
 
+// Like the first overload, but decodes |binary| with the grammar tables of the
+// existing |context| instead of creating new ones, so that many modules can be
+// built from the same |context|, including from several threads at once.  The
+// consumer of |context| is not used: errors are sent to |consumer|.
+std::unique_ptr<opt::IRContext> BuildModule(spv_const_context context,
+                                            MessageConsumer consumer,
+                                            const uint32_t* binary, size_t size,
+                                            bool extra_line_tracking);
+
 // Builds an Module and returns the owning IRContext from the given
 // SPIR-V assembly |text|.  The |text| will be encoded according to the given
 // target |env|. Returns nullptr if errors occur and sends the errors to
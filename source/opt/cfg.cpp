@@ -39,7 +39,14 @@ CFG::CFG(Module* module)
           new Instruction(module->context(), SpvOpLabel, 0, 0, {}))),
       pseudo_exit_block_(std::unique_ptr<Instruction>(new Instruction(
           module->context(), SpvOpLabel, 0, kMaxResultId, {}))) {
-  for (auto& fn : *module) {
+  Rebuild();
+}
+
+void CFG::Rebuild() {
+  block2structured_succs_.clear();
+  label2preds_.clear();
+  id2block_.clear();
+  for (auto& fn : *module_) {
     for (auto& blk : fn) {
       RegisterBlock(&blk);
     }
@@ -30,6 +30,10 @@ class CFG {
  public:
   explicit CFG(Module* module);
 
+  // Recomputes the CFG of the module from scratch.  The pseudo entry and exit
+  // blocks are kept.
+  void Rebuild();
+
   // Return the list of predecesors for basic block with label |blkid|.
   // TODO(dnovillo): Move this to BasicBlock.
   const std::vector<uint32_t>& preds(uint32_t blk_id) const {
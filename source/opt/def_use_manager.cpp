@@ -14,6 +14,7 @@
 
 #include "source/opt/def_use_manager.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "source/opt/log.h"
@@ -23,16 +24,49 @@ namespace spvtools {
 namespace opt {
 namespace analysis {
 
+namespace {
+
+// The number of erased users an id may have before its user list is compacted.
+const uint32_t kMinErasedUsersToCompact = 8;
+
+}  // namespace
+
+void DefinitionMap::Set(uint32_t id, Instruction* def) {
+  assert(def && "Definition must not be null.");
+  if (id >= defs_.size()) defs_.resize(id + 1, nullptr);
+  if (!defs_[id]) ++size_;
+  defs_[id] = def;
+}
+
+void DefinitionMap::Erase(uint32_t id) {
+  if (id < defs_.size() && defs_[id]) {
+    defs_[id] = nullptr;
+    --size_;
+  }
+}
+
+bool operator==(const DefinitionMap& lhs, const DefinitionMap& rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  const size_t bound = std::max(lhs.defs_.size(), rhs.defs_.size());
+  for (uint32_t id = 0; id < bound; ++id) {
+    if (lhs.Get(id) != rhs.Get(id)) return false;
+  }
+  return true;
+}
+
 void DefUseManager::AnalyzeInstDef(Instruction* inst) {
   const uint32_t def_id = inst->result_id();
   if (def_id != 0) {
-    auto iter = id_to_def_.find(def_id);
-    if (iter != id_to_def_.end()) {
+    Instruction* old_def = id_to_def_.Get(def_id);
+    if (old_def) {
       // Clear the original instruction that defining the same result id of the
       // new instruction.
-      ClearInst(iter->second);
+      ClearInst(old_def);
+      // The users of the original instruction are not users of the new one,
+      // even if the original instruction had not been analyzed.
+      if (old_def != inst) ClearUsers(def_id);
     }
-    id_to_def_[def_id] = inst;
+    id_to_def_.Set(def_id, inst);
   } else {
     ClearInst(inst);
   }
@@ -42,12 +76,13 @@ void DefUseManager::AnalyzeInstUse(Instruction* inst) {
   // Create entry for the given instruction. Note that the instruction may
   // not have any in-operands. In such cases, we still need a entry for those
   // instructions so this manager knows it has seen the instruction later.
-  auto* used_ids = &inst_to_used_ids_[inst];
-  if (used_ids->size()) {
-    EraseUseRecordsOfOperandIds(inst);
-    used_ids = &inst_to_used_ids_[inst];
+  const uint32_t unique_id = inst->unique_id();
+  if (unique_id >= inst_to_used_ids_.size()) {
+    inst_to_used_ids_.resize(unique_id + 1);
   }
-  used_ids->clear();  // It might have existed before.
+  EraseUseRecordsOfOperandIds(inst);  // It might have existed before.
+  InstUses& used_ids = inst_to_used_ids_[unique_id];
+  used_ids.analyzed = true;
 
   for (uint32_t i = 0; i < inst->NumOperands(); ++i) {
     switch (inst->GetOperand(i).type) {
@@ -57,10 +92,9 @@ void DefUseManager::AnalyzeInstUse(Instruction* inst) {
       case SPV_OPERAND_TYPE_MEMORY_SEMANTICS_ID:
       case SPV_OPERAND_TYPE_SCOPE_ID: {
         uint32_t use_id = inst->GetSingleWordOperand(i);
-        Instruction* def = GetDef(use_id);
-        assert(def && "Definition is not registered.");
-        id_to_users_.insert(UserEntry(def, inst));
-        used_ids->push_back(use_id);
+        assert(GetDef(use_id) && "Definition is not registered.");
+        AddUser(use_id, inst);
+        used_ids.ids.push_back(use_id);
       } break;
       default:
         break;
@@ -75,42 +109,16 @@ void DefUseManager::AnalyzeInstDefUse(Instruction* inst) {
 
 void DefUseManager::UpdateDefUse(Instruction* inst) {
   const uint32_t def_id = inst->result_id();
-  if (def_id != 0) {
-    auto iter = id_to_def_.find(def_id);
-    if (iter == id_to_def_.end()) {
-      AnalyzeInstDef(inst);
-    }
+  if (def_id != 0 && !id_to_def_.Get(def_id)) {
+    AnalyzeInstDef(inst);
   }
   AnalyzeInstUse(inst);
 }
 
-Instruction* DefUseManager::GetDef(uint32_t id) {
-  auto iter = id_to_def_.find(id);
-  if (iter == id_to_def_.end()) return nullptr;
-  return iter->second;
-}
+Instruction* DefUseManager::GetDef(uint32_t id) { return id_to_def_.Get(id); }
 
 const Instruction* DefUseManager::GetDef(uint32_t id) const {
-  const auto iter = id_to_def_.find(id);
-  if (iter == id_to_def_.end()) return nullptr;
-  return iter->second;
-}
-
-DefUseManager::IdToUsersMap::const_iterator DefUseManager::UsersBegin(
-    const Instruction* def) const {
-  return id_to_users_.lower_bound(
-      UserEntry(const_cast<Instruction*>(def), nullptr));
-}
-
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const IdToUsersMap::const_iterator& cached_end,
-                                const Instruction* inst) const {
-  return (iter != cached_end && iter->first == inst);
-}
-
-bool DefUseManager::UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                                const Instruction* inst) const {
-  return UsersNotEnd(iter, id_to_users_.end(), inst);
+  return id_to_def_.Get(id);
 }
 
 bool DefUseManager::WhileEachUser(
@@ -120,9 +128,31 @@ bool DefUseManager::WhileEachUser(
          "Definition is not registered.");
   if (!def->HasResultId()) return true;
 
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    if (!f(iter->second)) return false;
+  const uint32_t id = def->result_id();
+  const UserList* users = GetUsers(id);
+  if (!users) return true;
+
+  // |f| may add or remove users of |id|.  The list is looked up again after
+  // every call, and if users were moved the iteration resumes after the last
+  // user visited.
+  uint32_t generation = users->generation;
+  uint32_t last_unique_id = 0;
+  for (size_t i = 0;; ++i) {
+    users = GetUsers(id);
+    if (users->generation != generation) {
+      generation = users->generation;
+      i = std::upper_bound(users->records.begin(), users->records.end(),
+                           last_unique_id,
+                           [](uint32_t unique_id, const UserRecord& record) {
+                             return unique_id < record.unique_id;
+                           }) -
+          users->records.begin();
+    }
+    if (i >= users->records.size()) break;
+
+    const UserRecord& record = users->records[i];
+    last_unique_id = record.unique_id;
+    if (record.user && !f(record.user)) return false;
   }
   return true;
 }
@@ -148,14 +178,7 @@ void DefUseManager::ForEachUser(
 bool DefUseManager::WhileEachUse(
     const Instruction* def,
     const std::function<bool(Instruction*, uint32_t)>& f) const {
-  // Ensure that |def| has been registered.
-  assert(def && (!def->HasResultId() || def == GetDef(def->result_id())) &&
-         "Definition is not registered.");
-  if (!def->HasResultId()) return true;
-
-  auto end = id_to_users_.end();
-  for (auto iter = UsersBegin(def); UsersNotEnd(iter, end, def); ++iter) {
-    Instruction* user = iter->second;
+  return WhileEachUser(def, [def, &f](Instruction* user) {
     for (uint32_t idx = 0; idx != user->NumOperands(); ++idx) {
       const Operand& op = user->GetOperand(idx);
       if (op.type != SPV_OPERAND_TYPE_RESULT_ID && spvIsIdType(op.type)) {
@@ -164,8 +187,8 @@ bool DefUseManager::WhileEachUse(
         }
       }
     }
-  }
-  return true;
+    return true;
+  });
 }
 
 bool DefUseManager::WhileEachUse(
@@ -188,9 +211,14 @@ void DefUseManager::ForEachUse(
 }
 
 uint32_t DefUseManager::NumUsers(const Instruction* def) const {
-  uint32_t count = 0;
-  ForEachUser(def, [&count](Instruction*) { ++count; });
-  return count;
+  // Ensure that |def| has been registered.
+  assert(def && (!def->HasResultId() || def == GetDef(def->result_id())) &&
+         "Definition is not registered.");
+  if (!def->HasResultId()) return 0;
+
+  const UserList* users = GetUsers(def->result_id());
+  if (!users) return 0;
+  return static_cast<uint32_t>(users->records.size() - users->num_erased);
 }
 
 uint32_t DefUseManager::NumUsers(uint32_t id) const {
@@ -220,8 +248,82 @@ std::vector<Instruction*> DefUseManager::GetAnnotations(uint32_t id) const {
   return annos;
 }
 
+const DefUseManager::InstUses* DefUseManager::GetInstUses(
+    const Instruction* inst) const {
+  const uint32_t unique_id = inst->unique_id();
+  if (unique_id >= inst_to_used_ids_.size()) return nullptr;
+  const InstUses& inst_uses = inst_to_used_ids_[unique_id];
+  return inst_uses.analyzed ? &inst_uses : nullptr;
+}
+
+void DefUseManager::AddUser(uint32_t id, Instruction* user) {
+  if (id >= id_to_users_.size()) id_to_users_.resize(id + 1);
+  UserList& users = id_to_users_[id];
+  std::vector<UserRecord>& records = users.records;
+  const uint32_t unique_id = user->unique_id();
+
+  // Users are usually analyzed in the order they were created.
+  if (records.empty() || records.back().unique_id < unique_id) {
+    records.push_back({unique_id, user});
+    return;
+  }
+
+  auto iter = std::lower_bound(records.begin(), records.end(), unique_id,
+                               [](const UserRecord& record, uint32_t uid) {
+                                 return record.unique_id < uid;
+                               });
+  if (iter != records.end() && iter->unique_id == unique_id) {
+    if (!iter->user) {
+      iter->user = user;
+      --users.num_erased;
+    }
+    return;
+  }
+  records.insert(iter, {unique_id, user});
+  ++users.generation;
+}
+
+void DefUseManager::EraseUser(uint32_t id, const Instruction* user) {
+  if (id >= id_to_users_.size()) return;
+  UserList& users = id_to_users_[id];
+  std::vector<UserRecord>& records = users.records;
+  const uint32_t unique_id = user->unique_id();
+
+  auto iter = std::lower_bound(records.begin(), records.end(), unique_id,
+                               [](const UserRecord& record, uint32_t uid) {
+                                 return record.unique_id < uid;
+                               });
+  if (iter == records.end() || iter->unique_id != unique_id || !iter->user) {
+    return;
+  }
+  iter->user = nullptr;
+  ++users.num_erased;
+
+  if (users.num_erased == records.size()) {
+    ClearUsers(id);
+  } else if (users.num_erased >= kMinErasedUsersToCompact &&
+             2 * users.num_erased > records.size()) {
+    records.erase(std::remove_if(records.begin(), records.end(),
+                                 [](const UserRecord& record) {
+                                   return record.user == nullptr;
+                                 }),
+                  records.end());
+    users.num_erased = 0;
+    ++users.generation;
+  }
+}
+
+void DefUseManager::ClearUsers(uint32_t id) {
+  if (id >= id_to_users_.size()) return;
+  UserList& users = id_to_users_[id];
+  users.records.clear();
+  users.num_erased = 0;
+  ++users.generation;
+}
+
 void DefUseManager::AnalyzeDefUse(Module* module) {
   if (!module) return;
+  id_to_users_.reserve(module->IdBound());
   // Analyze all the defs before any uses to catch forward references.
   module->ForEachInst(
       std::bind(&DefUseManager::AnalyzeInstDef, this, std::placeholders::_1));
@@ -230,18 +332,12 @@ void DefUseManager::AnalyzeDefUse(Module* module) {
 }
 
 void DefUseManager::ClearInst(Instruction* inst) {
-  auto iter = inst_to_used_ids_.find(inst);
-  if (iter != inst_to_used_ids_.end()) {
+  if (GetInstUses(inst)) {
     EraseUseRecordsOfOperandIds(inst);
     if (inst->result_id() != 0) {
       // Remove all uses of this inst.
-      auto users_begin = UsersBegin(inst);
-      auto end = id_to_users_.end();
-      auto new_end = users_begin;
-      for (; UsersNotEnd(new_end, end, inst); ++new_end) {
-      }
-      id_to_users_.erase(users_begin, new_end);
-      id_to_def_.erase(inst->result_id());
+      if (GetDef(inst->result_id()) == inst) ClearUsers(inst->result_id());
+      id_to_def_.Erase(inst->result_id());
     }
   }
 }
@@ -249,13 +345,13 @@ void DefUseManager::ClearInst(Instruction* inst) {
 void DefUseManager::EraseUseRecordsOfOperandIds(const Instruction* inst) {
   // Go through all ids used by this instruction, remove this instruction's
   // uses of them.
-  auto iter = inst_to_used_ids_.find(inst);
-  if (iter != inst_to_used_ids_.end()) {
-    for (auto use_id : iter->second) {
-      id_to_users_.erase(
-          UserEntry(GetDef(use_id), const_cast<Instruction*>(inst)));
+  if (GetInstUses(inst)) {
+    InstUses& inst_uses = inst_to_used_ids_[inst->unique_id()];
+    for (auto use_id : inst_uses.ids) {
+      EraseUser(use_id, inst);
     }
-    inst_to_used_ids_.erase(inst);
+    inst_uses.ids.clear();
+    inst_uses.analyzed = false;
   }
 }
 
@@ -264,32 +360,39 @@ bool operator==(const DefUseManager& lhs, const DefUseManager& rhs) {
     return false;
   }
 
-  if (lhs.id_to_users_ != rhs.id_to_users_) {
-    for (auto p : lhs.id_to_users_) {
-      if (rhs.id_to_users_.count(p) == 0) {
-        return false;
+  // Erased users are skipped, since where they remain depends on the order in
+  // which the instructions were analyzed.
+  auto live_users = [](const DefUseManager& manager, uint32_t id) {
+    std::vector<Instruction*> users;
+    if (const DefUseManager::UserList* list = manager.GetUsers(id)) {
+      for (const auto& record : list->records) {
+        if (record.user) users.push_back(record.user);
       }
     }
-    for (auto p : rhs.id_to_users_) {
-      if (lhs.id_to_users_.count(p) == 0) {
-        return false;
-      }
+    return users;
+  };
+  const size_t id_bound =
+      std::max(lhs.id_to_users_.size(), rhs.id_to_users_.size());
+  for (uint32_t id = 0; id < id_bound; ++id) {
+    if (live_users(lhs, id) != live_users(rhs, id)) {
+      return false;
     }
-    return false;
   }
 
-  if (lhs.inst_to_used_ids_ != rhs.inst_to_used_ids_) {
-    for (auto p : lhs.inst_to_used_ids_) {
-      if (rhs.inst_to_used_ids_.count(p.first) == 0) {
-        return false;
-      }
+  const size_t unique_id_bound =
+      std::max(lhs.inst_to_used_ids_.size(), rhs.inst_to_used_ids_.size());
+  for (uint32_t unique_id = 0; unique_id < unique_id_bound; ++unique_id) {
+    const bool lhs_analyzed = unique_id < lhs.inst_to_used_ids_.size() &&
+                              lhs.inst_to_used_ids_[unique_id].analyzed;
+    const bool rhs_analyzed = unique_id < rhs.inst_to_used_ids_.size() &&
+                              rhs.inst_to_used_ids_[unique_id].analyzed;
+    if (lhs_analyzed != rhs_analyzed) {
+      return false;
     }
-    for (auto p : rhs.inst_to_used_ids_) {
-      if (lhs.inst_to_used_ids_.count(p.first) == 0) {
-        return false;
-      }
+    if (lhs_analyzed && lhs.inst_to_used_ids_[unique_id].ids !=
+                            rhs.inst_to_used_ids_[unique_id].ids) {
+      return false;
     }
-    return false;
   }
   return true;
 }
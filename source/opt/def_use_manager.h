@@ -15,6 +15,10 @@
 #ifndef SOURCE_OPT_DEF_USE_MANAGER_H_
 #define SOURCE_OPT_DEF_USE_MANAGER_H_
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <list>
 #include <set>
 #include <unordered_map>
@@ -51,53 +55,96 @@ inline bool operator<(const Use& lhs, const Use& rhs) {
   return lhs.operand_index < rhs.operand_index;
 }
 
-// Definition and user pair.
-//
-// The first element of the pair is the definition.
-// The second element of the pair is the user.
-//
-// Definition should never be null. User can be null, however, such an entry
-// should be used only for searching (e.g. all users of a particular definition)
-// and never stored in a container.
-using UserEntry = std::pair<Instruction*, Instruction*>;
+// Maps ids to their definitions.  The definitions are kept in a vector
+// indexed by id, which grows as larger ids are defined.  Iteration visits the
+// defined ids in increasing order.
+class DefinitionMap {
+ public:
+  using value_type = std::pair<uint32_t, Instruction*>;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = DefinitionMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    value_type operator*() const {
+      return value_type(id_, (*defs_)[id_]);
+    }
 
-// Orders UserEntry for use in associative containers (i.e. less than ordering).
-//
-// The definition of an UserEntry is treated as the major key and the users as
-// the minor key so that all the users of a particular definition are
-// consecutive in a container.
-//
-// A null user always compares less than a real user. This is done to provide
-// easy values to search for the beginning of the users of a particular
-// definition (i.e. using {def, nullptr}).
-struct UserEntryLess {
-  bool operator()(const UserEntry& lhs, const UserEntry& rhs) const {
-    // If lhs.first and rhs.first are both null, fall through to checking the
-    // second entries.
-    if (!lhs.first && rhs.first) return true;
-    if (lhs.first && !rhs.first) return false;
-
-    // If neither definition is null, then compare unique ids.
-    if (lhs.first && rhs.first) {
-      if (lhs.first->unique_id() < rhs.first->unique_id()) return true;
-      if (rhs.first->unique_id() < lhs.first->unique_id()) return false;
+    const_iterator& operator++() {
+      ++id_;
+      SkipUndefined();
+      return *this;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return id_ == other.id_;
     }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class DefinitionMap;
+
+    const_iterator(const std::vector<Instruction*>* defs, uint32_t id)
+        : defs_(defs), id_(id) {
+      SkipUndefined();
+    }
+
+    void SkipUndefined() {
+      while (id_ < defs_->size() && !(*defs_)[id_]) ++id_;
+    }
+
+    const std::vector<Instruction*>* defs_;
+    uint32_t id_;
+  };
+
+  // Returns the number of defined ids.
+  size_t size() const { return size_; }
 
-    // Return false on equality.
-    if (!lhs.second && !rhs.second) return false;
-    if (!lhs.second) return true;
-    if (!rhs.second) return false;
+  // Returns 1 if |id| is defined, and 0 otherwise.
+  size_t count(uint32_t id) const { return Get(id) ? 1 : 0; }
 
-    // If neither user is null then compare unique ids.
-    return lhs.second->unique_id() < rhs.second->unique_id();
+  // Returns the definition of |id|, which must be defined.
+  Instruction* at(uint32_t id) const {
+    assert(Get(id) && "Id is not defined.");
+    return Get(id);
   }
+
+  // Returns the definition of |id|, or nullptr if it is not defined.
+  Instruction* Get(uint32_t id) const {
+    return id < defs_.size() ? defs_[id] : nullptr;
+  }
+
+  // Makes |def| the definition of |id|.
+  void Set(uint32_t id, Instruction* def);
+
+  // Removes the definition of |id|, if any.
+  void Erase(uint32_t id);
+
+  const_iterator begin() const { return const_iterator(&defs_, 0); }
+  const_iterator end() const {
+    return const_iterator(&defs_, static_cast<uint32_t>(defs_.size()));
+  }
+
+  friend bool operator==(const DefinitionMap& lhs, const DefinitionMap& rhs);
+  friend bool operator!=(const DefinitionMap& lhs, const DefinitionMap& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  std::vector<Instruction*> defs_;
+  size_t size_ = 0;
 };
 
 // A class for analyzing and managing defs and uses in an Module.
 class DefUseManager {
  public:
-  using IdToDefMap = std::unordered_map<uint32_t, Instruction*>;
-  using IdToUsersMap = std::set<UserEntry, UserEntryLess>;
+  using IdToDefMap = DefinitionMap;
 
   // Constructs a def-use manager from the given |module|. All internal messages
   // will be communicated to the outside via the given message |consumer|. This
@@ -197,8 +244,6 @@ class DefUseManager {
 
   // Returns the map from ids to their def instructions.
   const IdToDefMap& id_to_defs() const { return id_to_def_; }
-  // Returns the map from instructions to their users.
-  const IdToUsersMap& id_to_users() const { return id_to_users_; }
 
   // Clear the internal def-use record of the given instruction |inst|. This
   // method will update the use information of the operand ids of |inst|. The
@@ -220,33 +265,57 @@ class DefUseManager {
   void UpdateDefUse(Instruction* inst);
 
  private:
-  using InstToUsedIdsMap =
-      std::unordered_map<const Instruction*, std::vector<uint32_t>>;
+  // A user of an id, identified by the unique id of the instruction.  The
+  // instruction is null once the user is erased.
+  struct UserRecord {
+    uint32_t unique_id;
+    Instruction* user;
+  };
+
+  // The users of an id, sorted by unique id.  Erasing a user leaves a hole in
+  // the list, which is filled again if the same instruction uses the id again.
+  // The holes are removed once they make up half of the list.  |generation|
+  // changes whenever users move within |records|, so that an iteration over
+  // the users can find its place again.
+  struct UserList {
+    std::vector<UserRecord> records;
+    uint32_t num_erased = 0;
+    uint32_t generation = 0;
+  };
+
+  // The ids used by an instruction, in the order of its operands, and whether
+  // the uses of the instruction have been analyzed.
+  struct InstUses {
+    std::vector<uint32_t> ids;
+    bool analyzed = false;
+  };
+
+  // Returns the users of |id|, or nullptr if it never had any.
+  const UserList* GetUsers(uint32_t id) const {
+    return id < id_to_users_.size() ? &id_to_users_[id] : nullptr;
+  }
 
-  // Returns the first location that {|def|, nullptr} could be inserted into the
-  // users map without violating ordering.
-  IdToUsersMap::const_iterator UsersBegin(const Instruction* def) const;
+  // Returns the uses recorded for |inst|, or nullptr if there are none.
+  const InstUses* GetInstUses(const Instruction* inst) const;
 
-  // Returns true if |iter| has not reached the end of |def|'s users.
-  //
-  // In the first version |iter| is compared against the end of the map for
-  // validity before other checks. In the second version, |iter| is compared
-  // against |cached_end| for validity before other checks. This allows caching
-  // the map's end which is a performance improvement on some platforms.
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const Instruction* def) const;
-  bool UsersNotEnd(const IdToUsersMap::const_iterator& iter,
-                   const IdToUsersMap::const_iterator& cached_end,
-                   const Instruction* def) const;
+  // Records that |user| uses |id|.  Does nothing if it was already recorded.
+  void AddUser(uint32_t id, Instruction* user);
+
+  // Erases the record that |user| uses |id|, if any.
+  void EraseUser(uint32_t id, const Instruction* user);
+
+  // Erases all the users of |id|.
+  void ClearUsers(uint32_t id);
 
   // Analyzes the defs and uses in the given |module| and populates data
   // structures in this class. Does nothing if |module| is nullptr.
   void AnalyzeDefUse(Module* module);
 
-  IdToDefMap id_to_def_;      // Mapping from ids to their definitions
-  IdToUsersMap id_to_users_;  // Mapping from ids to their users
-  // Mapping from instructions to the ids used in the instruction.
-  InstToUsedIdsMap inst_to_used_ids_;
+  IdToDefMap id_to_def_;  // Mapping from ids to their definitions
+  // The users of each id, indexed by id.
+  std::vector<UserList> id_to_users_;
+  // The ids used by each analyzed instruction, indexed by unique id.
+  std::vector<InstUses> inst_to_used_ids_;
 };
 
 }  // namespace analysis
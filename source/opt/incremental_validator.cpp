@@ -0,0 +1,59 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/incremental_validator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "source/table.h"
+
+namespace spvtools {
+namespace opt {
+
+bool IncrementalValidator::Validate(
+    IRContext* context,
+    const std::unordered_set<const Function*>* modified_functions) {
+  // The validator checks words: its instructions point into them, and it
+  // takes the number kinds of the operands from the parser.
+  std::vector<uint32_t> binary;
+  context->module()->ToBinary(&binary, true);
+
+  // Without a module to compare with, the bodies of all the functions are
+  // hashed, so that later calls without |modified_functions| can compare them.
+  if (!validated_.valid) modified_functions = nullptr;
+  std::unordered_set<uint32_t> changed_functions;
+  if (modified_functions) {
+    for (const Function& function : *context->module()) {
+      if (modified_functions->count(&function)) {
+        changed_functions.insert(function.result_id());
+      }
+    }
+  }
+
+  spv_diagnostic diagnostic = nullptr;
+  const bool valid =
+      val::ValidateBinaryIncrementally(
+          GetSharedContext(target_env_), options_, binary.data(),
+          binary.size(), &validated_, &diagnostic,
+          modified_functions ? &changed_functions : nullptr) == SPV_SUCCESS;
+  if (!valid && diagnostic && consumer_) {
+    consumer_(SPV_MSG_ERROR, nullptr, diagnostic->position, diagnostic->error);
+  }
+  spvDiagnosticDestroy(diagnostic);
+  return valid;
+}
+
+}  // namespace opt
+}  // namespace spvtools
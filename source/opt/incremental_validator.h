@@ -0,0 +1,65 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_INCREMENTAL_VALIDATOR_H_
+#define SOURCE_OPT_INCREMENTAL_VALIDATOR_H_
+
+#include <unordered_set>
+#include <utility>
+
+#include "source/opt/function.h"
+#include "source/opt/ir_context.h"
+#include "source/val/validate.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace opt {
+
+// Validates the module of an IRContext after each of a sequence of passes.
+// The functions that did not change since the module last validated
+// successfully are not checked again, as long as the rest of the module did
+// not change either.
+class IncrementalValidator {
+ public:
+  // Constructs a validator for modules of |target_env| that validates them
+  // with |options|, which must outlive the validator, and reports errors to
+  // |consumer|.
+  IncrementalValidator(spv_target_env target_env,
+                       spv_const_validator_options options,
+                       MessageConsumer consumer)
+      : target_env_(target_env),
+        options_(options),
+        consumer_(std::move(consumer)) {}
+
+  // Returns true if the module of |context| is valid.  Otherwise reports the
+  // error to the message consumer.  If |modified_functions| is
+  // not null, it must hold every function that changed since the last call,
+  // and the bodies of the other functions are not compared with the module
+  // of the last call.
+  bool Validate(IRContext* context,
+                const std::unordered_set<const Function*>* modified_functions);
+
+ private:
+  spv_target_env target_env_;
+  spv_const_validator_options options_;
+  MessageConsumer consumer_;
+  // The fingerprint of the module as of the last time it validated
+  // successfully.
+  val::ModuleFingerprint validated_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_INCREMENTAL_VALIDATOR_H_
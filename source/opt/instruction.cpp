@@ -153,6 +153,10 @@ Instruction* Instruction::Clone(IRContext* c) const {
   clone->unique_id_ = c->TakeNextUniqueId();
   clone->operands_ = operands_;
   clone->dbg_line_insts_ = dbg_line_insts_;
+  for (auto& i : clone->dbg_line_insts_) {
+    i.context_ = c;
+    i.unique_id_ = c->TakeNextUniqueId();
+  }
   clone->dbg_scope_ = dbg_scope_;
   return clone;
 }
@@ -27,6 +27,7 @@
 #include "source/latest_version_spirv_header.h"
 #include "source/opcode.h"
 #include "source/operand.h"
+#include "source/opt/ir_allocator.h"
 #include "source/opt/reflect.h"
 #include "source/util/ilist_node.h"
 #include "source/util/small_vector.h"
@@ -211,6 +212,10 @@ class Instruction : public utils::IntrusiveNodeBase<Instruction> {
 
   ~Instruction() override = default;
 
+  // Instructions are allocated from the IRAllocator current on this thread.
+  static void* operator new(size_t size) { return IRAllocator::Allocate(size); }
+  static void operator delete(void* object) { IRAllocator::Free(object); }
+
   // Returns a newly allocated instruction that has the same operands, result,
   // and type as |this|.  The new instruction is not linked into any list.
   // It is the responsibility of the caller to make sure that the storage is
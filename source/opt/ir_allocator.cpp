@@ -0,0 +1,103 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/ir_allocator.h"
+
+#include <cassert>
+#include <new>
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+// The allocator current on this thread.
+thread_local IRAllocator* current_allocator = nullptr;
+
+}  // namespace
+
+IRAllocator::Scope::Scope(IRAllocator* allocator)
+    : previous_(current_allocator) {
+  current_allocator = allocator;
+}
+
+IRAllocator::Scope::~Scope() { current_allocator = previous_; }
+
+IRAllocator* IRAllocator::Current() { return current_allocator; }
+
+void* IRAllocator::Allocate(size_t size) {
+  Header* header = nullptr;
+  if (current_allocator) {
+    header = current_allocator->AllocateSlot(size);
+  }
+  if (!header) {
+    header = static_cast<Header*>(::operator new(sizeof(Header) + size));
+    header->allocator = nullptr;
+    header->size_class = 0;
+  }
+  return header + 1;
+}
+
+void IRAllocator::Free(void* object) {
+  if (!object) return;
+  Header* header = static_cast<Header*>(object) - 1;
+  if (header->allocator) {
+    header->allocator->ReturnSlot(header);
+  } else {
+    ::operator delete(header);
+  }
+}
+
+void IRAllocator::Release() {
+  assert(!released_ && "The allocator was already released.");
+  released_ = true;
+  if (live_objects_ == 0) delete this;
+}
+
+IRAllocator::Header* IRAllocator::AllocateSlot(size_t size) {
+  uint32_t index = 0;
+  while (index < num_size_classes_ && size_classes_[index].size != size) {
+    ++index;
+  }
+  if (index == num_size_classes_) {
+    if (num_size_classes_ == kMaxSizeClasses) return nullptr;
+    size_classes_[num_size_classes_++] = {size, nullptr};
+  }
+
+  SizeClass& size_class = size_classes_[index];
+  void* slot;
+  if (size_class.free_list) {
+    slot = size_class.free_list;
+    size_class.free_list = size_class.free_list->next;
+  } else {
+    slot = arena_.AllocateBytes(sizeof(Header) + size, alignof(Header));
+  }
+
+  Header* header = static_cast<Header*>(slot);
+  header->allocator = this;
+  header->size_class = index;
+  ++live_objects_;
+  return header;
+}
+
+void IRAllocator::ReturnSlot(Header* header) {
+  assert(live_objects_ != 0);
+  SizeClass& size_class = size_classes_[header->size_class];
+  FreeSlot* slot = reinterpret_cast<FreeSlot*>(header);
+  slot->next = size_class.free_list;
+  size_class.free_list = slot;
+  if (--live_objects_ == 0 && released_) delete this;
+}
+
+}  // namespace opt
+}  // namespace spvtools
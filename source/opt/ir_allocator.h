@@ -0,0 +1,132 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_OPT_IR_ALLOCATOR_H_
+#define SOURCE_OPT_IR_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "source/util/arena.h"
+
+namespace spvtools {
+namespace opt {
+
+// Storage for the instructions and basic blocks of an IRContext.
+//
+// Instruction and BasicBlock get their storage from Allocate() and give it
+// back with Free().  While an allocator is made current on a thread by a
+// Scope, objects allocated on that thread are placed in fixed size slots
+// carved from an arena.  A freed slot is kept on a free list and handed out
+// again to the next object of the same size.  Objects allocated while no
+// allocator is current come from the heap.
+//
+// The arena is released in one go when the allocator is released and the
+// last of its objects has been freed, so objects may outlive the context that
+// released it.  An allocator is not thread safe: its objects must be allocated
+// and freed on one thread at a time.
+class IRAllocator {
+ public:
+  // Releases an allocator owned by a std::unique_ptr.
+  struct Releaser {
+    void operator()(IRAllocator* allocator) const { allocator->Release(); }
+  };
+
+  // Makes an allocator current on this thread for the lifetime of the scope.
+  class Scope {
+   public:
+    explicit Scope(IRAllocator* allocator);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    IRAllocator* previous_;
+  };
+
+  IRAllocator() : live_objects_(0), num_size_classes_(0), released_(false) {}
+
+  IRAllocator(const IRAllocator&) = delete;
+  IRAllocator& operator=(const IRAllocator&) = delete;
+
+  // Returns storage for an object of |size| bytes.  The storage comes from
+  // the allocator current on this thread, if any, and from the heap
+  // otherwise.
+  static void* Allocate(size_t size);
+
+  // Returns the storage at |object|, which was obtained from Allocate(), to
+  // where it came from.  Does nothing if |object| is null.
+  static void Free(void* object);
+
+  // Returns the allocator current on this thread, or nullptr if there is none.
+  static IRAllocator* Current();
+
+  // Gives up ownership of the allocator.  It is destroyed now if none of its
+  // objects is alive, and otherwise when the last one is freed.
+  void Release();
+
+  // Returns the number of objects allocated from this allocator that have not
+  // been freed.
+  size_t live_objects() const { return live_objects_; }
+
+  // Returns the number of bytes in the arena of this allocator.
+  size_t capacity() const { return arena_.capacity(); }
+
+ private:
+  // Placed in front of every object returned by Allocate().
+  struct alignas(alignof(std::max_align_t)) Header {
+    // The allocator the object came from, or nullptr if it came from the
+    // heap.
+    IRAllocator* allocator;
+    // The index of the size class of the object in |allocator|.
+    uint32_t size_class;
+  };
+
+  // A slot on a free list.
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  // The slots for objects of one size.
+  struct SizeClass {
+    size_t size;
+    FreeSlot* free_list;
+  };
+
+  // The number of distinct object sizes served from the arena.  Objects of
+  // any other size come from the heap.
+  static const uint32_t kMaxSizeClasses = 4;
+
+  ~IRAllocator() = default;
+
+  // Returns the header of a slot for an object of |size| bytes, or nullptr if
+  // there are already too many size classes.
+  Header* AllocateSlot(size_t size);
+
+  // Puts the slot with |header| back on its free list.
+  void ReturnSlot(Header* header);
+
+  utils::Arena arena_;
+  size_t live_objects_;
+  SizeClass size_classes_[kMaxSizeClasses];
+  uint32_t num_size_classes_;
+  // Whether Release() has been called.
+  bool released_;
+};
+
+}  // namespace opt
+}  // namespace spvtools
+
+#endif  // SOURCE_OPT_IR_ALLOCATOR_H_
@@ -90,12 +90,65 @@ void IRContext::BuildInvalidAnalyses(IRContext::Analysis set) {
   }
 }
 
+std::unique_ptr<IRContext> IRContext::Clone() const {
+  auto clone = MakeUnique<IRContext>(grammar_.target_env(), consumer_);
+  {
+    IRAllocator::Scope allocator_scope(clone->allocator());
+    clone->module_ = module_->Clone(clone.get());
+  }
+  clone->module_->SetContext(clone.get());
+  clone->max_id_bound_ = max_id_bound_;
+  clone->preserve_bindings_ = preserve_bindings_;
+  clone->preserve_spec_constants_ = preserve_spec_constants_;
+  clone->num_threads_ = num_threads_;
+  return clone;
+}
+
 void IRContext::InvalidateAnalysesExceptFor(
     IRContext::Analysis preserved_analyses) {
   uint32_t analyses_to_invalidate = valid_analyses_ & (~preserved_analyses);
   InvalidateAnalyses(static_cast<IRContext::Analysis>(analyses_to_invalidate));
 }
 
+void IRContext::InvalidateAnalysesExceptFor(
+    IRContext::Analysis preserved_analyses,
+    const std::unordered_set<const Function*>& modified_functions) {
+  const Analysis kFunctionAnalyses =
+      kAnalysisDominatorAnalysis | kAnalysisLoopAnalysis;
+  Analysis analyses_to_invalidate =
+      Analysis(valid_analyses_ & ~preserved_analyses);
+
+  // The dominators of the modified functions follow the CFG, as in
+  // InvalidateAnalyses().
+  Analysis function_analyses =
+      Analysis(analyses_to_invalidate & kFunctionAnalyses);
+  if (analyses_to_invalidate & kAnalysisCFG) {
+    function_analyses |= kAnalysisDominatorAnalysis;
+  }
+  for (const Function* f : modified_functions) {
+    InvalidateFunctionAnalyses(f, function_analyses);
+  }
+
+  // Keep the CFG object, so that BuildCFG() rebuilds it in place.
+  const bool rebuild_cfg = (analyses_to_invalidate & kAnalysisCFG) != 0;
+  InvalidateAnalyses(Analysis(analyses_to_invalidate &
+                              ~(kFunctionAnalyses | kAnalysisCFG)));
+  if (rebuild_cfg) {
+    valid_analyses_ = Analysis(valid_analyses_ & ~kAnalysisCFG);
+  }
+}
+
+void IRContext::InvalidateFunctionAnalyses(
+    const Function* f, IRContext::Analysis analyses_to_invalidate) {
+  if (analyses_to_invalidate & kAnalysisDominatorAnalysis) {
+    dominator_trees_.erase(f);
+    post_dominator_trees_.erase(f);
+  }
+  if (analyses_to_invalidate & kAnalysisLoopAnalysis) {
+    loop_descriptors_.erase(f);
+  }
+}
+
 void IRContext::InvalidateAnalyses(IRContext::Analysis analyses_to_invalidate) {
   // The ConstantManager and DebugInfoManager contain Type pointers. If the
   // TypeManager goes away, the ConstantManager and DebugInfoManager have to
@@ -906,6 +959,31 @@ bool IRContext::ProcessReachableCallTree(ProcessFunction& pfn) {
   return ProcessCallTreeFromRoots(pfn, &roots);
 }
 
+void IRContext::ForEachInParallel(size_t count, Analysis required,
+                                  const std::function<void(size_t)>& fn) {
+  // Build everything the calls may need now, since the lazy getters are not
+  // safe to call from several threads.
+  BuildInvalidAnalyses(static_cast<Analysis>(required & ~valid_analyses_));
+  if ((required & kAnalysisCombinators) &&
+      !AreAnalysesValid(kAnalysisCombinators)) {
+    InitializeCombinators();
+  }
+  get_feature_mgr();
+
+  if (num_threads_ == 1 || count < 2) {
+    for (size_t i = 0; i < count; ++i) fn(i);
+    return;
+  }
+
+  if (!thread_pool_) {
+    thread_pool_ = MakeUnique<utils::ThreadPool>(num_threads_);
+  }
+  for (size_t i = 0; i < count; ++i) {
+    thread_pool_->Submit([&fn, i]() { fn(i); });
+  }
+  thread_pool_->Wait();
+}
+
 bool IRContext::ProcessCallTreeFromRoots(ProcessFunction& pfn,
                                          std::queue<uint32_t>* roots) {
   // Process call tree
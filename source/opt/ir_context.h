@@ -16,6 +16,7 @@
 #define SOURCE_OPT_IR_CONTEXT_H_
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -35,6 +36,7 @@
 #include "source/opt/dominator_analysis.h"
 #include "source/opt/feature_manager.h"
 #include "source/opt/fold.h"
+#include "source/opt/ir_allocator.h"
 #include "source/opt/loop_descriptor.h"
 #include "source/opt/module.h"
 #include "source/opt/register_pressure.h"
@@ -43,6 +45,7 @@
 #include "source/opt/type_manager.h"
 #include "source/opt/value_number_table.h"
 #include "source/util/make_unique.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 namespace opt {
@@ -92,9 +95,9 @@ class IRContext {
 
   // Creates an |IRContext| that contains an owned |Module|
   IRContext(spv_target_env env, MessageConsumer c)
-      : syntax_context_(spvContextCreate(env)),
-        grammar_(syntax_context_),
+      : grammar_(GetSharedContext(env)),
         unique_id_(0),
+        allocator_(new IRAllocator()),
         module_(new Module()),
         consumer_(std::move(c)),
         def_use_mgr_(nullptr),
@@ -104,15 +107,15 @@ class IRContext {
         id_to_name_(nullptr),
         max_id_bound_(kDefaultMaxIdBound),
         preserve_bindings_(false),
-        preserve_spec_constants_(false) {
-    SetContextMessageConsumer(syntax_context_, consumer_);
+        preserve_spec_constants_(false),
+        num_threads_(1) {
     module_->SetContext(this);
   }
 
   IRContext(spv_target_env env, std::unique_ptr<Module>&& m, MessageConsumer c)
-      : syntax_context_(spvContextCreate(env)),
-        grammar_(syntax_context_),
+      : grammar_(GetSharedContext(env)),
         unique_id_(0),
+        allocator_(new IRAllocator()),
         module_(std::move(m)),
         consumer_(std::move(c)),
         def_use_mgr_(nullptr),
@@ -121,16 +124,27 @@ class IRContext {
         id_to_name_(nullptr),
         max_id_bound_(kDefaultMaxIdBound),
         preserve_bindings_(false),
-        preserve_spec_constants_(false) {
-    SetContextMessageConsumer(syntax_context_, consumer_);
+        preserve_spec_constants_(false),
+        num_threads_(1) {
     module_->SetContext(this);
     InitializeCombinators();
   }
 
-  ~IRContext() { spvContextDestroy(syntax_context_); }
-
   Module* module() const { return module_.get(); }
 
+  // Returns a new context holding a copy of the module of this context, with
+  // the same target environment, message consumer and options.  No analyses
+  // are valid in the copy.  This is much cheaper than writing the module to a
+  // binary and building a new context from it, so it is the way to keep a
+  // snapshot of the module before a speculative change: to roll the change
+  // back, continue with the copy.
+  std::unique_ptr<IRContext> Clone() const;
+
+  // Returns the allocator for the instructions and basic blocks of this
+  // context.  It is made current while a pass runs on the context and while
+  // a module is loaded into it.
+  IRAllocator* allocator() const { return allocator_.get(); }
+
   // Returns a vector of pointers to constant-creation instructions in this
   // context.
   inline std::vector<Instruction*> GetConstants();
@@ -377,6 +391,22 @@ class IRContext {
   // Invalidates all of the analyses except for those in |preserved_analyses|.
   void InvalidateAnalysesExceptFor(Analysis preserved_analyses);
 
+  // Invalidates all of the analyses except for those in |preserved_analyses|
+  // after a change in which only the functions in |modified_functions| had
+  // their control flow changed, added or removed.  The dominator,
+  // post-dominator and loop analyses are only invalidated for those
+  // functions.  If the CFG is invalidated it is rebuilt in place, so the
+  // dominator trees of the other functions stay valid.
+  void InvalidateAnalysesExceptFor(
+      Analysis preserved_analyses,
+      const std::unordered_set<const Function*>& modified_functions);
+
+  // Invalidates the analyses in |analyses_to_invalidate| that are kept per
+  // function, i.e. the dominator, post-dominator and loop analyses, for |f|
+  // only.
+  void InvalidateFunctionAnalyses(const Function* f,
+                                  Analysis analyses_to_invalidate);
+
   // Invalidates the analyses marked in |analyses_to_invalidate|.
   void InvalidateAnalyses(Analysis analyses_to_invalidate);
 
@@ -469,12 +499,16 @@ class IRContext {
     const uint32_t kExtInstSetIdInIndx = 0;
     const uint32_t kExtInstInstructionInIndx = 1;
 
+    // Use find() so that the map is not modified: this is called while
+    // analyzing functions in parallel.
     if (inst->opcode() != SpvOpExtInst) {
-      return combinator_ops_[0].count(inst->opcode()) != 0;
+      auto ops = combinator_ops_.find(0);
+      return ops != combinator_ops_.end() && ops->second.count(inst->opcode());
     } else {
       uint32_t set = inst->GetSingleWordInOperand(kExtInstSetIdInIndx);
       uint32_t op = inst->GetSingleWordInOperand(kExtInstInstructionInIndx);
-      return combinator_ops_[set].count(op) != 0;
+      auto ops = combinator_ops_.find(set);
+      return ops != combinator_ops_.end() && ops->second.count(op) != 0;
     }
   }
 
@@ -554,6 +588,15 @@ class IRContext {
     preserve_spec_constants_ = should_preserve_spec_constants;
   }
 
+  // The number of threads ForEachInParallel() may use.  1, the default, runs
+  // everything on the calling thread, and 0 uses one thread per hardware
+  // thread.
+  uint32_t num_threads() const { return num_threads_; }
+  void set_num_threads(uint32_t num_threads) {
+    if (num_threads != num_threads_) thread_pool_.reset();
+    num_threads_ = num_threads;
+  }
+
   // Return id of input variable only decorated with |builtin|, if in module.
   // Create variable and return its id otherwise. If builtin not currently
   // supported, return 0.
@@ -589,6 +632,16 @@ class IRContext {
   // true.  By convention |pfn| should return true if it modified the module.
   bool ProcessReachableCallTree(ProcessFunction& pfn);
 
+  // Calls |fn| with every index in [0, |count|).  When num_threads() is not 1,
+  // the calls may run at the same time on different threads.  The analyses in
+  // |required| and the feature manager are built before the first call.  |fn|
+  // must not modify the module, the context, or any analysis, and must only
+  // use the analyses in |required|.  Each call should write its results to a
+  // location of its own, so that the results do not depend on the number of
+  // threads.
+  void ForEachInParallel(size_t count, Analysis required,
+                         const std::function<void(size_t)>& fn);
+
   // Applies |pfn| to every function in the call trees rooted at the elements of
   // |roots|.  Returns true if any call to |pfn| returns true.  By convention
   // |pfn| should return true if it modified the module.  After returning
@@ -635,7 +688,14 @@ class IRContext {
   }
 
   void BuildCFG() {
-    cfg_ = MakeUnique<CFG>(module());
+    if (cfg_) {
+      // The CFG was invalidated by a change to some functions only.  The
+      // dominator trees of the other functions refer to its pseudo entry and
+      // exit blocks, so it is rebuilt in place.
+      cfg_->Rebuild();
+    } else {
+      cfg_ = MakeUnique<CFG>(module());
+    }
     valid_analyses_ = valid_analyses_ | kAnalysisCFG;
   }
 
@@ -738,10 +798,6 @@ class IRContext {
   // Add |var_id| to all entry points in module.
   void AddVarToEntryPoints(uint32_t var_id);
 
-  // The SPIR-V syntax context containing grammar tables for opcodes and
-  // operands.
-  spv_context syntax_context_;
-
   // Auxiliary object for querying SPIR-V grammar facts.
   AssemblyGrammar grammar_;
 
@@ -752,6 +808,10 @@ class IRContext {
   // Therefore, 0 is not a valid unique id for an instruction.
   uint32_t unique_id_;
 
+  // The storage for the instructions and basic blocks created for this
+  // context.  It is released after |module_| is destroyed.
+  std::unique_ptr<IRAllocator, IRAllocator::Releaser> allocator_;
+
   // The module being processed within this IR context.
   std::unique_ptr<Module> module_;
 
@@ -795,8 +855,9 @@ class IRContext {
 
   // Each function in the module will create its own dominator tree. We cache
   // the result so it doesn't need to be rebuilt each time.
-  std::map<const Function*, DominatorAnalysis> dominator_trees_;
-  std::map<const Function*, PostDominatorAnalysis> post_dominator_trees_;
+  std::unordered_map<const Function*, DominatorAnalysis> dominator_trees_;
+  std::unordered_map<const Function*, PostDominatorAnalysis>
+      post_dominator_trees_;
 
   // Cache of loop descriptors for each function.
   std::unordered_map<const Function*, LoopDescriptor> loop_descriptors_;
@@ -834,6 +895,12 @@ class IRContext {
   // Whether all specialization constants within |module_|
   // should be preserved.
   bool preserve_spec_constants_;
+
+  // The number of threads used by ForEachInParallel().
+  uint32_t num_threads_;
+
+  // The workers used by ForEachInParallel().  Created on first use.
+  std::unique_ptr<utils::ThreadPool> thread_pool_;
 };
 
 inline IRContext::Analysis operator|(IRContext::Analysis lhs,
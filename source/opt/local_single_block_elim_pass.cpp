@@ -25,29 +25,35 @@ namespace opt {
 namespace {
 
 const uint32_t kStoreValIdInIdx = 1;
+const uint32_t kTypePointerStorageClassInIdx = 0;
+const uint32_t kTypePointerTypeIdInIdx = 1;
 
 }  // anonymous namespace
 
-bool LocalSingleBlockLoadStoreElimPass::HasOnlySupportedRefs(uint32_t ptrId) {
-  if (supported_ref_ptrs_.find(ptrId) != supported_ref_ptrs_.end()) return true;
-  if (get_def_use_mgr()->WhileEachUser(ptrId, [this](Instruction* user) {
-        auto dbg_op = user->GetOpenCL100DebugOpcode();
-        if (dbg_op == OpenCLDebugInfo100DebugDeclare ||
-            dbg_op == OpenCLDebugInfo100DebugValue) {
-          return true;
-        }
-        SpvOp op = user->opcode();
-        if (IsNonPtrAccessChain(op) || op == SpvOpCopyObject) {
-          if (!HasOnlySupportedRefs(user->result_id())) {
-            return false;
-          }
-        } else if (op != SpvOpStore && op != SpvOpLoad && op != SpvOpName &&
-                   !IsNonTypeDecorate(op)) {
-          return false;
-        }
-        return true;
-      })) {
-    supported_ref_ptrs_.insert(ptrId);
+bool LocalSingleBlockLoadStoreElimPass::HasOnlySupportedRefs(
+    uint32_t ptrId, std::unordered_set<uint32_t>* supported_ref_ptrs) {
+  if (supported_ref_ptrs->find(ptrId) != supported_ref_ptrs->end())
+    return true;
+  if (get_def_use_mgr()->WhileEachUser(
+          ptrId, [this, supported_ref_ptrs](Instruction* user) {
+            auto dbg_op = user->GetOpenCL100DebugOpcode();
+            if (dbg_op == OpenCLDebugInfo100DebugDeclare ||
+                dbg_op == OpenCLDebugInfo100DebugValue) {
+              return true;
+            }
+            SpvOp op = user->opcode();
+            if (IsNonPtrAccessChain(op) || op == SpvOpCopyObject) {
+              if (!HasOnlySupportedRefs(user->result_id(),
+                                        supported_ref_ptrs)) {
+                return false;
+              }
+            } else if (op != SpvOpStore && op != SpvOpLoad &&
+                       op != SpvOpName && !IsNonTypeDecorate(op)) {
+              return false;
+            }
+            return true;
+          })) {
+    supported_ref_ptrs->insert(ptrId);
     return true;
   }
   return false;
@@ -55,14 +61,45 @@ bool LocalSingleBlockLoadStoreElimPass::HasOnlySupportedRefs(uint32_t ptrId) {
 
 bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
     Function* func) {
+  Eliminations eliminations;
+  FindEliminations(func, true, &eliminations);
+  return ApplyEliminations(eliminations, true);
+}
+
+void LocalSingleBlockLoadStoreElimPass::FindEliminations(
+    Function* func, bool replace_loads, Eliminations* eliminations) {
+  // Variables that are only referenced by supported operations for this
+  // pass ie. loads and stores.
+  std::unordered_set<uint32_t> supported_ref_ptrs;
+
+  // Map from function scope variable to a store of that variable in the
+  // current block whose value is currently valid. This map is cleared
+  // at the start of each block and incrementally updated as the block
+  // is scanned. The stores are candidates for elimination. The map is
+  // conservatively cleared when a function call is encountered.
+  std::unordered_map<uint32_t, Instruction*> var2store;
+
+  // Map from function scope variable to a load of that variable in the
+  // current block whose value is currently valid. This map is cleared
+  // at the start of each block and incrementally updated as the block
+  // is scanned. The stores are candidates for elimination. The map is
+  // conservatively cleared when a function call is encountered.
+  std::unordered_map<uint32_t, Instruction*> var2load;
+
+  // Returns the value stored by |store|, as it is once the loads found so
+  // far are replaced.
+  auto stored_value = [eliminations](const Instruction* store) {
+    uint32_t val_id = store->GetSingleWordInOperand(kStoreValIdInIdx);
+    auto ri = eliminations->replacements.find(val_id);
+    return ri != eliminations->replacements.end() ? ri->second : val_id;
+  };
+
   // Perform local store/load, load/load and store/store elimination
   // on each block
-  bool modified = false;
-  std::vector<Instruction*> instructions_to_kill;
   std::unordered_set<Instruction*> instructions_to_save;
   for (auto bi = func->begin(); bi != func->end(); ++bi) {
-    var2store_.clear();
-    var2load_.clear();
+    var2store.clear();
+    var2load.clear();
     auto next = bi->begin();
     for (auto ii = next; ii != bi->end(); ii = next) {
       ++next;
@@ -71,8 +108,8 @@ bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
           // Verify store variable is target type
           uint32_t varId;
           Instruction* ptrInst = GetPtr(&*ii, &varId);
-          if (!IsTargetVar(varId)) continue;
-          if (!HasOnlySupportedRefs(varId)) continue;
+          if (seen_target_vars_.count(varId) == 0) continue;
+          if (!HasOnlySupportedRefs(varId, &supported_ref_ptrs)) continue;
           // If a store to the whole variable, remember it for succeeding
           // loads and stores. Otherwise forget any previous store to that
           // variable.
@@ -80,20 +117,18 @@ bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
             // If a previous store to same variable, mark the store
             // for deletion if not still used. Don't delete store
             // if debugging; let ssa-rewrite and DCE handle it
-            auto prev_store = var2store_.find(varId);
-            if (prev_store != var2store_.end() &&
+            auto prev_store = var2store.find(varId);
+            if (prev_store != var2store.end() &&
                 instructions_to_save.count(prev_store->second) == 0 &&
                 !context()->get_debug_info_mgr()->IsVariableDebugDeclared(
                     varId)) {
-              instructions_to_kill.push_back(prev_store->second);
-              modified = true;
+              eliminations->instructions_to_kill.push_back(prev_store->second);
             }
 
             bool kill_store = false;
-            auto li = var2load_.find(varId);
-            if (li != var2load_.end()) {
-              if (ii->GetSingleWordInOperand(kStoreValIdInIdx) ==
-                  li->second->result_id()) {
+            auto li = var2load.find(varId);
+            if (li != var2load.end()) {
+              if (stored_value(&*ii) == li->second->result_id()) {
                 // We are storing the same value that already exists in the
                 // memory location.  The store does nothing.
                 kill_store = true;
@@ -101,71 +136,114 @@ bool LocalSingleBlockLoadStoreElimPass::LocalSingleBlockLoadStoreElim(
             }
 
             if (!kill_store) {
-              var2store_[varId] = &*ii;
-              var2load_.erase(varId);
+              var2store[varId] = &*ii;
+              var2load.erase(varId);
             } else {
-              instructions_to_kill.push_back(&*ii);
-              modified = true;
+              eliminations->instructions_to_kill.push_back(&*ii);
             }
           } else {
             assert(IsNonPtrAccessChain(ptrInst->opcode()));
-            var2store_.erase(varId);
-            var2load_.erase(varId);
+            var2store.erase(varId);
+            var2load.erase(varId);
           }
         } break;
         case SpvOpLoad: {
           // Verify store variable is target type
           uint32_t varId;
           Instruction* ptrInst = GetPtr(&*ii, &varId);
-          if (!IsTargetVar(varId)) continue;
-          if (!HasOnlySupportedRefs(varId)) continue;
+          if (seen_target_vars_.count(varId) == 0) continue;
+          if (!HasOnlySupportedRefs(varId, &supported_ref_ptrs)) continue;
           uint32_t replId = 0;
           if (ptrInst->opcode() == SpvOpVariable) {
             // If a load from a variable, look for a previous store or
             // load from that variable and use its value.
-            auto si = var2store_.find(varId);
-            if (si != var2store_.end()) {
-              replId = si->second->GetSingleWordInOperand(kStoreValIdInIdx);
+            auto si = var2store.find(varId);
+            if (si != var2store.end()) {
+              replId = stored_value(si->second);
             } else {
-              auto li = var2load_.find(varId);
-              if (li != var2load_.end()) {
+              auto li = var2load.find(varId);
+              if (li != var2load.end()) {
                 replId = li->second->result_id();
               }
             }
           } else {
             // If a partial load of a previously seen store, remember
             // not to delete the store.
-            auto si = var2store_.find(varId);
-            if (si != var2store_.end()) instructions_to_save.insert(si->second);
+            auto si = var2store.find(varId);
+            if (si != var2store.end()) instructions_to_save.insert(si->second);
           }
           if (replId != 0) {
             // replace load's result id and delete load
-            context()->KillNamesAndDecorates(&*ii);
-            context()->ReplaceAllUsesWith(ii->result_id(), replId);
-            instructions_to_kill.push_back(&*ii);
-            modified = true;
+            if (replace_loads) {
+              context()->KillNamesAndDecorates(&*ii);
+              context()->ReplaceAllUsesWith(ii->result_id(), replId);
+            }
+            eliminations->replaced_loads.emplace_back(&*ii, replId);
+            eliminations->replacements[ii->result_id()] = replId;
+            eliminations->instructions_to_kill.push_back(&*ii);
           } else {
             if (ptrInst->opcode() == SpvOpVariable)
-              var2load_[varId] = &*ii;  // register load
+              var2load[varId] = &*ii;  // register load
           }
         } break;
         case SpvOpFunctionCall: {
           // Conservatively assume all locals are redefined for now.
           // TODO(): Handle more optimally
-          var2store_.clear();
-          var2load_.clear();
+          var2store.clear();
+          var2load.clear();
         } break;
         default:
           break;
       }
     }
   }
+}
+
+bool LocalSingleBlockLoadStoreElimPass::ApplyEliminations(
+    const Eliminations& eliminations, bool replace_loads) {
+  if (!replace_loads) {
+    for (const auto& load_and_repl : eliminations.replaced_loads) {
+      context()->KillNamesAndDecorates(load_and_repl.first);
+      context()->ReplaceAllUsesWith(load_and_repl.first->result_id(),
+                                    load_and_repl.second);
+    }
+  }
 
-  for (Instruction* inst : instructions_to_kill) {
+  for (Instruction* inst : eliminations.instructions_to_kill) {
     context()->KillInst(inst);
   }
 
-  return modified;
+  return !eliminations.instructions_to_kill.empty();
+}
+
+bool LocalSingleBlockLoadStoreElimPass::MayStorePointers() {
+  for (auto& inst : get_module()->types_values()) {
+    if (inst.opcode() == SpvOpTypePointer &&
+        inst.GetSingleWordInOperand(kTypePointerStorageClassInIdx) ==
+            SpvStorageClassFunction &&
+        ContainsPointer(
+            inst.GetSingleWordInOperand(kTypePointerTypeIdInIdx))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LocalSingleBlockLoadStoreElimPass::ContainsPointer(uint32_t type_id) {
+  const Instruction* type_inst = get_def_use_mgr()->GetDef(type_id);
+  switch (type_inst->opcode()) {
+    case SpvOpTypePointer:
+      return true;
+    case SpvOpTypeArray:
+    case SpvOpTypeRuntimeArray:
+      return ContainsPointer(type_inst->GetSingleWordInOperand(0));
+    case SpvOpTypeStruct:
+      return !type_inst->WhileEachInId([this](const uint32_t* member_id) {
+        return !ContainsPointer(*member_id);
+      });
+    default:
+      return false;
+  }
 }
 
 void LocalSingleBlockLoadStoreElimPass::Initialize() {
@@ -173,9 +251,6 @@ void LocalSingleBlockLoadStoreElimPass::Initialize() {
   seen_target_vars_.clear();
   seen_non_target_vars_.clear();
 
-  // Clear collections
-  supported_ref_ptrs_.clear();
-
   // Initialize extensions allowlist
   InitExtensions();
 }
@@ -204,12 +279,51 @@ Pass::Status LocalSingleBlockLoadStoreElimPass::ProcessImpl() {
   // If any extensions in the module are not explicitly supported,
   // return unmodified.
   if (!AllExtensionsSupported()) return Status::SuccessWithoutChange;
-  // Process all entry point functions
-  ProcessFunction pfn = [this](Function* fp) {
-    return LocalSingleBlockLoadStoreElim(fp);
+
+  // Fill the target variable caches, so that the functions only read them.
+  for (auto& inst : get_module()->types_values()) {
+    if (inst.opcode() == SpvOpVariable) IsTargetVar(inst.result_id());
+  }
+  for (auto& func : *get_module()) {
+    if (func.begin() == func.end()) continue;
+    for (auto& inst : *func.begin()) {
+      if (inst.opcode() == SpvOpVariable) IsTargetVar(inst.result_id());
+    }
+  }
+
+  if (context()->num_threads() == 1 || MayStorePointers()) {
+    // Process all entry point functions
+    ProcessFunction pfn = [this](Function* fp) {
+      return LocalSingleBlockLoadStoreElim(fp);
+    };
+
+    bool modified = context()->ProcessEntryPointCallTree(pfn);
+    return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
+  }
+
+  // The eliminations of a function only depend on its own variables, so
+  // they are found for all the functions at once, possibly in parallel.
+  // They are then applied one function at a time, in the same order as
+  // above, so the result does not depend on the number of threads.
+  std::vector<Function*> functions;
+  ProcessFunction collect = [&functions](Function* fp) {
+    functions.push_back(fp);
+    return false;
   };
+  context()->ProcessEntryPointCallTree(collect);
+
+  std::vector<Eliminations> eliminations(functions.size());
+  context()->ForEachInParallel(
+      functions.size(),
+      IRContext::kAnalysisDefUse | IRContext::kAnalysisDebugInfo,
+      [this, &functions, &eliminations](size_t i) {
+        FindEliminations(functions[i], false, &eliminations[i]);
+      });
 
-  bool modified = context()->ProcessEntryPointCallTree(pfn);
+  bool modified = false;
+  for (const auto& function_eliminations : eliminations) {
+    modified |= ApplyEliminations(function_eliminations, false);
+  }
   return modified ? Status::SuccessWithChange : Status::SuccessWithoutChange;
 }
 
@@ -24,6 +24,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "source/opt/basic_block.h"
 #include "source/opt/def_use_manager.h"
@@ -48,12 +49,27 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
   }
 
  private:
+  // The changes that LocalSingleBlockLoadStoreElim makes to a function.
+  struct Eliminations {
+    // The loads that are replaced, with the ids that replace them, in the
+    // order they are found.
+    std::vector<std::pair<Instruction*, uint32_t>> replaced_loads;
+
+    // Map from the result id of each replaced load to the id that replaces
+    // it.
+    std::unordered_map<uint32_t, uint32_t> replacements;
+
+    // The loads and stores to delete.
+    std::vector<Instruction*> instructions_to_kill;
+  };
+
   // Return true if all uses of |varId| are only through supported reference
-  // operations ie. loads and store. Also cache in supported_ref_ptrs_.
+  // operations ie. loads and store. Also cache in |supported_ref_ptrs|.
   // TODO(dnovillo): This function is replicated in other passes and it's
   // slightly different in every pass. Is it possible to make one common
   // implementation?
-  bool HasOnlySupportedRefs(uint32_t varId);
+  bool HasOnlySupportedRefs(uint32_t varId,
+                            std::unordered_set<uint32_t>* supported_ref_ptrs);
 
   // On all entry point functions, within each basic block, eliminate
   // loads and stores to function variables where possible. For
@@ -63,6 +79,30 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
   // where possible. Assumes logical addressing.
   bool LocalSingleBlockLoadStoreElim(Function* func);
 
+  // Finds the loads and stores of |func| that LocalSingleBlockLoadStoreElim
+  // eliminates, and records them in |eliminations|.  If |replace_loads| is
+  // true, the uses of each replaced load are replaced as soon as it is found.
+  // Otherwise the module is not modified, so functions can be searched at
+  // the same time.  The target variable caches must be filled before.
+  void FindEliminations(Function* func, bool replace_loads,
+                        Eliminations* eliminations);
+
+  // Deletes the instructions to kill in |eliminations|, after replacing the
+  // loads that were not replaced by FindEliminations.  Returns true if the
+  // module is modified.
+  bool ApplyEliminations(const Eliminations& eliminations,
+                         bool replace_loads);
+
+  // Returns true if a function scope variable may hold a pointer.  A load
+  // of such a variable may be replaced by another pointer, which changes
+  // the variables that the later loads and stores use, so the loads must
+  // be replaced as they are found.
+  bool MayStorePointers();
+
+  // Returns true if |type_id| is a pointer type, or an array or structure
+  // that contains one.
+  bool ContainsPointer(uint32_t type_id);
+
   // Initialize extensions allowlist
   void InitExtensions();
 
@@ -72,20 +112,6 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
   void Initialize();
   Pass::Status ProcessImpl();
 
-  // Map from function scope variable to a store of that variable in the
-  // current block whose value is currently valid. This map is cleared
-  // at the start of each block and incrementally updated as the block
-  // is scanned. The stores are candidates for elimination. The map is
-  // conservatively cleared when a function call is encountered.
-  std::unordered_map<uint32_t, Instruction*> var2store_;
-
-  // Map from function scope variable to a load of that variable in the
-  // current block whose value is currently valid. This map is cleared
-  // at the start of each block and incrementally updated as the block
-  // is scanned. The stores are candidates for elimination. The map is
-  // conservatively cleared when a function call is encountered.
-  std::unordered_map<uint32_t, Instruction*> var2load_;
-
   // Set of variables whose most recent store in the current block cannot be
   // deleted, for example, if there is a load of the variable which is
   // dependent on the store and is not replaced and deleted by this pass,
@@ -95,10 +121,6 @@ class LocalSingleBlockLoadStoreElimPass : public MemPass {
 
   // Extensions supported by this pass.
   std::unordered_set<std::string> extensions_allowlist_;
-
-  // Variables that are only referenced by supported operations for this
-  // pass ie. loads and stores.
-  std::unordered_set<uint32_t> supported_ref_ptrs_;
 };
 
 }  // namespace opt
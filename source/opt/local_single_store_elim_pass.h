@@ -50,6 +50,8 @@ class LocalSingleStoreElimPass : public Pass {
            IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
   }
 
+  bool TracksModifiedFunctions() const override { return true; }
+
  private:
   // Do "single-store" optimization of function variables defined only
   // with a single non-access-chain store in |func|. Replace all their
@@ -21,6 +21,7 @@
 #include "source/operand.h"
 #include "source/opt/ir_context.h"
 #include "source/opt/reflect.h"
+#include "source/util/make_unique.h"
 
 namespace spvtools {
 namespace opt {
@@ -37,6 +38,45 @@ uint32_t Module::TakeNextIdBound() {
   return header_.bound++;
 }
 
+std::unique_ptr<Module> Module::Clone(IRContext* context) const {
+  auto clone = MakeUnique<Module>();
+  clone->header_ = header_;
+
+  auto clone_list = [context](const InstructionList& from,
+                              InstructionList* to) {
+    for (const auto& inst : from) {
+      to->push_back(std::unique_ptr<Instruction>(inst.Clone(context)));
+    }
+  };
+  clone_list(capabilities_, &clone->capabilities_);
+  clone_list(extensions_, &clone->extensions_);
+  clone_list(ext_inst_imports_, &clone->ext_inst_imports_);
+  if (memory_model_) {
+    clone->memory_model_.reset(memory_model_->Clone(context));
+  }
+  clone_list(entry_points_, &clone->entry_points_);
+  clone_list(execution_modes_, &clone->execution_modes_);
+  clone_list(debugs1_, &clone->debugs1_);
+  clone_list(debugs2_, &clone->debugs2_);
+  clone_list(debugs3_, &clone->debugs3_);
+  clone_list(ext_inst_debuginfo_, &clone->ext_inst_debuginfo_);
+  clone_list(annotations_, &clone->annotations_);
+  clone_list(types_values_, &clone->types_values_);
+
+  clone->functions_.reserve(functions_.size());
+  for (const auto& function : functions_) {
+    clone->AddFunction(std::unique_ptr<Function>(function->Clone(context)));
+  }
+
+  clone->trailing_dbg_line_info_.reserve(trailing_dbg_line_info_.size());
+  for (const auto& inst : trailing_dbg_line_info_) {
+    std::unique_ptr<Instruction> inst_clone(inst.Clone(context));
+    clone->trailing_dbg_line_info_.push_back(*inst_clone);
+  }
+  clone->contains_debug_info_ = contains_debug_info_;
+  return clone;
+}
+
 std::vector<Instruction*> Module::GetTypes() {
   std::vector<Instruction*> type_insts;
   for (auto& inst : types_values_) {
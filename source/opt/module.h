@@ -51,6 +51,10 @@ class Module {
   // Creates an empty module with zero'd header.
   Module() : header_({}), contains_debug_info_(false) {}
 
+  // Returns a copy of this module whose instructions belong to |context|.
+  // The copy is not associated with |context| until SetContext is called.
+  std::unique_ptr<Module> Clone(IRContext* context) const;
+
   // Sets the header to the given |header|.
   void SetHeader(const ModuleHeader& header) { header_ = header; }
 
@@ -14,6 +14,7 @@
 
 #include "spirv-tools/optimizer.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <string>
@@ -27,17 +28,38 @@
 #include "source/opt/pass_manager.h"
 #include "source/opt/passes.h"
 #include "source/spirv_optimizer_options.h"
+#include "source/table.h"
 #include "source/util/make_unique.h"
 #include "source/util/string_utils.h"
+#include "source/util/thread_pool.h"
 
 namespace spvtools {
 
 struct Optimizer::PassToken::Impl {
   Impl(std::unique_ptr<opt::Pass> p) : pass(std::move(p)) {}
+  Impl(std::unique_ptr<opt::Pass> p, opt::PassManager::PassFactory f)
+      : pass(std::move(p)), factory(std::move(f)) {}
 
   std::unique_ptr<opt::Pass> pass;  // Internal implementation pass.
+  // Creates new instances of |pass|.  Empty for out-of-tree passes.
+  opt::PassManager::PassFactory factory;
 };
 
+namespace {
+
+// Returns a token for a new pass of type |T| constructed with |args|.  The
+// token remembers |args| so that the optimizer can create a fresh instance of
+// the pass every time it runs.
+template <typename T, typename... Args>
+Optimizer::PassToken MakePassToken(Args... args) {
+  return MakeUnique<Optimizer::PassToken::Impl>(
+      MakeUnique<T>(args...), [args...]() -> std::unique_ptr<opt::Pass> {
+        return MakeUnique<T>(args...);
+      });
+}
+
+}  // namespace
+
 Optimizer::PassToken::PassToken(
     std::unique_ptr<Optimizer::PassToken::Impl> impl)
     : impl_(std::move(impl)) {}
@@ -56,12 +78,110 @@ Optimizer::PassToken& Optimizer::PassToken::operator=(PassToken&& that) {
 Optimizer::PassToken::~PassToken() {}
 
 struct Optimizer::Impl {
-  explicit Impl(spv_target_env env) : target_env(env), pass_manager() {}
-
-  spv_target_env target_env;      // Target environment.
-  opt::PassManager pass_manager;  // Internal implementation pass manager.
+  explicit Impl(spv_target_env env)
+      : target_env(env), pass_manager(), validation_cache(nullptr) {}
+
+  // Optimizes |original_binary| as described for Optimizer::Run(), running
+  // the passes of |pass_manager|.  The binary is decoded with the grammar
+  // tables of |grammar|, and messages are sent to |consumer|.
+  bool Optimize(spv_const_context grammar, const MessageConsumer& consumer,
+                opt::PassManager* pass_manager, const uint32_t* original_binary,
+                size_t original_binary_size,
+                std::vector<uint32_t>* optimized_binary,
+                const spv_optimizer_options opt_options) const;
+
+  spv_target_env target_env;          // Target environment.
+  opt::PassManager pass_manager;      // Internal implementation pass manager.
+  ValidationCache* validation_cache;  // Results of validating the input.
 };
 
+bool Optimizer::Impl::Optimize(spv_const_context grammar,
+                               const MessageConsumer& consumer,
+                               opt::PassManager* pass_manager,
+                               const uint32_t* original_binary,
+                               const size_t original_binary_size,
+                               std::vector<uint32_t>* optimized_binary,
+                               const spv_optimizer_options opt_options) const {
+  if (opt_options->run_validator_) {
+    ValidationCache::Result result;
+    if (!validation_cache ||
+        !validation_cache->Lookup(target_env, original_binary,
+                                  original_binary_size,
+                                  &opt_options->val_options_, &result)) {
+      spv_context_t hijack_context = *grammar;
+      SetContextMessageConsumer(&hijack_context, consumer);
+      spv_const_binary_t binary{original_binary, original_binary_size};
+      spv_diagnostic diagnostic = nullptr;
+      result.status = spvValidateWithOptions(
+          &hijack_context, &opt_options->val_options_, &binary, &diagnostic);
+      result.position = {0, 0, 0};
+      if (diagnostic) {
+        result.position = diagnostic->position;
+        result.message = diagnostic->error;
+      }
+      spvDiagnosticDestroy(diagnostic);
+      if (validation_cache) {
+        validation_cache->Insert(target_env, original_binary,
+                                 original_binary_size,
+                                 &opt_options->val_options_, result);
+      }
+    }
+    if (result.status != SPV_SUCCESS) {
+      if (consumer) {
+        consumer(SPV_MSG_ERROR, nullptr, result.position,
+                 result.message.c_str());
+      }
+      return false;
+    }
+  }
+
+  std::unique_ptr<opt::IRContext> context = BuildModule(
+      grammar, consumer, original_binary, original_binary_size, true);
+  if (context == nullptr) return false;
+
+  context->set_max_id_bound(opt_options->max_id_bound_);
+  context->set_preserve_bindings(opt_options->preserve_bindings_);
+  context->set_preserve_spec_constants(opt_options->preserve_spec_constants_);
+  context->set_num_threads(opt_options->num_threads_);
+
+  pass_manager->SetValidatorOptions(&opt_options->val_options_);
+  pass_manager->SetTargetEnv(target_env);
+  auto status = pass_manager->Run(context.get());
+
+  if (status == opt::Pass::Status::Failure) {
+    return false;
+  }
+
+#ifndef NDEBUG
+  // We do not keep the result id of DebugScope in struct DebugScope.
+  // Instead, we assign random ids for them, which results in integrity
+  // check failures. In addition, propagating the OpLine/OpNoLine to preserve
+  // the debug information through transformations results in integrity
+  // check failures. We want to skip the integrity check when the module
+  // contains DebugScope or OpLine/OpNoLine instructions.
+  if (status == opt::Pass::Status::SuccessWithoutChange &&
+      !context->module()->ContainsDebugInfo()) {
+    std::vector<uint32_t> optimized_binary_with_nop;
+    context->module()->ToBinary(&optimized_binary_with_nop,
+                                /* skip_nop = */ false);
+    assert(optimized_binary_with_nop.size() == original_binary_size &&
+           "Binary size unexpectedly changed despite the optimizer saying "
+           "there was no change");
+    assert(memcmp(optimized_binary_with_nop.data(), original_binary,
+                  original_binary_size) == 0 &&
+           "Binary content unexpectedly changed despite the optimizer saying "
+           "there was no change");
+  }
+#endif  // !NDEBUG
+
+  // Note that |original_binary| and |optimized_binary| may share the same
+  // buffer and the below will invalidate |original_binary|.
+  optimized_binary->clear();
+  context->module()->ToBinary(optimized_binary, /* skip_nop = */ true);
+
+  return true;
+}
+
 Optimizer::Optimizer(spv_target_env env) : impl_(new Impl(env)) {
   assert(env != SPV_ENV_WEBGPU_0);
 }
@@ -83,7 +203,8 @@ const MessageConsumer& Optimizer::consumer() const {
 Optimizer& Optimizer::RegisterPass(PassToken&& p) {
   // Change to use the pass manager's consumer.
   p.impl_->pass->SetMessageConsumer(consumer());
-  impl_->pass_manager.AddPass(std::move(p.impl_->pass));
+  impl_->pass_manager.AddPass(std::move(p.impl_->pass),
+                              std::move(p.impl_->factory));
   return *this;
 }
 
@@ -531,58 +652,66 @@ bool Optimizer::Run(const uint32_t* original_binary,
                     const size_t original_binary_size,
                     std::vector<uint32_t>* optimized_binary,
                     const spv_optimizer_options opt_options) const {
-  spvtools::SpirvTools tools(impl_->target_env);
-  tools.SetMessageConsumer(impl_->pass_manager.consumer());
-  if (opt_options->run_validator_ &&
-      !tools.Validate(original_binary, original_binary_size,
-                      &opt_options->val_options_)) {
-    return false;
+  spv_const_context grammar = GetSharedContext(impl_->target_env);
+
+  // When all the passes can be instantiated again, run fresh instances of them
+  // so that this optimizer can be run any number of times, including from
+  // several threads at once.  Otherwise the registered passes are consumed.
+  std::unique_ptr<opt::PassManager> run_pass_manager;
+  opt::PassManager* pass_manager = &impl_->pass_manager;
+  if (impl_->pass_manager.IsReusable()) {
+    run_pass_manager = impl_->pass_manager.Instantiate();
+    pass_manager = run_pass_manager.get();
   }
 
-  std::unique_ptr<opt::IRContext> context = BuildModule(
-      impl_->target_env, consumer(), original_binary, original_binary_size);
-  if (context == nullptr) return false;
-
-  context->set_max_id_bound(opt_options->max_id_bound_);
-  context->set_preserve_bindings(opt_options->preserve_bindings_);
-  context->set_preserve_spec_constants(opt_options->preserve_spec_constants_);
+  return impl_->Optimize(grammar, consumer(), pass_manager, original_binary,
+                         original_binary_size, optimized_binary, opt_options);
+}
 
-  impl_->pass_manager.SetValidatorOptions(&opt_options->val_options_);
-  impl_->pass_manager.SetTargetEnv(impl_->target_env);
-  auto status = impl_->pass_manager.Run(context.get());
+std::vector<Optimizer::BatchResult> Optimizer::RunBatch(
+    const std::vector<std::vector<uint32_t>>& binaries,
+    uint32_t num_threads) const {
+  return RunBatch(binaries, num_threads, OptimizerOptions());
+}
 
-  if (status == opt::Pass::Status::Failure) {
-    return false;
+std::vector<Optimizer::BatchResult> Optimizer::RunBatch(
+    const std::vector<std::vector<uint32_t>>& binaries, uint32_t num_threads,
+    const spv_optimizer_options opt_options) const {
+  std::vector<BatchResult> results(binaries.size());
+  if (!impl_->pass_manager.IsReusable()) {
+    for (auto& result : results) {
+      result.messages.push_back(
+          {SPV_MSG_ERROR, "", {0, 0, 0},
+           "Optimizer with out-of-tree passes cannot optimize a batch"});
+    }
+    return results;
   }
 
-#ifndef NDEBUG
-  // We do not keep the result id of DebugScope in struct DebugScope.
-  // Instead, we assign random ids for them, which results in integrity
-  // check failures. In addition, propagating the OpLine/OpNoLine to preserve
-  // the debug information through transformations results in integrity
-  // check failures. We want to skip the integrity check when the module
-  // contains DebugScope or OpLine/OpNoLine instructions.
-  if (status == opt::Pass::Status::SuccessWithoutChange &&
-      !context->module()->ContainsDebugInfo()) {
-    std::vector<uint32_t> optimized_binary_with_nop;
-    context->module()->ToBinary(&optimized_binary_with_nop,
-                                /* skip_nop = */ false);
-    assert(optimized_binary_with_nop.size() == original_binary_size &&
-           "Binary size unexpectedly changed despite the optimizer saying "
-           "there was no change");
-    assert(memcmp(optimized_binary_with_nop.data(), original_binary,
-                  original_binary_size) == 0 &&
-           "Binary content unexpectedly changed despite the optimizer saying "
-           "there was no change");
+  // The shared context is immutable, so all the workers can use it.
+  spv_const_context grammar = GetSharedContext(impl_->target_env);
+  {
+    utils::ThreadPool pool(
+        std::min(num_threads == 0 ? utils::ThreadPool::DefaultNumThreads()
+                                  : num_threads,
+                 static_cast<uint32_t>(std::max<size_t>(binaries.size(), 1))));
+    for (size_t i = 0; i < binaries.size(); ++i) {
+      pool.Submit([this, grammar, &binaries, &results, i, opt_options]() {
+        BatchResult* result = &results[i];
+        MessageConsumer consumer = [result](spv_message_level_t level,
+                                            const char* source,
+                                            const spv_position_t& position,
+                                            const char* message) {
+          result->messages.push_back(
+              {level, source ? source : "", position, message});
+        };
+        const std::vector<uint32_t>& binary = binaries[i];
+        result->success = impl_->Optimize(
+            grammar, consumer, impl_->pass_manager.Instantiate(consumer).get(),
+            binary.data(), binary.size(), &result->binary, opt_options);
+      });
+    }
   }
-#endif  // !NDEBUG
-
-  // Note that |original_binary| and |optimized_binary| may share the same
-  // buffer and the below will invalidate |original_binary|.
-  optimized_binary->clear();
-  context->module()->ToBinary(optimized_binary, /* skip_nop = */ true);
-
-  return true;
+  return results;
 }
 
 Optimizer& Optimizer::SetPrintAll(std::ostream* out) {
@@ -600,148 +729,127 @@ Optimizer& Optimizer::SetValidateAfterAll(bool validate) {
   return *this;
 }
 
+Optimizer& Optimizer::SetValidationCache(ValidationCache* cache) {
+  impl_->validation_cache = cache;
+  return *this;
+}
+
 Optimizer::PassToken CreateNullPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::NullPass>());
+  return MakePassToken<opt::NullPass>();
 }
 
 Optimizer::PassToken CreateStripDebugInfoPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::StripDebugInfoPass>());
+  return MakePassToken<opt::StripDebugInfoPass>();
 }
 
 Optimizer::PassToken CreateStripReflectInfoPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::StripReflectInfoPass>());
+  return MakePassToken<opt::StripReflectInfoPass>();
 }
 
 Optimizer::PassToken CreateEliminateDeadFunctionsPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::EliminateDeadFunctionsPass>());
+  return MakePassToken<opt::EliminateDeadFunctionsPass>();
 }
 
 Optimizer::PassToken CreateEliminateDeadMembersPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::EliminateDeadMembersPass>());
+  return MakePassToken<opt::EliminateDeadMembersPass>();
 }
 
 Optimizer::PassToken CreateSetSpecConstantDefaultValuePass(
     const std::unordered_map<uint32_t, std::string>& id_value_map) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SetSpecConstantDefaultValuePass>(id_value_map));
+  return MakePassToken<opt::SetSpecConstantDefaultValuePass>(id_value_map);
 }
 
 Optimizer::PassToken CreateSetSpecConstantDefaultValuePass(
     const std::unordered_map<uint32_t, std::vector<uint32_t>>& id_value_map) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SetSpecConstantDefaultValuePass>(id_value_map));
+  return MakePassToken<opt::SetSpecConstantDefaultValuePass>(id_value_map);
 }
 
 Optimizer::PassToken CreateFlattenDecorationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FlattenDecorationPass>());
+  return MakePassToken<opt::FlattenDecorationPass>();
 }
 
 Optimizer::PassToken CreateFreezeSpecConstantValuePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FreezeSpecConstantValuePass>());
+  return MakePassToken<opt::FreezeSpecConstantValuePass>();
 }
 
 Optimizer::PassToken CreateFoldSpecConstantOpAndCompositePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FoldSpecConstantOpAndCompositePass>());
+  return MakePassToken<opt::FoldSpecConstantOpAndCompositePass>();
 }
 
 Optimizer::PassToken CreateUnifyConstantPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::UnifyConstantPass>());
+  return MakePassToken<opt::UnifyConstantPass>();
 }
 
 Optimizer::PassToken CreateEliminateDeadConstantPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::EliminateDeadConstantPass>());
+  return MakePassToken<opt::EliminateDeadConstantPass>();
 }
 
 Optimizer::PassToken CreateDeadVariableEliminationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DeadVariableElimination>());
+  return MakePassToken<opt::DeadVariableElimination>();
 }
 
 Optimizer::PassToken CreateStrengthReductionPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::StrengthReductionPass>());
+  return MakePassToken<opt::StrengthReductionPass>();
 }
 
 Optimizer::PassToken CreateBlockMergePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::BlockMergePass>());
+  return MakePassToken<opt::BlockMergePass>();
 }
 
 Optimizer::PassToken CreateInlineExhaustivePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InlineExhaustivePass>());
+  return MakePassToken<opt::InlineExhaustivePass>();
 }
 
 Optimizer::PassToken CreateInlineOpaquePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InlineOpaquePass>());
+  return MakePassToken<opt::InlineOpaquePass>();
 }
 
 Optimizer::PassToken CreateLocalAccessChainConvertPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalAccessChainConvertPass>());
+  return MakePassToken<opt::LocalAccessChainConvertPass>();
 }
 
 Optimizer::PassToken CreateLocalSingleBlockLoadStoreElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalSingleBlockLoadStoreElimPass>());
+  return MakePassToken<opt::LocalSingleBlockLoadStoreElimPass>();
 }
 
 Optimizer::PassToken CreateLocalSingleStoreElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalSingleStoreElimPass>());
+  return MakePassToken<opt::LocalSingleStoreElimPass>();
 }
 
 Optimizer::PassToken CreateInsertExtractElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SimplificationPass>());
+  return MakePassToken<opt::SimplificationPass>();
 }
 
 Optimizer::PassToken CreateDeadInsertElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DeadInsertElimPass>());
+  return MakePassToken<opt::DeadInsertElimPass>();
 }
 
 Optimizer::PassToken CreateDeadBranchElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DeadBranchElimPass>());
+  return MakePassToken<opt::DeadBranchElimPass>();
 }
 
 Optimizer::PassToken CreateLocalMultiStoreElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SSARewritePass>());
+  return MakePassToken<opt::SSARewritePass>();
 }
 
 Optimizer::PassToken CreateAggressiveDCEPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::AggressiveDCEPass>());
+  return MakePassToken<opt::AggressiveDCEPass>();
 }
 
 Optimizer::PassToken CreatePropagateLineInfoPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::EmptyPass>());
+  return MakePassToken<opt::EmptyPass>();
 }
 
 Optimizer::PassToken CreateRedundantLineInfoElimPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::EmptyPass>());
+  return MakePassToken<opt::EmptyPass>();
 }
 
 Optimizer::PassToken CreateCompactIdsPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CompactIdsPass>());
+  return MakePassToken<opt::CompactIdsPass>();
 }
 
 Optimizer::PassToken CreateMergeReturnPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::MergeReturnPass>());
+  return MakePassToken<opt::MergeReturnPass>();
 }
 
 std::vector<const char*> Optimizer::GetPassNames() const {
@@ -753,176 +861,146 @@ std::vector<const char*> Optimizer::GetPassNames() const {
 }
 
 Optimizer::PassToken CreateCFGCleanupPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CFGCleanupPass>());
+  return MakePassToken<opt::CFGCleanupPass>();
 }
 
 Optimizer::PassToken CreateLocalRedundancyEliminationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LocalRedundancyEliminationPass>());
+  return MakePassToken<opt::LocalRedundancyEliminationPass>();
 }
 
 Optimizer::PassToken CreateLoopFissionPass(size_t threshold) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopFissionPass>(threshold));
+  return MakePassToken<opt::LoopFissionPass>(threshold);
 }
 
 Optimizer::PassToken CreateLoopFusionPass(size_t max_registers_per_loop) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopFusionPass>(max_registers_per_loop));
+  return MakePassToken<opt::LoopFusionPass>(max_registers_per_loop);
 }
 
 Optimizer::PassToken CreateLoopInvariantCodeMotionPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::LICMPass>());
+  return MakePassToken<opt::LICMPass>();
 }
 
 Optimizer::PassToken CreateLoopPeelingPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopPeelingPass>());
+  return MakePassToken<opt::LoopPeelingPass>();
 }
 
 Optimizer::PassToken CreateLoopUnswitchPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopUnswitchPass>());
+  return MakePassToken<opt::LoopUnswitchPass>();
 }
 
 Optimizer::PassToken CreateRedundancyEliminationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::RedundancyEliminationPass>());
+  return MakePassToken<opt::RedundancyEliminationPass>();
 }
 
 Optimizer::PassToken CreateRemoveDuplicatesPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::RemoveDuplicatesPass>());
+  return MakePassToken<opt::RemoveDuplicatesPass>();
 }
 
 Optimizer::PassToken CreateScalarReplacementPass(uint32_t size_limit) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::ScalarReplacementPass>(size_limit));
+  return MakePassToken<opt::ScalarReplacementPass>(size_limit);
 }
 
 Optimizer::PassToken CreatePrivateToLocalPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::PrivateToLocalPass>());
+  return MakePassToken<opt::PrivateToLocalPass>();
 }
 
 Optimizer::PassToken CreateCCPPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::CCPPass>());
+  return MakePassToken<opt::CCPPass>();
 }
 
 Optimizer::PassToken CreateWorkaround1209Pass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::Workaround1209>());
+  return MakePassToken<opt::Workaround1209>();
 }
 
 Optimizer::PassToken CreateIfConversionPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::IfConversion>());
+  return MakePassToken<opt::IfConversion>();
 }
 
 Optimizer::PassToken CreateReplaceInvalidOpcodePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::ReplaceInvalidOpcodePass>());
+  return MakePassToken<opt::ReplaceInvalidOpcodePass>();
 }
 
 Optimizer::PassToken CreateSimplificationPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SimplificationPass>());
+  return MakePassToken<opt::SimplificationPass>();
 }
 
 Optimizer::PassToken CreateLoopUnrollPass(bool fully_unroll, int factor) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::LoopUnroller>(fully_unroll, factor));
+  return MakePassToken<opt::LoopUnroller>(fully_unroll, factor);
 }
 
 Optimizer::PassToken CreateSSARewritePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::SSARewritePass>());
+  return MakePassToken<opt::SSARewritePass>();
 }
 
 Optimizer::PassToken CreateCopyPropagateArraysPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CopyPropagateArrays>());
+  return MakePassToken<opt::CopyPropagateArrays>();
 }
 
 Optimizer::PassToken CreateVectorDCEPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::VectorDCE>());
+  return MakePassToken<opt::VectorDCE>();
 }
 
 Optimizer::PassToken CreateReduceLoadSizePass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::ReduceLoadSize>());
+  return MakePassToken<opt::ReduceLoadSize>();
 }
 
 Optimizer::PassToken CreateCombineAccessChainsPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CombineAccessChains>());
+  return MakePassToken<opt::CombineAccessChains>();
 }
 
 Optimizer::PassToken CreateUpgradeMemoryModelPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::UpgradeMemoryModel>());
+  return MakePassToken<opt::UpgradeMemoryModel>();
 }
 
 Optimizer::PassToken CreateInstBindlessCheckPass(
     uint32_t desc_set, uint32_t shader_id, bool desc_length_enable,
     bool desc_init_enable, bool buff_oob_enable, bool texbuff_oob_enable) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InstBindlessCheckPass>(
-          desc_set, shader_id, desc_length_enable, desc_init_enable,
-          buff_oob_enable, texbuff_oob_enable,
-          desc_length_enable || desc_init_enable || buff_oob_enable));
+  return MakePassToken<opt::InstBindlessCheckPass>(
+      desc_set, shader_id, desc_length_enable, desc_init_enable,
+      buff_oob_enable, texbuff_oob_enable,
+      desc_length_enable || desc_init_enable || buff_oob_enable);
 }
 
 Optimizer::PassToken CreateInstDebugPrintfPass(uint32_t desc_set,
                                                uint32_t shader_id) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InstDebugPrintfPass>(desc_set, shader_id));
+  return MakePassToken<opt::InstDebugPrintfPass>(desc_set, shader_id);
 }
 
 Optimizer::PassToken CreateInstBuffAddrCheckPass(uint32_t desc_set,
                                                  uint32_t shader_id) {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::InstBuffAddrCheckPass>(desc_set, shader_id));
+  return MakePassToken<opt::InstBuffAddrCheckPass>(desc_set, shader_id);
 }
 
 Optimizer::PassToken CreateConvertRelaxedToHalfPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::ConvertToHalfPass>());
+  return MakePassToken<opt::ConvertToHalfPass>();
 }
 
 Optimizer::PassToken CreateRelaxFloatOpsPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::RelaxFloatOpsPass>());
+  return MakePassToken<opt::RelaxFloatOpsPass>();
 }
 
 Optimizer::PassToken CreateCodeSinkingPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::CodeSinkingPass>());
+  return MakePassToken<opt::CodeSinkingPass>();
 }
 
 Optimizer::PassToken CreateFixStorageClassPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::FixStorageClass>());
+  return MakePassToken<opt::FixStorageClass>();
 }
 
 Optimizer::PassToken CreateGraphicsRobustAccessPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::GraphicsRobustAccessPass>());
+  return MakePassToken<opt::GraphicsRobustAccessPass>();
 }
 
 Optimizer::PassToken CreateDescriptorScalarReplacementPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::DescriptorScalarReplacement>());
+  return MakePassToken<opt::DescriptorScalarReplacement>();
 }
 
 Optimizer::PassToken CreateWrapOpKillPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(MakeUnique<opt::WrapOpKill>());
+  return MakePassToken<opt::WrapOpKill>();
 }
 
 Optimizer::PassToken CreateAmdExtToKhrPass() {
-  return MakeUnique<Optimizer::PassToken::Impl>(
-      MakeUnique<opt::AmdExtensionToKhrPass>());
+  return MakePassToken<opt::AmdExtensionToKhrPass>();
 }
 
 }  // namespace spvtools
@@ -37,11 +37,20 @@ Pass::Status Pass::Run(IRContext* ctx) {
   already_run_ = true;
 
   context_ = ctx;
-  Pass::Status status = Process();
+  Pass::Status status;
+  {
+    IRAllocator::Scope allocator_scope(ctx->allocator());
+    status = Process();
+  }
   context_ = nullptr;
 
   if (status == Status::SuccessWithChange) {
-    ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses());
+    if (TracksModifiedFunctions()) {
+      ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses(),
+                                       modified_functions_);
+    } else {
+      ctx->InvalidateAnalysesExceptFor(GetPreservedAnalyses());
+    }
   }
   assert((status == Status::Failure || ctx->IsConsistent()) &&
          "An analysis in the context is out of date.");
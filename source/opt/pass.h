@@ -106,6 +106,20 @@ class Pass {
     return IRContext::kAnalysisNone;
   }
 
+  // Returns true if the pass calls MarkFunctionModified() for every function
+  // that it changed, added or removed.  The dominator, post-dominator and loop
+  // analyses of the other functions are then kept after the pass, even if the
+  // pass does not preserve them, and the validator does not check the other
+  // functions again.
+  virtual bool TracksModifiedFunctions() const { return false; }
+
+  // Returns the functions that the pass passed to MarkFunctionModified() when
+  // it was run, or nullptr if TracksModifiedFunctions() returns false.  The
+  // removed functions no longer exist, so they may only be compared with.
+  const std::unordered_set<const Function*>* modified_functions() const {
+    return TracksModifiedFunctions() ? &modified_functions_ : nullptr;
+  }
+
   // Return type id for |ptrInst|'s pointee
   uint32_t GetPointeeTypeId(const Instruction* ptrInst) const;
 
@@ -142,6 +156,12 @@ class Pass {
   uint32_t GenerateCopy(Instruction* object_to_copy, uint32_t new_type_id,
                         Instruction* insertion_position);
 
+  // Records that the pass changed |function|, or added or removed it.  Only
+  // used if TracksModifiedFunctions() returns true.
+  void MarkFunctionModified(const Function* function) {
+    modified_functions_.insert(function);
+  }
+
  private:
   MessageConsumer consumer_;  // Message consumer.
 
@@ -152,6 +172,9 @@ class Pass {
   // enforce proper resetting of internal state for each instance.  This member
   // is used to check that we do not run the same instance twice.
   bool already_run_;
+
+  // The functions passed to MarkFunctionModified().
+  std::unordered_set<const Function*> modified_functions_;
 };
 
 inline Pass::Status CombineStatus(Pass::Status a, Pass::Status b) {
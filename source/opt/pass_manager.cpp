@@ -14,10 +14,14 @@
 
 #include "source/opt/pass_manager.h"
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "source/opt/incremental_validator.h"
 #include "source/opt/ir_context.h"
 #include "source/util/timer.h"
 #include "spirv-tools/libspirv.hpp"
@@ -26,6 +30,29 @@ namespace spvtools {
 
 namespace opt {
 
+bool PassManager::IsReusable() const {
+  return std::all_of(factories_.begin(), factories_.end(),
+                     [](const PassFactory& factory) { return bool(factory); });
+}
+
+std::unique_ptr<PassManager> PassManager::Instantiate(
+    MessageConsumer consumer) const {
+  assert(IsReusable() && "Some passes cannot be instantiated again.");
+  std::unique_ptr<PassManager> manager(new PassManager());
+  manager->consumer_ = std::move(consumer);
+  manager->print_all_stream_ = print_all_stream_;
+  manager->time_report_stream_ = time_report_stream_;
+  manager->target_env_ = target_env_;
+  manager->val_options_ = val_options_;
+  manager->validate_after_all_ = validate_after_all_;
+  for (const auto& factory : factories_) {
+    std::unique_ptr<Pass> pass = factory();
+    pass->SetMessageConsumer(manager->consumer_);
+    manager->AddPass(std::move(pass), factory);
+  }
+  return manager;
+}
+
 Pass::Status PassManager::Run(IRContext* context) {
   auto status = Pass::Status::SuccessWithoutChange;
 
@@ -43,6 +70,10 @@ Pass::Status PassManager::Run(IRContext* context) {
     }
   };
 
+  IncrementalValidator validator(target_env_, val_options_, consumer());
+  // Whether the module has been validated after a pass already.
+  bool validated = false;
+
   SPIRV_TIMER_DESCRIPTION(time_report_stream_, /* measure_mem_usage = */ true);
   for (auto& pass : passes_) {
     print_disassembly("; IR before pass ", pass.get());
@@ -51,12 +82,12 @@ Pass::Status PassManager::Run(IRContext* context) {
     if (one_status == Pass::Status::Failure) return one_status;
     if (one_status == Pass::Status::SuccessWithChange) status = one_status;
 
-    if (validate_after_all_) {
-      spvtools::SpirvTools tools(target_env_);
-      tools.SetMessageConsumer(consumer());
-      std::vector<uint32_t> binary;
-      context->module()->ToBinary(&binary, true);
-      if (!tools.Validate(binary.data(), binary.size(), val_options_)) {
+    if (validate_after_all_ &&
+        (one_status == Pass::Status::SuccessWithChange || !validated)) {
+      // Only the functions that the pass reports as modified are checked
+      // again, if it reports them.
+      validated = validator.Validate(context, pass->modified_functions());
+      if (!validated) {
         std::string msg = "Validation failed after pass ";
         msg += pass->name();
         spv_position_t null_pos{0, 0, 0};
@@ -78,6 +109,7 @@ Pass::Status PassManager::Run(IRContext* context) {
     context->module()->SetIdBound(context->module()->ComputeIdBound());
   }
   passes_.clear();
+  factories_.clear();
   return status;
 }
 
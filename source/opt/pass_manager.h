@@ -15,6 +15,7 @@
 #ifndef SOURCE_OPT_PASS_MANAGER_H_
 #define SOURCE_OPT_PASS_MANAGER_H_
 
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <utility>
@@ -35,6 +36,9 @@ namespace opt {
 // to run on a module. Passes are executed in the exact order of addition.
 class PassManager {
  public:
+  // A function that returns a new instance of a pass, in its initial state.
+  using PassFactory = std::function<std::unique_ptr<Pass>()>;
+
   // Constructs a pass manager.
   //
   // The constructed instance will have an empty message consumer, which just
@@ -53,6 +57,9 @@ class PassManager {
 
   // Adds an externally constructed pass.
   void AddPass(std::unique_ptr<Pass> pass);
+  // Adds an externally constructed pass, together with a |factory| that
+  // returns new instances equivalent to |pass|.  See Instantiate().
+  void AddPass(std::unique_ptr<Pass> pass, PassFactory factory);
   // Uses the argument |args| to construct a pass instance of type |T|, and adds
   // the pass instance to this pass manger. The pass added will use this pass
   // manager's message consumer.
@@ -67,6 +74,23 @@ class PassManager {
   // Returns the message consumer.
   inline const MessageConsumer& consumer() const;
 
+  // Returns true if every pass added to this pass manager has a factory, in
+  // which case Instantiate() can be used.
+  bool IsReusable() const;
+
+  // Returns a new pass manager with the same options and message consumer as
+  // this one, whose passes are fresh instances created by the factories of the
+  // passes of this pass manager.  This pass manager is not modified, so it can
+  // be instantiated any number of times, and the returned pass managers can be
+  // run concurrently on different contexts.  Must only be called if
+  // IsReusable() returns true.
+  std::unique_ptr<PassManager> Instantiate() const {
+    return Instantiate(consumer_);
+  }
+  // Like above, but the returned pass manager and its passes send their
+  // messages to |consumer| instead.
+  std::unique_ptr<PassManager> Instantiate(MessageConsumer consumer) const;
+
   // Runs all passes on the given |module|. Returns Status::Failure if errors
   // occur when processing using one of the registered passes. All passes
   // registered after the error-reporting pass will be skipped. Returns the
@@ -104,7 +128,10 @@ class PassManager {
     return *this;
   }
 
-  // Sets the option to validate after each pass.
+  // Sets the option to validate after each pass.  The opcode checks are only
+  // run again on the functions that changed since the module was last
+  // validated, and a pass that reports no change is not followed by
+  // validation once the module has been validated.
   PassManager& SetValidateAfterAll(bool validate) {
     validate_after_all_ = validate;
     return *this;
@@ -115,6 +142,9 @@ class PassManager {
   MessageConsumer consumer_;
   // A vector of passes. Order matters.
   std::vector<std::unique_ptr<Pass>> passes_;
+  // The factories for the passes in |passes_|, at the same index.  An empty
+  // factory means that the pass cannot be instantiated again.
+  std::vector<PassFactory> factories_;
   // The output stream to write disassembly to before each pass, and after
   // the last pass.  If this is null, no output is generated.
   std::ostream* print_all_stream_;
@@ -130,13 +160,20 @@ class PassManager {
 };
 
 inline void PassManager::AddPass(std::unique_ptr<Pass> pass) {
+  AddPass(std::move(pass), nullptr);
+}
+
+inline void PassManager::AddPass(std::unique_ptr<Pass> pass,
+                                 PassFactory factory) {
   passes_.push_back(std::move(pass));
+  factories_.push_back(std::move(factory));
 }
 
 template <typename T, typename... Args>
 inline void PassManager::AddPass(Args&&... args) {
   passes_.emplace_back(new T(std::forward<Args>(args)...));
   passes_.back()->SetMessageConsumer(consumer_);
+  factories_.emplace_back(nullptr);
 }
 
 inline uint32_t PassManager::NumPasses() const {
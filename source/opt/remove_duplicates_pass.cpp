@@ -98,7 +98,9 @@ bool RemoveDuplicatesPass::RemoveDuplicateTypes() const {
 
   analysis::TypeManager type_manager(context()->consumer(), context());
 
-  std::vector<Instruction*> visited_types;
+  // The type manager holds one object for each distinct type, so the types
+  // seen so far are keyed by that object.
+  std::unordered_map<const analysis::Type*, SpvId> visited_types;
   std::vector<analysis::ForwardPointer> visited_forward_pointers;
   std::vector<Instruction*> to_delete;
   for (auto* i = &*context()->types_values_begin(); i; i = i->NextNode()) {
@@ -111,25 +113,13 @@ bool RemoveDuplicatesPass::RemoveDuplicateTypes() const {
 
     if (!is_i_forward_pointer) {
       // Is the current type equal to one of the types we have already visited?
-      SpvId id_to_keep = 0u;
-      analysis::Type* i_type = type_manager.GetType(i->result_id());
+      const analysis::Type* i_type = type_manager.GetType(i->result_id());
       assert(i_type);
-      // TODO(dneto0): Use a trie to avoid quadratic behaviour? Extract the
-      // ResultIdTrie from unify_const_pass.cpp for this.
-      for (auto j : visited_types) {
-        analysis::Type* j_type = type_manager.GetType(j->result_id());
-        assert(j_type);
-        if (*i_type == *j_type) {
-          id_to_keep = j->result_id();
-          break;
-        }
-      }
-
-      if (id_to_keep == 0u) {
-        // This is a never seen before type, keep it around.
-        visited_types.emplace_back(i);
-      } else {
+      // A never seen before type is kept around.
+      auto inserted = visited_types.insert({i_type, i->result_id()});
+      if (!inserted.second) {
         // The same type has already been seen before, remove this one.
+        SpvId id_to_keep = inserted.first->second;
         context()->KillNamesAndDecorates(i->result_id());
         context()->ReplaceAllUsesWith(i->result_id(), id_to_keep);
         modified = true;
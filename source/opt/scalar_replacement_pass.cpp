@@ -35,10 +35,12 @@ Pass::Status ScalarReplacementPass::Process() {
   Status status = Status::SuccessWithoutChange;
   for (auto& f : *get_module()) {
     Status functionStatus = ProcessFunction(&f);
-    if (functionStatus == Status::Failure)
+    if (functionStatus == Status::Failure) {
       return functionStatus;
-    else if (functionStatus == Status::SuccessWithChange)
+    } else if (functionStatus == Status::SuccessWithChange) {
       status = functionStatus;
+      MarkFunctionModified(&f);
+    }
   }
 
   return status;
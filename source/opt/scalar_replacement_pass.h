@@ -56,6 +56,8 @@ class ScalarReplacementPass : public Pass {
            IRContext::kAnalysisConstants | IRContext::kAnalysisTypes;
   }
 
+  bool TracksModifiedFunctions() const override { return true; }
+
  private:
   // Small container for tracking statistics about variables.
   //
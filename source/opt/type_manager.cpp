@@ -137,7 +137,8 @@ void TypeManager::AnalyzeTypes(const Module& module) {
     }
   }
 
-  // Add the remaining incomplete types to the type pool.
+  // Add the remaining incomplete types to the type pool.  They may refer to
+  // one another, so all of them are decorated before any is interned.
   for (auto& type : incomplete_types_) {
     if (type.type() && !type.type()->AsForwardPointer()) {
       std::vector<Instruction*> decorations =
@@ -145,9 +146,13 @@ void TypeManager::AnalyzeTypes(const Module& module) {
       for (auto dec : decorations) {
         AttachDecoration(*dec, type.type());
       }
-      auto pair = type_pool_.insert(type.ReleaseType());
-      id_to_type_[type.id()] = pair.first->get();
-      type_to_id_[pair.first->get()] = type.id();
+    }
+  }
+  for (auto& type : incomplete_types_) {
+    if (type.type() && !type.type()->AsForwardPointer()) {
+      Type* interned = InternType(type.ReleaseType());
+      id_to_type_[type.id()] = interned;
+      type_to_id_[interned] = type.id();
       id_to_incomplete_type_.erase(type.id());
     }
   }
@@ -162,12 +167,14 @@ void TypeManager::AnalyzeTypes(const Module& module) {
   // Check if the type pool contains two types that are the same.  This
   // is an indication that the hashing and comparison are wrong.  It
   // will cause a problem if the type pool gets resized and everything
-  // is rehashed.
+  // is rehashed.  IsSame() compares interned types by address, so their
+  // structure is compared directly.
   for (auto& i : type_pool_) {
     for (auto& j : type_pool_) {
       Type* ti = i.get();
       Type* tj = j.get();
-      assert((ti == tj || !ti->IsSame(tj)) &&
+      Type::IsSameCache seen;
+      assert((ti == tj || !ti->IsSameImpl(tj, &seen)) &&
              "Type pool contains two types that are the same.");
     }
   }
@@ -502,7 +509,23 @@ void TypeManager::CreateDecoration(uint32_t target,
   context()->get_def_use_mgr()->AnalyzeInstUse(inst);
 }
 
+Type* TypeManager::InternType(std::unique_ptr<Type> type) {
+  // The pool has to be searched while |type| is not interned yet: IsSame()
+  // takes two distinct interned types of this manager to be different.
+  auto iter = type_pool_.find(type);
+  if (iter != type_pool_.end()) {
+    return iter->get();
+  }
+  type->Intern(this);
+  return type_pool_.insert(std::move(type)).first->get();
+}
+
 Type* TypeManager::RebuildType(const Type& type) {
+  // A type of the pool is already built from types of the pool.
+  if (type.IsInternedBy(this)) {
+    return const_cast<Type*>(&type);
+  }
+
   // The comparison and hash on the type pool will avoid inserting the rebuilt
   // type if an equivalent type already exists. The rebuilt type will be deleted
   // when it goes out of scope at the end of the function in that case. Repeated
@@ -510,10 +533,9 @@ Type* TypeManager::RebuildType(const Type& type) {
   // the type pool.
   std::unique_ptr<Type> rebuilt_ty;
   switch (type.kind()) {
-#define DefineNoSubtypeCase(kind)             \
-  case Type::k##kind:                         \
-    rebuilt_ty.reset(type.Clone().release()); \
-    return type_pool_.insert(std::move(rebuilt_ty)).first->get()
+#define DefineNoSubtypeCase(kind) \
+  case Type::k##kind:             \
+    return InternType(type.Clone())
 
     DefineNoSubtypeCase(Void);
     DefineNoSubtypeCase(Bool);
@@ -562,8 +584,9 @@ Type* TypeManager::RebuildType(const Type& type) {
     }
     case Type::kArray: {
       const Array* array_ty = type.AsArray();
+      const Type* ele_ty = array_ty->element_type();
       rebuilt_ty =
-          MakeUnique<Array>(array_ty->element_type(), array_ty->length_info());
+          MakeUnique<Array>(RebuildType(*ele_ty), array_ty->length_info());
       break;
     }
     case Type::kRuntimeArray: {
@@ -638,7 +661,7 @@ Type* TypeManager::RebuildType(const Type& type) {
     rebuilt_ty->AddDecoration(std::move(copy));
   }
 
-  return type_pool_.insert(std::move(rebuilt_ty)).first->get();
+  return InternType(std::move(rebuilt_ty));
 }
 
 void TypeManager::RegisterType(uint32_t id, const Type& type) {
@@ -879,10 +902,9 @@ Type* TypeManager::RecordIfTypeDefinition(const Instruction& inst) {
   for (auto dec : decorations) {
     AttachDecoration(*dec, type);
   }
-  std::unique_ptr<Type> unique(type);
-  auto pair = type_pool_.insert(std::move(unique));
-  id_to_type_[id] = pair.first->get();
-  type_to_id_[pair.first->get()] = id;
+  type = InternType(std::unique_ptr<Type>(type));
+  id_to_type_[id] = type;
+  type_to_id_[type] = id;
   return type;
 }
 
@@ -250,6 +250,10 @@ class TypeManager {
   // |type| (e.g. should be called in loop of |type|'s decorations).
   void AttachDecoration(const Instruction& inst, Type* type);
 
+  // Returns the type of |type_pool_| that is the same as |type|.  If there is
+  // none, |type| is interned and added to the pool.
+  Type* InternType(std::unique_ptr<Type> type);
+
   // Returns an equivalent pointer to |type| built in terms of pointers owned by
   // |type_pool_|. For example, if |type| is a vec3 of bool, it will be rebuilt
   // replacing the bool subtype with one owned by |type_pool_|.
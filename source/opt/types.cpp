@@ -21,6 +21,7 @@
 #include <string>
 #include <unordered_set>
 
+#include "source/util/hash.h"
 #include "source/util/make_unique.h"
 #include "spirv/unified1/spirv.h"
 
@@ -182,23 +183,29 @@ bool Type::operator==(const Type& other) const {
   }
 }
 
-void Type::GetHashWords(std::vector<uint32_t>* words,
-                        std::unordered_set<const Type*>* seen) const {
-  if (!seen->insert(this).second) {
-    return;
+uint64_t Type::ComputeHashValue(HashState* state) const {
+  if (hash_value_ != 0) {
+    return hash_value_;
+  }
+  if (std::find(state->path.begin(), state->path.end(), this) !=
+      state->path.end()) {
+    state->found_cycle = true;
+    return kind_;
   }
+  state->path.push_back(this);
 
-  words->push_back(kind_);
+  uint64_t hash = utils::HashCombine(0, kind_);
   for (const auto& d : decorations_) {
+    hash = utils::HashCombine(hash, d.size());
     for (auto w : d) {
-      words->push_back(w);
+      hash = utils::HashCombine(hash, w);
     }
   }
 
   switch (kind_) {
-#define DeclareKindCase(type)                   \
-  case k##type:                                 \
-    As##type()->GetExtraHashWords(words, seen); \
+#define DeclareKindCase(type)                               \
+  case k##type:                                             \
+    hash = As##type()->ComputeExtraStateHash(hash, state); \
     break
     DeclareKindCase(Void);
     DeclareKindCase(Bool);
@@ -232,18 +239,26 @@ void Type::GetHashWords(std::vector<uint32_t>* words,
       break;
   }
 
-  seen->erase(this);
+  state->path.pop_back();
+  return hash;
 }
 
 size_t Type::HashValue() const {
-  std::u32string h;
-  std::vector<uint32_t> words;
-  GetHashWords(&words);
-  for (auto w : words) {
-    h.push_back(w);
+  HashState state;
+  return static_cast<size_t>(ComputeHashValue(&state));
+}
+
+void Type::Intern(const TypeManager* owner) {
+  assert(!owner_ && "The type is already interned.");
+  HashState state;
+  uint64_t hash = ComputeHashValue(&state);
+  owner_ = owner;
+  // The hash value of a type that refers to itself depends on where the
+  // computation starts, so it is not kept.  A kept value of 0 would not be
+  // used either.
+  if (!state.found_cycle) {
+    hash_value_ = hash;
   }
-
-  return std::hash<std::u32string>()(h);
 }
 
 bool Integer::IsSameImpl(const Type* that, IsSameCache*) const {
@@ -258,10 +273,9 @@ std::string Integer::str() const {
   return oss.str();
 }
 
-void Integer::GetExtraHashWords(std::vector<uint32_t>* words,
-                                std::unordered_set<const Type*>*) const {
-  words->push_back(width_);
-  words->push_back(signed_);
+uint64_t Integer::ComputeExtraStateHash(uint64_t hash, HashState*) const {
+  hash = utils::HashCombine(hash, width_);
+  return utils::HashCombine(hash, signed_);
 }
 
 bool Float::IsSameImpl(const Type* that, IsSameCache*) const {
@@ -275,9 +289,8 @@ std::string Float::str() const {
   return oss.str();
 }
 
-void Float::GetExtraHashWords(std::vector<uint32_t>* words,
-                              std::unordered_set<const Type*>*) const {
-  words->push_back(width_);
+uint64_t Float::ComputeExtraStateHash(uint64_t hash, HashState*) const {
+  return utils::HashCombine(hash, width_);
 }
 
 Vector::Vector(const Type* type, uint32_t count)
@@ -299,10 +312,9 @@ std::string Vector::str() const {
   return oss.str();
 }
 
-void Vector::GetExtraHashWords(std::vector<uint32_t>* words,
-                               std::unordered_set<const Type*>* seen) const {
-  element_type_->GetHashWords(words, seen);
-  words->push_back(count_);
+uint64_t Vector::ComputeExtraStateHash(uint64_t hash, HashState* state) const {
+  hash = utils::HashCombine(hash, element_type_->ComputeHashValue(state));
+  return utils::HashCombine(hash, count_);
 }
 
 Matrix::Matrix(const Type* type, uint32_t count)
@@ -324,10 +336,9 @@ std::string Matrix::str() const {
   return oss.str();
 }
 
-void Matrix::GetExtraHashWords(std::vector<uint32_t>* words,
-                               std::unordered_set<const Type*>* seen) const {
-  element_type_->GetHashWords(words, seen);
-  words->push_back(count_);
+uint64_t Matrix::ComputeExtraStateHash(uint64_t hash, HashState* state) const {
+  hash = utils::HashCombine(hash, element_type_->ComputeHashValue(state));
+  return utils::HashCombine(hash, count_);
 }
 
 Image::Image(Type* type, SpvDim dimen, uint32_t d, bool array, bool multisample,
@@ -362,16 +373,15 @@ std::string Image::str() const {
   return oss.str();
 }
 
-void Image::GetExtraHashWords(std::vector<uint32_t>* words,
-                              std::unordered_set<const Type*>* seen) const {
-  sampled_type_->GetHashWords(words, seen);
-  words->push_back(dim_);
-  words->push_back(depth_);
-  words->push_back(arrayed_);
-  words->push_back(ms_);
-  words->push_back(sampled_);
-  words->push_back(format_);
-  words->push_back(access_qualifier_);
+uint64_t Image::ComputeExtraStateHash(uint64_t hash, HashState* state) const {
+  hash = utils::HashCombine(hash, sampled_type_->ComputeHashValue(state));
+  hash = utils::HashCombine(hash, dim_);
+  hash = utils::HashCombine(hash, depth_);
+  hash = utils::HashCombine(hash, arrayed_);
+  hash = utils::HashCombine(hash, ms_);
+  hash = utils::HashCombine(hash, sampled_);
+  hash = utils::HashCombine(hash, format_);
+  return utils::HashCombine(hash, access_qualifier_);
 }
 
 bool SampledImage::IsSameImpl(const Type* that, IsSameCache* seen) const {
@@ -387,9 +397,9 @@ std::string SampledImage::str() const {
   return oss.str();
 }
 
-void SampledImage::GetExtraHashWords(
-    std::vector<uint32_t>* words, std::unordered_set<const Type*>* seen) const {
-  image_type_->GetHashWords(words, seen);
+uint64_t SampledImage::ComputeExtraStateHash(uint64_t hash,
+                                             HashState* state) const {
+  return utils::HashCombine(hash, image_type_->ComputeHashValue(state));
 }
 
 Array::Array(const Type* type, const Array::LengthInfo& length_info_arg)
@@ -422,12 +432,13 @@ std::string Array::str() const {
   return oss.str();
 }
 
-void Array::GetExtraHashWords(std::vector<uint32_t>* words,
-                              std::unordered_set<const Type*>* seen) const {
-  element_type_->GetHashWords(words, seen);
+uint64_t Array::ComputeExtraStateHash(uint64_t hash, HashState* state) const {
+  hash = utils::HashCombine(hash, element_type_->ComputeHashValue(state));
   // This should mirror the logic in IsSameImpl
-  words->insert(words->end(), length_info_.words.begin(),
-                length_info_.words.end());
+  for (auto w : length_info_.words) {
+    hash = utils::HashCombine(hash, w);
+  }
+  return hash;
 }
 
 void Array::ReplaceElementType(const Type* type) { element_type_ = type; }
@@ -450,9 +461,9 @@ std::string RuntimeArray::str() const {
   return oss.str();
 }
 
-void RuntimeArray::GetExtraHashWords(
-    std::vector<uint32_t>* words, std::unordered_set<const Type*>* seen) const {
-  element_type_->GetHashWords(words, seen);
+uint64_t RuntimeArray::ComputeExtraStateHash(uint64_t hash,
+                                             HashState* state) const {
+  return utils::HashCombine(hash, element_type_->ComputeHashValue(state));
 }
 
 void RuntimeArray::ReplaceElementType(const Type* type) {
@@ -509,19 +520,20 @@ std::string Struct::str() const {
   return oss.str();
 }
 
-void Struct::GetExtraHashWords(std::vector<uint32_t>* words,
-                               std::unordered_set<const Type*>* seen) const {
+uint64_t Struct::ComputeExtraStateHash(uint64_t hash, HashState* state) const {
   for (auto* t : element_types_) {
-    t->GetHashWords(words, seen);
+    hash = utils::HashCombine(hash, t->ComputeHashValue(state));
   }
   for (const auto& pair : element_decorations_) {
-    words->push_back(pair.first);
+    hash = utils::HashCombine(hash, pair.first);
     for (const auto& d : pair.second) {
+      hash = utils::HashCombine(hash, d.size());
       for (auto w : d) {
-        words->push_back(w);
+        hash = utils::HashCombine(hash, w);
       }
     }
   }
+  return hash;
 }
 
 bool Opaque::IsSameImpl(const Type* that, IsSameCache*) const {
@@ -536,11 +548,11 @@ std::string Opaque::str() const {
   return oss.str();
 }
 
-void Opaque::GetExtraHashWords(std::vector<uint32_t>* words,
-                               std::unordered_set<const Type*>*) const {
+uint64_t Opaque::ComputeExtraStateHash(uint64_t hash, HashState*) const {
   for (auto c : name_) {
-    words->push_back(static_cast<char32_t>(c));
+    hash = utils::HashCombine(hash, static_cast<char32_t>(c));
   }
+  return hash;
 }
 
 Pointer::Pointer(const Type* type, SpvStorageClass sc)
@@ -569,10 +581,9 @@ std::string Pointer::str() const {
   return os.str();
 }
 
-void Pointer::GetExtraHashWords(std::vector<uint32_t>* words,
-                                std::unordered_set<const Type*>* seen) const {
-  pointee_type_->GetHashWords(words, seen);
-  words->push_back(storage_class_);
+uint64_t Pointer::ComputeExtraStateHash(uint64_t hash, HashState* state) const {
+  hash = utils::HashCombine(hash, pointee_type_->ComputeHashValue(state));
+  return utils::HashCombine(hash, storage_class_);
 }
 
 void Pointer::SetPointeeType(const Type* type) { pointee_type_ = type; }
@@ -606,12 +617,13 @@ std::string Function::str() const {
   return oss.str();
 }
 
-void Function::GetExtraHashWords(std::vector<uint32_t>* words,
-                                 std::unordered_set<const Type*>* seen) const {
-  return_type_->GetHashWords(words, seen);
+uint64_t Function::ComputeExtraStateHash(uint64_t hash,
+                                         HashState* state) const {
+  hash = utils::HashCombine(hash, return_type_->ComputeHashValue(state));
   for (const auto* t : param_types_) {
-    t->GetHashWords(words, seen);
+    hash = utils::HashCombine(hash, t->ComputeHashValue(state));
   }
+  return hash;
 }
 
 void Function::SetReturnType(const Type* type) { return_type_ = type; }
@@ -628,9 +640,8 @@ std::string Pipe::str() const {
   return oss.str();
 }
 
-void Pipe::GetExtraHashWords(std::vector<uint32_t>* words,
-                             std::unordered_set<const Type*>*) const {
-  words->push_back(access_qualifier_);
+uint64_t Pipe::ComputeExtraStateHash(uint64_t hash, HashState*) const {
+  return utils::HashCombine(hash, access_qualifier_);
 }
 
 bool ForwardPointer::IsSameImpl(const Type* that, IsSameCache*) const {
@@ -653,11 +664,14 @@ std::string ForwardPointer::str() const {
   return oss.str();
 }
 
-void ForwardPointer::GetExtraHashWords(
-    std::vector<uint32_t>* words, std::unordered_set<const Type*>* seen) const {
-  words->push_back(target_id_);
-  words->push_back(storage_class_);
-  if (pointer_) pointer_->GetHashWords(words, seen);
+uint64_t ForwardPointer::ComputeExtraStateHash(uint64_t hash,
+                                               HashState* state) const {
+  hash = utils::HashCombine(hash, target_id_);
+  hash = utils::HashCombine(hash, storage_class_);
+  if (pointer_) {
+    hash = utils::HashCombine(hash, pointer_->ComputeHashValue(state));
+  }
+  return hash;
 }
 
 CooperativeMatrixNV::CooperativeMatrixNV(const Type* type, const uint32_t scope,
@@ -681,12 +695,12 @@ std::string CooperativeMatrixNV::str() const {
   return oss.str();
 }
 
-void CooperativeMatrixNV::GetExtraHashWords(
-    std::vector<uint32_t>* words, std::unordered_set<const Type*>* pSet) const {
-  component_type_->GetHashWords(words, pSet);
-  words->push_back(scope_id_);
-  words->push_back(rows_id_);
-  words->push_back(columns_id_);
+uint64_t CooperativeMatrixNV::ComputeExtraStateHash(uint64_t hash,
+                                                    HashState* state) const {
+  hash = utils::HashCombine(hash, component_type_->ComputeHashValue(state));
+  hash = utils::HashCombine(hash, scope_id_);
+  hash = utils::HashCombine(hash, rows_id_);
+  return utils::HashCombine(hash, columns_id_);
 }
 
 bool CooperativeMatrixNV::IsSameImpl(const Type* that,
@@ -17,6 +17,7 @@
 #ifndef SOURCE_OPT_TYPES_H_
 #define SOURCE_OPT_TYPES_H_
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <set>
@@ -60,6 +61,7 @@ class NamedBarrier;
 class AccelerationStructureNV;
 class CooperativeMatrixNV;
 class RayQueryKHR;
+class TypeManager;
 
 // Abstract class for a SPIR-V type. It has a bunch of As<sublcass>() methods,
 // which is used as a way to probe the actual <subclass>.
@@ -99,7 +101,29 @@ class Type {
     kRayQueryKHR
   };
 
-  Type(Kind k) : kind_(k) {}
+  // The state of a hash value computation: the types whose hash values are
+  // being computed, outermost first, and whether one of them was reached again
+  // through its own subtypes.
+  struct HashState {
+    std::vector<const Type*> path;
+    bool found_cycle = false;
+  };
+
+  Type(Kind k) : kind_(k), owner_(nullptr), hash_value_(0) {}
+
+  // A copy is not interned, whether or not |that| is.
+  Type(const Type& that)
+      : decorations_(that.decorations_),
+        kind_(that.kind_),
+        owner_(nullptr),
+        hash_value_(0) {}
+  Type& operator=(const Type& that) {
+    decorations_ = that.decorations_;
+    kind_ = that.kind_;
+    owner_ = nullptr;
+    hash_value_ = 0;
+    return *this;
+  }
 
   virtual ~Type() = default;
 
@@ -112,8 +136,11 @@ class Type {
   // Returns true if this type has exactly the same decorations as |that| type.
   bool HasSameDecorations(const Type* that) const;
   // Returns true if this type is exactly the same as |that| type, including
-  // decorations.
+  // decorations.  A type manager never holds two interned types that are the
+  // same, so two of its interned types are compared by address.
   bool IsSame(const Type* that) const {
+    if (this == that) return true;
+    if (owner_ && owner_ == that->owner_) return false;
     IsSameCache seen;
     return IsSameImpl(that, &seen);
   }
@@ -154,22 +181,27 @@ class Type {
   // Returns the hash value of this type.
   size_t HashValue() const;
 
-  // Adds the necessary words to compute a hash value of this type to |words|.
-  void GetHashWords(std::vector<uint32_t>* words) const {
-    std::unordered_set<const Type*> seen;
-    GetHashWords(words, &seen);
+  // Returns the hash value of this type, computed as part of the hash value
+  // of the types on |state|'s path.  The hash value of a subtype is computed
+  // on its own and then combined into the hash value of its parent, so that an
+  // interned subtype can contribute the value computed when it was interned.
+  uint64_t ComputeHashValue(HashState* state) const;
+
+  // Returns |hash| combined with the hash values of the members specific to
+  // the subclass.
+  virtual uint64_t ComputeExtraStateHash(uint64_t hash,
+                                         HashState* state) const = 0;
+
+  // Marks this type as owned by the type pool of |owner|.  Its hash value is
+  // computed once here and kept, unless the type refers to itself through its
+  // subtypes.  An interned type must not be changed.
+  void Intern(const TypeManager* owner);
+
+  // Returns true if this type is owned by the type pool of |owner|.
+  bool IsInternedBy(const TypeManager* owner) const {
+    return owner_ && owner_ == owner;
   }
 
-  // Adds the necessary words to compute a hash value of this type to |words|.
-  void GetHashWords(std::vector<uint32_t>* words,
-                    std::unordered_set<const Type*>* seen) const;
-
-  // Adds necessary extra words for a subtype to calculate a hash value into
-  // |words|.
-  virtual void GetExtraHashWords(
-      std::vector<uint32_t>* words,
-      std::unordered_set<const Type*>* pSet) const = 0;
-
 // A bunch of methods for casting this type to a given type. Returns this if the
 // cast can be done, nullptr otherwise.
 // clang-format off
@@ -216,6 +248,10 @@ class Type {
   virtual void ClearDecorations() { decorations_.clear(); }
 
   Kind kind_;
+  // The type manager this type is interned by, or nullptr.
+  const TypeManager* owner_;
+  // The hash value of this type, or 0 if it has to be computed.
+  uint64_t hash_value_;
 };
 // clang-format on
 
@@ -232,8 +268,8 @@ class Integer : public Type {
   uint32_t width() const { return width_; }
   bool IsSigned() const { return signed_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -253,8 +289,8 @@ class Float : public Type {
   const Float* AsFloat() const override { return this; }
   uint32_t width() const { return width_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -274,8 +310,8 @@ class Vector : public Type {
   Vector* AsVector() override { return this; }
   const Vector* AsVector() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -296,8 +332,8 @@ class Matrix : public Type {
   Matrix* AsMatrix() override { return this; }
   const Matrix* AsMatrix() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -327,8 +363,8 @@ class Image : public Type {
   SpvImageFormat format() const { return format_; }
   SpvAccessQualifier access_qualifier() const { return access_qualifier_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -355,8 +391,8 @@ class SampledImage : public Type {
 
   const Type* image_type() const { return image_type_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -399,8 +435,8 @@ class Array : public Type {
   Array* AsArray() override { return this; }
   const Array* AsArray() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
   void ReplaceElementType(const Type* element_type);
 
@@ -422,8 +458,8 @@ class RuntimeArray : public Type {
   RuntimeArray* AsRuntimeArray() override { return this; }
   const RuntimeArray* AsRuntimeArray() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
   void ReplaceElementType(const Type* element_type);
 
@@ -459,8 +495,8 @@ class Struct : public Type {
   Struct* AsStruct() override { return this; }
   const Struct* AsStruct() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -474,8 +510,8 @@ class Struct : public Type {
   // We can attach decorations to struct members and that should not affect the
   // underlying element type. So we need an extra data structure here to keep
   // track of element type decorations.  They must be stored in an ordered map
-  // because |GetExtraHashWords| will traverse the structure.  It must have a
-  // fixed order in order to hash to the same value every time.
+  // because |ComputeExtraStateHash| will traverse the structure.  It must have
+  // a fixed order in order to hash to the same value every time.
   std::map<uint32_t, std::vector<std::vector<uint32_t>>> element_decorations_;
 };
 
@@ -491,8 +527,8 @@ class Opaque : public Type {
 
   const std::string& name() const { return name_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -512,8 +548,8 @@ class Pointer : public Type {
   Pointer* AsPointer() override { return this; }
   const Pointer* AsPointer() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
   void SetPointeeType(const Type* type);
 
@@ -539,8 +575,8 @@ class Function : public Type {
   const std::vector<const Type*>& param_types() const { return param_types_; }
   std::vector<const Type*>& param_types() { return param_types_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>*) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
   void SetReturnType(const Type* type);
 
@@ -564,8 +600,8 @@ class Pipe : public Type {
 
   SpvAccessQualifier access_qualifier() const { return access_qualifier_; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -592,8 +628,8 @@ class ForwardPointer : public Type {
   ForwardPointer* AsForwardPointer() override { return this; }
   const ForwardPointer* AsForwardPointer() const override { return this; }
 
-  void GetExtraHashWords(std::vector<uint32_t>* words,
-                         std::unordered_set<const Type*>* pSet) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
  private:
   bool IsSameImpl(const Type* that, IsSameCache*) const override;
@@ -616,8 +652,8 @@ class CooperativeMatrixNV : public Type {
     return this;
   }
 
-  void GetExtraHashWords(std::vector<uint32_t>*,
-                         std::unordered_set<const Type*>*) const override;
+  uint64_t ComputeExtraStateHash(uint64_t hash,
+                                 HashState* state) const override;
 
   const Type* component_type() const { return component_type_; }
   uint32_t scope_id() const { return scope_id_; }
@@ -644,8 +680,9 @@ class CooperativeMatrixNV : public Type {
     type* As##type() override { return this; }                                 \
     const type* As##type() const override { return this; }                     \
                                                                                \
-    void GetExtraHashWords(std::vector<uint32_t>*,                             \
-                           std::unordered_set<const Type*>*) const override {} \
+    uint64_t ComputeExtraStateHash(uint64_t hash, HashState*) const override { \
+      return hash;                                                             \
+    }                                                                          \
                                                                                \
    private:                                                                    \
     bool IsSameImpl(const Type* that, IsSameCache*) const override {           \
@@ -15,6 +15,7 @@
 #include "source/opt/vector_dce.h"
 
 #include <utility>
+#include <vector>
 
 namespace spvtools {
 namespace opt {
@@ -27,17 +28,29 @@ const uint32_t kInsertCompositeIdInIdx = 1;
 }  // namespace
 
 Pass::Status VectorDCE::Process() {
-  bool modified = false;
+  std::vector<Function*> functions;
   for (Function& function : *get_module()) {
-    modified |= VectorDCEFunction(&function);
+    functions.push_back(&function);
   }
-  return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
-}
 
-bool VectorDCE::VectorDCEFunction(Function* function) {
-  LiveComponentMap live_components;
-  FindLiveComponents(function, &live_components);
-  return RewriteInstructions(function, live_components);
+  // Finding the live components only reads the module, so it is done for all
+  // the functions at once, possibly in parallel.  The rewrites are then done
+  // one function at a time, in module order, as they create new instructions.
+  // Rewriting a function does not change the live components of the others.
+  std::vector<LiveComponentMap> live_components(functions.size());
+  context()->ForEachInParallel(
+      functions.size(),
+      IRContext::kAnalysisDefUse | IRContext::kAnalysisCombinators |
+          IRContext::kAnalysisTypes,
+      [this, &functions, &live_components](size_t i) {
+        FindLiveComponents(functions[i], &live_components[i]);
+      });
+
+  bool modified = false;
+  for (size_t i = 0; i < functions.size(); ++i) {
+    modified |= RewriteInstructions(functions[i], live_components[i]);
+  }
+  return (modified ? Status::SuccessWithChange : Status::SuccessWithoutChange);
 }
 
 void VectorDCE::FindLiveComponents(Function* function,
@@ -58,12 +58,10 @@ class VectorDCE : public MemPass {
   }
 
  private:
-  // Runs the vector dce pass on |function|.  Returns true if |function| was
-  // modified.
-  bool VectorDCEFunction(Function* function);
-
   // Identifies the live components of the vectors that are results of
   // instructions in |function|.  The results are stored in |live_components|.
+  // Only reads the module and its analyses, so it can be called for several
+  // functions at the same time.
   void FindLiveComponents(Function* function,
                           LiveComponentMap* live_components);
 
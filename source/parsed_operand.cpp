@@ -17,7 +17,10 @@
 #include "source/parsed_operand.h"
 
 #include <cassert>
+#include <sstream>
+
 #include "source/util/hex_float.h"
+#include "source/util/string_utils.h"
 
 namespace spvtools {
 
@@ -71,4 +74,39 @@ void EmitNumericLiteral(std::ostream* out, const spv_parsed_instruction_t& inst,
     }
   }
 }
+
+void EmitNumericLiteral(std::string* out, const spv_parsed_instruction_t& inst,
+                        const spv_parsed_operand_t& operand) {
+  if (operand.type != SPV_OPERAND_TYPE_LITERAL_INTEGER &&
+      operand.type != SPV_OPERAND_TYPE_TYPED_LITERAL_NUMBER)
+    return;
+  if (operand.num_words < 1 || operand.num_words > 2) return;
+
+  const uint32_t word = inst.words[operand.offset];
+  const uint64_t bits =
+      operand.num_words == 1
+          ? word
+          : uint64_t(word) | (uint64_t(inst.words[operand.offset + 1]) << 32);
+  switch (operand.number_kind) {
+    case SPV_NUMBER_SIGNED_INT:
+      if (operand.num_words == 1) {
+        utils::AppendSigned(int32_t(word), out);
+      } else {
+        utils::AppendSigned(int64_t(bits), out);
+      }
+      break;
+    case SPV_NUMBER_UNSIGNED_INT:
+      utils::AppendUnsigned(bits, out);
+      break;
+    case SPV_NUMBER_FLOATING: {
+      // Floats are rare enough that the stream formatting is kept, which
+      // also keeps the text exactly the same.
+      std::ostringstream text;
+      EmitNumericLiteral(&text, inst, operand);
+      out->append(text.str());
+    } break;
+    default:
+      break;
+  }
+}
 }  // namespace spvtools
@@ -16,6 +16,7 @@
 #define SOURCE_PARSED_OPERAND_H_
 
 #include <ostream>
+#include <string>
 
 #include "spirv-tools/libspirv.h"
 
@@ -28,6 +29,11 @@ namespace spvtools {
 void EmitNumericLiteral(std::ostream* out, const spv_parsed_instruction_t& inst,
                         const spv_parsed_operand_t& operand);
 
+// Like the above, but appends the text to |out|.  Integers are formatted
+// without going through a stream.
+void EmitNumericLiteral(std::string* out, const spv_parsed_instruction_t& inst,
+                        const spv_parsed_operand_t& operand);
+
 }  // namespace spvtools
 
 #endif  // SOURCE_PARSED_OPERAND_H_
@@ -23,15 +23,22 @@ namespace reduce {
 
 std::vector<uint32_t> ReductionPass::TryApplyReduction(
     const std::vector<uint32_t>& binary, uint32_t target_function) {
-  // We represent modules as binaries because (a) attempts at reduction need to
-  // end up in binary form to be passed on to SPIR-V-consuming tools, and (b)
-  // when we apply a reduction step we need to do it on a fresh version of the
-  // module as if the reduction step proves to be uninteresting we need to
-  // backtrack; re-parsing from binary provides a very clean way of cloning the
-  // module.
-  std::unique_ptr<opt::IRContext> context =
-      BuildModule(target_env_, consumer_, binary.data(), binary.size());
-  assert(context);
+  // We represent modules as binaries because attempts at reduction need to
+  // end up in binary form to be passed on to SPIR-V-consuming tools.  When we
+  // apply a reduction step we need to do it on a fresh version of the module,
+  // as if the reduction step proves to be uninteresting we need to backtrack.
+  // Parsing a large binary for every attempt is expensive, so the module of
+  // the binary is kept and each attempt works on a clone of it.  The binary is
+  // only parsed again if it is not the one the module was built from.
+  if (!context_ || binary != context_binary_) {
+    context_ =
+        BuildModule(target_env_, consumer_, binary.data(), binary.size());
+    assert(context_);
+    context_binary_ = binary;
+  }
+  std::unique_ptr<opt::IRContext> context = context_->Clone();
+  attempt_context_.reset();
+  attempt_binary_.clear();
 
   std::vector<std::unique_ptr<ReductionOpportunity>> opportunities =
       finder_->GetAvailableOpportunities(context.get(), target_function);
@@ -51,6 +58,8 @@ std::vector<uint32_t> ReductionPass::TryApplyReduction(
     // of the round.
     index_ = 0;
     granularity_ = std::max((uint32_t)1, granularity_ / 2);
+    context_.reset();
+    context_binary_.clear();
     return std::vector<uint32_t>();
   }
 
@@ -62,6 +71,8 @@ std::vector<uint32_t> ReductionPass::TryApplyReduction(
 
   std::vector<uint32_t> result;
   context->module()->ToBinary(&result, false);
+  attempt_context_ = std::move(context);
+  attempt_binary_ = result;
   return result;
 }
 
@@ -79,7 +90,14 @@ std::string ReductionPass::GetName() const { return finder_->GetName(); }
 void ReductionPass::NotifyInteresting(bool interesting) {
   if (!interesting) {
     index_ += granularity_;
+  } else if (attempt_context_) {
+    // The next call will most likely be given the binary of this attempt, so
+    // its module becomes the one to clone.
+    context_ = std::move(attempt_context_);
+    context_binary_ = std::move(attempt_binary_);
   }
+  attempt_context_.reset();
+  attempt_binary_.clear();
 }
 
 }  // namespace reduce
@@ -16,6 +16,8 @@
 #define SOURCE_REDUCE_REDUCTION_PASS_H_
 
 #include <limits>
+#include <memory>
+#include <vector>
 
 #include "source/opt/ir_context.h"
 #include "source/reduce/reduction_opportunity_finder.h"
@@ -78,6 +80,17 @@ class ReductionPass {
   MessageConsumer consumer_;
   uint32_t index_;
   uint32_t granularity_;
+
+  // The module that |context_binary_| was last built into, kept unmodified so
+  // that each attempt can start from a clone of it instead of re-parsing the
+  // binary.  Null if no module is cached.
+  std::unique_ptr<opt::IRContext> context_;
+  std::vector<uint32_t> context_binary_;
+
+  // The module and binary produced by the last attempt.  They replace
+  // |context_| and |context_binary_| if the attempt is interesting.
+  std::unique_ptr<opt::IRContext> attempt_context_;
+  std::vector<uint32_t> attempt_binary_;
 };
 
 }  // namespace reduce
@@ -48,6 +48,18 @@ bool spvParseUniversalLimitsOptions(const char* s, spv_validator_limit* type) {
   return true;
 }
 
+bool spvParseValidatorProfile(const char* s, spv_validator_profile* profile) {
+  if (!s) return false;
+  if (0 == strcmp(s, "full")) {
+    *profile = spv_validator_profile_full;
+  } else if (0 == strcmp(s, "structural")) {
+    *profile = spv_validator_profile_structural;
+  } else {
+    return false;
+  }
+  return true;
+}
+
 spv_validator_options spvValidatorOptionsCreate(void) {
   return new spv_validator_options_t;
 }
@@ -120,3 +132,12 @@ void spvValidatorOptionsSetSkipBlockLayout(spv_validator_options options,
                                            bool val) {
   options->skip_block_layout = val;
 }
+
+void spvValidatorOptionsSetParallel(spv_validator_options options, bool val) {
+  options->parallel = val;
+}
+
+void spvValidatorOptionsSetProfile(spv_validator_options options,
+                                   spv_validator_profile profile) {
+  options->profile = profile;
+}
@@ -21,6 +21,11 @@
 // returns the Enum for option in this case). Returns false otherwise.
 bool spvParseUniversalLimitsOptions(const char* s, spv_validator_limit* limit);
 
+// Returns true if |s| is the name of a validator profile, "full" or
+// "structural", and stores the profile in |profile| in that case.  Returns
+// false otherwise.
+bool spvParseValidatorProfile(const char* s, spv_validator_profile* profile);
+
 // Default initialization of this structure is to the default Universal Limits
 // described in the SPIR-V Spec.
 struct validator_universal_limits_t {
@@ -36,7 +41,8 @@ struct validator_universal_limits_t {
 };
 
 // Manages command line options passed to the SPIR-V Validator. New struct
-// members may be added for any new option.
+// members may be added for any new option.  Members which change the verdict
+// of the validator must also be added to the key of the ValidationCache.
 struct spv_validator_options_t {
   spv_validator_options_t()
       : universal_limits_(),
@@ -47,7 +53,9 @@ struct spv_validator_options_t {
         scalar_block_layout(false),
         workgroup_scalar_block_layout(false),
         skip_block_layout(false),
-        before_hlsl_legalization(false) {}
+        before_hlsl_legalization(false),
+        parallel(false),
+        profile(spv_validator_profile_full) {}
 
   validator_universal_limits_t universal_limits_;
   bool relax_struct_store;
@@ -58,6 +66,8 @@ struct spv_validator_options_t {
   bool workgroup_scalar_block_layout;
   bool skip_block_layout;
   bool before_hlsl_legalization;
+  bool parallel;
+  spv_validator_profile profile;
 };
 
 #endif  // SOURCE_SPIRV_VALIDATOR_OPTIONS_H_
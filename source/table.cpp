@@ -16,7 +16,27 @@
 
 #include <utility>
 
-spv_context spvContextCreate(spv_target_env env) {
+namespace {
+
+// Returns the hash of the |length| characters of |name| for the given |seed|.
+// This must match name_hash() in utils/generate_grammar_tables.py.
+uint32_t NameHash(uint32_t seed, const char* name, size_t length) {
+  uint32_t hash = 0x811c9dc5u ^ seed;
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(name[i])) * 0x01000193u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x7feb352du;
+  hash ^= hash >> 15;
+  return hash;
+}
+
+// The number of values of spv_target_env.  Must be updated when a target env
+// is added.
+const int kNumTargetEnvs = SPV_ENV_VULKAN_1_2 + 1;
+
+// Returns a new context for |env|, or nullptr if |env| is not supported.
+spv_context CreateContext(spv_target_env env) {
   switch (env) {
     case SPV_ENV_UNIVERSAL_1_0:
     case SPV_ENV_VULKAN_1_0:
@@ -58,9 +78,50 @@ spv_context spvContextCreate(spv_target_env env) {
                            nullptr /* a null default consumer */};
 }
 
+}  // namespace
+
+uint32_t spvNameIndexFind(const spv_name_index_t* index, const char* name,
+                          size_t length) {
+  if (index->count == 0) return ~0u;
+  const int32_t displacement =
+      index->displacements[NameHash(0, name, length) % index->count];
+  const uint32_t slot =
+      displacement < 0
+          ? static_cast<uint32_t>(-displacement - 1)
+          : NameHash(static_cast<uint32_t>(displacement), name, length) %
+                index->count;
+  return index->slots[slot];
+}
+
+uint32_t spvValueIndexFind(const spv_value_index_t* index, uint32_t value) {
+  if (value >= index->count || index->entries[value] == 0xffff) return ~0u;
+  return index->entries[value];
+}
+
+spv_context spvContextCreate(spv_target_env env) {
+  spv_const_context shared = spvtools::GetSharedContext(env);
+  if (!shared) return nullptr;
+  return new spv_context_t(*shared);
+}
+
 void spvContextDestroy(spv_context context) { delete context; }
 
 void spvtools::SetContextMessageConsumer(spv_context context,
                                          spvtools::MessageConsumer consumer) {
   context->consumer = std::move(consumer);
 }
+
+spv_const_context spvtools::GetSharedContext(spv_target_env env) {
+  // The contexts for all the target envs are created together on first use,
+  // and are never destroyed, so that they outlive every user.
+  static const spv_context* const contexts = []() {
+    spv_context* result = new spv_context[kNumTargetEnvs];
+    for (int i = 0; i < kNumTargetEnvs; ++i) {
+      result[i] = CreateContext(static_cast<spv_target_env>(i));
+    }
+    return result;
+  }();
+  const int index = static_cast<int>(env);
+  if (index < 0 || index >= kNumTargetEnvs) return nullptr;
+  return contexts[index];
+}
@@ -19,6 +19,27 @@
 #include "source/latest_version_spirv_header.h"
 #include "spirv-tools/libspirv.hpp"
 
+// A minimal perfect hash index over the names of the entries of a generated
+// table.  A name hashes to one of |count| buckets.  A negative displacement d
+// for the bucket means the name can only be in slot -d - 1.  Any other
+// displacement is the seed of a second hash of the name, which gives its slot.
+// Each slot holds the index of the one entry that can have the names hashing
+// to it.  See utils/generate_grammar_tables.py.
+typedef struct spv_name_index_t {
+  const uint32_t count;
+  const int32_t* displacements;
+  const uint16_t* slots;
+} spv_name_index_t;
+
+// A dense index over the values of the entries of a generated table, which
+// are sorted by value.  entries[v] is the index of the first entry with the
+// value v, or 0xffff if there is no such entry.  Values of at least |count|
+// have no entry.
+typedef struct spv_value_index_t {
+  const uint32_t count;
+  const uint16_t* entries;
+} spv_value_index_t;
+
 typedef struct spv_opcode_desc_t {
   const char* name;
   const SpvOp opcode;
@@ -67,6 +88,9 @@ typedef struct spv_operand_desc_group_t {
   const spv_operand_type_t type;
   const uint32_t count;
   const spv_operand_desc_t* entries;
+  const spv_name_index_t* name_index;
+  // Null if the values are too sparse for a dense index.
+  const spv_value_index_t* value_index;
 } spv_operand_desc_group_t;
 
 typedef struct spv_ext_inst_desc_t {
@@ -81,11 +105,15 @@ typedef struct spv_ext_inst_group_t {
   const spv_ext_inst_type_t type;
   const uint32_t count;
   const spv_ext_inst_desc_t* entries;
+  const spv_name_index_t* name_index;
+  const spv_value_index_t* value_index;
 } spv_ext_inst_group_t;
 
 typedef struct spv_opcode_table_t {
   const uint32_t count;
   const spv_opcode_desc_t* entries;
+  const spv_name_index_t* name_index;
+  const spv_value_index_t* value_index;
 } spv_opcode_table_t;
 
 typedef struct spv_operand_table_t {
@@ -119,8 +147,25 @@ namespace spvtools {
 // Sets the message consumer to |consumer| in the given |context|. The original
 // message consumer will be overwritten.
 void SetContextMessageConsumer(spv_context context, MessageConsumer consumer);
+
+// Returns the context for |env| that is shared by the whole process, or
+// nullptr if |env| is not supported.  The shared contexts are created on first
+// use, are never destroyed, and are safe to use from any thread.  They have no
+// message consumer, and must not be modified: to report messages, use a copy
+// with its consumer set.
+spv_const_context GetSharedContext(spv_target_env env);
 }  // namespace spvtools
 
+// Returns the index of the only entry of a table that can be named |name|,
+// which has |length| characters, or ~0u if the table is empty.  The caller
+// must check that the entry has that name.
+uint32_t spvNameIndexFind(const spv_name_index_t* index, const char* name,
+                          size_t length);
+
+// Returns the index of the first entry of a table with the given |value|, or
+// ~0u if there is none.
+uint32_t spvValueIndexFind(const spv_value_index_t* index, uint32_t value);
+
 // Populates *table with entries for env.
 spv_result_t spvOpcodeTableGet(spv_opcode_table* table, spv_target_env env);
 
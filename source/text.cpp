@@ -21,7 +21,6 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
-#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -223,6 +222,7 @@ spv_result_t spvTextEncodeOperand(const spvtools::AssemblyGrammar& grammar,
       }
       const uint32_t id = context->spvNamedIdAssignOrGet(textValue);
       if (type == SPV_OPERAND_TYPE_TYPE_ID) pInst->resultTypeId = id;
+      context->recordIdWord(pInst->words.size());
       spvInstructionAddWord(pInst, id);
 
       // Set the extended instruction type.
@@ -695,57 +695,60 @@ spv_result_t SetHeader(spv_target_env env, const uint32_t bound,
   return SPV_SUCCESS;
 }
 
-// Collects all numeric ids in the module source into |numeric_ids|.
-// This function is essentially a dry-run of spvTextToBinary.
-spv_result_t GetNumericIds(const spvtools::AssemblyGrammar& grammar,
-                           const spvtools::MessageConsumer& consumer,
-                           const spv_text text,
-                           std::set<uint32_t>* numeric_ids) {
-  spvtools::AssemblyContext context(text, consumer);
-
-  if (!text->str) return context.diagnostic() << "Missing assembly text.";
-
-  if (!grammar.isValid()) {
-    return SPV_ERROR_INVALID_TABLE;
-  }
-
-  // Skip past whitespace and comments.
-  context.advance();
-
-  while (context.hasText()) {
-    spv_instruction_t inst;
-
-    if (spvTextEncodeOpcode(grammar, &context, &inst)) {
-      return SPV_ERROR_INVALID_TEXT;
+// A buffer of words that grows as words are appended, and whose storage can
+// then be handed over to a spv_binary.
+class WordBuffer {
+ public:
+  WordBuffer() : capacity_(0), size_(0) {}
+
+  size_t size() const { return size_; }
+  uint32_t* data() { return data_.get(); }
+
+  // Appends the given |words|.
+  void Append(const std::vector<uint32_t>& words) {
+    if (size_ + words.size() > capacity_) {
+      const size_t capacity =
+          std::max(size_ + words.size(), std::max<size_t>(capacity_ * 2, 256));
+      std::unique_ptr<uint32_t[]> data(new uint32_t[capacity]);
+      if (size_) memcpy(data.get(), data_.get(), sizeof(uint32_t) * size_);
+      data_ = std::move(data);
+      capacity_ = capacity;
+    }
+    if (!words.empty()) {
+      memcpy(data_.get() + size_, words.data(),
+             sizeof(uint32_t) * words.size());
     }
+    size_ += words.size();
+  }
 
-    if (context.advance()) break;
+  // Returns the storage of the buffer, which must be deleted with delete[].
+  uint32_t* Release() {
+    capacity_ = size_ = 0;
+    return data_.release();
   }
 
-  *numeric_ids = context.GetNumericIds();
-  return SPV_SUCCESS;
-}
+ private:
+  std::unique_ptr<uint32_t[]> data_;
+  size_t capacity_;
+  size_t size_;
+};
 
 // Translates a given assembly language module into binary form.
 // If a diagnostic is generated, it is not yet marked as being
 // for a text-based input.
+//
+// The words of each instruction are appended to the output as soon as it is
+// assembled.  When numeric ids are preserved, the final values of the other
+// ids depend on numeric ids that may appear later in the text, so their words
+// are patched once the whole text has been read.
 spv_result_t spvTextToBinaryInternal(const spvtools::AssemblyGrammar& grammar,
                                      const spvtools::MessageConsumer& consumer,
                                      const spv_text text,
                                      const uint32_t options,
                                      spv_binary* pBinary) {
-  // The ids in this set will have the same values both in source and binary.
-  // All other ids will be generated by filling in the gaps.
-  std::set<uint32_t> ids_to_preserve;
-
-  if (options & SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS) {
-    // Collect all numeric ids from the source into ids_to_preserve.
-    const spv_result_t result =
-        GetNumericIds(grammar, consumer, text, &ids_to_preserve);
-    if (result != SPV_SUCCESS) return result;
-  }
-
-  spvtools::AssemblyContext context(text, consumer, std::move(ids_to_preserve));
+  spvtools::AssemblyContext context(
+      text, consumer,
+      (options & SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS) != 0);
 
   if (!text->str) return context.diagnostic() << "Missing assembly text.";
 
@@ -754,46 +757,40 @@ spv_result_t spvTextToBinaryInternal(const spvtools::AssemblyGrammar& grammar,
   }
   if (!pBinary) return SPV_ERROR_INVALID_POINTER;
 
-  std::vector<spv_instruction_t> instructions;
+  WordBuffer words;
+  // Reserve the header, which is filled in at the end.
+  words.Append(std::vector<uint32_t>(SPV_INDEX_INSTRUCTION, 0));
 
   // Skip past whitespace and comments.
   context.advance();
 
+  // The instruction being assembled.  It is reused so that its words keep
+  // their storage from one instruction to the next.
+  spv_instruction_t inst;
   while (context.hasText()) {
-    instructions.push_back({});
-    spv_instruction_t& inst = instructions.back();
+    inst.opcode = SpvOpNop;
+    inst.extInstType = SPV_EXT_INST_TYPE_NONE;
+    inst.resultTypeId = 0;
+    inst.words.clear();
+    context.setInstructionOffset(words.size());
 
     if (spvTextEncodeOpcode(grammar, &context, &inst)) {
       return SPV_ERROR_INVALID_TEXT;
     }
+    words.Append(inst.words);
 
     if (context.advance()) break;
   }
 
-  size_t totalSize = SPV_INDEX_INSTRUCTION;
-  for (auto& inst : instructions) {
-    totalSize += inst.words.size();
-  }
-
-  uint32_t* data = new uint32_t[totalSize];
-  if (!data) return SPV_ERROR_OUT_OF_MEMORY;
-  uint64_t currentIndex = SPV_INDEX_INSTRUCTION;
-  for (auto& inst : instructions) {
-    memcpy(data + currentIndex, inst.words.data(),
-           sizeof(uint32_t) * inst.words.size());
-    currentIndex += inst.words.size();
-  }
+  context.resolveIds(words.data());
 
-  if (auto error = SetHeader(grammar.target_env(), context.getBound(), data))
+  if (auto error =
+          SetHeader(grammar.target_env(), context.getBound(), words.data()))
     return error;
 
   spv_binary binary = new spv_binary_t();
-  if (!binary) {
-    delete[] data;
-    return SPV_ERROR_OUT_OF_MEMORY;
-  }
-  binary->code = data;
-  binary->wordCount = totalSize;
+  binary->wordCount = words.size();
+  binary->code = words.Release();
 
   *pBinary = binary;
 
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <tuple>
@@ -155,26 +156,27 @@ const IdType kUnknownType = {0, false, IdTypeClass::kBottom};
 // This represents all of the data that is only valid for the duration of
 // a single compilation.
 uint32_t AssemblyContext::spvNamedIdAssignOrGet(const char* textValue) {
-  if (!ids_to_preserve_.empty()) {
-    uint32_t id = 0;
-    if (spvtools::utils::ParseNumber(textValue, &id)) {
-      if (ids_to_preserve_.find(id) != ids_to_preserve_.end()) {
-        bound_ = std::max(bound_, id + 1);
-        return id;
-      }
+  if (preserve_numeric_ids_) {
+    // Numeric IDs are identified by their value, so that %5 and %05 are the
+    // same ID.
+    uint32_t value = 0;
+    if (spvtools::utils::ParseNumber(textValue, &value)) {
+      const auto it = numeric_ids_.find(value);
+      if (it != numeric_ids_.end()) return it->second;
+      const uint32_t id = next_id_++;
+      numeric_ids_.emplace(value, id);
+      provisional_ids_.resize(id + 1, ~0ull);
+      provisional_ids_[id] = value;
+      bound_ = std::max(bound_, id + 1);
+      return id;
     }
   }
 
   const auto it = named_ids_.find(textValue);
   if (it == named_ids_.end()) {
-    uint32_t id = next_id_++;
-    if (!ids_to_preserve_.empty()) {
-      while (ids_to_preserve_.find(id) != ids_to_preserve_.end()) {
-        id = next_id_++;
-      }
-    }
-
+    const uint32_t id = next_id_++;
     named_ids_.emplace(textValue, id);
+    if (preserve_numeric_ids_) provisional_ids_.resize(id + 1, ~0ull);
     bound_ = std::max(bound_, id + 1);
     return id;
   }
@@ -184,6 +186,45 @@ uint32_t AssemblyContext::spvNamedIdAssignOrGet(const char* textValue) {
 
 uint32_t AssemblyContext::getBound() const { return bound_; }
 
+void AssemblyContext::resolveIds(uint32_t* words) {
+  if (!preserve_numeric_ids_) return;
+
+  std::vector<uint32_t> preserved;
+  preserved.reserve(numeric_ids_.size());
+  for (const auto& value_and_id : numeric_ids_) {
+    preserved.push_back(value_and_id.first);
+  }
+  std::sort(preserved.begin(), preserved.end());
+
+  // The other IDs take the smallest values not used by a numeric ID, in the
+  // order they first appear in the text.
+  std::vector<uint32_t> final_ids(provisional_ids_.size(), 0);
+  auto next_preserved = preserved.begin();
+  uint32_t next_id = 1;
+  bound_ = 1;
+  for (size_t id = 1; id < provisional_ids_.size(); ++id) {
+    uint32_t final_id;
+    if (provisional_ids_[id] <= UINT32_MAX) {
+      final_id = static_cast<uint32_t>(provisional_ids_[id]);
+    } else {
+      while (next_preserved != preserved.end() && *next_preserved < next_id) {
+        ++next_preserved;
+      }
+      while (next_preserved != preserved.end() && *next_preserved == next_id) {
+        ++next_preserved;
+        ++next_id;
+      }
+      final_id = next_id++;
+    }
+    final_ids[id] = final_id;
+    bound_ = std::max(bound_, final_id + 1);
+  }
+
+  for (size_t offset : id_words_) {
+    words[offset] = final_ids[words[offset]];
+  }
+}
+
 spv_result_t AssemblyContext::advance() {
   return spvtools::advance(text_, &current_position_);
 }
@@ -385,13 +426,4 @@ spv_ext_inst_type_t AssemblyContext::getExtInstTypeForId(uint32_t id) const {
   return std::get<1>(*type);
 }
 
-std::set<uint32_t> AssemblyContext::GetNumericIds() const {
-  std::set<uint32_t> ids;
-  for (const auto& kv : named_ids_) {
-    uint32_t id;
-    if (spvtools::utils::ParseNumber(kv.first.c_str(), &id)) ids.insert(id);
-  }
-  return ids;
-}
-
 }  // namespace spvtools
@@ -16,12 +16,12 @@
 #define SOURCE_TEXT_HANDLER_H_
 
 #include <iomanip>
-#include <set>
 #include <sstream>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "source/diagnostic.h"
 #include "source/instruction.h"
@@ -120,14 +120,20 @@ class ClampToZeroIfUnsignedType<
 // Encapsulates the data used during the assembly of a SPIR-V module.
 class AssemblyContext {
  public:
+  // Creates a context for assembling |text|.  If |preserve_numeric_ids| is
+  // true, each numeric ID such as %12 keeps its value in the binary, and the
+  // other IDs fill in the gaps.  The numeric IDs are only all known at the end
+  // of the text, so in that mode spvNamedIdAssignOrGet returns provisional
+  // values, which resolveIds replaces with the final ones.
   AssemblyContext(spv_text text, const MessageConsumer& consumer,
-                  std::set<uint32_t>&& ids_to_preserve = std::set<uint32_t>())
+                  bool preserve_numeric_ids = false)
       : current_position_({}),
         consumer_(consumer),
         text_(text),
         bound_(1),
         next_id_(1),
-        ids_to_preserve_(std::move(ids_to_preserve)) {}
+        preserve_numeric_ids_(preserve_numeric_ids),
+        instruction_offset_(0) {}
 
   // Assigns a new integer value to the given text ID, or returns the previously
   // assigned integer value if the ID has been seen before.
@@ -136,6 +142,20 @@ class AssemblyContext {
   // Returns the largest largest numeric ID that has been assigned.
   uint32_t getBound() const;
 
+  // Sets the offset in the output binary of the instruction being assembled.
+  void setInstructionOffset(size_t offset) { instruction_offset_ = offset; }
+
+  // Records that the word at |index| in the instruction being assembled holds
+  // an ID returned by spvNamedIdAssignOrGet.
+  void recordIdWord(size_t index) {
+    if (preserve_numeric_ids_) id_words_.push_back(instruction_offset_ + index);
+  }
+
+  // Replaces the provisional IDs in the |words| of the output binary with
+  // their final values, and updates the bound to match.  Does nothing unless
+  // numeric IDs are preserved.
+  void resolveIds(uint32_t* words);
+
   // Advances position to point to the next word in the input stream.
   // Returns SPV_SUCCESS on success.
   spv_result_t advance();
@@ -233,11 +253,6 @@ class AssemblyContext {
   // id is not the id for an extended instruction type.
   spv_ext_inst_type_t getExtInstTypeForId(uint32_t id) const;
 
-  // Returns a set consisting of each ID generated by spvNamedIdAssignOrGet from
-  // a numeric ID text representation. For example, generated from "%12" but not
-  // from "%foo".
-  std::set<uint32_t> GetNumericIds() const;
-
  private:
   // Maps ID names to their corresponding numerical ids.
   using spv_named_id_table = std::unordered_map<std::string, uint32_t>;
@@ -247,6 +262,13 @@ class AssemblyContext {
   using spv_id_to_type_id = std::unordered_map<uint32_t, uint32_t>;
 
   spv_named_id_table named_ids_;
+  // When numeric IDs are preserved, maps the value of each numeric ID to its
+  // provisional ID.
+  std::unordered_map<uint32_t, uint32_t> numeric_ids_;
+  // When numeric IDs are preserved, the value of the numeric ID for each
+  // provisional ID, or a value above UINT32_MAX for the IDs that are not
+  // numeric.  Provisional IDs start at 1, so index 0 is unused.
+  std::vector<uint64_t> provisional_ids_;
   spv_id_to_type_map types_;
   spv_id_to_type_id value_types_;
   // Maps an extended instruction import Id to the extended instruction type.
@@ -256,7 +278,11 @@ class AssemblyContext {
   spv_text text_;
   uint32_t bound_;
   uint32_t next_id_;
-  std::set<uint32_t> ids_to_preserve_;
+  bool preserve_numeric_ids_;
+  // The offset in the output binary of the instruction being assembled.
+  size_t instruction_offset_;
+  // The offsets in the output binary of the words holding provisional IDs.
+  std::vector<size_t> id_words_;
 };
 
 }  // namespace spvtools
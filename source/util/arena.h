@@ -0,0 +1,122 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_ARENA_H_
+#define SOURCE_UTIL_ARENA_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A bump allocator for objects that all live as long as the arena.
+//
+// Memory is handed out from large blocks, and is only released, all at once,
+// when the arena is destroyed.  The destructors of the objects are never run,
+// so only trivially destructible types can be allocated.  This makes
+// allocating the many small arrays that describe a module a matter of moving a
+// pointer, instead of a call to the heap allocator each.
+class Arena {
+ public:
+  // Creates an arena whose first block has room for |initial_size| bytes.
+  // Each following block is twice as large as the one before it, up to
+  // kMaxBlockSize, or larger if needed for a single allocation.  No memory is
+  // allocated until the first allocation.
+  explicit Arena(size_t initial_size = kDefaultBlockSize)
+      : next_(nullptr),
+        end_(nullptr),
+        next_block_size_(initial_size < kMinBlockSize ? kMinBlockSize
+                                                      : initial_size),
+        capacity_(0) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Returns uninitialized storage for |count| objects of type |T|, or nullptr
+  // if |count| is 0.
+  template <class T>
+  T* Allocate(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "The destructors of arena objects are never run.");
+    if (count == 0) return nullptr;
+    return static_cast<T*>(AllocateBytes(sizeof(T) * count, alignof(T)));
+  }
+
+  // Returns a copy of the |count| objects at |data| made in the arena, or
+  // nullptr if |count| is 0.
+  template <class T>
+  T* Copy(const T* data, size_t count) {
+    T* copy = Allocate<T>(count);
+    std::uninitialized_copy(data, data + count, copy);
+    return copy;
+  }
+
+  // Returns |size| bytes of uninitialized storage aligned to |alignment|,
+  // which must be a power of 2 no larger than the alignment of the fundamental
+  // types.
+  void* AllocateBytes(size_t size, size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    uintptr_t start = AlignUp(reinterpret_cast<uintptr_t>(next_), alignment);
+    if (next_ == nullptr || start + size > reinterpret_cast<uintptr_t>(end_)) {
+      AddBlock(size + alignment);
+      start = AlignUp(reinterpret_cast<uintptr_t>(next_), alignment);
+    }
+    next_ = reinterpret_cast<char*>(start + size);
+    return reinterpret_cast<void*>(start);
+  }
+
+  // Returns the number of bytes in all the blocks of the arena.
+  size_t capacity() const { return capacity_; }
+
+  static const size_t kDefaultBlockSize = 4096;
+  static const size_t kMinBlockSize = 256;
+  static const size_t kMaxBlockSize = 1024 * 1024;
+
+ private:
+  static uintptr_t AlignUp(uintptr_t address, size_t alignment) {
+    return (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  }
+
+  // Replaces the current block by a new one of at least |min_size| bytes.
+  // The rest of the current block is left unused.
+  void AddBlock(size_t min_size) {
+    const size_t size = std::max(next_block_size_, min_size);
+    blocks_.emplace_back(new char[size]);
+    next_ = blocks_.back().get();
+    end_ = next_ + size;
+    capacity_ += size;
+    next_block_size_ = next_block_size_ < kMaxBlockSize / 2
+                           ? next_block_size_ * 2
+                           : kMaxBlockSize;
+  }
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // The free part of the current block.
+  char* next_;
+  char* end_;
+  // The size of the next block to allocate.
+  size_t next_block_size_;
+  size_t capacity_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_ARENA_H_
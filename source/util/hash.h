@@ -0,0 +1,93 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_HASH_H_
+#define SOURCE_UTIL_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace spvtools {
+namespace utils {
+
+// Fast 64-bit non-cryptographic hashes, for finding data that did not change.
+// They must not be relied on for data crafted to collide.
+
+namespace hash_internal {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+
+inline uint64_t RotateLeft(uint64_t x, int bits) {
+  return (x << bits) | (x >> (64 - bits));
+}
+
+// Scrambles the bits of |h| so that each input bit affects all output bits.
+inline uint64_t Avalanche(uint64_t h) {
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
+}
+
+}  // namespace hash_internal
+
+// Returns a hash of the |count| words of |words|, seeded with |seed|.  The
+// words are consumed in four independent lanes of two words each, so that the
+// multiplications of consecutive words do not wait on one another.
+inline uint64_t HashWords(const uint32_t* words, size_t count,
+                          uint64_t seed = 0) {
+  using namespace hash_internal;
+  uint64_t lanes[4] = {seed + kPrime1 + kPrime2, seed + kPrime2, seed,
+                       seed - kPrime1};
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    for (int lane = 0; lane < 4; ++lane) {
+      const uint64_t input = uint64_t(words[i + 2 * lane]) |
+                             uint64_t(words[i + 2 * lane + 1]) << 32;
+      lanes[lane] = RotateLeft(lanes[lane] + input * kPrime2, 31) * kPrime1;
+    }
+  }
+  uint64_t h = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) +
+               RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18) +
+               uint64_t(count);
+  for (; i < count; ++i) {
+    h = RotateLeft(h ^ (words[i] * kPrime1), 23) * kPrime2 + kPrime3;
+  }
+  return Avalanche(h);
+}
+
+// Returns |hash| with |value| mixed into it.  Use this to build a hash value
+// from the hash values of its parts.
+inline uint64_t HashCombine(uint64_t hash, uint64_t value) {
+  using namespace hash_internal;
+  return RotateLeft(hash ^ (value * kPrime2), 29) * kPrime1 + kPrime3;
+}
+
+// Returns a hash of the |count| bytes of |bytes|, seeded with |seed|.
+inline uint64_t HashBytes(const char* bytes, size_t count, uint64_t seed = 0) {
+  uint64_t h = seed ^ 0xCBF29CE484222325ULL;
+  for (size_t i = 0; i < count; ++i) {
+    h = (h ^ static_cast<unsigned char>(bytes[i])) * 0x100000001B3ULL;
+  }
+  return hash_internal::Avalanche(h);
+}
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_HASH_H_
@@ -0,0 +1,141 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_ID_MAP_H_
+#define SOURCE_UTIL_ID_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// Maps ids to values of type |T|.
+//
+// Ids are dense in most modules, so the values of the ids below the dense size
+// are kept in a vector indexed by id, which is allocated once.  The values of
+// larger ids, which only occur in modules with a sparse or invalid id space,
+// are kept in an ordered map.  An id maps to a value-initialized |T| until it
+// is assigned something else, and such ids are skipped when iterating.
+// Iteration visits the ids in increasing order.
+template <typename T>
+class IdMap {
+ public:
+  using value_type = std::pair<uint32_t, const T&>;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = IdMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    value_type operator*() const {
+      if (index_ < map_->dense_.size()) {
+        return value_type(index_, map_->dense_[index_]);
+      }
+      return value_type(sparse_->first, sparse_->second);
+    }
+
+    const_iterator& operator++() {
+      Advance();
+      SkipEmpty();
+      return *this;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return index_ == other.index_ && sparse_ == other.sparse_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class IdMap;
+
+    using SparseIterator = typename std::map<uint32_t, T>::const_iterator;
+
+    const_iterator(const IdMap* map, uint32_t index, SparseIterator sparse)
+        : map_(map), index_(index), sparse_(sparse) {}
+
+    void Advance() {
+      if (index_ < map_->dense_.size()) {
+        ++index_;
+      } else {
+        ++sparse_;
+      }
+    }
+
+    // Moves past the ids that map to the empty value.
+    void SkipEmpty() {
+      while (*this != map_->end() && (**this).second == map_->empty_) {
+        Advance();
+      }
+    }
+
+    const IdMap* map_;
+    // The id in the vector, or the size of the vector once past its end.
+    uint32_t index_;
+    // The entry of the map, once past the end of the vector.
+    SparseIterator sparse_;
+  };
+
+  // Creates a map that keeps the ids below |dense_size| in a vector.
+  explicit IdMap(uint32_t dense_size = 0) : dense_(dense_size), empty_() {}
+
+  // Discards all the values, and keeps the ids below |dense_size| in a vector
+  // from now on.
+  void Reset(uint32_t dense_size) {
+    dense_.assign(dense_size, T());
+    sparse_.clear();
+  }
+
+  // Returns the value of |id| for modification.
+  T& operator[](uint32_t id) {
+    if (id < dense_.size()) return dense_[id];
+    return sparse_[id];
+  }
+
+  // Returns the value of |id|, or the empty value if it was never assigned.
+  const T& Get(uint32_t id) const {
+    if (id < dense_.size()) return dense_[id];
+    const auto it = sparse_.find(id);
+    return it == sparse_.end() ? empty_ : it->second;
+  }
+
+  const_iterator begin() const {
+    const_iterator it(this, 0, sparse_.begin());
+    it.SkipEmpty();
+    return it;
+  }
+  const_iterator end() const {
+    return const_iterator(this, static_cast<uint32_t>(dense_.size()),
+                          sparse_.end());
+  }
+
+ private:
+  std::vector<T> dense_;
+  std::map<uint32_t, T> sparse_;
+  T empty_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_ID_MAP_H_
@@ -21,6 +21,38 @@
 namespace spvtools {
 namespace utils {
 
+void AppendUnsigned(uint64_t value, std::string* out) {
+  char digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  while (count) out->push_back(digits[--count]);
+}
+
+void AppendSigned(int64_t value, std::string* out) {
+  if (value < 0) {
+    out->push_back('-');
+    // Negate in unsigned arithmetic, so the most negative value works too.
+    AppendUnsigned(0 - static_cast<uint64_t>(value), out);
+  } else {
+    AppendUnsigned(static_cast<uint64_t>(value), out);
+  }
+}
+
+void AppendHex(uint64_t value, size_t min_digits, std::string* out) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  char digits[16];
+  size_t count = 0;
+  do {
+    digits[count++] = kHexDigits[value & 0xf];
+    value >>= 4;
+  } while (value);
+  if (min_digits > count) out->append(min_digits - count, '0');
+  while (count) out->push_back(digits[--count]);
+}
+
 std::string CardinalToOrdinal(size_t cardinal) {
   const size_t mod10 = cardinal % 10;
   const size_t mod100 = cardinal % 100;
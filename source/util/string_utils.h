@@ -16,6 +16,7 @@
 #define SOURCE_UTIL_STRING_UTILS_H_
 
 #include <assert.h>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -36,6 +37,15 @@ std::string ToString(T val) {
   return os.str();
 }
 
+// Appends the decimal representation of |value| to |out|.  The text is the
+// same as for ToString, but no stream or locale is involved.
+void AppendUnsigned(uint64_t value, std::string* out);
+void AppendSigned(int64_t value, std::string* out);
+
+// Appends the lower case hexadecimal representation of |value| to |out|,
+// padded with leading zeros to at least |min_digits| digits.
+void AppendHex(uint64_t value, size_t min_digits, std::string* out);
+
 // Converts cardinal number to ordinal number string.
 std::string CardinalToOrdinal(size_t cardinal);
 
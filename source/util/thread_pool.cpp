@@ -0,0 +1,136 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/util/thread_pool.h"
+
+#include <utility>
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+// The pool the current thread is a worker of, if any, and its index in that
+// pool.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local uint32_t current_worker = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(uint32_t num_threads)
+    : num_queued_(0), num_unfinished_(0), next_queue_(0), stopping_(false) {
+  if (num_threads == 0) num_threads = DefaultNumThreads();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    queues_.emplace_back(new WorkQueue());
+  }
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_queued_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+uint32_t ThreadPool::DefaultNumThreads() {
+  const uint32_t hardware_threads = std::thread::hardware_concurrency();
+  return hardware_threads == 0 ? 1 : hardware_threads;
+}
+
+void ThreadPool::Submit(Task task) {
+  uint32_t index;
+  if (current_pool == this) {
+    index = current_worker;
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index = next_queue_;
+    next_queue_ = (next_queue_ + 1) % num_threads();
+  }
+
+  {
+    WorkQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  // The task is counted only once it is in a queue, so a worker that claims
+  // it is guaranteed to find it.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_queued_;
+    ++num_unfinished_;
+  }
+  task_queued_.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  all_done_.wait(lock, [this]() { return num_unfinished_ == 0; });
+}
+
+bool ThreadPool::TakeTask(uint32_t index, Task* task) {
+  {
+    WorkQueue& own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      *task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (uint32_t i = 1; i < num_threads(); ++i) {
+    WorkQueue& victim = *queues_[(index + i) % num_threads()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(uint32_t index) {
+  current_pool = this;
+  current_worker = index;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_queued_.wait(lock,
+                        [this]() { return stopping_ || num_queued_ != 0; });
+      if (num_queued_ == 0) return;
+      // Claim one of the queued tasks.  Every claim matches a task that is in
+      // some queue, so the task is found below, even if another worker
+      // takes the particular one we would have found first.
+      --num_queued_;
+    }
+
+    Task task;
+    while (!TakeTask(index, &task)) std::this_thread::yield();
+    task();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_unfinished_ == 0) all_done_.notify_all();
+  }
+}
+
+}  // namespace utils
+}  // namespace spvtools
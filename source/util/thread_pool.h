@@ -0,0 +1,104 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SOURCE_UTIL_THREAD_POOL_H_
+#define SOURCE_UTIL_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spvtools {
+namespace utils {
+
+// A fixed-size pool of worker threads that run submitted tasks.
+//
+// Each worker owns a queue of tasks.  Tasks submitted from outside the pool
+// are distributed over the queues in a round-robin fashion, and tasks
+// submitted by a running task go to the queue of the worker running it.  A
+// worker takes tasks from the back of its own queue, and when that queue is
+// empty it steals from the front of the queues of the other workers, so that
+// uneven tasks still keep all the workers busy.
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  // Creates a pool with |num_threads| worker threads.  If |num_threads| is 0,
+  // the pool has one worker per hardware thread.
+  explicit ThreadPool(uint32_t num_threads);
+
+  // Waits for all the submitted tasks to finish, and stops the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Returns the number of worker threads.
+  uint32_t num_threads() const {
+    return static_cast<uint32_t>(threads_.size());
+  }
+
+  // Queues |task| to be run by one of the workers.
+  void Submit(Task task);
+
+  // Blocks until all the tasks submitted so far have finished.  Must not be
+  // called from a task run by this pool.
+  void Wait();
+
+  // Returns the number of threads used for a requested count of 0.
+  static uint32_t DefaultNumThreads();
+
+ private:
+  // The queue of tasks owned by one worker.
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  // Runs tasks on behalf of the worker at |index| until the pool is stopped.
+  void WorkerLoop(uint32_t index);
+
+  // Removes a task from the queue of the worker at |index|, or steals one
+  // from another worker.  Returns false if all the queues are empty.
+  bool TakeTask(uint32_t index, Task* task);
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  // Guards the counters below.
+  std::mutex mutex_;
+  // Signaled when a task is queued or the pool is stopping.
+  std::condition_variable task_queued_;
+  // Signaled when the last unfinished task finishes.
+  std::condition_variable all_done_;
+  // The number of tasks in the queues that no worker has claimed yet.
+  size_t num_queued_;
+  // The number of submitted tasks that have not finished running.
+  size_t num_unfinished_;
+  // The queue that receives the next task submitted from outside the pool.
+  uint32_t next_queue_;
+  // True when the workers should exit once the queues are empty.
+  bool stopping_;
+};
+
+}  // namespace utils
+}  // namespace spvtools
+
+#endif  // SOURCE_UTIL_THREAD_POOL_H_
@@ -25,6 +25,12 @@ BasicBlock::BasicBlock(uint32_t label_id)
     : id_(label_id),
       immediate_dominator_(nullptr),
       immediate_post_dominator_(nullptr),
+      dom_root_(nullptr),
+      dom_pre_(0),
+      dom_post_(0),
+      pdom_root_(nullptr),
+      pdom_pre_(0),
+      pdom_post_(0),
       predecessors_(),
       successors_(),
       type_(0),
@@ -40,6 +46,20 @@ void BasicBlock::SetImmediatePostDominator(BasicBlock* pdom_block) {
   immediate_post_dominator_ = pdom_block;
 }
 
+void BasicBlock::SetDominatorTreeNumbers(const BasicBlock* root, uint32_t pre,
+                                         uint32_t post) {
+  dom_root_ = root;
+  dom_pre_ = pre;
+  dom_post_ = post;
+}
+
+void BasicBlock::SetPostDominatorTreeNumbers(const BasicBlock* root,
+                                             uint32_t pre, uint32_t post) {
+  pdom_root_ = root;
+  pdom_pre_ = pre;
+  pdom_post_ = post;
+}
+
 const BasicBlock* BasicBlock::immediate_dominator() const {
   return immediate_dominator_;
 }
@@ -62,14 +82,26 @@ void BasicBlock::RegisterSuccessors(
 }
 
 bool BasicBlock::dominates(const BasicBlock& other) const {
-  return (this == &other) ||
-         !(other.dom_end() ==
+  if (this == &other) return true;
+  // A block dominates the blocks in its subtree of the dominator tree, which
+  // are the ones numbered after it in pre-order and before it in post-order.
+  // The numbers of different trees are unrelated, and no block of one tree
+  // dominates a block of another.
+  if (dom_root_ && other.dom_root_) {
+    return dom_root_ == other.dom_root_ && dom_pre_ < other.dom_pre_ &&
+           dom_post_ > other.dom_post_;
+  }
+  return !(other.dom_end() ==
            std::find(other.dom_begin(), other.dom_end(), this));
 }
 
 bool BasicBlock::postdominates(const BasicBlock& other) const {
-  return (this == &other) ||
-         !(other.pdom_end() ==
+  if (this == &other) return true;
+  if (pdom_root_ && other.pdom_root_) {
+    return pdom_root_ == other.pdom_root_ && pdom_pre_ < other.pdom_pre_ &&
+           pdom_post_ > other.pdom_post_;
+  }
+  return !(other.pdom_end() ==
            std::find(other.pdom_begin(), other.pdom_end(), this));
 }
 
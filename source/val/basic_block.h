@@ -106,6 +106,28 @@ class BasicBlock {
   /// Returns the immedate post dominator of this basic block
   const BasicBlock* immediate_post_dominator() const;
 
+  /// Sets the numbers of this block in a depth-first walk of the dominator
+  /// tree.  Once set, dominates() compares these numbers instead of walking
+  /// the dominator chain, so they must be set for all the blocks of the tree
+  /// after the immediate dominators are final.  Each tree is numbered on its
+  /// own, so blocks whose trees have different roots, such as the blocks of
+  /// two functions, never dominate each other.
+  ///
+  /// @param[in] root The root of the dominator tree that holds the block
+  /// @param[in] pre  The pre-order number of the block, starting from 1
+  /// @param[in] post The post-order number of the block, starting from 1
+  void SetDominatorTreeNumbers(const BasicBlock* root, uint32_t pre,
+                               uint32_t post);
+
+  /// Sets the numbers of this block in a depth-first walk of the post
+  /// dominator tree, for postdominates().  See SetDominatorTreeNumbers.
+  ///
+  /// @param[in] root The root of the post dominator tree that holds the block
+  /// @param[in] pre  The pre-order number of the block, starting from 1
+  /// @param[in] post The post-order number of the block, starting from 1
+  void SetPostDominatorTreeNumbers(const BasicBlock* root, uint32_t pre,
+                                   uint32_t post);
+
   /// Returns the label instruction for the block, or nullptr if not set.
   const Instruction* label() const { return label_; }
 
@@ -214,6 +236,18 @@ class BasicBlock {
   /// Pointer to the immediate dominator of the BasicBlock
   BasicBlock* immediate_post_dominator_;
 
+  /// The root of the dominator tree, and the pre-order and post-order numbers
+  /// of the BasicBlock in it, or null and 0 if they have not been set
+  const BasicBlock* dom_root_;
+  uint32_t dom_pre_;
+  uint32_t dom_post_;
+
+  /// The root of the post dominator tree, and the pre-order and post-order
+  /// numbers of the BasicBlock in it, or null and 0 if they have not been set
+  const BasicBlock* pdom_root_;
+  uint32_t pdom_pre_;
+  uint32_t pdom_post_;
+
   /// The set of predecessors of the BasicBlock
   std::vector<BasicBlock*> predecessors_;
 
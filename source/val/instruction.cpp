@@ -14,20 +14,31 @@
 
 #include "source/val/instruction.h"
 
+#include <memory>
+#include <new>
 #include <utility>
 
 namespace spvtools {
 namespace val {
 
-Instruction::Instruction(const spv_parsed_instruction_t* inst)
-    : words_(inst->words, inst->words + inst->num_words),
-      operands_(inst->operands, inst->operands + inst->num_operands),
-      inst_({words_.data(), inst->num_words, inst->opcode, inst->ext_inst_type,
-             inst->type_id, inst->result_id, operands_.data(),
-             inst->num_operands}) {}
+Instruction::Instruction(const spv_parsed_instruction_t* inst,
+                         const uint32_t* words,
+                         const spv_parsed_operand_t* operands)
+    : inst_({words, inst->num_words, inst->opcode, inst->ext_inst_type,
+             inst->type_id, inst->result_id, operands, inst->num_operands}) {}
 
-void Instruction::RegisterUse(const Instruction* inst, uint32_t index) {
-  uses_.push_back(std::make_pair(inst, index));
+void Instruction::RegisterUse(const Instruction* inst, uint32_t index,
+                              utils::Arena* arena) {
+  if (num_uses_ == uses_capacity_) {
+    // Most ids have only a few uses.  The array that is outgrown is left in
+    // the arena.
+    const uint32_t capacity = uses_capacity_ == 0 ? 4 : 2 * uses_capacity_;
+    Use* uses = arena->Allocate<Use>(capacity);
+    std::uninitialized_copy(uses_, uses_ + num_uses_, uses);
+    uses_ = uses;
+    uses_capacity_ = capacity;
+  }
+  new (&uses_[num_uses_++]) Use(inst, index);
 }
 
 bool operator<(const Instruction& lhs, const Instruction& rhs) {
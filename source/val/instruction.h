@@ -23,6 +23,8 @@
 
 #include "source/ext_inst.h"
 #include "source/table.h"
+#include "source/util/arena.h"
+#include "source/util/span.h"
 #include "spirv-tools/libspirv.h"
 
 namespace spvtools {
@@ -32,13 +34,24 @@ class BasicBlock;
 class Function;
 
 /// Wraps the spv_parsed_instruction struct along with use and definition of the
-/// instruction's result id
+/// instruction's result id.
+///
+/// The instruction does not own its words, operands, or uses.  They are kept
+/// by the validation state, either in the input binary or in an arena.
 class Instruction {
  public:
-  explicit Instruction(const spv_parsed_instruction_t* inst);
+  using Use = std::pair<const Instruction*, uint32_t>;
 
-  /// Registers the use of the Instruction in instruction \p inst at \p index
-  void RegisterUse(const Instruction* inst, uint32_t index);
+  /// Creates an instruction for |inst|, whose words and operands are
+  /// |words| and |operands| instead of those of |inst|, which may not live as
+  /// long.  |words| and |operands| must outlive the instruction.
+  Instruction(const spv_parsed_instruction_t* inst, const uint32_t* words,
+              const spv_parsed_operand_t* operands);
+
+  /// Registers the use of the Instruction in instruction \p inst at \p index.
+  /// The list of uses grows in \p arena.
+  void RegisterUse(const Instruction* inst, uint32_t index,
+                   utils::Arena* arena);
 
   uint32_t id() const { return inst_.result_id; }
   uint32_t type_id() const { return inst_.type_id; }
@@ -54,28 +67,33 @@ class Instruction {
   const BasicBlock* block() const { return block_; }
   void set_block(BasicBlock* b) { block_ = b; }
 
-  /// Returns a vector of pairs of all references to this instruction's result
-  /// id. The first element is the instruction in which this result id was
-  /// referenced and the second is the index of the word in that instruction
-  /// where this result id appeared
-  const std::vector<std::pair<const Instruction*, uint32_t>>& uses() const {
-    return uses_;
-  }
+  /// Returns pairs of all references to this instruction's result id. The
+  /// first element is the instruction in which this result id was referenced
+  /// and the second is the index of the word in that instruction where this
+  /// result id appeared
+  utils::Span<Use> uses() const { return utils::Span<Use>(uses_, num_uses_); }
 
   /// The word used to define the Instruction
-  uint32_t word(size_t index) const { return words_[index]; }
+  uint32_t word(size_t index) const {
+    assert(index < inst_.num_words);
+    return inst_.words[index];
+  }
 
   /// The words used to define the Instruction
-  const std::vector<uint32_t>& words() const { return words_; }
+  utils::Span<uint32_t> words() const {
+    return utils::Span<uint32_t>(inst_.words, inst_.num_words);
+  }
 
   /// Returns the operand at |idx|.
   const spv_parsed_operand_t& operand(size_t idx) const {
-    return operands_[idx];
+    assert(idx < inst_.num_operands);
+    return inst_.operands[idx];
   }
 
   /// The operands of the Instruction
-  const std::vector<spv_parsed_operand_t>& operands() const {
-    return operands_;
+  utils::Span<spv_parsed_operand_t> operands() const {
+    return utils::Span<spv_parsed_operand_t>(inst_.operands,
+                                             inst_.num_operands);
   }
 
   /// Provides direct access to the stored C instruction object.
@@ -100,18 +118,16 @@ class Instruction {
   // Casts the words belonging to the operand under |index| to |T| and returns.
   template <typename T>
   T GetOperandAs(size_t index) const {
-    const spv_parsed_operand_t& o = operands_.at(index);
+    const spv_parsed_operand_t& o = operand(index);
     assert(o.num_words * 4 >= sizeof(T));
     assert(o.offset + o.num_words <= inst_.num_words);
-    return *reinterpret_cast<const T*>(&words_[o.offset]);
+    return *reinterpret_cast<const T*>(&inst_.words[o.offset]);
   }
 
   size_t LineNum() const { return line_num_; }
   void SetLineNum(size_t pos) { line_num_ = pos; }
 
  private:
-  const std::vector<uint32_t> words_;
-  const std::vector<spv_parsed_operand_t> operands_;
   spv_parsed_instruction_t inst_;
   size_t line_num_ = 0;
 
@@ -121,11 +137,14 @@ class Instruction {
   /// The basic block in which this instruction was declared
   BasicBlock* block_ = nullptr;
 
-  /// This is a vector of pairs of all references to this instruction's result
+  /// This is an array of pairs of all references to this instruction's result
   /// id. The first element is the instruction in which this result id was
   /// referenced and the second is the index of the word in the referencing
-  /// instruction where this instruction appeared
-  std::vector<std::pair<const Instruction*, uint32_t>> uses_;
+  /// instruction where this instruction appeared.  It is allocated in an
+  /// arena, with room for |uses_capacity_| uses.
+  Use* uses_ = nullptr;
+  uint32_t num_uses_ = 0;
+  uint32_t uses_capacity_ = 0;
 };
 
 bool operator<(const Instruction& lhs, const Instruction& rhs);
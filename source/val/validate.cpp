@@ -15,6 +15,7 @@
 #include "source/val/validate.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdio>
 #include <functional>
@@ -22,6 +23,8 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "source/binary.h"
@@ -35,6 +38,8 @@
 #include "source/spirv_endian.h"
 #include "source/spirv_target_env.h"
 #include "source/spirv_validator_options.h"
+#include "source/util/hash.h"
+#include "source/util/thread_pool.h"
 #include "source/val/construct.h"
 #include "source/val/function.h"
 #include "source/val/instruction.h"
@@ -120,7 +125,6 @@ spv_result_t ValidateForwardDecls(ValidationState_t& _) {
 //
 // Additionally enforces that entry points for Vulkan should not have recursion.
 spv_result_t ValidateEntryPoints(ValidationState_t& _) {
-  _.ComputeFunctionToEntryPointMapping();
   _.ComputeRecursiveEntryPoints();
 
   if (_.entry_points().empty() && !_.HasCapability(SpvCapabilityLinkage)) {
@@ -152,6 +156,49 @@ spv_result_t ValidateEntryPoints(ValidationState_t& _) {
   return SPV_SUCCESS;
 }
 
+// The minimum total size of the functions that CheckFunctionsInOrder checks
+// as a single task.  The sizes are counted in instructions.
+const size_t kMinParallelRangeSize = 1024;
+
+// Runs ValidateInstruction and BuiltInsPass on all the instructions of the
+// module, except those of unchanged functions.  The instructions before the
+// first function are checked in order first, since their checks register
+// state that the checks of the functions rely on.  The functions are then
+// checked by CheckFunctionsInOrder.
+spv_result_t ValidateInstructionsInParallel(ValidationState_t& _,
+                                            BuiltInsState* built_ins) {
+  const std::vector<Instruction>& instructions = _.ordered_instructions();
+  const auto function_ranges = GetFunctionInstructionRanges(_);
+  const size_t first_function =
+      function_ranges.empty() ? instructions.size() : function_ranges[0].first;
+  for (size_t i = 0; i < first_function; ++i) {
+    if (auto error = ValidateInstruction(_, &instructions[i])) return error;
+    if (auto error = BuiltInsPass(_, built_ins, &instructions[i])) return error;
+  }
+
+  std::vector<size_t> function_sizes;
+  for (const auto& range : function_ranges) {
+    // The OpFunction instruction is not in the body of its function.
+    const bool unchanged =
+        range.second - range.first > 1 &&
+        _.IsInUnchangedFunction(&instructions[range.first + 1]);
+    function_sizes.push_back(unchanged ? 0 : range.second - range.first);
+  }
+  return CheckFunctionsInOrder(
+      _, function_sizes,
+      [&_, built_ins, &instructions, &function_ranges](size_t f) {
+        for (size_t i = function_ranges[f].first;
+             i < function_ranges[f].second; ++i) {
+          if (_.IsInUnchangedFunction(&instructions[i])) continue;
+          if (auto error = ValidateInstruction(_, &instructions[i]))
+            return error;
+          if (auto error = BuiltInsPass(_, built_ins, &instructions[i]))
+            return error;
+        }
+        return SPV_SUCCESS;
+      });
+}
+
 spv_result_t ValidateBinaryUsingContextAndValidationState(
     const spv_context_t& context, const uint32_t* words, const size_t num_words,
     spv_diagnostic* pDiagnostic, ValidationState_t* vstate) {
@@ -316,38 +363,24 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
     if (auto error = UpdateIdUse(*vstate, &instruction)) return error;
   }
 
-  // Validate individual opcodes.
-  for (size_t i = 0; i < vstate->ordered_instructions().size(); ++i) {
-    auto& instruction = vstate->ordered_instructions()[i];
-
-    // Keep these passes in the order they appear in the SPIR-V specification
-    // sections to maintain test consistency.
-    if (auto error = MiscPass(*vstate, &instruction)) return error;
-    if (auto error = DebugPass(*vstate, &instruction)) return error;
-    if (auto error = AnnotationPass(*vstate, &instruction)) return error;
-    if (auto error = ExtensionPass(*vstate, &instruction)) return error;
-    if (auto error = ModeSettingPass(*vstate, &instruction)) return error;
-    if (auto error = TypePass(*vstate, &instruction)) return error;
-    if (auto error = ConstantPass(*vstate, &instruction)) return error;
-    if (auto error = MemoryPass(*vstate, &instruction)) return error;
-    if (auto error = FunctionPass(*vstate, &instruction)) return error;
-    if (auto error = ImagePass(*vstate, &instruction)) return error;
-    if (auto error = ConversionPass(*vstate, &instruction)) return error;
-    if (auto error = CompositesPass(*vstate, &instruction)) return error;
-    if (auto error = ArithmeticsPass(*vstate, &instruction)) return error;
-    if (auto error = BitwisePass(*vstate, &instruction)) return error;
-    if (auto error = LogicalsPass(*vstate, &instruction)) return error;
-    if (auto error = ControlFlowPass(*vstate, &instruction)) return error;
-    if (auto error = DerivativesPass(*vstate, &instruction)) return error;
-    if (auto error = AtomicsPass(*vstate, &instruction)) return error;
-    if (auto error = PrimitivesPass(*vstate, &instruction)) return error;
-    if (auto error = BarriersPass(*vstate, &instruction)) return error;
-    // Group
-    // Device-Side Enqueue
-    // Pipe
-    if (auto error = NonUniformPass(*vstate, &instruction)) return error;
-
-    if (auto error = LiteralsPass(*vstate, &instruction)) return error;
+  // Validate individual opcodes, and the built-in variables they define or
+  // reference.  The built-in checks need the execution models with which each
+  // function can be called.  Only the full profile checks built-ins.
+  vstate->ComputeFunctionToEntryPointMapping();
+  std::unique_ptr<BuiltInsState> built_ins;
+  if (vstate->options()->profile == spv_validator_profile_full) {
+    built_ins.reset(new BuiltInsState(*vstate));
+  }
+  if (vstate->options()->parallel) {
+    if (auto error = ValidateInstructionsInParallel(*vstate, built_ins.get()))
+      return error;
+  } else {
+    for (const auto& instruction : vstate->ordered_instructions()) {
+      if (vstate->IsInUnchangedFunction(&instruction)) continue;
+      if (auto error = ValidateInstruction(*vstate, &instruction)) return error;
+      if (auto error = BuiltInsPass(*vstate, built_ins.get(), &instruction))
+        return error;
+    }
   }
 
   // Validate the preconditions involving adjacent instructions. e.g. SpvOpPhi
@@ -361,9 +394,6 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
   if (auto error = CheckIdDefinitionDominateUse(*vstate)) return error;
   if (auto error = ValidateDecorations(*vstate)) return error;
   if (auto error = ValidateInterfaces(*vstate)) return error;
-  // TODO(dsinclair): Restructure ValidateBuiltins so we can move into the
-  // for() above as it loops over all ordered_instructions internally.
-  if (auto error = ValidateBuiltIns(*vstate)) return error;
   // These checks must be performed after individual opcode checks because
   // those checks register the limitation checked here.
   for (const auto& inst : vstate->ordered_instructions()) {
@@ -376,6 +406,81 @@ spv_result_t ValidateBinaryUsingContextAndValidationState(
 
 }  // namespace
 
+std::vector<std::pair<size_t, size_t>> GetFunctionInstructionRanges(
+    const ValidationState_t& _) {
+  const std::vector<Instruction>& instructions = _.ordered_instructions();
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    if (instructions[i].opcode() == SpvOpFunction) {
+      ranges.emplace_back(i, instructions.size());
+    } else if (instructions[i].opcode() == SpvOpFunctionEnd &&
+               !ranges.empty()) {
+      ranges.back().second = i + 1;
+    }
+  }
+  return ranges;
+}
+
+spv_result_t CheckFunctionsInOrder(
+    ValidationState_t& _, const std::vector<size_t>& function_sizes,
+    const std::function<spv_result_t(size_t)>& check) {
+  // The index of the first function of each task.
+  std::vector<size_t> task_begins;
+  size_t task_size = 0;
+  for (size_t f = 0; f < function_sizes.size(); ++f) {
+    if (task_begins.empty() || task_size >= kMinParallelRangeSize) {
+      task_begins.push_back(f);
+      task_size = 0;
+    }
+    task_size += function_sizes[f];
+  }
+
+  auto check_functions = [&check](size_t begin, size_t end) {
+    for (size_t f = begin; f < end; ++f) {
+      if (auto error = check(f)) return error;
+    }
+    return SPV_SUCCESS;
+  };
+  if (!_.options()->parallel || task_begins.size() < 2) {
+    return check_functions(0, function_sizes.size());
+  }
+  task_begins.push_back(function_sizes.size());
+
+  struct Task {
+    spv_result_t result = SPV_SUCCESS;
+    std::vector<ValidationState_t::DeferredDiagnostic> diagnostics;
+  };
+  std::vector<Task> tasks(task_begins.size() - 1);
+  // The tasks after the first one that fails are not reported, so there is
+  // no need to run them.
+  std::atomic<size_t> first_failure(tasks.size());
+  utils::ThreadPool pool(0);
+  for (size_t t = 0; t < tasks.size(); ++t) {
+    pool.Submit(
+        [&check_functions, &task_begins, &tasks, &first_failure, t]() {
+          if (t > first_failure.load()) return;
+          Task& task = tasks[t];
+          {
+            ValidationState_t::DiagnosticDeferral deferral(&task.diagnostics);
+            task.result = check_functions(task_begins[t], task_begins[t + 1]);
+          }
+          if (task.result != SPV_SUCCESS) {
+            size_t failure = first_failure.load();
+            while (t < failure &&
+                   !first_failure.compare_exchange_weak(failure, t)) {
+            }
+          }
+        });
+  }
+  pool.Wait();
+
+  for (const Task& task : tasks) {
+    _.ReportDeferredDiagnostics(task.diagnostics);
+    if (task.result != SPV_SUCCESS) return task.result;
+  }
+  return SPV_SUCCESS;
+}
+
 spv_result_t ValidateBinaryAndKeepValidationState(
     const spv_const_context context, spv_const_validator_options options,
     const uint32_t* words, const size_t num_words, spv_diagnostic* pDiagnostic,
@@ -393,6 +498,113 @@ spv_result_t ValidateBinaryAndKeepValidationState(
       hijack_context, words, num_words, pDiagnostic, vstate->get());
 }
 
+ModuleFingerprint ComputeModuleFingerprint(
+    const uint32_t* words, const size_t num_words,
+    const std::unordered_set<uint32_t>* functions_to_hash) {
+  ModuleFingerprint fingerprint;
+  if (num_words < SPV_INDEX_INSTRUCTION || words[0] != SpvMagicNumber) {
+    return fingerprint;
+  }
+
+  uint64_t module_hash = utils::HashWords(words, SPV_INDEX_BOUND);
+  module_hash = utils::HashWords(words + SPV_INDEX_SCHEMA, 1, module_hash);
+  bool in_function = false;
+  uint32_t function_id = 0;
+  size_t function_begin = 0;
+  for (size_t i = SPV_INDEX_INSTRUCTION; i < num_words;) {
+    const uint32_t* inst = words + i;
+    const uint16_t word_count = static_cast<uint16_t>(inst[0] >> 16);
+    const SpvOp opcode = static_cast<SpvOp>(inst[0] & 0xFFFF);
+    if (word_count == 0 || word_count > num_words - i) {
+      return ModuleFingerprint();
+    }
+
+    switch (opcode) {
+      case SpvOpFunction:
+        if (in_function || word_count < 3) return ModuleFingerprint();
+        in_function = true;
+        function_id = inst[2];
+        function_begin = i;
+        module_hash = utils::HashWords(inst, word_count, module_hash);
+        break;
+      case SpvOpFunctionParameter:
+        module_hash = utils::HashWords(inst, word_count, module_hash);
+        break;
+      case SpvOpFunctionCall:
+        // The call graph decides which entry points reach each function, and
+        // so which execution model limitations apply to it.
+        if (!in_function || word_count < 4) return ModuleFingerprint();
+        {
+          const uint32_t call[] = {function_id, inst[3]};
+          module_hash = utils::HashWords(call, 2, module_hash);
+        }
+        break;
+      case SpvOpFunctionEnd:
+        if (!in_function) return ModuleFingerprint();
+        in_function = false;
+        if (functions_to_hash && !functions_to_hash->count(function_id)) {
+          fingerprint.function_hashes[function_id] = 0;
+        } else {
+          fingerprint.function_hashes[function_id] = utils::HashWords(
+              words + function_begin, i + word_count - function_begin);
+        }
+        break;
+      default:
+        if (!in_function) {
+          module_hash = utils::HashWords(inst, word_count, module_hash);
+        }
+        break;
+    }
+    i += word_count;
+  }
+  if (in_function) return ModuleFingerprint();
+
+  fingerprint.valid = true;
+  fingerprint.module_hash = module_hash;
+  fingerprint.id_bound = words[SPV_INDEX_BOUND];
+  return fingerprint;
+}
+
+spv_result_t ValidateBinaryIncrementally(
+    const spv_const_context context, spv_const_validator_options options,
+    const uint32_t* words, const size_t num_words,
+    ModuleFingerprint* fingerprint, spv_diagnostic* pDiagnostic,
+    const std::unordered_set<uint32_t>* changed_functions) {
+  spv_context_t hijack_context = *context;
+  if (pDiagnostic) {
+    *pDiagnostic = nullptr;
+    UseDiagnosticAsMessageConsumer(&hijack_context, pDiagnostic);
+  }
+
+  ValidationState_t vstate(&hijack_context, options, words, num_words,
+                           kDefaultMaxNumOfWarnings);
+  ModuleFingerprint current =
+      ComputeModuleFingerprint(words, num_words, changed_functions);
+  if (current.valid && fingerprint->valid &&
+      current.module_hash == fingerprint->module_hash &&
+      current.id_bound >= fingerprint->id_bound) {
+    std::unordered_set<uint32_t> unchanged_functions;
+    for (auto& function : current.function_hashes) {
+      const auto previous = fingerprint->function_hashes.find(function.first);
+      if (previous == fingerprint->function_hashes.end()) continue;
+      if (changed_functions) {
+        if (changed_functions->count(function.first)) continue;
+        // The words of the function are the same as in the last module.
+        function.second = previous->second;
+      } else if (previous->second != function.second) {
+        continue;
+      }
+      unchanged_functions.insert(function.first);
+    }
+    vstate.set_unchanged_functions(std::move(unchanged_functions));
+  }
+
+  const spv_result_t result = ValidateBinaryUsingContextAndValidationState(
+      hijack_context, words, num_words, pDiagnostic, &vstate);
+  if (result == SPV_SUCCESS) *fingerprint = std::move(current);
+  return result;
+}
+
 }  // namespace val
 }  // namespace spvtools
 
@@ -15,8 +15,11 @@
 #ifndef SOURCE_VAL_VALIDATE_H_
 #define SOURCE_VAL_VALIDATE_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -65,6 +68,27 @@ spv_result_t UpdateIdUse(ValidationState_t& _, const Instruction* inst);
 /// @return SPV_SUCCESS if no errors are found. SPV_ERROR_INVALID_ID otherwise
 spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _);
 
+/// @brief Returns the range of each function in the ordered instructions
+///
+/// The ranges are in the order of _.functions().  Each one goes from the
+/// OpFunction instruction to just past the OpFunctionEnd instruction.
+std::vector<std::pair<size_t, size_t>> GetFunctionInstructionRanges(
+    const ValidationState_t& _);
+
+/// @brief Calls |check| with the index of each function in _.functions()
+///
+/// If parallel validation is enabled, consecutive functions are grouped into
+/// tasks by the sizes in |function_sizes|, and the tasks are run on several
+/// threads with their diagnostics deferred.  The diagnostics are reported in
+/// the order of the tasks, up to and including the first task that fails,
+/// which gives the same diagnostics and result as calling |check| in order.
+/// |check| may only change the state of the function it is called with.
+///
+/// @return the first error returned by |check| in the order of the functions
+spv_result_t CheckFunctionsInOrder(
+    ValidationState_t& _, const std::vector<size_t>& function_sizes,
+    const std::function<spv_result_t(size_t)>& check);
+
 /// @brief This function checks for preconditions involving the adjacent
 /// instructions.
 ///
@@ -130,8 +154,37 @@ spv_result_t InstructionPass(ValidationState_t& _, const Instruction* inst);
 /// has been propagated down to the group members.
 spv_result_t ValidateDecorations(ValidationState_t& _);
 
-/// Performs validation of built-in variables.
-spv_result_t ValidateBuiltIns(ValidationState_t& _);
+class BuiltInsValidator;
+
+/// The rules for the references to built-in variables that BuiltInsPass keeps
+/// from one instruction to the next.
+class BuiltInsState {
+ public:
+  /// Finds the execution models with which each function can be called.
+  /// Requires ComputeFunctionToEntryPointMapping to have been called.
+  explicit BuiltInsState(ValidationState_t& _);
+  ~BuiltInsState();
+
+  BuiltInsState(const BuiltInsState&) = delete;
+  BuiltInsState& operator=(const BuiltInsState&) = delete;
+
+ private:
+  friend class BuiltInsValidator;
+
+  struct Rules;
+  std::unique_ptr<Rules> rules_;
+};
+
+/// Validates the built-in variables defined by |inst|, and the references of
+/// |inst| to ids that depend on built-in variables.  It is called on the
+/// instructions in order, in the same walk as ValidateInstruction.  The
+/// definitions and references in the global scope add rules to |state| for
+/// the ids that depend on built-ins.  The instructions of functions only read
+/// |state|, so they may be checked concurrently once all the instructions
+/// before the first function have been.  Does nothing if |state| is null,
+/// which is how the profiles other than the full one skip the built-ins.
+spv_result_t BuiltInsPass(ValidationState_t& _, BuiltInsState* state,
+                          const Instruction* inst);
 
 /// Validates type instructions.
 spv_result_t TypePass(ValidationState_t& _, const Instruction* inst);
@@ -197,6 +250,21 @@ spv_result_t FunctionPass(ValidationState_t& _, const Instruction* inst);
 /// Validates correctness of miscellaneous instructions.
 spv_result_t MiscPass(ValidationState_t& _, const Instruction* inst);
 
+/// Runs on |inst| the passes from MiscPass to LiteralsPass that have checks
+/// for its opcode, in the order of the sections of the SPIR-V specification
+/// that they cover.  The passes that apply to each opcode are found once from
+/// the grammar.  The structural profile skips the checks of extended
+/// instructions and of image operations.
+spv_result_t ValidateInstruction(ValidationState_t& _, const Instruction* inst);
+
+/// A per-instruction validation pass, such as MiscPass.
+using InstructionPassFunction = spv_result_t (*)(ValidationState_t& _,
+                                                 const Instruction* inst);
+
+/// Returns the passes that ValidateInstruction does not run on instructions
+/// with |opcode| under the full profile, because they have no checks for it.
+std::vector<InstructionPassFunction> GetSkippedInstructionPasses(SpvOp opcode);
+
 /// Calculates the reachability of basic blocks.
 void ReachabilityPass(ValidationState_t& _);
 
@@ -236,6 +304,49 @@ spv_result_t ValidateBinaryAndKeepValidationState(
     const uint32_t* words, const size_t num_words, spv_diagnostic* pDiagnostic,
     std::unique_ptr<ValidationState_t>* vstate);
 
+/// Hashes of the parts of a module, from which ValidateBinaryIncrementally
+/// finds the functions that did not change since the last module it validated.
+struct ModuleFingerprint {
+  /// False if the module has not been fingerprinted.
+  bool valid = false;
+  /// Hash of the header except for the id bound, and of everything outside of
+  /// function bodies, which includes the declarations of the functions and
+  /// the calls between them.
+  uint64_t module_hash = 0;
+  /// The id bound of the module.  Passes that take fresh ids raise it, which
+  /// leaves the ids of the unchanged functions valid.
+  uint32_t id_bound = 0;
+  /// Hash of each function, by the id of the function.  The hash is 0 if the
+  /// body of the function was not hashed.
+  std::unordered_map<uint32_t, uint64_t> function_hashes;
+};
+
+/// Returns the fingerprint of the |num_words| words of |words|.  The
+/// fingerprint is not valid if the words are not a sequence of whole
+/// instructions in the native byte order with well-formed function bodies.
+/// If |functions_to_hash| is not null, only the bodies of the functions whose
+/// ids are in it are hashed.
+ModuleFingerprint ComputeModuleFingerprint(
+    const uint32_t* words, const size_t num_words,
+    const std::unordered_set<uint32_t>* functions_to_hash = nullptr);
+
+/// Validates the |num_words| words of |words| like spvValidateWithOptions,
+/// except that the opcode, control flow and dominance checks of a function
+/// are skipped if the function did not change since the module last validated
+/// successfully with |fingerprint|, as long as the rest of the module is
+/// identical as well.  If |changed_functions| is null, a function did not
+/// change if its words are identical.  Otherwise it holds the ids of the
+/// functions that changed, and all the other functions of the last module did
+/// not change; their bodies are then not hashed.  Every call must use the same
+/// |context| and |options|.  |fingerprint| should be default-constructed for
+/// the first call, and is updated to the fingerprint of |words| if validation
+/// succeeds.
+spv_result_t ValidateBinaryIncrementally(
+    const spv_const_context context, spv_const_validator_options options,
+    const uint32_t* words, const size_t num_words,
+    ModuleFingerprint* fingerprint, spv_diagnostic* pDiagnostic,
+    const std::unordered_set<uint32_t>* changed_functions = nullptr);
+
 }  // namespace val
 }  // namespace spvtools
 
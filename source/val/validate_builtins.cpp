@@ -16,11 +16,9 @@
 
 // Validates correctness of built-in variables.
 
+#include <algorithm>
 #include <array>
 #include <functional>
-#include <list>
-#include <map>
-#include <set>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -31,6 +29,7 @@
 #include "source/opcode.h"
 #include "source/spirv_target_env.h"
 #include "source/util/bitutils.h"
+#include "source/util/id_map.h"
 #include "source/val/instruction.h"
 #include "source/val/validate.h"
 #include "source/val/validation_state.h"
@@ -238,24 +237,143 @@ bool IsExecutionModelValidForRtBuiltIn(SpvBuiltIn builtin,
   return false;
 }
 
-// Helper class managing validation of built-ins.
-// TODO: Generic functionality of this class can be moved into
-// ValidationState_t to be made available to other users.
-class BuiltInsValidator {
+// The largest number of distinct execution models that the entry points of a
+// module can have.  It is larger than the number of execution models of
+// SPIR-V.
+const uint32_t kMaxExecutionModels = 32;
+
+// A set of the execution models of the entry points of a module, kept as a
+// bit mask over the sorted list of those models.  Like a std::set, it visits
+// the models in increasing order.
+class ExecutionModelSet {
  public:
-  BuiltInsValidator(ValidationState_t& vstate) : _(vstate) {}
+  class const_iterator {
+   public:
+    SpvExecutionModel operator*() const { return (*set_->models_)[index_]; }
+
+    const_iterator& operator++() {
+      ++index_;
+      SkipAbsent();
+      return *this;
+    }
+
+    bool operator!=(const const_iterator& other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    friend class ExecutionModelSet;
+
+    const_iterator(const ExecutionModelSet* set, uint32_t index)
+        : set_(set), index_(index) {
+      SkipAbsent();
+    }
+
+    void SkipAbsent() {
+      while (index_ < kMaxExecutionModels && !((set_->bits_ >> index_) & 1u))
+        ++index_;
+    }
+
+    const ExecutionModelSet* set_;
+    uint32_t index_;
+  };
+
+  ExecutionModelSet() = default;
+  ExecutionModelSet(const std::vector<SpvExecutionModel>* models, uint32_t bits)
+      : models_(models), bits_(bits) {}
+
+  size_t count(SpvExecutionModel model) const {
+    for (const SpvExecutionModel member : *this) {
+      if (member == model) return 1;
+    }
+    return 0;
+  }
+
+  uint32_t bits() const { return bits_; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const {
+    return const_iterator(this, kMaxExecutionModels);
+  }
+
+ private:
+  // The sorted execution models of the entry points of the module.
+  const std::vector<SpvExecutionModel>* models_ = nullptr;
+  // Bit i is set if the set holds (*models_)[i].
+  uint32_t bits_ = 0;
+};
 
-  // Run validation.
-  spv_result_t Run();
+}  // namespace
+
+// Helper class managing validation of built-ins.  BuiltInsPass makes one for
+// each instruction, which shares the rules of the ids that depend on
+// built-ins with the other instructions through BuiltInsState.
+class BuiltInsValidator {
+ public:
+  // A check of the references to an id that depends on a built-in.  It is
+  // either one of the functions which validate references, or, when |check|
+  // is null, the limitation that the references are not called with
+  // |execution_model|.  The rules keep pointers to decorations and
+  // instructions of the validation state, which do not move once the walk
+  // reaches the definitions of built-ins.
+  using AtReferenceCheck = spv_result_t (BuiltInsValidator::*)(
+      const Decoration& decoration, const Instruction& built_in_inst,
+      const Instruction& referenced_inst,
+      const Instruction& referenced_from_inst);
+  struct ReferenceRule {
+    AtReferenceCheck check;
+    const Decoration* decoration;
+    const Instruction* built_in_inst;
+    const Instruction* referenced_inst;
+    // The fields of a limitation, see ValidateNotCalledWithExecutionModel().
+    SpvExecutionModel execution_model;
+    int vuid;
+    const char* comment;
+  };
+
+  // The rules of the references to one id.
+  struct IdRules {
+    std::vector<ReferenceRule> rules;
+    // True if any of |rules| is not a limitation.
+    bool has_checks = false;
+    // The bits of the execution models limited by |rules|, as in the
+    // ExecutionModelSet of a function.  References from a function whose
+    // execution models are not among them need no check.
+    uint32_t limited_models = 0;
+  };
+
+  BuiltInsValidator(ValidationState_t& vstate, BuiltInsState* state)
+      : _(vstate), rules_(state->rules_.get()) {}
+
+  // Validates the built-ins defined by |inst| and the references of |inst|
+  // to ids which depend on built-ins.
+  spv_result_t Run(const Instruction& inst);
 
  private:
-  // Goes through all decorations in the module, if decoration is BuiltIn
-  // calls ValidateSingleBuiltInAtDefinition().
-  spv_result_t ValidateBuiltInsAtDefinition();
+  // Runs the rules of the ids referenced by |inst| on |inst|.
+  spv_result_t ValidateReferences(const Instruction& inst);
+
+  // Runs |rule| on |referenced_from_inst|.
+  spv_result_t ApplyRule(const ReferenceRule& rule,
+                         const Instruction& referenced_from_inst);
+
+  // Adds a rule which runs |check| on the references to the id defined by
+  // |referenced_inst|.
+  void AddReferenceCheck(AtReferenceCheck check, const Decoration& decoration,
+                         const Instruction& built_in_inst,
+                         const Instruction& referenced_inst);
+
+  // Adds a rule which runs ValidateNotCalledWithExecutionModel() on the
+  // references to the id defined by |referenced_inst|.
+  void AddExecutionModelLimitation(int vuid, const char* comment,
+                                   SpvExecutionModel execution_model,
+                                   const Decoration& decoration,
+                                   const Instruction& built_in_inst,
+                                   const Instruction& referenced_inst);
 
   // Validates the instruction defining an id with built-in decoration.
   // Can be called multiple times for the same id, if multiple built-ins are
-  // specified. Seeds id_to_at_reference_checks_ with decorated ids if needed.
+  // specified. Adds rules for the references to decorated ids if needed.
   spv_result_t ValidateSingleBuiltInAtDefinition(const Decoration& decoration,
                                                  const Instruction& inst);
 
@@ -635,56 +753,127 @@ class BuiltInsValidator {
   // UniformConstant".
   std::string GetStorageClassDesc(const Instruction& inst) const;
 
-  // Updates inner working of the class. Is called sequentially for every
-  // instruction.
+  // Finds the function which |inst| is inside of.
   void Update(const Instruction& inst);
 
   ValidationState_t& _;
 
-  // Mapping id -> list of rules which validate instruction referencing the
-  // id. Rules can create new rules and add them to this container.
-  // Using std::map, and not std::unordered_map to avoid iterator invalidation
-  // during rehashing.
-  std::map<uint32_t, std::list<std::function<spv_result_t(const Instruction&)>>>
-      id_to_at_reference_checks_;
+  // The rules of the ids which depend on built-ins, shared by all the
+  // instructions.  Rules can create new rules for the ids defined in the
+  // global scope, which are checked in order.
+  BuiltInsState::Rules* rules_;
 
   // Id of the function we are currently inside. 0 if not inside a function.
   uint32_t function_id_ = 0;
 
   // Entry points which can (indirectly) call the current function.
-  // The pointer either points to a vector inside to function_to_entry_points_
-  // or to no_entry_points_. The pointer is guaranteed to never be null.
-  const std::vector<uint32_t> no_entry_points;
-  const std::vector<uint32_t>* entry_points_ = &no_entry_points;
+  // The pointer is guaranteed to never be null.
+  const std::vector<uint32_t>* entry_points_ = nullptr;
 
   // Execution models with which the current function can be called.
-  std::set<SpvExecutionModel> execution_models_;
+  ExecutionModelSet execution_models_;
 };
 
-void BuiltInsValidator::Update(const Instruction& inst) {
-  const SpvOp opcode = inst.opcode();
-  if (opcode == SpvOpFunction) {
-    // Entering a function.
-    assert(function_id_ == 0);
-    function_id_ = inst.id();
-    execution_models_.clear();
-    entry_points_ = &_.FunctionEntryPoints(function_id_);
-    // Collect execution models from all entry points from which the current
-    // function can be called.
-    for (const uint32_t entry_point : *entry_points_) {
-      if (const auto* models = _.GetExecutionModels(entry_point)) {
-        execution_models_.insert(models->begin(), models->end());
+struct BuiltInsState::Rules {
+  // Keeps the ids below |dense_size| in vectors.
+  explicit Rules(uint32_t dense_size)
+      : id_rules(dense_size), function_models(dense_size) {}
+
+  // Returns the bit of |execution_model| in an ExecutionModelSet, or 0 if no
+  // entry point of the module has it.
+  uint32_t ModelBit(SpvExecutionModel execution_model) const {
+    const auto it =
+        std::lower_bound(models.begin(), models.end(), execution_model);
+    if (it == models.end() || *it != execution_model) return 0;
+    return 1u << (it - models.begin());
+  }
+
+  // The rules of the references to each id.
+  utils::IdMap<BuiltInsValidator::IdRules> id_rules;
+  // The sorted execution models of the entry points of the module.
+  std::vector<SpvExecutionModel> models;
+  // The execution models with which each function can be called.
+  utils::IdMap<ExecutionModelSet> function_models;
+};
+
+BuiltInsState::BuiltInsState(ValidationState_t& _)
+    : rules_(new Rules(_.getDenseIdBound())) {
+  std::vector<SpvExecutionModel>& models = rules_->models;
+  for (const uint32_t entry_point : _.entry_points()) {
+    if (const auto* entry_point_models = _.GetExecutionModels(entry_point)) {
+      models.insert(models.end(), entry_point_models->begin(),
+                    entry_point_models->end());
+    }
+  }
+  std::sort(models.begin(), models.end());
+  models.erase(std::unique(models.begin(), models.end()), models.end());
+  assert(models.size() <= kMaxExecutionModels);
+
+  // The execution models of each entry point, then those of each function as
+  // the union of those of the entry points which call it.
+  utils::IdMap<uint32_t> entry_point_bits(_.getDenseIdBound());
+  for (const uint32_t entry_point : _.entry_points()) {
+    if (const auto* entry_point_models = _.GetExecutionModels(entry_point)) {
+      for (const SpvExecutionModel model : *entry_point_models) {
+        entry_point_bits[entry_point] |= rules_->ModelBit(model);
       }
     }
   }
+  for (const Function& function : _.functions()) {
+    uint32_t bits = 0;
+    for (const uint32_t entry_point : _.FunctionEntryPoints(function.id())) {
+      bits |= entry_point_bits.Get(entry_point);
+    }
+    rules_->function_models[function.id()] = ExecutionModelSet(&models, bits);
+  }
+}
+
+BuiltInsState::~BuiltInsState() = default;
 
-  if (opcode == SpvOpFunctionEnd) {
-    // Exiting a function.
-    assert(function_id_ != 0);
+void BuiltInsValidator::Update(const Instruction& inst) {
+  // The function instruction itself is not marked as being inside of its
+  // function.
+  if (inst.opcode() == SpvOpFunction) {
+    function_id_ = inst.id();
+  } else if (inst.function()) {
+    function_id_ = inst.function()->id();
+  } else {
     function_id_ = 0;
-    entry_points_ = &no_entry_points;
-    execution_models_.clear();
   }
+  entry_points_ = &_.FunctionEntryPoints(function_id_);
+  execution_models_ = rules_->function_models.Get(function_id_);
+}
+
+spv_result_t BuiltInsValidator::ApplyRule(
+    const ReferenceRule& rule, const Instruction& referenced_from_inst) {
+  if (rule.check) {
+    return (this->*rule.check)(*rule.decoration, *rule.built_in_inst,
+                               *rule.referenced_inst, referenced_from_inst);
+  }
+  return ValidateNotCalledWithExecutionModel(
+      rule.vuid, rule.comment, rule.execution_model, *rule.decoration,
+      *rule.built_in_inst, *rule.referenced_inst, referenced_from_inst);
+}
+
+void BuiltInsValidator::AddReferenceCheck(AtReferenceCheck check,
+                                          const Decoration& decoration,
+                                          const Instruction& built_in_inst,
+                                          const Instruction& referenced_inst) {
+  IdRules& id_rules = rules_->id_rules[referenced_inst.id()];
+  id_rules.rules.push_back({check, &decoration, &built_in_inst,
+                            &referenced_inst, SpvExecutionModelMax, -1,
+                            nullptr});
+  id_rules.has_checks = true;
+}
+
+void BuiltInsValidator::AddExecutionModelLimitation(
+    int vuid, const char* comment, SpvExecutionModel execution_model,
+    const Decoration& decoration, const Instruction& built_in_inst,
+    const Instruction& referenced_inst) {
+  IdRules& id_rules = rules_->id_rules[referenced_inst.id()];
+  id_rules.rules.push_back({nullptr, &decoration, &built_in_inst,
+                            &referenced_inst, execution_model, vuid, comment});
+  id_rules.limited_models |= rules_->ModelBit(execution_model);
 }
 
 std::string BuiltInsValidator::GetDefinitionDesc(
@@ -1116,10 +1305,8 @@ spv_result_t BuiltInsValidator::ValidateNotCalledWithExecutionModel(
     }
   } else {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateNotCalledWithExecutionModel, this,
-                  vuid, comment, execution_model, decoration, built_in_inst,
-                  referenced_from_inst, std::placeholders::_1));
+    AddExecutionModelLimitation(vuid, comment, execution_model, decoration,
+                                built_in_inst, referenced_from_inst);
   }
   return SPV_SUCCESS;
 }
@@ -1155,32 +1342,32 @@ spv_result_t BuiltInsValidator::ValidateClipOrCullDistanceAtReference(
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInClipDistance) ? 4188 : 4197;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
+      AddExecutionModelLimitation(
+          vuid,
           "Vulkan spec doesn't allow BuiltIn ClipDistance/CullDistance to be "
           "used for variables with Input storage class if execution model is "
           "Vertex.",
           SpvExecutionModelVertex, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          vuid,
           "Vulkan spec doesn't allow BuiltIn ClipDistance/CullDistance to be "
           "used for variables with Input storage class if execution model is "
           "Vertex.",
           SpvExecutionModelMeshNV, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInClipDistance) ? 4189 : 4198;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
+      AddExecutionModelLimitation(
+          vuid,
           "Vulkan spec doesn't allow BuiltIn ClipDistance/CullDistance to be "
           "used for variables with Output storage class if execution model is "
           "Fragment.",
           SpvExecutionModelFragment, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     for (const SpvExecutionModel execution_model : execution_models_) {
@@ -1278,10 +1465,9 @@ spv_result_t BuiltInsValidator::ValidateClipOrCullDistanceAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateClipOrCullDistanceAtReference,
-                  this, decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateClipOrCullDistanceAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1341,9 +1527,9 @@ spv_result_t BuiltInsValidator::ValidateFragCoordAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFragCoordAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFragCoordAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1417,9 +1603,9 @@ spv_result_t BuiltInsValidator::ValidateFragDepthAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFragDepthAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFragDepthAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1478,9 +1664,9 @@ spv_result_t BuiltInsValidator::ValidateFrontFacingAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFrontFacingAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFrontFacingAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1537,10 +1723,9 @@ spv_result_t BuiltInsValidator::ValidateHelperInvocationAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateHelperInvocationAtReference, this,
-                  decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateHelperInvocationAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1598,9 +1783,9 @@ spv_result_t BuiltInsValidator::ValidateInvocationIdAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateInvocationIdAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateInvocationIdAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1659,9 +1844,9 @@ spv_result_t BuiltInsValidator::ValidateInstanceIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateInstanceIndexAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateInstanceIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1720,9 +1905,9 @@ spv_result_t BuiltInsValidator::ValidatePatchVerticesAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidatePatchVerticesAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidatePatchVerticesAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1780,9 +1965,9 @@ spv_result_t BuiltInsValidator::ValidatePointCoordAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidatePointCoordAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidatePointCoordAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1814,13 +1999,12 @@ spv_result_t BuiltInsValidator::ValidatePointSizeAtReference(
 
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4315,
+      AddExecutionModelLimitation(
+          4315,
           "Vulkan spec doesn't allow BuiltIn PointSize to be used for "
-          "variables with Input storage class if execution model is "
-          "Vertex.",
+          "variables with Input storage class if execution model is Vertex.",
           SpvExecutionModelVertex, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     for (const SpvExecutionModel execution_model : execution_models_) {
@@ -1897,9 +2081,9 @@ spv_result_t BuiltInsValidator::ValidatePointSizeAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidatePointSizeAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidatePointSizeAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -1930,20 +2114,18 @@ spv_result_t BuiltInsValidator::ValidatePositionAtReference(
 
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4319,
-          "Vulkan spec doesn't allow BuiltIn Position to be used "
-          "for variables "
+      AddExecutionModelLimitation(
+          4319,
+          "Vulkan spec doesn't allow BuiltIn Position to be used for variables "
           "with Input storage class if execution model is Vertex.",
           SpvExecutionModelVertex, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4319,
-          "Vulkan spec doesn't allow BuiltIn Position to be used "
-          "for variables "
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          4319,
+          "Vulkan spec doesn't allow BuiltIn Position to be used for variables "
           "with Input storage class if execution model is MeshNV.",
           SpvExecutionModelMeshNV, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     for (const SpvExecutionModel execution_model : execution_models_) {
@@ -2023,9 +2205,9 @@ spv_result_t BuiltInsValidator::ValidatePositionAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidatePositionAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidatePositionAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2087,48 +2269,47 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveIdAtReference(
 
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
+      AddExecutionModelLimitation(
+          4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "TessellationControl.",
           SpvExecutionModelTessellationControl, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "TessellationEvaluation.",
           SpvExecutionModelTessellationEvaluation, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
-          "variables with Output storage class if execution model is "
-          "Fragment.",
+          "variables with Output storage class if execution model is Fragment.",
           SpvExecutionModelFragment, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "IntersectionKHR.",
           SpvExecutionModelIntersectionKHR, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "AnyHitKHR.",
           SpvExecutionModelAnyHitKHR, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, 4334,
+          referenced_from_inst);
+      AddExecutionModelLimitation(
+          4334,
           "Vulkan spec doesn't allow BuiltIn PrimitiveId to be used for "
           "variables with Output storage class if execution model is "
           "ClosestHitKHR.",
           SpvExecutionModelClosestHitKHR, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     for (const SpvExecutionModel execution_model : execution_models_) {
@@ -2162,9 +2343,9 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveIdAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidatePrimitiveIdAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidatePrimitiveIdAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2221,9 +2402,9 @@ spv_result_t BuiltInsValidator::ValidateSampleIdAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateSampleIdAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateSampleIdAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2282,9 +2463,9 @@ spv_result_t BuiltInsValidator::ValidateSampleMaskAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateSampleMaskAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateSampleMaskAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2344,9 +2525,9 @@ spv_result_t BuiltInsValidator::ValidateSamplePositionAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateSamplePositionAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateSamplePositionAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2404,9 +2585,9 @@ spv_result_t BuiltInsValidator::ValidateTessCoordAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateTessCoordAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateTessCoordAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2478,27 +2659,25 @@ spv_result_t BuiltInsValidator::ValidateTessLevelAtReference(
     if (storage_class == SpvStorageClassInput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInTessLevelOuter) ? 4391 : 4395;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
-          "Vulkan spec doesn't allow TessLevelOuter/TessLevelInner to be "
-          "used "
+      AddExecutionModelLimitation(
+          vuid,
+          "Vulkan spec doesn't allow TessLevelOuter/TessLevelInner to be used "
           "for variables with Input storage class if execution model is "
           "TessellationControl.",
           SpvExecutionModelTessellationControl, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
       uint32_t vuid = (decoration.params()[0] == SpvBuiltInTessLevelOuter) ? 4392 : 4396;
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-          &BuiltInsValidator::ValidateNotCalledWithExecutionModel, this, vuid,
-          "Vulkan spec doesn't allow TessLevelOuter/TessLevelInner to be "
-          "used "
+      AddExecutionModelLimitation(
+          vuid,
+          "Vulkan spec doesn't allow TessLevelOuter/TessLevelInner to be used "
           "for variables with Output storage class if execution model is "
           "TessellationEvaluation.",
           SpvExecutionModelTessellationEvaluation, decoration, built_in_inst,
-          referenced_from_inst, std::placeholders::_1));
+          referenced_from_inst);
     }
 
     for (const SpvExecutionModel execution_model : execution_models_) {
@@ -2526,9 +2705,9 @@ spv_result_t BuiltInsValidator::ValidateTessLevelAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateTessLevelAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateTessLevelAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2579,10 +2758,9 @@ spv_result_t BuiltInsValidator::ValidateLocalInvocationIndexAtReference(
     const Instruction& referenced_from_inst) {
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateLocalInvocationIndexAtReference,
-                  this, decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateLocalInvocationIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2620,9 +2798,9 @@ spv_result_t BuiltInsValidator::ValidateVertexIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateVertexIndexAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateVertexIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2701,31 +2879,24 @@ spv_result_t BuiltInsValidator::ValidateLayerOrViewportIndexAtReference(
       for (const auto em :
            {SpvExecutionModelVertex, SpvExecutionModelTessellationEvaluation,
             SpvExecutionModelGeometry, SpvExecutionModelMeshNV}) {
-        id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-            std::bind(&BuiltInsValidator::ValidateNotCalledWithExecutionModel,
-                      this, ((operand == SpvBuiltInLayer) ? 4274 : 4406),
-                      "Vulkan spec doesn't allow BuiltIn Layer and "
-                      "ViewportIndex to be "
-                      "used for variables with Input storage class if "
-                      "execution model is Vertex, TessellationEvaluation, "
-                      "Geometry, or MeshNV.",
-                      em, decoration, built_in_inst, referenced_from_inst,
-                      std::placeholders::_1));
+        AddExecutionModelLimitation(
+            ((operand == SpvBuiltInLayer) ? 4274 : 4406),
+            "Vulkan spec doesn't allow BuiltIn Layer and ViewportIndex to be "
+            "used for variables with Input storage class if execution model is "
+            "Vertex, TessellationEvaluation, Geometry, or MeshNV.",
+            em, decoration, built_in_inst, referenced_from_inst);
       }
     }
 
     if (storage_class == SpvStorageClassOutput) {
       assert(function_id_ == 0);
-      id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-          std::bind(&BuiltInsValidator::ValidateNotCalledWithExecutionModel,
-                    this, ((operand == SpvBuiltInLayer) ? 4275 : 4407),
-                    "Vulkan spec doesn't allow BuiltIn Layer and "
-                    "ViewportIndex to be "
-                    "used for variables with Output storage class if "
-                    "execution model is "
-                    "Fragment.",
-                    SpvExecutionModelFragment, decoration, built_in_inst,
-                    referenced_from_inst, std::placeholders::_1));
+      AddExecutionModelLimitation(
+          ((operand == SpvBuiltInLayer) ? 4275 : 4407),
+          "Vulkan spec doesn't allow BuiltIn Layer and ViewportIndex to be "
+          "used for variables with Output storage class if execution model is "
+          "Fragment.",
+          SpvExecutionModelFragment, decoration, built_in_inst,
+          referenced_from_inst);
     }
 
     for (const SpvExecutionModel execution_model : execution_models_) {
@@ -2779,10 +2950,9 @@ spv_result_t BuiltInsValidator::ValidateLayerOrViewportIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateLayerOrViewportIndexAtReference,
-                  this, decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateLayerOrViewportIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2855,10 +3025,9 @@ spv_result_t BuiltInsValidator::ValidateComputeShaderI32Vec3InputAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateComputeShaderI32Vec3InputAtReference, this,
-        decoration, built_in_inst, referenced_from_inst,
-        std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateComputeShaderI32Vec3InputAtReference,
+        decoration, built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -2937,10 +3106,9 @@ spv_result_t BuiltInsValidator::ValidateComputeI32InputAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateComputeI32InputAtReference, this,
-                  decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateComputeI32InputAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3086,9 +3254,9 @@ spv_result_t BuiltInsValidator::ValidateWorkgroupSizeAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateWorkgroupSizeAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateWorkgroupSizeAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3155,10 +3323,9 @@ spv_result_t BuiltInsValidator::ValidateBaseInstanceOrVertexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateBaseInstanceOrVertexAtReference,
-                  this, decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateBaseInstanceOrVertexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3223,9 +3390,9 @@ spv_result_t BuiltInsValidator::ValidateDrawIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateDrawIndexAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateDrawIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3287,9 +3454,9 @@ spv_result_t BuiltInsValidator::ValidateViewIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateViewIndexAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateViewIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3339,9 +3506,9 @@ spv_result_t BuiltInsValidator::ValidateDeviceIndexAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateDeviceIndexAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateDeviceIndexAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3410,9 +3577,9 @@ spv_result_t BuiltInsValidator::ValidateFragInvocationCountAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFragInvocationCountAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFragInvocationCountAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3480,9 +3647,9 @@ spv_result_t BuiltInsValidator::ValidateFragSizeAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFragSizeAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFragSizeAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3550,9 +3717,9 @@ spv_result_t BuiltInsValidator::ValidateFragStencilRefAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFragStencilRefAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFragStencilRefAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3620,9 +3787,9 @@ spv_result_t BuiltInsValidator::ValidateFullyCoveredAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateFullyCoveredAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateFullyCoveredAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3675,9 +3842,9 @@ spv_result_t BuiltInsValidator::ValidateSMBuiltinsAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateSMBuiltinsAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateSMBuiltinsAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3746,10 +3913,9 @@ spv_result_t BuiltInsValidator::ValidatePrimitiveShadingRateAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidatePrimitiveShadingRateAtReference,
-                  this, decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidatePrimitiveShadingRateAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3811,9 +3977,9 @@ spv_result_t BuiltInsValidator::ValidateShadingRateAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(std::bind(
-        &BuiltInsValidator::ValidateShadingRateAtReference, this, decoration,
-        built_in_inst, referenced_from_inst, std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateShadingRateAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -3978,10 +4144,9 @@ spv_result_t BuiltInsValidator::ValidateRayTracingBuiltinsAtReference(
 
   if (function_id_ == 0) {
     // Propagate this rule to all dependant ids in the global scope.
-    id_to_at_reference_checks_[referenced_from_inst.id()].push_back(
-        std::bind(&BuiltInsValidator::ValidateRayTracingBuiltinsAtReference,
-                  this, decoration, built_in_inst, referenced_from_inst,
-                  std::placeholders::_1));
+    AddReferenceCheck(
+        &BuiltInsValidator::ValidateRayTracingBuiltinsAtReference, decoration,
+        built_in_inst, referenced_from_inst);
   }
 
   return SPV_SUCCESS;
@@ -4203,24 +4368,41 @@ spv_result_t BuiltInsValidator::ValidateSingleBuiltInAtDefinition(
   return SPV_SUCCESS;
 }
 
-spv_result_t BuiltInsValidator::ValidateBuiltInsAtDefinition() {
-  for (const auto& kv : _.id_decorations()) {
-    const uint32_t id = kv.first;
-    const auto& decorations = kv.second;
-    if (decorations.empty()) {
+spv_result_t BuiltInsValidator::ValidateReferences(const Instruction& inst) {
+  const auto& operands = inst.operands();
+  for (size_t i = 0; i < operands.size(); ++i) {
+    if (!spvIsIdType(operands[i].type)) {
+      // Not id.
       continue;
     }
 
-    const Instruction* inst = _.FindDef(id);
-    assert(inst);
+    const uint32_t id = inst.word(operands[i].offset);
+    if (id == inst.id()) {
+      // No need to check result id.
+      continue;
+    }
 
-    for (const auto& decoration : kv.second) {
-      if (decoration.dec_type() != SpvDecorationBuiltIn) {
-        continue;
-      }
+    const IdRules& id_rules = rules_->id_rules.Get(id);
+    if (id_rules.rules.empty()) continue;
+    if (function_id_ && !id_rules.has_checks &&
+        !(id_rules.limited_models & execution_models_.bits())) {
+      // None of the limitations apply to the current function.
+      continue;
+    }
 
-      if (spv_result_t error =
-              ValidateSingleBuiltInAtDefinition(decoration, *inst)) {
+    // Skip the id if the instruction has already referenced it.
+    bool already_checked = false;
+    for (size_t j = 0; j < i && !already_checked; ++j) {
+      already_checked = spvIsIdType(operands[j].type) &&
+                        inst.word(operands[j].offset) == id;
+    }
+    if (already_checked) continue;
+
+    // Instruction references the id. Run all rules associated with the id on
+    // the instruction. The rules only add rules for the id defined by the
+    // instruction, which is not the id, so |id_rules| is not modified.
+    for (const ReferenceRule& rule : id_rules.rules) {
+      if (spv_result_t error = ApplyRule(rule, inst)) {
         return error;
       }
     }
@@ -4229,65 +4411,31 @@ spv_result_t BuiltInsValidator::ValidateBuiltInsAtDefinition() {
   return SPV_SUCCESS;
 }
 
-spv_result_t BuiltInsValidator::Run() {
-  // First pass: validate all built-ins at definition and seed
-  // id_to_at_reference_checks_ with built-ins.
-  if (auto error = ValidateBuiltInsAtDefinition()) {
-    return error;
-  }
-
-  if (id_to_at_reference_checks_.empty()) {
-    // No validation tasks were seeded. Nothing else to do.
-    return SPV_SUCCESS;
-  }
-
-  // Second pass: validate every id reference in the module using
-  // rules in id_to_at_reference_checks_.
-  for (const Instruction& inst : _.ordered_instructions()) {
-    Update(inst);
-
-    std::set<uint32_t> already_checked;
-
-    for (const auto& operand : inst.operands()) {
-      if (!spvIsIdType(operand.type)) {
-        // Not id.
-        continue;
-      }
-
-      const uint32_t id = inst.word(operand.offset);
-      if (id == inst.id()) {
-        // No need to check result id.
-        continue;
-      }
+spv_result_t BuiltInsValidator::Run(const Instruction& inst) {
+  Update(inst);
 
-      if (!already_checked.insert(id).second) {
-        // The instruction has already referenced this id.
+  if (inst.id()) {
+    for (const auto& decoration : _.id_decorations(inst.id())) {
+      if (decoration.dec_type() != SpvDecorationBuiltIn) {
         continue;
       }
 
-      // Instruction references the id. Run all checks associated with the id
-      // on the instruction. id_to_at_reference_checks_ can be modified in the
-      // process, iterators are safe because it's a tree-based map.
-      const auto it = id_to_at_reference_checks_.find(id);
-      if (it != id_to_at_reference_checks_.end()) {
-        for (const auto& check : it->second) {
-          if (spv_result_t error = check(inst)) {
-            return error;
-          }
-        }
+      if (spv_result_t error =
+              ValidateSingleBuiltInAtDefinition(decoration, inst)) {
+        return error;
       }
     }
   }
 
-  return SPV_SUCCESS;
+  return ValidateReferences(inst);
 }
 
-}  // namespace
+spv_result_t BuiltInsPass(ValidationState_t& _, BuiltInsState* state,
+                          const Instruction* inst) {
+  if (!state) return SPV_SUCCESS;
 
-// Validates correctness of built-in variables.
-spv_result_t ValidateBuiltIns(ValidationState_t& _) {
-  BuiltInsValidator validator(_);
-  return validator.Run();
+  BuiltInsValidator validator(_, state);
+  return validator.Run(*inst);
 }
 
 }  // namespace val
@@ -331,6 +331,54 @@ spv_result_t ValidateLoopMerge(ValidationState_t& _, const Instruction* inst) {
   return SPV_SUCCESS;
 }
 
+// Numbers the blocks of the tree given by |edges|, which pair each block with
+// its parent as returned by CFA::CalculateDominators, in a depth-first walk of
+// the tree.  The root of each block's tree and its pre-order and post-order
+// numbers are passed to |set_numbers|, after which a block (post)dominates
+// exactly the blocks of its tree whose numbers lie within its own.
+void NumberDominatorTree(
+    const std::vector<std::pair<BasicBlock*, BasicBlock*>>& edges,
+    void (BasicBlock::*set_numbers)(const BasicBlock*, uint32_t, uint32_t)) {
+  std::unordered_map<const BasicBlock*, std::vector<BasicBlock*>> children;
+  std::unordered_set<const BasicBlock*> has_parent;
+  for (const auto& edge : edges) {
+    if (edge.first != edge.second) {
+      children[edge.second].push_back(edge.first);
+      has_parent.insert(edge.first);
+    }
+  }
+
+  uint32_t next_pre = 1;
+  uint32_t next_post = 1;
+  std::unordered_set<const BasicBlock*> visited_roots;
+  // Pairs of a block and the pre-order number it was given.
+  std::vector<std::pair<BasicBlock*, uint32_t>> stack;
+  // The index of the next child to visit, for each block on the stack.
+  std::vector<size_t> next_child;
+  auto visit = [&](BasicBlock* root) {
+    if (has_parent.count(root) || !visited_roots.insert(root).second) return;
+    stack.emplace_back(root, next_pre++);
+    next_child.push_back(0);
+    while (!stack.empty()) {
+      BasicBlock* block = stack.back().first;
+      const auto found = children.find(block);
+      if (found != children.end() && next_child.back() < found->second.size()) {
+        BasicBlock* child = found->second[next_child.back()++];
+        stack.emplace_back(child, next_pre++);
+        next_child.push_back(0);
+      } else {
+        (block->*set_numbers)(root, stack.back().second, next_post++);
+        stack.pop_back();
+        next_child.pop_back();
+      }
+    }
+  };
+  for (const auto& edge : edges) {
+    visit(edge.first);
+    visit(edge.second);
+  }
+}
+
 }  // namespace
 
 void printDominatorList(const BasicBlock& b) {
@@ -817,112 +865,130 @@ spv_result_t StructuredControlFlowChecks(
   return SPV_SUCCESS;
 }
 
-spv_result_t PerformCfgChecks(ValidationState_t& _) {
-  for (auto& function : _.functions()) {
-    // Check all referenced blocks are defined within a function
-    if (function.undefined_block_count() != 0) {
-      std::string undef_blocks("{");
-      bool first = true;
-      for (auto undefined_block : function.undefined_blocks()) {
-        undef_blocks += _.getIdName(undefined_block);
-        if (!first) {
-          undef_blocks += " ";
-        }
-        first = false;
+// Performs the control flow graph checks of |function|.
+spv_result_t PerformCfgChecks(ValidationState_t& _, Function& function) {
+  // Check all referenced blocks are defined within a function
+  if (function.undefined_block_count() != 0) {
+    std::string undef_blocks("{");
+    bool first = true;
+    for (auto undefined_block : function.undefined_blocks()) {
+      undef_blocks += _.getIdName(undefined_block);
+      if (!first) {
+        undef_blocks += " ";
       }
-      return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(function.id()))
-             << "Block(s) " << undef_blocks << "}"
-             << " are referenced but not defined in function "
-             << _.getIdName(function.id());
+      first = false;
     }
+    return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(function.id()))
+           << "Block(s) " << undef_blocks << "}"
+           << " are referenced but not defined in function "
+           << _.getIdName(function.id());
+  }
 
-    // Set each block's immediate dominator and immediate postdominator,
-    // and find all back-edges.
-    //
-    // We want to analyze all the blocks in the function, even in degenerate
-    // control flow cases including unreachable blocks.  So use the augmented
-    // CFG to ensure we cover all the blocks.
-    std::vector<const BasicBlock*> postorder;
-    std::vector<const BasicBlock*> postdom_postorder;
-    std::vector<std::pair<uint32_t, uint32_t>> back_edges;
-    auto ignore_block = [](const BasicBlock*) {};
-    auto ignore_edge = [](const BasicBlock*, const BasicBlock*) {};
-    if (!function.ordered_blocks().empty()) {
-      /// calculate dominators
-      CFA<BasicBlock>::DepthFirstTraversal(
-          function.first_block(), function.AugmentedCFGSuccessorsFunction(),
-          ignore_block, [&](const BasicBlock* b) { postorder.push_back(b); },
-          ignore_edge);
-      auto edges = CFA<BasicBlock>::CalculateDominators(
-          postorder, function.AugmentedCFGPredecessorsFunction());
-      for (auto edge : edges) {
-        if (edge.first != edge.second)
-          edge.first->SetImmediateDominator(edge.second);
-      }
-
-      /// calculate post dominators
-      CFA<BasicBlock>::DepthFirstTraversal(
-          function.pseudo_exit_block(),
-          function.AugmentedCFGPredecessorsFunction(), ignore_block,
-          [&](const BasicBlock* b) { postdom_postorder.push_back(b); },
-          ignore_edge);
-      auto postdom_edges = CFA<BasicBlock>::CalculateDominators(
-          postdom_postorder, function.AugmentedCFGSuccessorsFunction());
-      for (auto edge : postdom_edges) {
-        edge.first->SetImmediatePostDominator(edge.second);
-      }
-      /// calculate back edges.
-      CFA<BasicBlock>::DepthFirstTraversal(
-          function.pseudo_entry_block(),
-          function
-              .AugmentedCFGSuccessorsFunctionIncludingHeaderToContinueEdge(),
-          ignore_block, ignore_block,
-          [&](const BasicBlock* from, const BasicBlock* to) {
-            back_edges.emplace_back(from->id(), to->id());
-          });
+  // Set each block's immediate dominator and immediate postdominator,
+  // and find all back-edges.
+  //
+  // We want to analyze all the blocks in the function, even in degenerate
+  // control flow cases including unreachable blocks.  So use the augmented
+  // CFG to ensure we cover all the blocks.
+  std::vector<const BasicBlock*> postorder;
+  std::vector<const BasicBlock*> postdom_postorder;
+  std::vector<std::pair<uint32_t, uint32_t>> back_edges;
+  auto ignore_block = [](const BasicBlock*) {};
+  auto ignore_edge = [](const BasicBlock*, const BasicBlock*) {};
+  if (!function.ordered_blocks().empty()) {
+    /// calculate dominators
+    CFA<BasicBlock>::DepthFirstTraversal(
+        function.first_block(), function.AugmentedCFGSuccessorsFunction(),
+        ignore_block, [&](const BasicBlock* b) { postorder.push_back(b); },
+        ignore_edge);
+    auto edges = CFA<BasicBlock>::CalculateDominators(
+        postorder, function.AugmentedCFGPredecessorsFunction());
+    for (auto edge : edges) {
+      if (edge.first != edge.second)
+        edge.first->SetImmediateDominator(edge.second);
     }
-    UpdateContinueConstructExitBlocks(function, back_edges);
-
-    auto& blocks = function.ordered_blocks();
-    if (!blocks.empty()) {
-      // Check if the order of blocks in the binary appear before the blocks
-      // they dominate
-      for (auto block = begin(blocks) + 1; block != end(blocks); ++block) {
-        if (auto idom = (*block)->immediate_dominator()) {
-          if (idom != function.pseudo_entry_block() &&
-              block == std::find(begin(blocks), block, idom)) {
-            return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(idom->id()))
-                   << "Block " << _.getIdName((*block)->id())
-                   << " appears in the binary before its dominator "
-                   << _.getIdName(idom->id());
-          }
+    NumberDominatorTree(edges, &BasicBlock::SetDominatorTreeNumbers);
+
+    /// calculate post dominators
+    CFA<BasicBlock>::DepthFirstTraversal(
+        function.pseudo_exit_block(),
+        function.AugmentedCFGPredecessorsFunction(), ignore_block,
+        [&](const BasicBlock* b) { postdom_postorder.push_back(b); },
+        ignore_edge);
+    auto postdom_edges = CFA<BasicBlock>::CalculateDominators(
+        postdom_postorder, function.AugmentedCFGSuccessorsFunction());
+    for (auto edge : postdom_edges) {
+      edge.first->SetImmediatePostDominator(edge.second);
+    }
+    NumberDominatorTree(postdom_edges,
+                        &BasicBlock::SetPostDominatorTreeNumbers);
+    /// calculate back edges.
+    CFA<BasicBlock>::DepthFirstTraversal(
+        function.pseudo_entry_block(),
+        function.AugmentedCFGSuccessorsFunctionIncludingHeaderToContinueEdge(),
+        ignore_block, ignore_block,
+        [&](const BasicBlock* from, const BasicBlock* to) {
+          back_edges.emplace_back(from->id(), to->id());
+        });
+  }
+  UpdateContinueConstructExitBlocks(function, back_edges);
+
+  auto& blocks = function.ordered_blocks();
+  if (!blocks.empty()) {
+    // Check if the order of blocks in the binary appear before the blocks
+    // they dominate
+    for (auto block = begin(blocks) + 1; block != end(blocks); ++block) {
+      if (auto idom = (*block)->immediate_dominator()) {
+        if (idom != function.pseudo_entry_block() &&
+            block == std::find(begin(blocks), block, idom)) {
+          return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef(idom->id()))
+                 << "Block " << _.getIdName((*block)->id())
+                 << " appears in the binary before its dominator "
+                 << _.getIdName(idom->id());
         }
       }
-      // If we have structed control flow, check that no block has a control
-      // flow nesting depth larger than the limit.
-      if (_.HasCapability(SpvCapabilityShader)) {
-        const int control_flow_nesting_depth_limit =
-            _.options()->universal_limits_.max_control_flow_nesting_depth;
-        for (auto block = begin(blocks); block != end(blocks); ++block) {
-          if (function.GetBlockDepth(*block) >
-              control_flow_nesting_depth_limit) {
-            return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef((*block)->id()))
-                   << "Maximum Control Flow nesting depth exceeded.";
-          }
+    }
+    // If we have structed control flow, check that no block has a control
+    // flow nesting depth larger than the limit.
+    if (_.HasCapability(SpvCapabilityShader)) {
+      const int control_flow_nesting_depth_limit =
+          _.options()->universal_limits_.max_control_flow_nesting_depth;
+      for (auto block = begin(blocks); block != end(blocks); ++block) {
+        if (function.GetBlockDepth(*block) > control_flow_nesting_depth_limit) {
+          return _.diag(SPV_ERROR_INVALID_CFG, _.FindDef((*block)->id()))
+                 << "Maximum Control Flow nesting depth exceeded.";
         }
       }
     }
+  }
 
-    /// Structured control flow checks are only required for shader capabilities
-    if (_.HasCapability(SpvCapabilityShader)) {
-      if (auto error =
-              StructuredControlFlowChecks(_, &function, back_edges, postorder))
-        return error;
-    }
+  /// Structured control flow checks are only required for shader capabilities
+  if (_.HasCapability(SpvCapabilityShader)) {
+    if (auto error =
+            StructuredControlFlowChecks(_, &function, back_edges, postorder))
+      return error;
   }
   return SPV_SUCCESS;
 }
 
+spv_result_t PerformCfgChecks(ValidationState_t& _) {
+  std::vector<Function>& functions = _.functions();
+  std::vector<size_t> function_sizes;
+  for (const auto& range : GetFunctionInstructionRanges(_)) {
+    function_sizes.push_back(range.second - range.first);
+  }
+  assert(function_sizes.size() == functions.size());
+  // The control flow of an unchanged function was checked with the module
+  // that it is unchanged from.
+  for (size_t f = 0; f < functions.size(); ++f) {
+    if (_.IsUnchangedFunction(&functions[f])) function_sizes[f] = 0;
+  }
+  return CheckFunctionsInOrder(_, function_sizes, [&_, &functions](size_t f) {
+    if (_.IsUnchangedFunction(&functions[f])) return SPV_SUCCESS;
+    return PerformCfgChecks(_, functions[f]);
+  });
+}
+
 spv_result_t CfgPass(ValidationState_t& _, const Instruction* inst) {
   SpvOp opcode = inst->opcode();
   switch (opcode) {
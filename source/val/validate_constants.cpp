@@ -295,7 +295,7 @@ spv_result_t ValidateConstantSampler(ValidationState_t& _,
 // True if instruction defines a type that can have a null value, as defined by
 // the SPIR-V spec.  Tracks composite-type components through module to check
 // nullability transitively.
-bool IsTypeNullable(const std::vector<uint32_t>& instruction,
+bool IsTypeNullable(utils::Span<uint32_t> instruction,
                     const ValidationState_t& _) {
   uint16_t opcode;
   uint16_t word_count;
@@ -67,6 +67,40 @@ struct LayoutConstraints {
 using MemberConstraints = std::unordered_map<std::pair<uint32_t, uint32_t>,
                                              LayoutConstraints, PairHash>;
 
+// A type id with the layout rules that apply to it.
+using LayoutKey = std::tuple<uint32_t, uint32_t, uint32_t>;
+
+// A functor for hashing layout keys.
+struct LayoutKeyHash {
+  std::size_t operator()(const LayoutKey& key) const {
+    const uint32_t words[] = {std::get<0>(key), std::get<1>(key),
+                              std::get<2>(key)};
+    return static_cast<std::size_t>(utils::HashWords(words, 3));
+  }
+};
+
+// The layouts of the types of a module.  The layout of a type only depends on
+// the type and on the layout rules, and the same types are often used by many
+// buffers, so each layout is only computed once per module.
+struct LayoutCache {
+  // The layout constraints of struct members.
+  MemberConstraints constraints;
+  // The structs whose member constraints, and those of the structs they
+  // contain, are in |constraints|.
+  std::unordered_set<uint32_t> constrained_structs;
+  // The Offset of each member of a struct, by struct id.  The offset of a
+  // member without an Offset decoration is 0xffffffff.
+  std::unordered_map<uint32_t, std::vector<uint32_t>> member_offsets;
+  // The base alignments, by (type id, round up, majorness).
+  std::unordered_map<LayoutKey, uint32_t, LayoutKeyHash> base_alignments;
+  // The scalar alignments, by type id.
+  std::unordered_map<uint32_t, uint32_t> scalar_alignments;
+  // The sizes, by (type id, majorness, matrix stride).
+  std::unordered_map<LayoutKey, uint32_t, LayoutKeyHash> sizes;
+  // The (struct id, layout rules, offset) for which checkLayout succeeded.
+  std::unordered_set<LayoutKey, LayoutKeyHash> valid_layouts;
+};
+
 // Returns the array stride of the given array type.
 uint32_t GetArrayStride(uint32_t array_id, ValidationState_t& vstate) {
   for (auto& decoration : vstate.id_decorations(array_id)) {
@@ -151,6 +185,27 @@ bool isMissingOffsetInStruct(uint32_t struct_id, ValidationState_t& vstate) {
                       [](const bool b) { return b; });
 }
 
+// Returns the Offset of each member of the given structure, or 0xffffffff for
+// members without one.
+const std::vector<uint32_t>& getMemberOffsets(uint32_t struct_id,
+                                              LayoutCache& cache,
+                                              ValidationState_t& vstate) {
+  const auto cached = cache.member_offsets.find(struct_id);
+  if (cached != cache.member_offsets.end()) return cached->second;
+
+  std::vector<uint32_t>& offsets = cache.member_offsets[struct_id];
+  offsets.assign(getStructMembers(struct_id, vstate).size(), 0xffffffff);
+  for (auto& decoration : vstate.id_decorations(struct_id)) {
+    const int member = decoration.struct_member_index();
+    if (SpvDecorationOffset == decoration.dec_type() &&
+        Decoration::kInvalidMember != member &&
+        member < static_cast<int>(offsets.size())) {
+      offsets[member] = decoration.params()[0];
+    }
+  }
+  return offsets;
+}
+
 // Rounds x up to the next alignment. Assumes alignment is a power of two.
 uint32_t align(uint32_t x, uint32_t alignment) {
   return (x + alignment - 1) & ~(alignment - 1);
@@ -161,8 +216,11 @@ uint32_t align(uint32_t x, uint32_t alignment) {
 // bytes.
 uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
                           const LayoutConstraints& inherited,
-                          MemberConstraints& constraints,
-                          ValidationState_t& vstate) {
+                          LayoutCache& cache, ValidationState_t& vstate) {
+  const LayoutKey key(member_id, roundUp, inherited.majorness);
+  const auto cached = cache.base_alignments.find(key);
+  if (cached != cache.base_alignments.end()) return cached->second;
+
   const auto inst = vstate.FindDef(member_id);
   const auto& words = inst->words();
   // Minimal alignment is byte-aligned.
@@ -175,8 +233,8 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
     case SpvOpTypeVector: {
       const auto componentId = words[2];
       const auto numComponents = words[3];
-      const auto componentAlignment = getBaseAlignment(
-          componentId, roundUp, inherited, constraints, vstate);
+      const auto componentAlignment =
+          getBaseAlignment(componentId, roundUp, inherited, cache, vstate);
       baseAlignment =
           componentAlignment * (numComponents == 3 ? 4 : numComponents);
       break;
@@ -184,16 +242,16 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
     case SpvOpTypeMatrix: {
       const auto column_type = words[2];
       if (inherited.majorness == kColumnMajor) {
-        baseAlignment = getBaseAlignment(column_type, roundUp, inherited,
-                                         constraints, vstate);
+        baseAlignment =
+            getBaseAlignment(column_type, roundUp, inherited, cache, vstate);
       } else {
         // A row-major matrix of C columns has a base alignment equal to the
         // base alignment of a vector of C matrix components.
         const auto num_columns = words[3];
         const auto component_inst = vstate.FindDef(column_type);
         const auto component_id = component_inst->words()[2];
-        const auto componentAlignment = getBaseAlignment(
-            component_id, roundUp, inherited, constraints, vstate);
+        const auto componentAlignment =
+            getBaseAlignment(component_id, roundUp, inherited, cache, vstate);
         baseAlignment =
             componentAlignment * (num_columns == 3 ? 4 : num_columns);
       }
@@ -201,7 +259,7 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
     case SpvOpTypeArray:
     case SpvOpTypeRuntimeArray:
       baseAlignment =
-          getBaseAlignment(words[2], roundUp, inherited, constraints, vstate);
+          getBaseAlignment(words[2], roundUp, inherited, cache, vstate);
       if (roundUp) baseAlignment = align(baseAlignment, 16u);
       break;
     case SpvOpTypeStruct: {
@@ -210,10 +268,10 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
            memberIdx < numMembers; ++memberIdx) {
         const auto id = members[memberIdx];
         const auto& constraint =
-            constraints[std::make_pair(member_id, memberIdx)];
-        baseAlignment = std::max(
-            baseAlignment,
-            getBaseAlignment(id, roundUp, constraint, constraints, vstate));
+            cache.constraints[std::make_pair(member_id, memberIdx)];
+        baseAlignment =
+            std::max(baseAlignment,
+                     getBaseAlignment(id, roundUp, constraint, cache, vstate));
       }
       if (roundUp) baseAlignment = align(baseAlignment, 16u);
       break;
@@ -226,11 +284,16 @@ uint32_t getBaseAlignment(uint32_t member_id, bool roundUp,
       break;
   }
 
+  cache.base_alignments[key] = baseAlignment;
   return baseAlignment;
 }
 
-// Returns scalar alignment of a type.
-uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
+uint32_t getScalarAlignment(uint32_t type_id, LayoutCache& cache,
+                            ValidationState_t& vstate);
+
+// Computes the scalar alignment of a type.
+uint32_t computeScalarAlignment(uint32_t type_id, LayoutCache& cache,
+                                ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(type_id);
   const auto& words = inst->words();
   switch (inst->opcode()) {
@@ -242,7 +305,7 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
     case SpvOpTypeArray:
     case SpvOpTypeRuntimeArray: {
       const auto compositeMemberTypeId = words[2];
-      return getScalarAlignment(compositeMemberTypeId, vstate);
+      return getScalarAlignment(compositeMemberTypeId, cache, vstate);
     }
     case SpvOpTypeStruct: {
       const auto members = getStructMembers(type_id, vstate);
@@ -250,7 +313,7 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
       for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
            memberIdx < numMembers; ++memberIdx) {
         const auto id = members[memberIdx];
-        uint32_t member_alignment = getScalarAlignment(id, vstate);
+        uint32_t member_alignment = getScalarAlignment(id, cache, vstate);
         if (member_alignment > max_member_alignment) {
           max_member_alignment = member_alignment;
         }
@@ -267,10 +330,22 @@ uint32_t getScalarAlignment(uint32_t type_id, ValidationState_t& vstate) {
   return 1;
 }
 
-// Returns size of a struct member. Doesn't include padding at the end of struct
-// or array.  Assumes that in the struct case, all members have offsets.
+// Returns scalar alignment of a type.
+uint32_t getScalarAlignment(uint32_t type_id, LayoutCache& cache,
+                            ValidationState_t& vstate) {
+  const auto cached = cache.scalar_alignments.find(type_id);
+  if (cached != cache.scalar_alignments.end()) return cached->second;
+  const uint32_t alignment = computeScalarAlignment(type_id, cache, vstate);
+  cache.scalar_alignments[type_id] = alignment;
+  return alignment;
+}
+
 uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
-                 MemberConstraints& constraints, ValidationState_t& vstate) {
+                 LayoutCache& cache, ValidationState_t& vstate);
+
+// Computes the size of a struct member, like getSize.
+uint32_t computeSize(uint32_t member_id, const LayoutConstraints& inherited,
+                     LayoutCache& cache, ValidationState_t& vstate) {
   const auto inst = vstate.FindDef(member_id);
   const auto& words = inst->words();
   switch (inst->opcode()) {
@@ -280,8 +355,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
     case SpvOpTypeVector: {
       const auto componentId = words[2];
       const auto numComponents = words[3];
-      const auto componentSize =
-          getSize(componentId, inherited, constraints, vstate);
+      const auto componentSize = getSize(componentId, inherited, cache, vstate);
       const auto size = componentSize * numComponents;
       return size;
     }
@@ -291,8 +365,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       assert(SpvOpConstant == sizeInst->opcode());
       const uint32_t num_elem = sizeInst->words()[3];
       const uint32_t elem_type = words[2];
-      const uint32_t elem_size =
-          getSize(elem_type, inherited, constraints, vstate);
+      const uint32_t elem_size = getSize(elem_type, inherited, cache, vstate);
       // Account for gaps due to alignments in the first N-1 elements,
       // then add the size of the last element.
       const auto size =
@@ -312,7 +385,7 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
         const auto num_rows = component_inst->words()[3];
         const auto scalar_elem_type = component_inst->words()[2];
         const uint32_t scalar_elem_size =
-            getSize(scalar_elem_type, inherited, constraints, vstate);
+            getSize(scalar_elem_type, inherited, cache, vstate);
         return (num_rows - 1) * inherited.matrix_stride +
                num_columns * scalar_elem_size;
       }
@@ -322,19 +395,15 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
       if (members.empty()) return 0;
       const auto lastIdx = uint32_t(members.size() - 1);
       const auto& lastMember = members.back();
-      uint32_t offset = 0xffffffff;
       // Find the offset of the last element and add the size.
-      for (auto& decoration : vstate.id_decorations(member_id)) {
-        if (SpvDecorationOffset == decoration.dec_type() &&
-            decoration.struct_member_index() == (int)lastIdx) {
-          offset = decoration.params()[0];
-        }
-      }
+      const uint32_t offset =
+          getMemberOffsets(member_id, cache, vstate)[lastIdx];
       // This check depends on the fact that all members have offsets.  This
       // has been checked earlier in the flow.
       assert(offset != 0xffffffff);
-      const auto& constraint = constraints[std::make_pair(lastMember, lastIdx)];
-      return offset + getSize(lastMember, constraint, constraints, vstate);
+      const auto& constraint =
+          cache.constraints[std::make_pair(lastMember, lastIdx)];
+      return offset + getSize(lastMember, constraint, cache, vstate);
     }
     case SpvOpTypePointer:
       return vstate.pointer_size_and_alignment();
@@ -344,6 +413,18 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
   }
 }
 
+// Returns size of a struct member. Doesn't include padding at the end of struct
+// or array.  Assumes that in the struct case, all members have offsets.
+uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
+                 LayoutCache& cache, ValidationState_t& vstate) {
+  const LayoutKey key(member_id, inherited.majorness, inherited.matrix_stride);
+  const auto cached = cache.sizes.find(key);
+  if (cached != cache.sizes.end()) return cached->second;
+  const uint32_t size = computeSize(member_id, inherited, cache, vstate);
+  cache.sizes[key] = size;
+  return size;
+}
+
 // A member is defined to improperly straddle if either of the following are
 // true:
 // - It is a vector with total size less than or equal to 16 bytes, and has
@@ -353,9 +434,8 @@ uint32_t getSize(uint32_t member_id, const LayoutConstraints& inherited,
 // decorations placing its first byte at a non-integer multiple of 16.
 bool hasImproperStraddle(uint32_t id, uint32_t offset,
                          const LayoutConstraints& inherited,
-                         MemberConstraints& constraints,
-                         ValidationState_t& vstate) {
-  const auto size = getSize(id, inherited, constraints, vstate);
+                         LayoutCache& cache, ValidationState_t& vstate) {
+  const auto size = getSize(id, inherited, cache, vstate);
   const auto F = offset;
   const auto L = offset + size - 1;
   if (size <= 16) {
@@ -380,8 +460,7 @@ bool IsAlignedTo(uint32_t offset, uint32_t alignment) {
 spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
                          const char* decoration_str, bool blockRules,
                          bool scalar_block_layout,
-                         uint32_t incoming_offset,
-                         MemberConstraints& constraints,
+                         uint32_t incoming_offset, LayoutCache& cache,
                          ValidationState_t& vstate) {
   if (vstate.options()->skip_block_layout) return SPV_SUCCESS;
 
@@ -389,6 +468,13 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
   // standard layout extension is being used.
   if (vstate.options()->uniform_buffer_standard_layout) blockRules = false;
 
+  // The result only depends on the rules and on the offset of the struct, and
+  // the diagnostic is only emitted for the first failure.
+  const LayoutKey layout_key(
+      struct_id, (blockRules ? 1 : 0) | (scalar_block_layout ? 2 : 0),
+      incoming_offset);
+  if (cache.valid_layouts.count(layout_key)) return SPV_SUCCESS;
+
   // Relaxed layout and scalar layout can both be in effect at the same time.
   // For example, relaxed layout is implied by Vulkan 1.1.  But scalar layout
   // is more permissive than relaxed layout.
@@ -418,22 +504,12 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     uint32_t member;
     uint32_t offset;
   };
+  const auto& offsets = getMemberOffsets(struct_id, cache, vstate);
   std::vector<MemberOffsetPair> member_offsets;
   member_offsets.reserve(members.size());
   for (uint32_t memberIdx = 0, numMembers = uint32_t(members.size());
        memberIdx < numMembers; memberIdx++) {
-    uint32_t offset = 0xffffffff;
-    for (auto& decoration : vstate.id_decorations(struct_id)) {
-      if (decoration.struct_member_index() == (int)memberIdx) {
-        switch (decoration.dec_type()) {
-          case SpvDecorationOffset:
-            offset = decoration.params()[0];
-            break;
-          default:
-            break;
-        }
-      }
-    }
+    const uint32_t offset = offsets[memberIdx];
     member_offsets.push_back(
         MemberOffsetPair{memberIdx, incoming_offset + offset});
   }
@@ -452,17 +528,17 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     const auto offset = member_offset.offset;
     auto id = members[member_offset.member];
     const LayoutConstraints& constraint =
-        constraints[std::make_pair(struct_id, uint32_t(memberIdx))];
+        cache.constraints[std::make_pair(struct_id, uint32_t(memberIdx))];
     // Scalar layout takes precedence because it's more permissive, and implying
     // an alignment that divides evenly into the alignment that would otherwise
     // be used.
     const auto alignment =
         scalar_block_layout
-            ? getScalarAlignment(id, vstate)
-            : getBaseAlignment(id, blockRules, constraint, constraints, vstate);
+            ? getScalarAlignment(id, cache, vstate)
+            : getBaseAlignment(id, blockRules, constraint, cache, vstate);
     const auto inst = vstate.FindDef(id);
     const auto opcode = inst->opcode();
-    const auto size = getSize(id, constraint, constraints, vstate);
+    const auto size = getSize(id, constraint, cache, vstate);
     // Check offset.
     if (offset == 0xffffffff)
       return fail(memberIdx) << "is missing an Offset decoration";
@@ -471,7 +547,8 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
       // In relaxed block layout, the vector offset must be aligned to the
       // vector's scalar element type.
       const auto componentId = inst->words()[2];
-      const auto scalar_alignment = getScalarAlignment(componentId, vstate);
+      const auto scalar_alignment =
+          getScalarAlignment(componentId, cache, vstate);
       if (!IsAlignedTo(offset, scalar_alignment)) {
         return fail(memberIdx)
                << "at offset " << offset
@@ -492,7 +569,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (!scalar_block_layout && relaxed_block_layout) {
       // Check improper straddle of vectors.
       if (SpvOpTypeVector == opcode &&
-          hasImproperStraddle(id, offset, constraint, constraints, vstate))
+          hasImproperStraddle(id, offset, constraint, cache, vstate))
         return fail(memberIdx)
                << "is an improperly straddling vector at offset " << offset;
     }
@@ -501,8 +578,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
     if (SpvOpTypeStruct == opcode &&
         SPV_SUCCESS != (recursive_status = checkLayout(
                             id, storage_class_str, decoration_str, blockRules,
-                            scalar_block_layout,
-                            offset, constraints, vstate)))
+                            scalar_block_layout, offset, cache, vstate)))
       return recursive_status;
     // Check matrix stride.
     if (SpvOpTypeMatrix == opcode) {
@@ -555,7 +631,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
             SPV_SUCCESS != (recursive_status = checkLayout(
                                 typeId, storage_class_str, decoration_str,
                                 blockRules, scalar_block_layout,
-                                next_offset, constraints, vstate)))
+                                next_offset, cache, vstate)))
           return recursive_status;
         // If offsets accumulate up to a 16-byte multiple stop checking since
         // it will just repeat.
@@ -564,13 +640,14 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
 
       // Proceed to the element in case it is an array.
       array_inst = element_inst;
-      array_alignment = scalar_block_layout
-                            ? getScalarAlignment(array_inst->id(), vstate)
-                            : getBaseAlignment(array_inst->id(), blockRules,
-                                               constraint, constraints, vstate);
+      array_alignment =
+          scalar_block_layout
+              ? getScalarAlignment(array_inst->id(), cache, vstate)
+              : getBaseAlignment(array_inst->id(), blockRules, constraint,
+                                 cache, vstate);
 
       const auto element_size =
-          getSize(element_inst->id(), constraint, constraints, vstate);
+          getSize(element_inst->id(), constraint, cache, vstate);
       if (element_size > array_stride) {
         return fail(memberIdx)
                << "contains an array with stride " << array_stride
@@ -585,6 +662,7 @@ spv_result_t checkLayout(uint32_t struct_id, const char* storage_class_str,
       nextValidOffset = align(nextValidOffset, alignment);
     }
   }
+  cache.valid_layouts.insert(layout_key);
   return SPV_SUCCESS;
 }
 
@@ -905,6 +983,7 @@ void ComputeMemberConstraintsForArray(MemberConstraints* constraints,
 spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
   // Set of entry points that are known to use a push constant.
   std::unordered_set<uint32_t> uses_push_constant;
+  LayoutCache layout_cache;
   for (const auto& inst : vstate.ordered_instructions()) {
     const auto& words = inst.words();
     if (SpvOpVariable == inst.opcode()) {
@@ -996,9 +1075,12 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
         }
         // Struct requirement is checked on variables so just move on here.
         if (SpvOpTypeStruct != id_inst->opcode()) continue;
-        MemberConstraints constraints;
-        ComputeMemberConstraintsForStruct(&constraints, id, LayoutConstraints(),
-                                          vstate);
+        // The member constraints only depend on the decorations of the
+        // structs, so they are the same for every variable of the struct.
+        if (layout_cache.constrained_structs.insert(id).second) {
+          ComputeMemberConstraintsForStruct(&layout_cache.constraints, id,
+                                            LayoutConstraints(), vstate);
+        }
         // Prepare for messages
         const char* sc_str =
             uniform ? "Uniform"
@@ -1122,13 +1204,13 @@ spv_result_t CheckDecorationsOfBuffers(ValidationState_t& vstate) {
                        (SPV_SUCCESS != (recursive_status = checkLayout(
                                             id, sc_str, deco_str, true,
                                             scalar_block_layout, 0,
-                                            constraints, vstate)))) {
+                                            layout_cache, vstate)))) {
               return recursive_status;
             } else if (bufferRules &&
                        (SPV_SUCCESS != (recursive_status = checkLayout(
                                             id, sc_str, deco_str, false,
                                             scalar_block_layout, 0,
-                                            constraints, vstate)))) {
+                                            layout_cache, vstate)))) {
               return recursive_status;
             }
           }
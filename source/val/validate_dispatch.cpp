@@ -0,0 +1,443 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Selects the per-instruction validation passes to run for each opcode.
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "source/opcode.h"
+#include "source/spirv_validator_options.h"
+#include "source/table.h"
+#include "source/val/instruction.h"
+#include "source/val/validate.h"
+#include "source/val/validation_state.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+bool Contains(std::initializer_list<SpvOp> opcodes, SpvOp opcode) {
+  return std::find(opcodes.begin(), opcodes.end(), opcode) != opcodes.end();
+}
+
+// The functions below return true if their pass has checks for instructions
+// described by |entry|.  The opcode lists are copies of the cases that the
+// passes switch on and must be kept in sync with them by hand: a pass is not
+// run at all for the opcodes it is not listed for.  The dispatch tests run
+// every pass on every opcode it is skipped for to catch a missing case.
+
+bool MiscPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpUndef, SpvOpBeginInvocationInterlockEXT,
+                   SpvOpEndInvocationInterlockEXT,
+                   SpvOpDemoteToHelperInvocationEXT,
+                   SpvOpIsHelperInvocationEXT, SpvOpReadClockKHR,
+                   SpvOpAssumeTrueKHR, SpvOpExpectKHR},
+                  entry.opcode);
+}
+
+bool DebugPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpMemberName, SpvOpLine}, entry.opcode);
+}
+
+bool AnnotationPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpDecorate, SpvOpDecorateId, SpvOpMemberDecorate,
+                   SpvOpDecorationGroup, SpvOpGroupDecorate,
+                   SpvOpGroupMemberDecorate},
+                  entry.opcode);
+}
+
+bool ExtensionPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpExtension, SpvOpExtInstImport, SpvOpExtInst},
+                  entry.opcode);
+}
+
+bool ModeSettingPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpEntryPoint, SpvOpExecutionMode, SpvOpExecutionModeId,
+                   SpvOpMemoryModel},
+                  entry.opcode);
+}
+
+bool TypePassHasChecks(const spv_opcode_desc_t& entry) {
+  return spvOpcodeGeneratesType(entry.opcode) ||
+         entry.opcode == SpvOpTypeForwardPointer;
+}
+
+bool ConstantPassHasChecks(const spv_opcode_desc_t& entry) {
+  return spvOpcodeIsConstant(entry.opcode);
+}
+
+bool MemoryPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpVariable, SpvOpLoad, SpvOpStore, SpvOpCopyMemory,
+       SpvOpCopyMemorySized, SpvOpPtrAccessChain, SpvOpAccessChain,
+       SpvOpInBoundsAccessChain, SpvOpInBoundsPtrAccessChain,
+       SpvOpArrayLength, SpvOpCooperativeMatrixLoadNV,
+       SpvOpCooperativeMatrixStoreNV, SpvOpCooperativeMatrixLengthNV,
+       SpvOpPtrEqual, SpvOpPtrNotEqual, SpvOpPtrDiff},
+      entry.opcode);
+}
+
+bool FunctionPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpFunction, SpvOpFunctionParameter, SpvOpFunctionCall},
+                  entry.opcode);
+}
+
+bool ImagePassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpTypeImage,
+       SpvOpTypeSampledImage,
+       SpvOpSampledImage,
+       SpvOpImageTexelPointer,
+       SpvOpImageSampleImplicitLod,
+       SpvOpImageSampleExplicitLod,
+       SpvOpImageSampleProjImplicitLod,
+       SpvOpImageSampleProjExplicitLod,
+       SpvOpImageSparseSampleImplicitLod,
+       SpvOpImageSparseSampleExplicitLod,
+       SpvOpImageSampleDrefImplicitLod,
+       SpvOpImageSampleDrefExplicitLod,
+       SpvOpImageSampleProjDrefImplicitLod,
+       SpvOpImageSampleProjDrefExplicitLod,
+       SpvOpImageSparseSampleDrefImplicitLod,
+       SpvOpImageSparseSampleDrefExplicitLod,
+       SpvOpImageFetch,
+       SpvOpImageSparseFetch,
+       SpvOpImageGather,
+       SpvOpImageDrefGather,
+       SpvOpImageSparseGather,
+       SpvOpImageSparseDrefGather,
+       SpvOpImageRead,
+       SpvOpImageSparseRead,
+       SpvOpImageWrite,
+       SpvOpImage,
+       SpvOpImageQueryFormat,
+       SpvOpImageQueryOrder,
+       SpvOpImageQuerySizeLod,
+       SpvOpImageQuerySize,
+       SpvOpImageQueryLod,
+       SpvOpImageQueryLevels,
+       SpvOpImageQuerySamples,
+       SpvOpImageSparseSampleProjImplicitLod,
+       SpvOpImageSparseSampleProjExplicitLod,
+       SpvOpImageSparseSampleProjDrefImplicitLod,
+       SpvOpImageSparseSampleProjDrefExplicitLod,
+       SpvOpImageSparseTexelsResident},
+      entry.opcode);
+}
+
+bool ConversionPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpConvertFToU, SpvOpConvertFToS, SpvOpConvertSToF,
+       SpvOpConvertUToF, SpvOpUConvert, SpvOpSConvert, SpvOpFConvert,
+       SpvOpQuantizeToF16, SpvOpConvertPtrToU, SpvOpSatConvertSToU,
+       SpvOpSatConvertUToS, SpvOpConvertUToPtr, SpvOpPtrCastToGeneric,
+       SpvOpGenericCastToPtr, SpvOpGenericCastToPtrExplicit, SpvOpBitcast},
+      entry.opcode);
+}
+
+bool CompositesPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpVectorExtractDynamic, SpvOpVectorInsertDynamic,
+       SpvOpVectorShuffle, SpvOpCompositeConstruct, SpvOpCompositeExtract,
+       SpvOpCompositeInsert, SpvOpCopyObject, SpvOpTranspose,
+       SpvOpCopyLogical},
+      entry.opcode);
+}
+
+bool ArithmeticsPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpFAdd,
+       SpvOpFSub,
+       SpvOpFMul,
+       SpvOpFDiv,
+       SpvOpFRem,
+       SpvOpFMod,
+       SpvOpFNegate,
+       SpvOpUDiv,
+       SpvOpUMod,
+       SpvOpISub,
+       SpvOpIAdd,
+       SpvOpIMul,
+       SpvOpSDiv,
+       SpvOpSMod,
+       SpvOpSRem,
+       SpvOpSNegate,
+       SpvOpDot,
+       SpvOpVectorTimesScalar,
+       SpvOpMatrixTimesScalar,
+       SpvOpVectorTimesMatrix,
+       SpvOpMatrixTimesVector,
+       SpvOpMatrixTimesMatrix,
+       SpvOpOuterProduct,
+       SpvOpIAddCarry,
+       SpvOpISubBorrow,
+       SpvOpUMulExtended,
+       SpvOpSMulExtended,
+       SpvOpCooperativeMatrixMulAddNV},
+      entry.opcode);
+}
+
+bool BitwisePassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpShiftRightLogical, SpvOpShiftRightArithmetic,
+       SpvOpShiftLeftLogical, SpvOpBitwiseOr, SpvOpBitwiseXor,
+       SpvOpBitwiseAnd, SpvOpNot, SpvOpBitFieldInsert, SpvOpBitFieldSExtract,
+       SpvOpBitFieldUExtract, SpvOpBitReverse, SpvOpBitCount},
+      entry.opcode);
+}
+
+bool LogicalsPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpAny,
+       SpvOpAll,
+       SpvOpIsNan,
+       SpvOpIsInf,
+       SpvOpIsFinite,
+       SpvOpIsNormal,
+       SpvOpSignBitSet,
+       SpvOpFOrdEqual,
+       SpvOpFUnordEqual,
+       SpvOpFOrdNotEqual,
+       SpvOpFUnordNotEqual,
+       SpvOpFOrdLessThan,
+       SpvOpFUnordLessThan,
+       SpvOpFOrdGreaterThan,
+       SpvOpFUnordGreaterThan,
+       SpvOpFOrdLessThanEqual,
+       SpvOpFUnordLessThanEqual,
+       SpvOpFOrdGreaterThanEqual,
+       SpvOpFUnordGreaterThanEqual,
+       SpvOpLessOrGreater,
+       SpvOpOrdered,
+       SpvOpUnordered,
+       SpvOpLogicalEqual,
+       SpvOpLogicalNotEqual,
+       SpvOpLogicalOr,
+       SpvOpLogicalAnd,
+       SpvOpLogicalNot,
+       SpvOpSelect,
+       SpvOpIEqual,
+       SpvOpINotEqual,
+       SpvOpUGreaterThan,
+       SpvOpUGreaterThanEqual,
+       SpvOpULessThan,
+       SpvOpULessThanEqual,
+       SpvOpSGreaterThan,
+       SpvOpSGreaterThanEqual,
+       SpvOpSLessThan,
+       SpvOpSLessThanEqual},
+      entry.opcode);
+}
+
+bool ControlFlowPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpPhi, SpvOpBranch, SpvOpBranchConditional,
+                   SpvOpReturnValue, SpvOpSwitch, SpvOpLoopMerge},
+                  entry.opcode);
+}
+
+bool DerivativesPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpDPdx, SpvOpDPdy, SpvOpFwidth, SpvOpDPdxFine,
+                   SpvOpDPdyFine, SpvOpFwidthFine, SpvOpDPdxCoarse,
+                   SpvOpDPdyCoarse, SpvOpFwidthCoarse},
+                  entry.opcode);
+}
+
+bool AtomicsPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains(
+      {SpvOpAtomicLoad, SpvOpAtomicStore, SpvOpAtomicExchange,
+       SpvOpAtomicFAddEXT, SpvOpAtomicCompareExchange,
+       SpvOpAtomicCompareExchangeWeak, SpvOpAtomicIIncrement,
+       SpvOpAtomicIDecrement, SpvOpAtomicIAdd, SpvOpAtomicISub,
+       SpvOpAtomicSMin, SpvOpAtomicUMin, SpvOpAtomicFMinEXT, SpvOpAtomicSMax,
+       SpvOpAtomicUMax, SpvOpAtomicFMaxEXT, SpvOpAtomicAnd, SpvOpAtomicOr,
+       SpvOpAtomicXor, SpvOpAtomicFlagTestAndSet, SpvOpAtomicFlagClear},
+      entry.opcode);
+}
+
+bool PrimitivesPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpEmitVertex, SpvOpEndPrimitive, SpvOpEmitStreamVertex,
+                   SpvOpEndStreamPrimitive},
+                  entry.opcode);
+}
+
+bool BarriersPassHasChecks(const spv_opcode_desc_t& entry) {
+  return Contains({SpvOpControlBarrier, SpvOpMemoryBarrier,
+                   SpvOpNamedBarrierInitialize, SpvOpMemoryNamedBarrier},
+                  entry.opcode);
+}
+
+bool NonUniformPassHasChecks(const spv_opcode_desc_t& entry) {
+  return spvOpcodeIsNonUniformGroupOperation(entry.opcode) ||
+         entry.opcode == SpvOpGroupNonUniformBallotBitCount;
+}
+
+// Only literal numbers whose type comes from an id can be narrower than a
+// word, so only the operands that are parsed as such can fail the check.
+bool LiteralsPassHasChecks(const spv_opcode_desc_t& entry) {
+  for (uint16_t i = 0; i < entry.numTypes; ++i) {
+    switch (entry.operandTypes[i]) {
+      case SPV_OPERAND_TYPE_TYPED_LITERAL_NUMBER:
+      case SPV_OPERAND_TYPE_OPTIONAL_TYPED_LITERAL_INTEGER:
+      case SPV_OPERAND_TYPE_VARIABLE_LITERAL_INTEGER_ID:
+      // The operands of these depend on another opcode or another grammar.
+      case SPV_OPERAND_TYPE_SPEC_CONSTANT_OP_NUMBER:
+      case SPV_OPERAND_TYPE_EXTENSION_INSTRUCTION_NUMBER:
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+// The structural profile keeps the checks of the declarations of images
+// and extensions, which are part of the structure of the module, and skips
+// the checks of the instructions that use them.
+
+bool ExtensionPassIsSkippedByStructural(const spv_opcode_desc_t& entry) {
+  return entry.opcode == SpvOpExtInst;
+}
+
+bool ImagePassIsSkippedByStructural(const spv_opcode_desc_t& entry) {
+  return entry.opcode != SpvOpTypeImage &&
+         entry.opcode != SpvOpTypeSampledImage;
+}
+
+struct InstructionPassInfo {
+  InstructionPassFunction pass;
+  bool (*has_checks)(const spv_opcode_desc_t& entry);
+  // Returns true if the structural profile skips the pass for instructions
+  // described by |entry|.  Null if it never does.
+  bool (*is_skipped_by_structural)(const spv_opcode_desc_t& entry);
+};
+
+// Keep these passes in the order they appear in the SPIR-V specification
+// sections to maintain test consistency.
+const InstructionPassInfo kInstructionPasses[] = {
+    {MiscPass, MiscPassHasChecks, nullptr},
+    {DebugPass, DebugPassHasChecks, nullptr},
+    {AnnotationPass, AnnotationPassHasChecks, nullptr},
+    {ExtensionPass, ExtensionPassHasChecks,
+     ExtensionPassIsSkippedByStructural},
+    {ModeSettingPass, ModeSettingPassHasChecks, nullptr},
+    {TypePass, TypePassHasChecks, nullptr},
+    {ConstantPass, ConstantPassHasChecks, nullptr},
+    {MemoryPass, MemoryPassHasChecks, nullptr},
+    {FunctionPass, FunctionPassHasChecks, nullptr},
+    {ImagePass, ImagePassHasChecks, ImagePassIsSkippedByStructural},
+    {ConversionPass, ConversionPassHasChecks, nullptr},
+    {CompositesPass, CompositesPassHasChecks, nullptr},
+    {ArithmeticsPass, ArithmeticsPassHasChecks, nullptr},
+    {BitwisePass, BitwisePassHasChecks, nullptr},
+    {LogicalsPass, LogicalsPassHasChecks, nullptr},
+    {ControlFlowPass, ControlFlowPassHasChecks, nullptr},
+    {DerivativesPass, DerivativesPassHasChecks, nullptr},
+    {AtomicsPass, AtomicsPassHasChecks, nullptr},
+    {PrimitivesPass, PrimitivesPassHasChecks, nullptr},
+    {BarriersPass, BarriersPassHasChecks, nullptr},
+    // Group
+    // Device-Side Enqueue
+    // Pipe
+    {NonUniformPass, NonUniformPassHasChecks, nullptr},
+    {LiteralsPass, LiteralsPassHasChecks, nullptr},
+};
+
+const uint32_t kNumInstructionPasses =
+    sizeof(kInstructionPasses) / sizeof(kInstructionPasses[0]);
+static_assert(kNumInstructionPasses <= 32, "The pass masks are too small");
+
+const uint32_t kAllInstructionPasses =
+    static_cast<uint32_t>((uint64_t(1) << kNumInstructionPasses) - 1);
+
+// Maps each opcode to the masks of the passes in kInstructionPasses that have
+// checks for it under each profile.
+class InstructionPassTable {
+ public:
+  InstructionPassTable() {
+    spv_opcode_table table = nullptr;
+    spvOpcodeTableGet(&table, SPV_ENV_UNIVERSAL_1_0);
+    uint32_t max_opcode = 0;
+    for (uint32_t i = 0; i < table->count; ++i) {
+      max_opcode = std::max(max_opcode, uint32_t(table->entries[i].opcode));
+    }
+    masks_.assign(max_opcode + 1, kAllInstructionPasses);
+    structural_masks_.assign(max_opcode + 1, kAllInstructionPasses);
+    for (uint32_t i = 0; i < table->count; ++i) {
+      const spv_opcode_desc_t& entry = table->entries[i];
+      uint32_t mask = 0;
+      uint32_t structural_mask = 0;
+      for (uint32_t pass = 0; pass < kNumInstructionPasses; ++pass) {
+        const InstructionPassInfo& info = kInstructionPasses[pass];
+        if (!info.has_checks(entry)) continue;
+        mask |= 1u << pass;
+        if (!info.is_skipped_by_structural ||
+            !info.is_skipped_by_structural(entry)) {
+          structural_mask |= 1u << pass;
+        }
+      }
+      masks_[entry.opcode] = mask;
+      structural_masks_[entry.opcode] = structural_mask;
+    }
+  }
+
+  // Returns the mask of the passes to run on instructions with |opcode|.
+  // Opcodes missing from the grammar get every pass.
+  uint32_t Get(SpvOp opcode, bool all_checks) const {
+    const std::vector<uint32_t>& masks =
+        all_checks ? masks_ : structural_masks_;
+    return opcode < masks.size() ? masks[opcode] : kAllInstructionPasses;
+  }
+
+ private:
+  std::vector<uint32_t> masks_;
+  std::vector<uint32_t> structural_masks_;
+};
+
+const InstructionPassTable& GetInstructionPassTable() {
+  static const InstructionPassTable table;
+  return table;
+}
+
+}  // namespace
+
+spv_result_t ValidateInstruction(ValidationState_t& _,
+                                 const Instruction* inst) {
+  const bool all_checks = _.options()->profile == spv_validator_profile_full;
+
+  uint32_t passes = GetInstructionPassTable().Get(inst->opcode(), all_checks);
+  for (uint32_t pass = 0; passes != 0; ++pass, passes >>= 1) {
+    if (passes & 1) {
+      if (auto error = kInstructionPasses[pass].pass(_, inst)) return error;
+    }
+  }
+  return SPV_SUCCESS;
+}
+
+std::vector<InstructionPassFunction> GetSkippedInstructionPasses(
+    SpvOp opcode) {
+  const uint32_t passes = GetInstructionPassTable().Get(opcode, true);
+  std::vector<InstructionPassFunction> skipped;
+  for (uint32_t pass = 0; pass < kNumInstructionPasses; ++pass) {
+    if (!(passes & (1u << pass))) {
+      skipped.push_back(kInstructionPasses[pass].pass);
+    }
+  }
+  return skipped;
+}
+
+}  // namespace val
+}  // namespace spvtools
@@ -43,27 +43,30 @@ spv_result_t UpdateIdUse(ValidationState_t& _, const Instruction* inst) {
     const uint32_t operand_id = inst->word(operand.offset);
     if (spvIsIdType(type) && type != SPV_OPERAND_TYPE_RESULT_ID) {
       if (auto def = _.FindDef(operand_id))
-        def->RegisterUse(inst, operand.offset);
+        def->RegisterUse(inst, operand.offset, _.arena());
     }
   }
 
   return SPV_SUCCESS;
 }
 
-/// This function checks all ID definitions dominate their use in the CFG.
-///
-/// This function will iterate over all ID definitions that are defined in the
-/// functions of a module and make sure that the definitions appear in a
-/// block that dominates their use.
-///
-/// NOTE: This function does NOT check module scoped functions which are
-/// checked during the initial binary parse in the IdPass below
-spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
-  std::vector<const Instruction*> phi_instructions;
+namespace {
+
+// Checks that the ids defined by the instructions of _.ordered_instructions()
+// from |begin| to |end| dominate their uses.  The OpPhi instructions that use
+// them are added to |phi_instructions| instead, which is checked afterwards.
+spv_result_t CheckDefinitionsDominateUses(
+    ValidationState_t& _, size_t begin, size_t end,
+    std::vector<const Instruction*>* phi_instructions) {
   std::unordered_set<uint32_t> phi_ids;
-  for (const auto& inst : _.ordered_instructions()) {
+  const std::vector<Instruction>& instructions = _.ordered_instructions();
+  for (size_t i = begin; i < end; ++i) {
+    const Instruction& inst = instructions[i];
     if (inst.id() == 0) continue;
     if (const Function* func = inst.function()) {
+      // The dominator tree of an unchanged function is not computed, but only
+      // its uses in other functions can have changed.
+      const bool unchanged = _.IsUnchangedFunction(func);
       if (const BasicBlock* block = inst.block()) {
         // If the Id is defined within a block then make sure all references to
         // that Id appear in a blocks that are dominated by the defining block
@@ -71,9 +74,10 @@ spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
           const Instruction* use = use_index_pair.first;
           if (const BasicBlock* use_block = use->block()) {
             if (use_block->reachable() == false) continue;
+            if (unchanged && use->function() == func) continue;
             if (use->opcode() == SpvOpPhi) {
               if (phi_ids.insert(use->id()).second) {
-                phi_instructions.push_back(use);
+                phi_instructions->push_back(use);
               }
             } else if (!block->dominates(*use->block())) {
               return _.diag(SPV_ERROR_INVALID_ID, use_block->label())
@@ -103,6 +107,47 @@ spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
     // NOTE: Ids defined outside of functions must appear before they are used
     // This check is being performed in the IdPass function
   }
+  return SPV_SUCCESS;
+}
+
+}  // namespace
+
+/// This function checks all ID definitions dominate their use in the CFG.
+///
+/// This function will iterate over all ID definitions that are defined in the
+/// functions of a module and make sure that the definitions appear in a
+/// block that dominates their use.
+///
+/// NOTE: This function does NOT check module scoped functions which are
+/// checked during the initial binary parse in the IdPass below
+spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
+  // Only the ids defined in functions need to be checked, so the functions
+  // are checked separately, which CheckFunctionsInOrder can do in parallel.
+  const auto function_ranges = GetFunctionInstructionRanges(_);
+  std::vector<size_t> function_sizes;
+  for (const auto& range : function_ranges) {
+    function_sizes.push_back(range.second - range.first);
+  }
+  std::vector<std::vector<const Instruction*>> function_phis(
+      function_ranges.size());
+  if (auto error = CheckFunctionsInOrder(
+          _, function_sizes, [&_, &function_ranges, &function_phis](size_t f) {
+            return CheckDefinitionsDominateUses(_, function_ranges[f].first,
+                                                function_ranges[f].second,
+                                                &function_phis[f]);
+          })) {
+    return error;
+  }
+
+  // An OpPhi instruction can use ids of several functions when the module is
+  // invalid, so it is kept only the first time it is found.
+  std::vector<const Instruction*> phi_instructions;
+  std::unordered_set<uint32_t> phi_ids;
+  for (const auto& phis : function_phis) {
+    for (const Instruction* phi : phis) {
+      if (phi_ids.insert(phi->id()).second) phi_instructions.push_back(phi);
+    }
+  }
 
   // Check all OpPhi parent blocks are dominated by the variable's defining
   // blocks
@@ -112,7 +157,11 @@ spv_result_t CheckIdDefinitionDominateUse(ValidationState_t& _) {
       const Instruction* variable = _.FindDef(phi->word(i));
       const BasicBlock* parent =
           phi->function()->GetBlock(phi->word(i + 1)).first;
+      // Only the definitions from other functions need to be checked again
+      // in an unchanged function.
       if (variable->block() && parent->reachable() &&
+          (!_.IsUnchangedFunction(phi->function()) ||
+           variable->function() != phi->function()) &&
           !variable->block()->dominates(*parent)) {
         return _.diag(SPV_ERROR_INVALID_ID, phi)
                << "In OpPhi instruction " << _.getIdName(phi->id()) << ", ID "
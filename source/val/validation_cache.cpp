@@ -0,0 +1,312 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "source/spirv_validator_options.h"
+#include "source/util/hash.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace {
+
+// Identifies a file written by ValidationCache::Save, and its format.
+const uint32_t kFileMagic = 0x43565053;  // "SPVC" in little-endian order.
+const uint32_t kFileVersion = 1;
+
+// The key of a cache entry.  The size of the module is kept beside the hash
+// of its words, so that only modules of the same size can collide.
+struct Key {
+  uint64_t hash;
+  uint64_t size;
+
+  bool operator==(const Key& other) const {
+    return hash == other.hash && size == other.size;
+  }
+};
+
+struct KeyHash {
+  size_t operator()(const Key& key) const {
+    return static_cast<size_t>(key.hash);
+  }
+};
+
+// Returns the key for validating the |binary_size| words of |binary| for |env|
+// with |options|, or with the default options if |options| is null.
+Key MakeKey(spv_target_env env, const uint32_t* binary, size_t binary_size,
+            spv_validator_options options) {
+  const spv_validator_options_t default_options;
+  const spv_validator_options_t& opts = options ? *options : default_options;
+  const validator_universal_limits_t& limits = opts.universal_limits_;
+  // Everything that can change the verdict of the validator.  The parallel
+  // option is left out, since it only changes how the work is done.
+  const uint32_t settings[] = {
+      static_cast<uint32_t>(env),
+      limits.max_struct_members,
+      limits.max_struct_depth,
+      limits.max_local_variables,
+      limits.max_global_variables,
+      limits.max_switch_branches,
+      limits.max_function_args,
+      limits.max_control_flow_nesting_depth,
+      limits.max_access_chain_indexes,
+      limits.max_id_bound,
+      opts.relax_struct_store,
+      opts.relax_logical_pointer,
+      opts.relax_block_layout,
+      opts.uniform_buffer_standard_layout,
+      opts.scalar_block_layout,
+      opts.workgroup_scalar_block_layout,
+      opts.skip_block_layout,
+      opts.before_hlsl_legalization,
+      static_cast<uint32_t>(opts.profile),
+  };
+  // A different version of the validator may reach a different verdict.
+  const char* version = spvSoftwareVersionDetailsString();
+  uint64_t seed = utils::HashBytes(version, strlen(version));
+  seed =
+      utils::HashWords(settings, sizeof(settings) / sizeof(settings[0]), seed);
+  return {utils::HashWords(binary, binary_size, seed), binary_size};
+}
+
+template <typename T>
+void AppendValue(const T& value, std::vector<char>* buffer) {
+  const char* bytes = reinterpret_cast<const char*>(&value);
+  buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
+
+// Reads values from a buffer, failing instead of reading past its end.
+class BufferReader {
+ public:
+  BufferReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool Read(T* value) {
+    if (size_ - offset_ < sizeof(T)) return false;
+    memcpy(value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(size_t length, std::string* str) {
+    if (size_ - offset_ < length) return false;
+    str->assign(data_ + offset_, length);
+    offset_ += length;
+    return true;
+  }
+
+  bool AtEnd() const { return offset_ == size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+// Returns a name for a temporary file next to |filename|, which differs
+// between calls, threads and processes that save to the same file at once.
+std::string MakeTempFilename(const std::string& filename) {
+  static std::atomic<uint64_t> counter(0);
+  std::ostringstream name;
+  name << filename << ".tmp." << std::hex << std::random_device()() << "."
+       << std::chrono::steady_clock::now().time_since_epoch().count() << "."
+       << counter.fetch_add(1);
+  return name.str();
+}
+
+}  // namespace
+
+const size_t ValidationCache::kDefaultCapacity;
+
+struct ValidationCache::Impl {
+  using Entry = std::pair<Key, Result>;
+
+  explicit Impl(size_t max_entries) : capacity(max_entries) {}
+
+  // Records |result| for |key| as the most recently used entry.  The caller
+  // must hold |mutex|.
+  void Put(const Key& key, const Result& result);
+
+  const size_t capacity;
+  // Guards the members below.
+  mutable std::mutex mutex;
+  // The entries, from the most recently used to the least recently used.
+  std::list<Entry> entries;
+  // Maps the key of each entry to its position in |entries|.
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+};
+
+void ValidationCache::Impl::Put(const Key& key, const Result& result) {
+  if (capacity == 0) return;
+  auto found = index.find(key);
+  if (found != index.end()) {
+    found->second->second = result;
+    entries.splice(entries.begin(), entries, found->second);
+    return;
+  }
+  if (entries.size() == capacity) {
+    index.erase(entries.back().first);
+    entries.pop_back();
+  }
+  entries.emplace_front(key, result);
+  index[key] = entries.begin();
+}
+
+ValidationCache::ValidationCache(size_t capacity) : impl_(new Impl(capacity)) {}
+
+ValidationCache::~ValidationCache() {}
+
+size_t ValidationCache::size() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  return impl_->entries.size();
+}
+
+size_t ValidationCache::capacity() const { return impl_->capacity; }
+
+bool ValidationCache::Lookup(spv_target_env env, const uint32_t* binary,
+                             size_t binary_size,
+                             spv_validator_options options, Result* result) {
+  const Key key = MakeKey(env, binary, binary_size, options);
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  auto found = impl_->index.find(key);
+  if (found == impl_->index.end()) return false;
+  impl_->entries.splice(impl_->entries.begin(), impl_->entries, found->second);
+  *result = found->second->second;
+  return true;
+}
+
+void ValidationCache::Insert(spv_target_env env, const uint32_t* binary,
+                             size_t binary_size,
+                             spv_validator_options options,
+                             const Result& result) {
+  const Key key = MakeKey(env, binary, binary_size, options);
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->Put(key, result);
+}
+
+void ValidationCache::Clear() {
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  impl_->index.clear();
+  impl_->entries.clear();
+}
+
+bool ValidationCache::Load(const std::string& filename) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) return false;
+  const std::vector<char> buffer((std::istreambuf_iterator<char>(file)),
+                                 std::istreambuf_iterator<char>());
+  // The file ends with a hash of the rest, so that a truncated or corrupted
+  // file is rejected as a whole.
+  uint64_t checksum = 0;
+  if (buffer.size() < sizeof(checksum)) return false;
+  const size_t content_size = buffer.size() - sizeof(checksum);
+  memcpy(&checksum, buffer.data() + content_size, sizeof(checksum));
+  if (checksum != utils::HashBytes(buffer.data(), content_size)) return false;
+
+  BufferReader reader(buffer.data(), content_size);
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t count = 0;
+  if (!reader.Read(&magic) || magic != kFileMagic || !reader.Read(&version) ||
+      version != kFileVersion || !reader.Read(&count)) {
+    return false;
+  }
+  std::vector<Impl::Entry> loaded;
+  for (uint64_t i = 0; i < count; ++i) {
+    Key key;
+    int32_t status = 0;
+    uint64_t line = 0;
+    uint64_t column = 0;
+    uint64_t index = 0;
+    uint64_t message_length = 0;
+    Result result;
+    if (!reader.Read(&key.hash) || !reader.Read(&key.size) ||
+        !reader.Read(&status) || !reader.Read(&line) ||
+        !reader.Read(&column) || !reader.Read(&index) ||
+        !reader.Read(&message_length) ||
+        !reader.ReadString(static_cast<size_t>(message_length),
+                           &result.message)) {
+      return false;
+    }
+    result.status = static_cast<spv_result_t>(status);
+    result.position = {static_cast<size_t>(line), static_cast<size_t>(column),
+                       static_cast<size_t>(index)};
+    loaded.emplace_back(key, std::move(result));
+  }
+  if (!reader.AtEnd()) return false;
+
+  // The entries were saved from the least recently used, so putting them in
+  // order leaves the last one as the most recently used.
+  std::lock_guard<std::mutex> lock(impl_->mutex);
+  for (const auto& entry : loaded) impl_->Put(entry.first, entry.second);
+  return true;
+}
+
+bool ValidationCache::Save(const std::string& filename) const {
+  std::vector<char> buffer;
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    AppendValue(kFileMagic, &buffer);
+    AppendValue(kFileVersion, &buffer);
+    AppendValue(uint64_t(impl_->entries.size()), &buffer);
+    for (auto it = impl_->entries.rbegin(); it != impl_->entries.rend(); ++it) {
+      const Key& key = it->first;
+      const Result& result = it->second;
+      AppendValue(key.hash, &buffer);
+      AppendValue(key.size, &buffer);
+      AppendValue(int32_t(result.status), &buffer);
+      AppendValue(uint64_t(result.position.line), &buffer);
+      AppendValue(uint64_t(result.position.column), &buffer);
+      AppendValue(uint64_t(result.position.index), &buffer);
+      AppendValue(uint64_t(result.message.size()), &buffer);
+      buffer.insert(buffer.end(), result.message.begin(),
+                    result.message.end());
+    }
+  }
+  AppendValue(utils::HashBytes(buffer.data(), buffer.size()), &buffer);
+
+  // Write the whole file under another name first, so that a reader never
+  // sees a partly written file.
+  const std::string temp_filename = MakeTempFilename(filename);
+  {
+    std::ofstream file(temp_filename, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file) return false;
+  }
+  if (std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+    // Renaming over an existing file fails on some platforms.
+    std::remove(filename.c_str());
+    if (std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+      std::remove(temp_filename.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace spvtools
@@ -14,9 +14,13 @@
 
 #include "source/val/validation_state.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <stack>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "source/opcode.h"
 #include "source/spirv_constant.h"
@@ -30,6 +34,11 @@ namespace spvtools {
 namespace val {
 namespace {
 
+// The list that receives the diagnostics produced on the current thread, or
+// nullptr if they are reported right away.
+thread_local std::vector<ValidationState_t::DeferredDiagnostic>*
+    deferred_diagnostics = nullptr;
+
 ModuleLayoutSection InstructionLayoutSection(
     ModuleLayoutSection current_section, SpvOp op) {
   // See Section 2.4
@@ -151,8 +160,11 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
       module_functions_(),
       module_capabilities_(),
       module_extensions_(),
+      // Most instructions have about as many operands as words.
+      arena_(num_words * sizeof(spv_parsed_operand_t)),
       ordered_instructions_(),
       all_definitions_(),
+      id_bound_(0),
       global_vars_(),
       local_vars_(),
       struct_nesting_depth_(),
@@ -200,6 +212,9 @@ ValidationState_t::ValidationState_t(const spv_const_context ctx,
 void ValidationState_t::preallocateStorage() {
   ordered_instructions_.reserve(total_instructions_);
   module_functions_.reserve(total_functions_);
+  const uint32_t dense_ids = getDenseIdBound();
+  all_definitions_.Reset(dense_ids);
+  id_decorations_.Reset(dense_ids);
 }
 
 spv_result_t ValidationState_t::ForwardDeclareId(uint32_t id) {
@@ -244,19 +259,15 @@ std::vector<uint32_t> ValidationState_t::UnresolvedForwardIds() const {
 }
 
 bool ValidationState_t::IsDefinedId(uint32_t id) const {
-  return all_definitions_.find(id) != std::end(all_definitions_);
+  return all_definitions_.Get(id) != nullptr;
 }
 
 const Instruction* ValidationState_t::FindDef(uint32_t id) const {
-  auto it = all_definitions_.find(id);
-  if (it == all_definitions_.end()) return nullptr;
-  return it->second;
+  return all_definitions_.Get(id);
 }
 
 Instruction* ValidationState_t::FindDef(uint32_t id) {
-  auto it = all_definitions_.find(id);
-  if (it == all_definitions_.end()) return nullptr;
-  return it->second;
+  return all_definitions_.Get(id);
 }
 
 ModuleLayoutSection ValidationState_t::current_layout_section() const {
@@ -283,6 +294,21 @@ bool ValidationState_t::IsOpcodeInCurrentLayoutSection(SpvOp op) {
 
 DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
                                          const Instruction* inst) {
+  if (deferred_diagnostics) {
+    // The warnings are counted when the diagnostics are reported.
+    std::vector<DeferredDiagnostic>* diagnostics = deferred_diagnostics;
+    std::string disassembly;
+    if (inst) disassembly = Disassemble(*inst);
+    return DiagnosticStream(
+        {0, 0, inst ? inst->LineNum() : 0},
+        [diagnostics, error_code](spv_message_level_t level, const char*,
+                                  const spv_position_t& position,
+                                  const char* message) {
+          diagnostics->push_back({error_code, level, position, message});
+        },
+        disassembly, error_code);
+  }
+
   if (error_code == SPV_WARNING) {
     if (num_of_warnings_ == max_num_of_warnings_) {
       DiagnosticStream({0, 0, 0}, context_->consumer, "", error_code)
@@ -301,6 +327,34 @@ DiagnosticStream ValidationState_t::diag(spv_result_t error_code,
                           context_->consumer, disassembly, error_code);
 }
 
+ValidationState_t::DiagnosticDeferral::DiagnosticDeferral(
+    std::vector<DeferredDiagnostic>* diagnostics)
+    : previous_(deferred_diagnostics) {
+  deferred_diagnostics = diagnostics;
+}
+
+ValidationState_t::DiagnosticDeferral::~DiagnosticDeferral() {
+  deferred_diagnostics = previous_;
+}
+
+void ValidationState_t::ReportDeferredDiagnostics(
+    const std::vector<DeferredDiagnostic>& diagnostics) {
+  for (const auto& diagnostic : diagnostics) {
+    if (diagnostic.error == SPV_WARNING) {
+      if (num_of_warnings_ == max_num_of_warnings_) {
+        DiagnosticStream({0, 0, 0}, context_->consumer, "", SPV_WARNING)
+            << "Other warnings have been suppressed.\n";
+      }
+      if (num_of_warnings_ >= max_num_of_warnings_) continue;
+      ++num_of_warnings_;
+    }
+    if (context_->consumer) {
+      context_->consumer(diagnostic.level, "input", diagnostic.position,
+                         diagnostic.message.c_str());
+    }
+  }
+}
+
 std::vector<Function>& ValidationState_t::functions() {
   return module_functions_;
 }
@@ -315,6 +369,11 @@ const Function& ValidationState_t::current_function() const {
   return module_functions_.back();
 }
 
+const std::vector<Decoration>& ValidationState_t::id_decorations(
+    uint32_t id) const {
+  return id_decorations_.Get(id);
+}
+
 const Function* ValidationState_t::function(uint32_t id) const {
   const auto it = id_to_function_.find(id);
   if (it == id_to_function_.end()) return nullptr;
@@ -484,7 +543,13 @@ spv_result_t ValidationState_t::RegisterFunctionEnd() {
 
 Instruction* ValidationState_t::AddOrderedInstruction(
     const spv_parsed_instruction_t* inst) {
-  ordered_instructions_.emplace_back(inst);
+  const uint32_t* words = inst->words;
+  if (!std::less_equal<const uint32_t*>()(words_, words) ||
+      !std::less<const uint32_t*>()(words, words_ + num_words_)) {
+    words = arena_.Copy(inst->words, inst->num_words);
+  }
+  ordered_instructions_.emplace_back(
+      inst, words, arena_.Copy(inst->operands, inst->num_operands));
   ordered_instructions_.back().SetLineNum(ordered_instructions_.size());
   return &ordered_instructions_.back();
 }
@@ -518,7 +583,10 @@ void ValidationState_t::RegisterDebugInstruction(const Instruction* inst) {
 }
 
 void ValidationState_t::RegisterInstruction(Instruction* inst) {
-  if (inst->id()) all_definitions_.insert(std::make_pair(inst->id(), inst));
+  if (inst->id()) {
+    Instruction*& def = all_definitions_[inst->id()];
+    if (!def) def = inst;
+  }
 
   // If the instruction is using an OpTypeSampledImage as an operand, it should
   // be recorded. The validator will ensure that all usages of an
@@ -552,6 +620,11 @@ void ValidationState_t::RegisterSampledImageConsumer(uint32_t sampled_image_id,
 
 uint32_t ValidationState_t::getIdBound() const { return id_bound_; }
 
+uint32_t ValidationState_t::getDenseIdBound() const {
+  return static_cast<uint32_t>(
+      std::min(static_cast<size_t>(id_bound_), num_words_));
+}
+
 void ValidationState_t::setIdBound(const uint32_t bound) { id_bound_ = bound; }
 
 bool ValidationState_t::RegisterUniqueTypeDeclaration(const Instruction* inst) {
@@ -22,6 +22,7 @@
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "source/assembly_grammar.h"
@@ -32,6 +33,9 @@
 #include "source/name_mapper.h"
 #include "source/spirv_definition.h"
 #include "source/spirv_validator_options.h"
+#include "source/util/bit_vector.h"
+#include "source/util/hash.h"
+#include "source/util/id_map.h"
 #include "source/val/decoration.h"
 #include "source/val/function.h"
 #include "source/val/instruction.h"
@@ -169,6 +173,11 @@ class ValidationState_t {
   /// Accessor function for ID bound.
   uint32_t getIdBound() const;
 
+  /// Returns the bound of the ids that are worth keeping in vectors indexed
+  /// by id: the ID bound, but no more than the number of words of the module.
+  /// Like in the parser, larger ids only occur in sparse or invalid modules.
+  uint32_t getDenseIdBound() const;
+
   /// Mutator function for ID bound.
   void setIdBound(uint32_t bound);
 
@@ -207,6 +216,35 @@ class ValidationState_t {
 
   DiagnosticStream diag(spv_result_t error_code, const Instruction* inst);
 
+  /// A diagnostic produced by diag() whose reporting is deferred.
+  struct DeferredDiagnostic {
+    spv_result_t error;
+    spv_message_level_t level;
+    spv_position_t position;
+    std::string message;
+  };
+
+  /// While alive, makes the diagnostics produced by diag() on the current
+  /// thread be appended to a list instead of being reported.  This allows
+  /// functions to be checked in parallel, with their diagnostics reported
+  /// afterwards in the order of the module.
+  class DiagnosticDeferral {
+   public:
+    explicit DiagnosticDeferral(std::vector<DeferredDiagnostic>* diagnostics);
+    ~DiagnosticDeferral();
+
+    DiagnosticDeferral(const DiagnosticDeferral&) = delete;
+    DiagnosticDeferral& operator=(const DiagnosticDeferral&) = delete;
+
+   private:
+    std::vector<DeferredDiagnostic>* previous_;
+  };
+
+  /// Reports |diagnostics| as if diag() produced them now.  In particular,
+  /// the warnings count towards the maximum number of warnings.
+  void ReportDeferredDiagnostics(
+      const std::vector<DeferredDiagnostic>& diagnostics);
+
   /// Returns the function states
   std::vector<Function>& functions();
 
@@ -379,8 +417,35 @@ class ValidationState_t {
   const AssemblyGrammar& grammar() const { return grammar_; }
 
   /// Inserts the instruction into the list of ordered instructions in the file.
+  /// Its words are used in place when they are the words of the module, and
+  /// copied to the arena otherwise.  Its operands are copied to the arena.
   Instruction* AddOrderedInstruction(const spv_parsed_instruction_t* inst);
 
+  /// Returns the arena that holds the operands and the use lists of the
+  /// instructions.
+  utils::Arena* arena() { return &arena_; }
+
+  /// Records the ids of the functions that are identical to functions of a
+  /// module validated earlier, in a module whose other parts did not change
+  /// either.  The opcode checks are skipped for their instructions, and so are
+  /// their control flow checks and the dominance checks within them.
+  void set_unchanged_functions(std::unordered_set<uint32_t> ids) {
+    unchanged_functions_ = std::move(ids);
+  }
+
+  /// Returns true if |function| is one of the functions recorded by
+  /// set_unchanged_functions.
+  bool IsUnchangedFunction(const Function* function) const {
+    return unchanged_functions_.count(function->id()) != 0;
+  }
+
+  /// Returns true if |inst| is in the body of one of the functions recorded by
+  /// set_unchanged_functions.  The OpFunction instructions themselves are not
+  /// in the body.
+  bool IsInUnchangedFunction(const Instruction* inst) const {
+    return inst->function() && IsUnchangedFunction(inst->function());
+  }
+
   /// Registers the instruction. This will add the instruction to the list of
   /// definitions and register sampled image consumers.
   void RegisterInstruction(Instruction* inst);
@@ -417,25 +482,21 @@ class ValidationState_t {
   }
 
   /// Returns all the decorations for the given <id>. If no decorations exist
-  /// for the <id>, it registers an empty vector for it in the map and
-  /// returns the empty vector.
-  std::vector<Decoration>& id_decorations(uint32_t id) {
-    return id_decorations_[id];
-  }
+  /// for the <id>, returns an empty vector.  Does not modify the state, so
+  /// that it can be called while functions are checked in parallel.
+  const std::vector<Decoration>& id_decorations(uint32_t id) const;
 
   // Returns const pointer to the internal decoration container.
-  const std::map<uint32_t, std::vector<Decoration>>& id_decorations() const {
+  const utils::IdMap<std::vector<Decoration>>& id_decorations() const {
     return id_decorations_;
   }
 
   /// Returns true if the given id <id> has the given decoration <dec>,
   /// otherwise returns false.
   bool HasDecoration(uint32_t id, SpvDecoration dec) {
-    const auto& decorations = id_decorations_.find(id);
-    if (decorations == id_decorations_.end()) return false;
-
+    const auto& decorations = id_decorations_.Get(id);
     return std::any_of(
-        decorations->second.begin(), decorations->second.end(),
+        decorations.begin(), decorations.end(),
         [dec](const Decoration& d) { return dec == d.dec_type(); });
   }
 
@@ -453,7 +514,7 @@ class ValidationState_t {
   }
 
   /// Returns a map of instructions mapped by their result id
-  const std::unordered_map<uint32_t, Instruction*>& all_definitions() const {
+  const utils::IdMap<Instruction*>& all_definitions() const {
     return all_definitions_;
   }
 
@@ -465,11 +526,11 @@ class ValidationState_t {
   void RegisterSampledImageConsumer(uint32_t sampled_image_id,
                                     Instruction* consumer);
 
-  /// Returns the set of Global Variables.
-  std::unordered_set<uint32_t>& global_vars() { return global_vars_; }
+  /// Returns the Global Variables, in the order they are defined.
+  const std::vector<uint32_t>& global_vars() const { return global_vars_; }
 
-  /// Returns the set of Local Variables.
-  std::unordered_set<uint32_t>& local_vars() { return local_vars_; }
+  /// Returns the Local Variables, in the order they are defined.
+  const std::vector<uint32_t>& local_vars() const { return local_vars_; }
 
   /// Returns the number of Global Variables.
   size_t num_global_vars() { return global_vars_.size(); }
@@ -478,10 +539,10 @@ class ValidationState_t {
   size_t num_local_vars() { return local_vars_.size(); }
 
   /// Inserts a new <id> to the set of Global Variables.
-  void registerGlobalVariable(const uint32_t id) { global_vars_.insert(id); }
+  void registerGlobalVariable(const uint32_t id) { global_vars_.push_back(id); }
 
   /// Inserts a new <id> to the set of Local Variables.
-  void registerLocalVariable(const uint32_t id) { local_vars_.insert(id); }
+  void registerLocalVariable(const uint32_t id) { local_vars_.push_back(id); }
 
   // Returns true if using relaxed block layout, equivalent to
   // VK_KHR_relaxed_block_layout.
@@ -513,12 +574,12 @@ class ValidationState_t {
 
   /// Records that the structure type has a member decorated with a built-in.
   void RegisterStructTypeWithBuiltInMember(uint32_t id) {
-    builtin_structs_.insert(id);
+    builtin_structs_.Set(id);
   }
 
   /// Returns true if the struct type with the given Id has a BuiltIn member.
   bool IsStructTypeWithBuiltInMember(uint32_t id) const {
-    return (builtin_structs_.find(id) != builtin_structs_.end());
+    return builtin_structs_.Get(id);
   }
 
   // Returns the state of optional features.
@@ -616,57 +677,52 @@ class ValidationState_t {
   // in uniform storage class? The result is only valid after internal method
   // CheckDecorationsOfBuffers has been called.
   bool IsPointerToUniformBlock(uint32_t type_id) const {
-    return pointer_to_uniform_block_.find(type_id) !=
-           pointer_to_uniform_block_.cend();
+    return pointer_to_uniform_block_.Get(type_id);
   }
   // Save the ID of a pointer to uniform block.
   void RegisterPointerToUniformBlock(uint32_t type_id) {
-    pointer_to_uniform_block_.insert(type_id);
+    pointer_to_uniform_block_.Set(type_id);
   }
   // Is the ID the type of a struct used as a uniform block?
   // The result is only valid after internal method CheckDecorationsOfBuffers
   // has been called.
   bool IsStructForUniformBlock(uint32_t type_id) const {
-    return struct_for_uniform_block_.find(type_id) !=
-           struct_for_uniform_block_.cend();
+    return struct_for_uniform_block_.Get(type_id);
   }
   // Save the ID of a struct of a uniform block.
   void RegisterStructForUniformBlock(uint32_t type_id) {
-    struct_for_uniform_block_.insert(type_id);
+    struct_for_uniform_block_.Set(type_id);
   }
   // Is the ID the type of a pointer to a storage buffer: BufferBlock-decorated
   // struct in uniform storage class, or Block-decorated struct in StorageBuffer
   // storage class? The result is only valid after internal method
   // CheckDecorationsOfBuffers has been called.
   bool IsPointerToStorageBuffer(uint32_t type_id) const {
-    return pointer_to_storage_buffer_.find(type_id) !=
-           pointer_to_storage_buffer_.cend();
+    return pointer_to_storage_buffer_.Get(type_id);
   }
   // Save the ID of a pointer to a storage buffer.
   void RegisterPointerToStorageBuffer(uint32_t type_id) {
-    pointer_to_storage_buffer_.insert(type_id);
+    pointer_to_storage_buffer_.Set(type_id);
   }
   // Is the ID the type of a struct for storage buffer?
   // The result is only valid after internal method CheckDecorationsOfBuffers
   // has been called.
   bool IsStructForStorageBuffer(uint32_t type_id) const {
-    return struct_for_storage_buffer_.find(type_id) !=
-           struct_for_storage_buffer_.cend();
+    return struct_for_storage_buffer_.Get(type_id);
   }
   // Save the ID of a struct of a storage buffer.
   void RegisterStructForStorageBuffer(uint32_t type_id) {
-    struct_for_storage_buffer_.insert(type_id);
+    struct_for_storage_buffer_.Set(type_id);
   }
 
   // Is the ID the type of a pointer to a storage image?  That is, the pointee
   // type is an image type which is known to not use a sampler.
   bool IsPointerToStorageImage(uint32_t type_id) const {
-    return pointer_to_storage_image_.find(type_id) !=
-           pointer_to_storage_image_.cend();
+    return pointer_to_storage_image_.Get(type_id);
   }
   // Save the ID of a pointer to a storage image.
   void RegisterPointerToStorageImage(uint32_t type_id) {
-    pointer_to_storage_image_.insert(type_id);
+    pointer_to_storage_image_.Set(type_id);
   }
 
   // Tries to evaluate a 32-bit signed or unsigned scalar integer constant.
@@ -781,11 +837,16 @@ class ValidationState_t {
   /// Extensions declared in the module
   ExtensionSet module_extensions_;
 
+  /// Holds the operands and use lists of the instructions, and the words of
+  /// those that are not in the module as given, like after an endianness
+  /// conversion.
+  utils::Arena arena_;
+
   /// List of all instructions in the order they appear in the binary
   std::vector<Instruction> ordered_instructions_;
 
   /// Instructions that can be referenced by Ids
-  std::unordered_map<uint32_t, Instruction*> all_definitions_;
+  utils::IdMap<Instruction*> all_definitions_;
 
   /// IDs that are entry points, ie, arguments to OpEntryPoint.
   std::vector<uint32_t> entry_points_;
@@ -804,14 +865,15 @@ class ValidationState_t {
   /// ID Bound from the Header
   uint32_t id_bound_;
 
-  /// Set of Global Variable IDs (Storage Class other than 'Function')
-  std::unordered_set<uint32_t> global_vars_;
+  /// Global Variable IDs (Storage Class other than 'Function').  The parser
+  /// rejects ids that are defined twice, so each is registered once.
+  std::vector<uint32_t> global_vars_;
 
-  /// Set of Local Variable IDs ('Function' Storage Class)
-  std::unordered_set<uint32_t> local_vars_;
+  /// Local Variable IDs ('Function' Storage Class)
+  std::vector<uint32_t> local_vars_;
 
   /// Set of struct types that have members with a BuiltIn decoration.
-  std::unordered_set<uint32_t> builtin_structs_;
+  utils::BitVector builtin_structs_;
 
   /// Structure Nesting Depth
   std::unordered_map<uint32_t, uint32_t> struct_nesting_depth_;
@@ -821,13 +883,19 @@ class ValidationState_t {
       struct_has_nested_blockorbufferblock_struct_;
 
   /// Stores the list of decorations for a given <id>
-  std::map<uint32_t, std::vector<Decoration>> id_decorations_;
+  utils::IdMap<std::vector<Decoration>> id_decorations_;
+
+  /// Hashes the key of a type declaration in unique_type_declarations_.
+  struct TypeDeclarationHash {
+    size_t operator()(const std::vector<uint32_t>& key) const {
+      return static_cast<size_t>(utils::HashWords(key.data(), key.size()));
+    }
+  };
 
   /// Stores type declarations which need to be unique (i.e. non-aggregates),
   /// in the form [opcode, operand words], result_id is not stored.
-  /// Using ordered set to avoid the need for a vector hash function.
-  /// The size of this container is expected not to exceed double-digits.
-  std::set<std::vector<uint32_t>> unique_type_declarations_;
+  std::unordered_set<std::vector<uint32_t>, TypeDeclarationHash>
+      unique_type_declarations_;
 
   AssemblyGrammar grammar_;
 
@@ -864,20 +932,20 @@ class ValidationState_t {
 
   // The IDs of types of pointers to Block-decorated structs in Uniform storage
   // class. This is populated at the start of ValidateDecorations.
-  std::unordered_set<uint32_t> pointer_to_uniform_block_;
+  utils::BitVector pointer_to_uniform_block_;
   // The IDs of struct types for uniform blocks.
   // This is populated at the start of ValidateDecorations.
-  std::unordered_set<uint32_t> struct_for_uniform_block_;
+  utils::BitVector struct_for_uniform_block_;
   // The IDs of types of pointers to BufferBlock-decorated structs in Uniform
   // storage class, or Block-decorated structs in StorageBuffer storage class.
   // This is populated at the start of ValidateDecorations.
-  std::unordered_set<uint32_t> pointer_to_storage_buffer_;
+  utils::BitVector pointer_to_storage_buffer_;
   // The IDs of struct types for storage buffers.
   // This is populated at the start of ValidateDecorations.
-  std::unordered_set<uint32_t> struct_for_storage_buffer_;
+  utils::BitVector struct_for_storage_buffer_;
   // The IDs of types of pointers to storage images.  This is populated in the
   // TypePass.
-  std::unordered_set<uint32_t> pointer_to_storage_image_;
+  utils::BitVector pointer_to_storage_image_;
 
   /// Maps ids to friendly names.
   std::unique_ptr<spvtools::FriendlyNameMapper> friendly_mapper_;
@@ -886,6 +954,10 @@ class ValidationState_t {
   /// Variables used to reduce the number of diagnostic messages.
   uint32_t num_of_warnings_;
   uint32_t max_num_of_warnings_;
+
+  /// The functions whose instructions are not checked by the opcode checks.
+  /// See set_unchanged_functions.
+  std::unordered_set<uint32_t> unchanged_functions_;
 };
 
 }  // namespace val
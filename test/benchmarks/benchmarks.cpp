@@ -0,0 +1,251 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for the main stages of the SPIR-V tools: assembling,
+// disassembling, parsing, validating and optimizing.  Parsing is timed both
+// with spvBinaryParse and with spvBinaryParseOpcodes.  Each stage runs on
+// synthetic modules of several sizes, and on the modules in the corpus
+// directory.  Besides the time, each benchmark reports the throughput in
+// words of binary per second, and the peak resident set size of the process.
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+// windows.h must come first.
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "benchmark/benchmark.h"
+#include "spirv-tools/libspirv.h"
+#include "spirv-tools/libspirv.hpp"
+#include "spirv-tools/optimizer.hpp"
+#include "test/benchmarks/module_generator.h"
+
+namespace spvtools {
+namespace bench {
+namespace {
+
+const spv_target_env kEnv = SPV_ENV_UNIVERSAL_1_5;
+
+// The modules in the corpus directory, in assembly form.
+const char* kCorpusFiles[] = {
+    "compute_reduction.spvasm",
+    "fragment_lighting.spvasm",
+};
+
+enum class Stage {
+  kAssemble,
+  kDisassemble,
+  kParse,
+  kParseOpcodes,
+  kValidate,
+  kOptimizePerformance,
+  kOptimizeSize,
+};
+
+// Returns the peak resident set size of the process, in kilobytes.
+double PeakResidentSetKb() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return static_cast<double>(counters.PeakWorkingSetSize) / 1024;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#if defined(__APPLE__)
+  // macOS reports bytes rather than kilobytes.
+  return static_cast<double>(usage.ru_maxrss) / 1024;
+#else
+  return static_cast<double>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// The instruction callback of the parse stages.  Both parsers are given one,
+// since spvBinaryParseOpcodes stops after the header without it.
+spv_result_t IgnoreInstruction(void*, const spv_parsed_instruction_t*) {
+  return SPV_SUCCESS;
+}
+
+// Runs |stage| on the module with assembly text |text|, for as many
+// iterations as |state| asks for.
+void RunStage(benchmark::State& state, Stage stage, const std::string& text) {
+  spv_context context = spvContextCreate(kEnv);
+  std::vector<uint32_t> binary;
+  SpirvTools tools(kEnv);
+  if (!tools.Assemble(text, &binary)) {
+    spvContextDestroy(context);
+    state.SkipWithError("The module does not assemble.");
+    return;
+  }
+
+  Optimizer optimizer(kEnv);
+  optimizer.SetMessageConsumer(
+      [](spv_message_level_t, const char*, const spv_position_t&,
+         const char*) {});
+  if (stage == Stage::kOptimizePerformance) {
+    optimizer.RegisterPerformancePasses();
+  } else if (stage == Stage::kOptimizeSize) {
+    optimizer.RegisterSizePasses();
+  }
+
+  bool failed = false;
+  for (auto _ : state) {
+    spv_result_t result = SPV_SUCCESS;
+    switch (stage) {
+      case Stage::kAssemble: {
+        spv_binary output = nullptr;
+        result = spvTextToBinary(context, text.data(), text.size(), &output,
+                                 nullptr);
+        spvBinaryDestroy(output);
+      } break;
+      case Stage::kDisassemble: {
+        spv_text output = nullptr;
+        result = spvBinaryToText(context, binary.data(), binary.size(),
+                                 SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES,
+                                 &output, nullptr);
+        spvTextDestroy(output);
+      } break;
+      case Stage::kParse:
+        result = spvBinaryParse(context, nullptr, binary.data(), binary.size(),
+                                nullptr, IgnoreInstruction, nullptr);
+        break;
+      case Stage::kParseOpcodes:
+        result = spvBinaryParseOpcodes(context, nullptr, binary.data(),
+                                       binary.size(), nullptr,
+                                       IgnoreInstruction, nullptr);
+        break;
+      case Stage::kValidate: {
+        spv_const_binary_t input = {binary.data(), binary.size()};
+        result = spvValidate(context, &input, nullptr);
+      } break;
+      case Stage::kOptimizePerformance:
+      case Stage::kOptimizeSize: {
+        std::vector<uint32_t> output;
+        if (!optimizer.Run(binary.data(), binary.size(), &output)) {
+          result = SPV_ERROR_INTERNAL;
+        }
+        benchmark::DoNotOptimize(output.data());
+      } break;
+    }
+    if (result != SPV_SUCCESS) {
+      failed = true;
+      break;
+    }
+  }
+  spvContextDestroy(context);
+
+  if (failed) {
+    state.SkipWithError("The stage failed on the module.");
+    return;
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(binary.size() *
+                                               sizeof(uint32_t)));
+  state.counters["words/s"] =
+      benchmark::Counter(static_cast<double>(binary.size()),
+                         benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["peak_rss_kb"] = PeakResidentSetKb();
+}
+
+// Runs |stage| on a synthetic module whose parameters are the arguments of
+// the benchmark.
+void BM_Synthetic(benchmark::State& state, Stage stage) {
+  ModuleParameters parameters;
+  parameters.num_functions = static_cast<uint32_t>(state.range(0));
+  parameters.num_blocks = static_cast<uint32_t>(state.range(1));
+  parameters.num_types = static_cast<uint32_t>(state.range(2));
+  parameters.num_decorations = static_cast<uint32_t>(state.range(3));
+  RunStage(state, stage, GenerateModule(parameters));
+}
+
+// Adds the synthetic module sizes to |benchmark|.
+void SyntheticSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"functions", "blocks", "types", "decorations"});
+  benchmark->Args({10, 4, 10, 10});
+  benchmark->Args({100, 8, 100, 100});
+  benchmark->Args({1000, 16, 1000, 1000});
+  // Few large functions, then many small ones.
+  benchmark->Args({4, 1000, 10, 100});
+  benchmark->Args({10000, 1, 10, 100});
+}
+
+BENCHMARK_CAPTURE(BM_Synthetic, assemble, Stage::kAssemble)
+    ->Apply(SyntheticSizes);
+BENCHMARK_CAPTURE(BM_Synthetic, disassemble, Stage::kDisassemble)
+    ->Apply(SyntheticSizes);
+BENCHMARK_CAPTURE(BM_Synthetic, parse, Stage::kParse)->Apply(SyntheticSizes);
+BENCHMARK_CAPTURE(BM_Synthetic, parse_opcodes, Stage::kParseOpcodes)
+    ->Apply(SyntheticSizes);
+BENCHMARK_CAPTURE(BM_Synthetic, validate, Stage::kValidate)
+    ->Apply(SyntheticSizes);
+BENCHMARK_CAPTURE(BM_Synthetic, optimize_O, Stage::kOptimizePerformance)
+    ->Apply(SyntheticSizes);
+BENCHMARK_CAPTURE(BM_Synthetic, optimize_Os, Stage::kOptimizeSize)
+    ->Apply(SyntheticSizes);
+
+// Registers a benchmark of every stage for every module in the corpus.
+void RegisterCorpusBenchmarks() {
+  const struct {
+    Stage stage;
+    const char* name;
+  } stages[] = {
+      {Stage::kAssemble, "assemble"},
+      {Stage::kDisassemble, "disassemble"},
+      {Stage::kParse, "parse"},
+      {Stage::kParseOpcodes, "parse_opcodes"},
+      {Stage::kValidate, "validate"},
+      {Stage::kOptimizePerformance, "optimize_O"},
+      {Stage::kOptimizeSize, "optimize_Os"},
+  };
+
+  for (const char* file : kCorpusFiles) {
+    const std::string path = std::string(SPIRV_TOOLS_BENCH_CORPUS) + "/" + file;
+    std::ifstream input(path);
+    if (!input) {
+      fprintf(stderr, "warning: could not read corpus file '%s'\n",
+              path.c_str());
+      continue;
+    }
+    std::stringstream text;
+    text << input.rdbuf();
+    for (const auto& stage : stages) {
+      const std::string name =
+          std::string("BM_Corpus/") + stage.name + "/" + file;
+      benchmark::RegisterBenchmark(name.c_str(), RunStage, stage.stage,
+                                   text.str());
+    }
+  }
+}
+
+}  // namespace
+}  // namespace bench
+}  // namespace spvtools
+
+int main(int argc, char** argv) {
+  spvtools::bench::RegisterCorpusBenchmarks();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
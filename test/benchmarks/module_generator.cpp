@@ -0,0 +1,119 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test/benchmarks/module_generator.h"
+
+#include <algorithm>
+
+namespace spvtools {
+namespace bench {
+namespace {
+
+// Returns the name of an id that is local to function |function|.
+std::string LocalId(const char* prefix, uint32_t function, uint32_t index) {
+  return "%" + std::string(prefix) + std::to_string(function) + "_" +
+         std::to_string(index);
+}
+
+}  // namespace
+
+std::string GenerateModule(const ModuleParameters& parameters) {
+  const uint32_t num_blocks = std::max(parameters.num_blocks, 1u);
+  const uint64_t num_decorations =
+      std::min<uint64_t>(parameters.num_decorations,
+                         uint64_t(parameters.num_functions) * num_blocks);
+
+  std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main" %out
+OpExecutionMode %main OriginUpperLeft
+OpDecorate %out Location 0
+)";
+  for (uint64_t i = 0; i < num_decorations; ++i) {
+    const uint32_t function = static_cast<uint32_t>(i / num_blocks);
+    const uint32_t block = static_cast<uint32_t>(i % num_blocks);
+    text += "OpDecorate " + LocalId("sum", function, block) +
+            " RelaxedPrecision\n";
+  }
+
+  text += R"(%void = OpTypeVoid
+%bool = OpTypeBool
+%float = OpTypeFloat 32
+%uint = OpTypeInt 32 0
+%void_fn = OpTypeFunction %void
+%float_fn = OpTypeFunction %float %float
+%_ptr_Function_float = OpTypePointer Function %float
+%_ptr_Output_float = OpTypePointer Output %float
+%out = OpVariable %_ptr_Output_float Output
+%float_0 = OpConstant %float 0
+%float_1 = OpConstant %float 1
+)";
+  for (uint32_t i = 1; i <= parameters.num_types; ++i) {
+    const std::string n = std::to_string(i);
+    text += "%uint_" + n + " = OpConstant %uint " + n + "\n";
+    text += "%_arr_float_uint_" + n + " = OpTypeArray %float %uint_" + n + "\n";
+  }
+
+  for (uint32_t f = 0; f < parameters.num_functions; ++f) {
+    const std::string var = "%var" + std::to_string(f);
+    text += "%fn" + std::to_string(f) + " = OpFunction %float None %float_fn\n";
+    text += "%param" + std::to_string(f) + " = OpFunctionParameter %float\n";
+    for (uint32_t b = 0; b < num_blocks; ++b) {
+      const std::string load = LocalId("load", f, b);
+      const std::string sum = LocalId("sum", f, b);
+      text += LocalId("block", f, b) + " = OpLabel\n";
+      if (b == 0) {
+        text += var + " = OpVariable %_ptr_Function_float Function\n";
+        text += "OpStore " + var + " %param" + std::to_string(f) + "\n";
+      }
+      text += load + " = OpLoad %float " + var + "\n";
+      text += sum + " = OpFAdd %float " + load + " %float_1\n";
+      text += "OpStore " + var + " " + sum + "\n";
+      if (b + 1 == num_blocks) {
+        text += LocalId("result", f, b) + " = OpLoad %float " + var + "\n";
+        text += "OpReturnValue " + LocalId("result", f, b) + "\n";
+        break;
+      }
+
+      const std::string next = LocalId("block", f, b + 1);
+      const std::string then = LocalId("then", f, b);
+      const std::string product = LocalId("product", f, b);
+      text += LocalId("cond", f, b) + " = OpFOrdLessThan %bool " + sum +
+              " %float_0\n";
+      text += "OpSelectionMerge " + next + " None\n";
+      text += "OpBranchConditional " + LocalId("cond", f, b) + " " + then +
+              " " + next + "\n";
+      text += then + " = OpLabel\n";
+      text += product + " = OpFMul %float " + sum + " " + sum + "\n";
+      text += "OpStore " + var + " " + product + "\n";
+      text += "OpBranch " + next + "\n";
+    }
+    text += "OpFunctionEnd\n";
+  }
+
+  // The entry point calls every function, passing on the previous result.
+  text += "%main = OpFunction %void None %void_fn\n%main_entry = OpLabel\n";
+  std::string value = "%float_1";
+  for (uint32_t f = 0; f < parameters.num_functions; ++f) {
+    const std::string call = "%call" + std::to_string(f);
+    text += call + " = OpFunctionCall %float %fn" + std::to_string(f) + " " +
+            value + "\n";
+    value = call;
+  }
+  text += "OpStore %out " + value + "\nOpReturn\nOpFunctionEnd\n";
+  return text;
+}
+
+}  // namespace bench
+}  // namespace spvtools
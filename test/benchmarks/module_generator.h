@@ -0,0 +1,46 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEST_BENCHMARKS_MODULE_GENERATOR_H_
+#define TEST_BENCHMARKS_MODULE_GENERATOR_H_
+
+#include <cstdint>
+#include <string>
+
+namespace spvtools {
+namespace bench {
+
+// The size of a synthetic module.
+struct ModuleParameters {
+  // The number of functions, besides the entry point that calls them all.
+  uint32_t num_functions;
+  // The number of blocks in each function.  Each block but the last one is a
+  // selection header with one conditionally executed block, so a function
+  // has about twice as many basic blocks.
+  uint32_t num_blocks;
+  // The number of array types, each with its own length constant.
+  uint32_t num_types;
+  // The number of RelaxedPrecision decorations.  There is at most one per
+  // block, so at most |num_functions| * |num_blocks| are emitted.
+  uint32_t num_decorations;
+};
+
+// Returns the assembly text of a valid fragment shader of the given size.
+// The same parameters always give the same text.
+std::string GenerateModule(const ModuleParameters& parameters);
+
+}  // namespace bench
+}  // namespace spvtools
+
+#endif  // TEST_BENCHMARKS_MODULE_GENERATOR_H_
@@ -202,6 +202,17 @@ class BinaryParseTest : public spvtest::TextToBinaryTestBase<::testing::Test> {
 
   void Parse(const SpirvVector& words, spv_result_t expected_result,
              bool flip_words = false) {
+    Parse(spvBinaryParse, words, expected_result, flip_words);
+  }
+
+  // Like Parse, but uses spvBinaryParseOpcodes.
+  void ParseOpcodes(const SpirvVector& words, spv_result_t expected_result,
+                    bool flip_words = false) {
+    Parse(spvBinaryParseOpcodes, words, expected_result, flip_words);
+  }
+
+  void Parse(decltype(spvBinaryParse)* parse, const SpirvVector& words,
+             spv_result_t expected_result, bool flip_words) {
     SpirvVector flipped_words(words);
     SCOPED_TRACE(flip_words ? "Flipped Endianness" : "Normal Endianness");
     if (flip_words) {
@@ -214,9 +225,9 @@ class BinaryParseTest : public spvtest::TextToBinaryTestBase<::testing::Test> {
                      });
     }
     EXPECT_EQ(expected_result,
-              spvBinaryParse(ScopedContext().context, &client_,
-                             flipped_words.data(), flipped_words.size(),
-                             invoke_header, invoke_instruction, &diagnostic_));
+              parse(ScopedContext().context, &client_, flipped_words.data(),
+                    flipped_words.size(), invoke_header, invoke_instruction,
+                    &diagnostic_));
   }
 
   spv_diagnostic diagnostic_ = nullptr;
@@ -542,6 +553,55 @@ TEST_F(BinaryParseTest, ExtendedInstruction) {
   EXPECT_EQ(nullptr, diagnostic_);
 }
 
+TEST_F(BinaryParseTest, OpcodesOnlyGivesWordsWithoutOperands) {
+  for (bool endian_swap : kSwapEndians) {
+    const auto words = CompileSuccessfully(
+        "%1 = OpTypeVoid "
+        "%2 = OpTypeInt 32 1");
+    const auto void_inst = MakeInstruction(SpvOpTypeVoid, {1});
+    const auto i32_inst = MakeInstruction(SpvOpTypeInt, {2, 32, 1});
+    InSequence calls_expected_in_specific_order;
+    EXPECT_HEADER(3).WillOnce(Return(SPV_SUCCESS));
+    EXPECT_CALL(client_,
+                Instruction(ParsedInstruction(spv_parsed_instruction_t{
+                    void_inst.data(), static_cast<uint16_t>(void_inst.size()),
+                    SpvOpTypeVoid, SPV_EXT_INST_TYPE_NONE, 0, 0, nullptr, 0})))
+        .WillOnce(Return(SPV_SUCCESS));
+    EXPECT_CALL(client_,
+                Instruction(ParsedInstruction(spv_parsed_instruction_t{
+                    i32_inst.data(), static_cast<uint16_t>(i32_inst.size()),
+                    SpvOpTypeInt, SPV_EXT_INST_TYPE_NONE, 0, 0, nullptr, 0})))
+        .WillOnce(Return(SPV_SUCCESS));
+    ParseOpcodes(words, SPV_SUCCESS, endian_swap);
+    EXPECT_EQ(nullptr, diagnostic_);
+  }
+}
+
+TEST_F(BinaryParseTest, OpcodesOnlyWithoutInstructionCallbackParsesHeader) {
+  // The bad instruction is not reached.
+  auto words = CompileSuccessfully("%1 = OpTypeVoid");
+  words.push_back(0xffffffff);
+  EXPECT_HEADER(2).WillOnce(Return(SPV_SUCCESS));
+  EXPECT_EQ(SPV_SUCCESS,
+            spvBinaryParseOpcodes(ScopedContext().context, &client_,
+                                  words.data(), words.size(), invoke_header,
+                                  nullptr, &diagnostic_));
+  EXPECT_EQ(nullptr, diagnostic_);
+}
+
+TEST_F(BinaryParseTest, OpcodesOnlyDiagnosesTruncatedInstruction) {
+  auto words = CompileSuccessfully("%1 = OpTypeInt 32 1");
+  words.pop_back();
+  EXPECT_HEADER(2).WillOnce(Return(SPV_SUCCESS));
+  EXPECT_CALL(client_, Instruction(_)).Times(0);
+  ParseOpcodes(words, SPV_ERROR_INVALID_BINARY);
+  ASSERT_NE(nullptr, diagnostic_);
+  EXPECT_STREQ(
+      "End of input reached while decoding OpTypeInt starting at word 5: "
+      "expected 4 words, but found 3 words.",
+      diagnostic_->error);
+}
+
 // A binary parser diagnostic test case where we provide the words array
 // pointer and word count explicitly.
 struct WordsAndCountDiagnosticCase {
@@ -555,6 +555,72 @@ INSTANTIATE_TEST_SUITE_P(GeneratorStrings, GeneratorStringTest,
                              {65535, 32767, "Unknown(65535); 32767"},
                          }));
 
+using ParallelDisassemblyTest = spvtest::TextToBinaryTestBase<
+    ::testing::TestWithParam<uint32_t>>;
+
+TEST_P(ParallelDisassemblyTest, SameTextAsSerialDisassembly) {
+  // Enough functions that the module is split into several chunks.
+  std::string input = R"(
+OpCapability Shader
+OpCapability Float64
+%glsl = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+OpName %main "main"
+OpDecorate %one RelaxedPrecision
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%double = OpTypeFloat 64
+%int = OpTypeInt 32 1
+%one = OpConstant %float 1.5
+%tiny = OpConstant %float 0x1p-140
+%half = OpConstant %double -0.5
+%neg = OpConstant %int -7
+)";
+  for (int f = 0; f < 200; ++f) {
+    const std::string n = std::to_string(f);
+    input += (f == 0 ? "%main" : "%f" + n) + " = OpFunction %void None %fn\n";
+    input += "%entry" + n + " = OpLabel\n";
+    for (int i = 0; i < 10; ++i) {
+      const std::string x = "%x" + n + "_" + std::to_string(i);
+      input += x + " = OpExtInst %float %glsl Sqrt %one\n";
+      input += x + "a = OpFAdd %float " + x + " %one\n";
+    }
+    input += "OpSelectionMerge %merge" + n + " None\n";
+    input += "OpSwitch %neg %merge" + n + " -7 %merge" + n + "\n";
+    input += "%merge" + n + " = OpLabel\nOpReturn\nOpFunctionEnd\n";
+  }
+
+  const uint32_t options = GetParam();
+  const std::string serial = EncodeAndDecodeSuccessfully(input, options);
+  const std::string parallel = EncodeAndDecodeSuccessfully(
+      input, options | SPV_BINARY_TO_TEXT_OPTION_PARALLEL);
+  EXPECT_FALSE(serial.empty());
+  EXPECT_EQ(serial, parallel);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Options, ParallelDisassemblyTest,
+    ::testing::Values(
+        SPV_BINARY_TO_TEXT_OPTION_NONE, SPV_BINARY_TO_TEXT_OPTION_INDENT,
+        SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES,
+        SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET,
+        SPV_BINARY_TO_TEXT_OPTION_COLOR,
+        SPV_BINARY_TO_TEXT_OPTION_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+            SPV_BINARY_TO_TEXT_OPTION_COMMENT,
+        SPV_BINARY_TO_TEXT_OPTION_INDENT |
+            SPV_BINARY_TO_TEXT_OPTION_FRIENDLY_NAMES |
+            SPV_BINARY_TO_TEXT_OPTION_COMMENT |
+            SPV_BINARY_TO_TEXT_OPTION_SHOW_BYTE_OFFSET));
+
+TEST_F(TextToBinaryTest, ParallelDisassemblyOfModuleWithoutInstructions) {
+  EXPECT_EQ("", EncodeAndDecodeSuccessfully(
+                    "", SPV_BINARY_TO_TEXT_OPTION_PARALLEL));
+}
+
 // TODO(dneto): Test new instructions and enums in SPIR-V 1.3
 
 }  // namespace
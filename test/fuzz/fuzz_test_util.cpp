@@ -167,7 +167,7 @@ void ApplyAndCheckFreshIds(
       ir_context->get_def_use_mgr()->id_to_defs();
   std::unordered_set<uint32_t> fresh_ids_for_transformation =
       transformation.GetFreshIds();
-  for (auto& entry : after_transformation) {
+  for (const auto& entry : after_transformation) {
     uint32_t id = entry.first;
     bool introduced_by_transformation_message =
         fresh_ids_for_transformation.count(id);
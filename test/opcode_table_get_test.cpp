@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "gmock/gmock.h"
+#include "source/spirv_target_env.h"
 #include "test/unit_spirv.h"
 
 namespace spvtools {
@@ -32,6 +33,46 @@ TEST_P(GetTargetOpcodeTableGetTest, InvalidPointerTable) {
   ASSERT_EQ(SPV_ERROR_INVALID_POINTER, spvOpcodeTableGet(nullptr, GetParam()));
 }
 
+TEST_P(GetTargetOpcodeTableGetTest, LookupsFindEveryAvailableEntry) {
+  const spv_target_env env = GetParam();
+  spv_opcode_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOpcodeTableGet(&table, env));
+  const uint32_t version = spvVersionForTargetEnv(env);
+  for (uint32_t i = 0; i < table->count; ++i) {
+    const spv_opcode_desc_t& entry = table->entries[i];
+    const bool available =
+        (version >= entry.minVersion && version <= entry.lastVersion) ||
+        entry.numExtensions > 0u || entry.numCapabilities > 0u;
+    spv_opcode_desc found = nullptr;
+    if (!available) {
+      EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+                spvOpcodeTableNameLookup(env, table, entry.name, &found))
+          << entry.name;
+      continue;
+    }
+    ASSERT_EQ(SPV_SUCCESS,
+              spvOpcodeTableNameLookup(env, table, entry.name, &found))
+        << entry.name;
+    EXPECT_EQ(&entry, found) << entry.name;
+    ASSERT_EQ(SPV_SUCCESS,
+              spvOpcodeTableValueLookup(env, table, entry.opcode, &found))
+        << entry.name;
+    EXPECT_EQ(entry.opcode, found->opcode) << entry.name;
+  }
+}
+
+TEST_P(GetTargetOpcodeTableGetTest, NameLookupRejectsUnknownNames) {
+  const spv_target_env env = GetParam();
+  spv_opcode_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOpcodeTableGet(&table, env));
+  spv_opcode_desc found = nullptr;
+  for (const char* name : {"", "N", "Nopp", "OpNop", "nop", "NotAnOpcode"}) {
+    EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+              spvOpcodeTableNameLookup(env, table, name, &found))
+        << name;
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(OpcodeTableGet, GetTargetOpcodeTableGetTest,
                          ValuesIn(spvtest::AllTargetEnvironments()));
 
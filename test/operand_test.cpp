@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
 #include <vector>
 
+#include "source/spirv_target_env.h"
 #include "test/unit_spirv.h"
 
 namespace spvtools {
@@ -33,6 +35,54 @@ TEST_P(GetTargetTest, InvalidPointerTable) {
   ASSERT_EQ(SPV_ERROR_INVALID_POINTER, spvOperandTableGet(nullptr, GetParam()));
 }
 
+TEST_P(GetTargetTest, LookupsFindEveryAvailableEntry) {
+  const spv_target_env env = GetParam();
+  spv_operand_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOperandTableGet(&table, env));
+  const uint32_t version = spvVersionForTargetEnv(env);
+  for (uint32_t typeIndex = 0; typeIndex < table->count; ++typeIndex) {
+    const auto& group = table->types[typeIndex];
+    for (uint32_t i = 0; i < group.count; ++i) {
+      const spv_operand_desc_t& entry = group.entries[i];
+      const bool available =
+          (version >= entry.minVersion && version <= entry.lastVersion) ||
+          entry.numExtensions > 0u || entry.numCapabilities > 0u;
+      spv_operand_desc found = nullptr;
+      if (!available) {
+        EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+                  spvOperandTableNameLookup(env, table, group.type, entry.name,
+                                            strlen(entry.name), &found))
+            << entry.name;
+        continue;
+      }
+      ASSERT_EQ(SPV_SUCCESS,
+                spvOperandTableNameLookup(env, table, group.type, entry.name,
+                                          strlen(entry.name), &found))
+          << entry.name;
+      EXPECT_EQ(&entry, found) << entry.name;
+      ASSERT_EQ(SPV_SUCCESS, spvOperandTableValueLookup(
+                                 env, table, group.type, entry.value, &found))
+          << entry.name;
+      EXPECT_EQ(entry.value, found->value) << entry.name;
+    }
+  }
+}
+
+TEST_P(GetTargetTest, NameLookupUsesOnlyTheGivenLength) {
+  const spv_target_env env = GetParam();
+  spv_operand_table table;
+  ASSERT_EQ(SPV_SUCCESS, spvOperandTableGet(&table, env));
+  spv_operand_desc found = nullptr;
+  const char* name = "ShaderWithTrailingText";
+  ASSERT_EQ(SPV_SUCCESS,
+            spvOperandTableNameLookup(env, table, SPV_OPERAND_TYPE_CAPABILITY,
+                                      name, strlen("Shader"), &found));
+  EXPECT_STREQ("Shader", found->name);
+  EXPECT_EQ(SPV_ERROR_INVALID_LOOKUP,
+            spvOperandTableNameLookup(env, table, SPV_OPERAND_TYPE_CAPABILITY,
+                                      name, strlen("Shade"), &found));
+}
+
 INSTANTIATE_TEST_SUITE_P(OperandTableGet, GetTargetTest,
                          ValuesIn(std::vector<spv_target_env>{
                              SPV_ENV_UNIVERSAL_1_0, SPV_ENV_UNIVERSAL_1_1,
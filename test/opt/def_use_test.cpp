@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -1707,12 +1708,175 @@ TEST_F(UpdateUsesTest, KeepOldUses) {
   def->SetInOperands({{SPV_OPERAND_TYPE_ID, {25}}});
   context->UpdateDefUse(def);
 
-  auto users = def_use_mgr->id_to_users();
-  UserEntry entry = {def, use};
-  EXPECT_THAT(users, Contains(entry));
+  std::vector<Instruction*> users;
+  def_use_mgr->ForEachUser(
+      def, [&users](Instruction* user) { users.push_back(user); });
+  EXPECT_THAT(users, Contains(use));
 }
 // clang-format on
 
+// The number of instructions that use %uint_5 in UserListTest.  Erasing most
+// of them is enough to compact the user list, which happens once at least 8
+// users are erased and they make up more than half of the list.
+const uint32_t kNumUsers = 16;
+
+// Tests of how the users of an id are kept as users are erased and added
+// again, including while the users are being visited.
+class UserListTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::ostringstream text;
+    text << R"(OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%uint_1 = OpConstant %uint 1
+%uint_5 = OpConstant %uint 5
+%main = OpFunction %void None %void_fn
+%entry = OpLabel
+)";
+    for (uint32_t i = 0; i < kNumUsers; ++i) {
+      text << "%add" << i << " = OpIAdd %uint %uint_5 %uint_1\n";
+    }
+    text << "OpReturn\nOpFunctionEnd\n";
+
+    context_ = BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text.str());
+    ASSERT_NE(nullptr, context_);
+    def_use_mgr_ = context_->get_def_use_mgr();
+    constant_ = nullptr;
+    for (Instruction* constant : context_->GetConstants()) {
+      if (constant->GetSingleWordInOperand(0) == 5) constant_ = constant;
+    }
+    ASSERT_NE(nullptr, constant_);
+    for (Instruction& inst : *context_->module()->begin()->begin()) {
+      if (inst.opcode() == SpvOpIAdd) users_.push_back(&inst);
+    }
+    ASSERT_EQ(kNumUsers, users_.size());
+  }
+
+  // Returns the users of %uint_5 in the order they are visited.
+  std::vector<Instruction*> GetUsers() const {
+    std::vector<Instruction*> users;
+    def_use_mgr_->ForEachUser(
+        constant_, [&users](Instruction* user) { users.push_back(user); });
+    return users;
+  }
+
+  // Returns the users in |users_| from |begin| to |end|.
+  std::vector<Instruction*> Users(uint32_t begin, uint32_t end) const {
+    return std::vector<Instruction*>(users_.begin() + begin,
+                                     users_.begin() + end);
+  }
+
+  // Erases the uses of the users in |users_| from |begin| to |end|.
+  void EraseUsers(uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      def_use_mgr_->EraseUseRecordsOfOperandIds(users_[i]);
+    }
+  }
+
+  // Records again the uses of the users in |users_| from |begin| to |end|.
+  void AddUsers(uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+      def_use_mgr_->AnalyzeInstUse(users_[i]);
+    }
+  }
+
+  std::unique_ptr<IRContext> context_;
+  DefUseManager* def_use_mgr_ = nullptr;
+  Instruction* constant_ = nullptr;
+  std::vector<Instruction*> users_;
+};
+
+TEST_F(UserListTest, EraseFewUsers) {
+  EraseUsers(2, 6);
+  std::vector<Instruction*> expected = Users(0, 2);
+  for (Instruction* user : Users(6, kNumUsers)) expected.push_back(user);
+  EXPECT_EQ(expected, GetUsers());
+  EXPECT_EQ(kNumUsers - 4, NumUses(context_, constant_->result_id()));
+
+  AddUsers(2, 6);
+  EXPECT_EQ(users_, GetUsers());
+}
+
+TEST_F(UserListTest, EraseEnoughUsersToCompact) {
+  EraseUsers(1, 13);
+  std::vector<Instruction*> expected = Users(0, 1);
+  for (Instruction* user : Users(13, kNumUsers)) expected.push_back(user);
+  EXPECT_EQ(expected, GetUsers());
+  EXPECT_EQ(kNumUsers - 12, NumUses(context_, constant_->result_id()));
+
+  // The users are inserted again between the ones that were kept.
+  AddUsers(1, 13);
+  EXPECT_EQ(users_, GetUsers());
+  EXPECT_EQ(kNumUsers, NumUses(context_, constant_->result_id()));
+}
+
+TEST_F(UserListTest, EraseAllUsers) {
+  EraseUsers(0, kNumUsers);
+  EXPECT_TRUE(GetUsers().empty());
+
+  AddUsers(0, kNumUsers);
+  EXPECT_EQ(users_, GetUsers());
+}
+
+TEST_F(UserListTest, KillUsersWhileVisiting) {
+  // Killing the users after the first compacts the list under the
+  // iteration, which resumes after the user it last visited.
+  std::vector<Instruction*> visited;
+  def_use_mgr_->ForEachUser(constant_, [this, &visited](Instruction* user) {
+    if (user == users_[0]) {
+      for (Instruction* killed : Users(1, 13)) context_->KillInst(killed);
+    }
+    visited.push_back(user);
+  });
+  EXPECT_EQ(4u, visited.size());
+  EXPECT_EQ(users_[0], visited[0]);
+  EXPECT_EQ(Users(13, kNumUsers),
+            std::vector<Instruction*>(visited.begin() + 1, visited.end()));
+}
+
+TEST_F(UserListTest, AddUsersBeforeTheCurrentOneWhileVisiting) {
+  // The users added before the one being visited move it within the list.
+  // The iteration finds its place again and does not visit it twice.
+  EraseUsers(1, 13);
+  std::vector<Instruction*> visited;
+  def_use_mgr_->ForEachUser(constant_, [this, &visited](Instruction* user) {
+    if (user == users_[13]) AddUsers(1, 13);
+    visited.push_back(user);
+  });
+  std::vector<Instruction*> expected = Users(0, 1);
+  for (Instruction* user : Users(13, kNumUsers)) expected.push_back(user);
+  EXPECT_EQ(expected, visited);
+  EXPECT_EQ(users_, GetUsers());
+}
+
+TEST_F(UserListTest, AddUsersAfterTheCurrentOneWhileVisiting) {
+  EraseUsers(1, 13);
+  std::vector<Instruction*> visited;
+  def_use_mgr_->ForEachUser(constant_, [this, &visited](Instruction* user) {
+    if (user == users_[0]) AddUsers(1, 13);
+    visited.push_back(user);
+  });
+  EXPECT_EQ(users_, visited);
+}
+
+TEST_F(UserListTest, StopWhileVisitingAfterCompaction) {
+  std::vector<Instruction*> visited;
+  EXPECT_FALSE(def_use_mgr_->WhileEachUser(
+      constant_, [this, &visited](Instruction* user) {
+        if (user == users_[0]) EraseUsers(1, 13);
+        visited.push_back(user);
+        return user != users_[14];
+      }));
+  EXPECT_EQ(3u, visited.size());
+  EXPECT_EQ(users_[0], visited[0]);
+  EXPECT_EQ(users_[13], visited[1]);
+  EXPECT_EQ(users_[14], visited[2]);
+}
+
 }  // namespace
 }  // namespace analysis
 }  // namespace opt
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "source/opt/ir_allocator.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "source/opt/build_module.h"
+#include "source/opt/ir_context.h"
+
+namespace spvtools {
+namespace opt {
+namespace {
+
+const char kShader[] = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %main "main"
+               OpExecutionMode %main OriginUpperLeft
+       %void = OpTypeVoid
+          %3 = OpTypeFunction %void
+       %main = OpFunction %void None %3
+          %5 = OpLabel
+               OpReturn
+               OpFunctionEnd
+)";
+
+TEST(IRAllocatorTest, NoCurrentAllocatorUsesHeap) {
+  ASSERT_EQ(nullptr, IRAllocator::Current());
+  std::unique_ptr<Instruction> inst(new Instruction());
+  EXPECT_NE(nullptr, inst.get());
+}
+
+TEST(IRAllocatorTest, ScopesNest) {
+  std::unique_ptr<IRAllocator, IRAllocator::Releaser> outer(new IRAllocator());
+  std::unique_ptr<IRAllocator, IRAllocator::Releaser> inner(new IRAllocator());
+  {
+    IRAllocator::Scope outer_scope(outer.get());
+    EXPECT_EQ(outer.get(), IRAllocator::Current());
+    {
+      IRAllocator::Scope inner_scope(inner.get());
+      EXPECT_EQ(inner.get(), IRAllocator::Current());
+    }
+    EXPECT_EQ(outer.get(), IRAllocator::Current());
+  }
+  EXPECT_EQ(nullptr, IRAllocator::Current());
+}
+
+TEST(IRAllocatorTest, FreedSlotsAreReused) {
+  std::unique_ptr<IRAllocator, IRAllocator::Releaser> allocator(
+      new IRAllocator());
+  IRAllocator::Scope scope(allocator.get());
+
+  Instruction* first = new Instruction();
+  EXPECT_EQ(1u, allocator->live_objects());
+  const size_t capacity = allocator->capacity();
+  delete first;
+  EXPECT_EQ(0u, allocator->live_objects());
+
+  Instruction* second = new Instruction();
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(capacity, allocator->capacity());
+  delete second;
+}
+
+TEST(IRAllocatorTest, ObjectsMayOutliveTheAllocator) {
+  std::unique_ptr<Instruction> inst;
+  {
+    std::unique_ptr<IRAllocator, IRAllocator::Releaser> allocator(
+        new IRAllocator());
+    IRAllocator::Scope scope(allocator.get());
+    inst.reset(new Instruction());
+  }
+  // The allocator is destroyed with its last object.
+  inst.reset();
+}
+
+TEST(IRAllocatorTest, BuildModuleAllocatesFromTheContext) {
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, kShader,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, context);
+  EXPECT_EQ(nullptr, IRAllocator::Current());
+
+  size_t num_objects = 0;
+  context->module()->ForEachInst(
+      [&num_objects](Instruction*) { ++num_objects; });
+  for (auto& function : *context->module()) {
+    num_objects += function.end() - function.begin();
+  }
+  EXPECT_EQ(num_objects, context->allocator()->live_objects());
+
+  // Instructions created outside of a pass come from the heap.
+  std::unique_ptr<Instruction> inst(new Instruction(context.get(), SpvOpNop));
+  EXPECT_EQ(num_objects, context->allocator()->live_objects());
+}
+
+}  // namespace
+}  // namespace opt
+}  // namespace spvtools
@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "OpenCLDebugInfo100.h"
 #include "gmock/gmock.h"
@@ -281,6 +282,18 @@ TEST_F(IRContextTest, KillGroupDecoration) {
   EXPECT_EQ(inst, context->annotation_end());
 }
 
+TEST_F(IRContextTest, ForEachInParallelVisitsEveryIndexOnce) {
+  for (uint32_t num_threads : {1u, 0u, 3u}) {
+    IRContext context(SPV_ENV_UNIVERSAL_1_2, nullptr);
+    context.set_num_threads(num_threads);
+    std::vector<int> visits(100, 0);
+    context.ForEachInParallel(visits.size(), IRContext::kAnalysisDefUse,
+                              [&visits](size_t i) { ++visits[i]; });
+    EXPECT_THAT(visits, Each(1));
+    EXPECT_TRUE(context.AreAnalysesValid(IRContext::kAnalysisDefUse));
+  }
+}
+
 TEST_F(IRContextTest, TakeNextUniqueIdIncrementing) {
   const uint32_t NUM_TESTS = 1000;
   IRContext localContext(SPV_ENV_UNIVERSAL_1_2, nullptr);
@@ -816,6 +829,97 @@ OpFunctionEnd)";
   EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
 }
 
+TEST_F(IRContextTest, InvalidateModifiedFunctionsOnly) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpFunction %1 None %2
+%4 = OpLabel
+OpBranch %5
+%5 = OpLabel
+OpReturn
+OpFunctionEnd
+%6 = OpFunction %1 None %2
+%7 = OpLabel
+OpBranch %8
+%8 = OpLabel
+OpReturn
+OpFunctionEnd)";
+
+  std::unique_ptr<IRContext> ctx =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, ctx);
+  Function* modified = ctx->GetFunction(3);
+  Function* unmodified = ctx->GetFunction(6);
+
+  ctx->GetDominatorAnalysis(modified);
+  DominatorAnalysis* dom = ctx->GetDominatorAnalysis(unmodified);
+  PostDominatorAnalysis* post_dom = ctx->GetPostDominatorAnalysis(unmodified);
+  const BasicBlock* pseudo_entry = ctx->cfg()->pseudo_entry_block();
+
+  ctx->InvalidateAnalysesExceptFor(IRContext::kAnalysisNone, {modified});
+
+  // Only the analyses of the modified function are dropped.
+  EXPECT_FALSE(ctx->AreAnalysesValid(IRContext::kAnalysisCFG));
+  EXPECT_TRUE(ctx->AreAnalysesValid(IRContext::kAnalysisDominatorAnalysis));
+  EXPECT_EQ(dom, ctx->GetDominatorAnalysis(unmodified));
+  EXPECT_EQ(post_dom, ctx->GetPostDominatorAnalysis(unmodified));
+  EXPECT_TRUE(dom->Dominates(7, 8));
+
+  // The CFG is rebuilt in place, so the kept trees stay usable.
+  EXPECT_EQ(pseudo_entry, ctx->cfg()->pseudo_entry_block());
+  EXPECT_TRUE(ctx->GetDominatorAnalysis(modified)->Dominates(4, 5));
+}
+
+TEST_F(IRContextTest, CloneIsIndependentOfOriginal) {
+  const std::string text = R"(
+OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %4 "main"
+OpExecutionMode %4 OriginUpperLeft
+OpName %4 "main"
+%2 = OpTypeVoid
+%3 = OpTypeFunction %2
+%6 = OpTypeInt 32 1
+%7 = OpConstant %6 1
+%4 = OpFunction %2 None %3
+%5 = OpLabel
+%8 = OpIAdd %6 %7 %7
+OpReturn
+OpFunctionEnd)";
+
+  std::unique_ptr<IRContext> ctx =
+      BuildModule(SPV_ENV_UNIVERSAL_1_1, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(nullptr, ctx);
+  std::vector<uint32_t> original_binary;
+  ctx->module()->ToBinary(&original_binary, false);
+
+  std::unique_ptr<IRContext> clone = ctx->Clone();
+  ASSERT_NE(nullptr, clone);
+  std::vector<uint32_t> clone_binary;
+  clone->module()->ToBinary(&clone_binary, false);
+  EXPECT_EQ(original_binary, clone_binary);
+  EXPECT_EQ(ctx->module()->IdBound(), clone->module()->IdBound());
+
+  // Changing the clone leaves the original untouched.
+  Instruction* add = clone->get_def_use_mgr()->GetDef(8);
+  ASSERT_NE(nullptr, add);
+  EXPECT_EQ(clone.get(), add->context());
+  EXPECT_NE(ctx->get_def_use_mgr()->GetDef(8), add);
+  clone->KillInst(add);
+
+  std::vector<uint32_t> after_binary;
+  ctx->module()->ToBinary(&after_binary, false);
+  EXPECT_EQ(original_binary, after_binary);
+  EXPECT_NE(nullptr, ctx->get_def_use_mgr()->GetDef(8));
+  EXPECT_EQ(nullptr, clone->get_def_use_mgr()->GetDef(8));
+}
+
 TEST_F(IRContextTest, AsanErrorTest) {
   std::string shader = R"(
                OpCapability Shader
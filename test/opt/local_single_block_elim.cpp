@@ -13,7 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "test/opt/pass_fixture.h"
 #include "test/opt/pass_utils.h"
@@ -1452,6 +1454,54 @@ TEST_F(LocalSingleBlockLoadStoreElimTest, DebugValueTest) {
   SinglePassRunAndMatch<LocalSingleBlockLoadStoreElimPass>(text, false);
 }
 
+TEST_F(LocalSingleBlockLoadStoreElimTest, ParallelRunMatchesSerialRun) {
+  // Each function stores the value of a replaced load and loads it again.
+  // Finding the eliminations of several functions at the same time must give
+  // the same module as eliminating them one function at a time.
+  std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%float_fn = OpTypeFunction %float
+%_ptr_Function_float = OpTypePointer Function %float
+%float_1 = OpConstant %float 1
+)";
+  std::string functions;
+  std::string calls;
+  for (int i = 0; i < 16; ++i) {
+    const std::string n = std::to_string(i);
+    functions += "%f" + n + " = OpFunction %float None %float_fn\n" + "%l" +
+                 n + " = OpLabel\n" + "%v" + n +
+                 " = OpVariable %_ptr_Function_float Function\n" + "%w" + n +
+                 " = OpVariable %_ptr_Function_float Function\n" +
+                 "OpStore %v" + n + " %float_1\n" + "%a" + n +
+                 " = OpLoad %float %v" + n + "\n" + "OpStore %v" + n + " %a" +
+                 n + "\n" + "%b" + n + " = OpLoad %float %v" + n + "\n" +
+                 "%c" + n + " = OpLoad %float %w" + n + "\n" + "OpStore %w" +
+                 n + " %c" + n + "\n" + "%d" + n + " = OpFAdd %float %b" + n +
+                 " %c" + n + "\n" + "OpReturnValue %d" + n + "\n" +
+                 "OpFunctionEnd\n";
+    calls += "%r" + n + " = OpFunctionCall %float %f" + n + "\n";
+  }
+  text += "%main = OpFunction %void None %void_fn\n%main_label = OpLabel\n" +
+          calls + "OpReturn\nOpFunctionEnd\n" + functions;
+
+  std::vector<uint32_t> binaries[2];
+  for (uint32_t num_threads : {1u, 4u}) {
+    std::unique_ptr<IRContext> context =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+    ASSERT_NE(nullptr, context);
+    context->set_num_threads(num_threads);
+    LocalSingleBlockLoadStoreElimPass pass;
+    EXPECT_EQ(Pass::Status::SuccessWithChange, pass.Run(context.get()));
+    context->module()->ToBinary(&binaries[num_threads == 1 ? 0 : 1], false);
+  }
+  EXPECT_EQ(binaries[0], binaries[1]);
+}
+
 // TODO(greg-lunarg): Add tests to verify handling of these cases:
 //
 //    Other target variable types
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -118,6 +119,188 @@ TEST(Optimizer, CanRunTransformingPassWithAliasedVectors) {
   EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
 }
 
+TEST(Optimizer, CanRunSameOptimizerOnSeveralModules) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateStripDebugInfoPass());
+
+  for (const char* name : {"foo", "bar", "baz"}) {
+    std::vector<uint32_t> binary;
+    tools.Assemble(Header() + "OpName %" + name + " \"" + name + "\"\n%" +
+                       name + " = OpTypeVoid",
+                   &binary);
+    ASSERT_TRUE(opt.Run(binary.data(), binary.size(), &binary));
+
+    std::string disassembly;
+    tools.Disassemble(binary.data(), binary.size(), &disassembly);
+    EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+  }
+  EXPECT_THAT(opt.GetPassNames().size(), Eq(1u));
+}
+
+TEST(Optimizer, CanRunSameOptimizerFromSeveralThreads) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary_in;
+  tools.Assemble(Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid",
+                 &binary_in);
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateStripDebugInfoPass())
+      .RegisterPass(CreateUnifyConstantPass())
+      .RegisterPass(CreateCompactIdsPass());
+
+  const size_t kNumThreads = 4;
+  std::vector<std::vector<uint32_t>> binaries_out(kNumThreads);
+  std::vector<int> results(kNumThreads, 0);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&opt, &binary_in, &binaries_out, &results, i]() {
+      results[i] =
+          opt.Run(binary_in.data(), binary_in.size(), &binaries_out[i]);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    EXPECT_TRUE(results[i]);
+    std::string disassembly;
+    tools.Disassemble(binaries_out[i].data(), binaries_out[i].size(),
+                      &disassembly);
+    EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+  }
+}
+
+TEST(Optimizer, OutOfTreePassMakesOptimizerSingleUse) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary_in;
+  tools.Assemble(Header() + "OpName %foo \"foo\"\n%foo = OpTypeVoid",
+                 &binary_in);
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(Optimizer::PassToken(MakeUnique<NullPass>()));
+  std::vector<uint32_t> binary_out;
+  EXPECT_TRUE(opt.Run(binary_in.data(), binary_in.size(), &binary_out));
+  // The pass was consumed by the first run, so the second one does nothing.
+  EXPECT_TRUE(opt.Run(binary_in.data(), binary_in.size(), &binary_out));
+  EXPECT_THAT(opt.GetPassNames().size(), Eq(0u));
+}
+
+TEST(Optimizer, RunBatchOptimizesEveryModuleInOrder) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(8);
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    tools.Assemble(Header() + "OpName %foo \"foo" + std::to_string(i) +
+                       "\"\n%foo = OpTypeVoid",
+                   &binaries[i]);
+  }
+  // Make one module invalid: only its result fails.
+  binaries[3].resize(3);
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateStripDebugInfoPass())
+      .RegisterPass(CreateCompactIdsPass());
+  int num_consumer_messages = 0;
+  opt.SetMessageConsumer(
+      [&num_consumer_messages](spv_message_level_t, const char*,
+                               const spv_position_t&,
+                               const char*) { ++num_consumer_messages; });
+
+  auto results = opt.RunBatch(binaries, 3);
+  ASSERT_THAT(results.size(), Eq(binaries.size()));
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (i == 3) {
+      EXPECT_FALSE(results[i].success);
+      EXPECT_FALSE(results[i].messages.empty());
+      continue;
+    }
+    EXPECT_TRUE(results[i].success);
+    EXPECT_TRUE(results[i].messages.empty());
+    std::string disassembly;
+    tools.Disassemble(results[i].binary.data(), results[i].binary.size(),
+                      &disassembly);
+    EXPECT_THAT(disassembly, Eq(Header() + "%void = OpTypeVoid\n"));
+  }
+  // Messages are collected in the results instead.
+  EXPECT_THAT(num_consumer_messages, Eq(0));
+}
+
+TEST(Optimizer, RunBatchMatchesRun) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(4);
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    tools.Assemble(Header() + "%void = OpTypeVoid\n%int = OpTypeInt 32 1\n" +
+                       "%c = OpConstant %int " + std::to_string(i) +
+                       "\n%d = OpConstant %int " + std::to_string(i),
+                   &binaries[i]);
+  }
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(CreateUnifyConstantPass())
+      .RegisterPass(CreateCompactIdsPass());
+
+  auto results = opt.RunBatch(binaries, 0);
+  ASSERT_THAT(results.size(), Eq(binaries.size()));
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    std::vector<uint32_t> expected;
+    EXPECT_TRUE(opt.Run(binaries[i].data(), binaries[i].size(), &expected));
+    EXPECT_TRUE(results[i].success);
+    EXPECT_THAT(results[i].binary, Eq(expected));
+  }
+}
+
+TEST(Optimizer, RunBatchRejectsOutOfTreePasses) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<std::vector<uint32_t>> binaries(2);
+  for (auto& binary : binaries) {
+    tools.Assemble(Header() + "%void = OpTypeVoid", &binary);
+  }
+
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.RegisterPass(Optimizer::PassToken(MakeUnique<NullPass>()));
+  auto results = opt.RunBatch(binaries, 2);
+  ASSERT_THAT(results.size(), Eq(binaries.size()));
+  for (const auto& result : results) {
+    EXPECT_FALSE(result.success);
+    ASSERT_THAT(result.messages.size(), Eq(1u));
+    EXPECT_THAT(result.messages[0].level, Eq(SPV_MSG_ERROR));
+  }
+}
+
+TEST(Optimizer, ValidationCacheSkipsValidation) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  tools.Assemble(Header() + "%void = OpTypeVoid", &binary);
+
+  ValidatorOptions val_options;
+  OptimizerOptions opt_options;
+  opt_options.set_validator_options(val_options);
+  ValidationCache cache;
+  std::vector<std::string> messages;
+  Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
+  opt.SetMessageConsumer([&messages](spv_message_level_t, const char*,
+                                     const spv_position_t&,
+                                     const char* message) {
+    messages.push_back(message);
+  });
+  opt.SetValidationCache(&cache);
+
+  std::vector<uint32_t> optimized;
+  EXPECT_TRUE(opt.Run(binary.data(), binary.size(), &optimized, opt_options));
+  EXPECT_THAT(cache.size(), Eq(1u));
+
+  // A result in the cache is used instead of validating the module again.
+  ValidationCache::Result result;
+  result.status = SPV_ERROR_INVALID_DATA;
+  result.position = {0, 0, 0};
+  result.message = "from the cache";
+  cache.Insert(SPV_ENV_UNIVERSAL_1_0, binary.data(), binary.size(),
+               val_options, result);
+  EXPECT_FALSE(
+      opt.Run(binary.data(), binary.size(), &optimized, opt_options));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0], Eq("from the cache"));
+}
+
 TEST(Optimizer, CanValidateFlags) {
   Optimizer opt(SPV_ENV_UNIVERSAL_1_0);
   EXPECT_FALSE(opt.FlagHasValidForm("bad-flag"));
@@ -137,6 +137,39 @@ TEST_F(PassManagerTest, Run) {
   RunAndCheck(text, text + "OpNop\nOpNop\nOpNop\n");
 }
 
+TEST_F(PassManagerTest, InstantiateCreatesFreshPasses) {
+  const std::string text = "OpMemoryModel Logical GLSL450\nOpSource ESSL 310\n";
+
+  PassManager manager;
+  EXPECT_TRUE(manager.IsReusable());
+  manager.AddPass(MakeUnique<AppendMultipleOpNopPass>(2), []() {
+    return std::unique_ptr<Pass>(MakeUnique<AppendMultipleOpNopPass>(2));
+  });
+  EXPECT_TRUE(manager.IsReusable());
+
+  // Every instance runs its own copy of the pass, so they can all be run.
+  for (int i = 0; i < 3; ++i) {
+    std::unique_ptr<PassManager> instance = manager.Instantiate();
+    EXPECT_EQ(1u, instance->NumPasses());
+    std::unique_ptr<IRContext> context =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+    ASSERT_NE(nullptr, context);
+    EXPECT_EQ(Pass::Status::SuccessWithChange, instance->Run(context.get()));
+    std::vector<uint32_t> binary;
+    context->module()->ToBinary(&binary, /* skip_nop = */ false);
+    std::string disassembly;
+    SpirvTools tools(SPV_ENV_UNIVERSAL_1_2);
+    EXPECT_TRUE(tools.Disassemble(binary, &disassembly,
+                                  SPV_BINARY_TO_TEXT_OPTION_NO_HEADER));
+    EXPECT_EQ(text + "OpNop\nOpNop\n", disassembly);
+  }
+  EXPECT_EQ(1u, manager.NumPasses());
+
+  // A pass without a factory cannot be instantiated again.
+  manager.AddPass<AppendOpNopPass>();
+  EXPECT_FALSE(manager.IsReusable());
+}
+
 // A pass that appends an OpTypeVoid instruction that uses a given id.
 class AppendTypeVoidInstPass : public Pass {
  public:
@@ -186,6 +219,69 @@ TEST(PassManager, RecomputeIdBoundAutomatically) {
   EXPECT_THAT(GetIdBound(*context.module()), Eq(201u));
 }
 
+// A pass that reports a change to every function, without changing any.
+class MarkAllFunctionsPass : public Pass {
+ public:
+  const char* name() const override { return "MarkAllFunctionsPass"; }
+  bool TracksModifiedFunctions() const override { return true; }
+  Status Process() override {
+    for (auto& function : *get_module()) MarkFunctionModified(&function);
+    return Status::SuccessWithChange;
+  }
+};
+
+// A pass that removes the terminator of the last block of the first function,
+// and reports that function as modified.
+class RemoveTerminatorPass : public Pass {
+ public:
+  const char* name() const override { return "RemoveTerminatorPass"; }
+  bool TracksModifiedFunctions() const override { return true; }
+  Status Process() override {
+    Function* function = &*get_module()->begin();
+    context()->KillInst(function->tail()->terminator());
+    MarkFunctionModified(function);
+    return Status::SuccessWithChange;
+  }
+};
+
+TEST(PassManager, ValidateAfterAllChecksModifiedFunctions) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%f = OpFunction %void None %void_fn
+%f_entry = OpLabel
+OpReturn
+OpFunctionEnd
+%g = OpFunction %void None %void_fn
+%g_entry = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  std::vector<std::string> messages;
+  PassManager manager;
+  manager.SetMessageConsumer([&messages](spv_message_level_t, const char*,
+                                         const spv_position_t&,
+                                         const char* message) {
+    messages.push_back(message);
+  });
+  ValidatorOptions options;
+  manager.SetTargetEnv(SPV_ENV_UNIVERSAL_1_2)
+      .SetValidatorOptions(options)
+      .SetValidateAfterAll(true);
+  auto context = BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+  ASSERT_NE(nullptr, context);
+
+  manager.AddPass<MarkAllFunctionsPass>();
+  manager.AddPass<RemoveTerminatorPass>();
+  EXPECT_EQ(Pass::Status::Failure, manager.Run(context.get()));
+  ASSERT_FALSE(messages.empty());
+  EXPECT_EQ("Validation failed after pass RemoveTerminatorPass",
+            messages.back());
+}
+
 }  // anonymous namespace
 }  // namespace opt
 }  // namespace spvtools
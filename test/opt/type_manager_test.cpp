@@ -1168,6 +1168,51 @@ OpMemoryModel Logical GLSL450
   Match(text, context.get());
 }
 
+TEST(TypeManager, RegisteredTypesAreInterned) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%uint = OpTypeInt 32 0
+%1 = OpTypeStruct %uint
+%2 = OpTypeStruct %uint
+%3 = OpTypePointer Function %1
+  )";
+
+  std::unique_ptr<IRContext> context =
+      BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text,
+                  SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS);
+  ASSERT_NE(context, nullptr);
+  TypeManager* type_mgr = context->get_type_mgr();
+
+  // Types that are the same are one object.
+  Type* struct_type = type_mgr->GetType(1);
+  EXPECT_EQ(struct_type, type_mgr->GetType(2));
+  EXPECT_TRUE(struct_type->IsInternedBy(type_mgr));
+  EXPECT_EQ(struct_type, type_mgr->GetType(3)->AsPointer()->pointee_type());
+
+  // A type built outside of the manager hashes and compares the same as the
+  // interned type.
+  Integer uint_32(32, false);
+  Struct query({&uint_32});
+  EXPECT_FALSE(query.IsInternedBy(type_mgr));
+  EXPECT_EQ(query.HashValue(), struct_type->HashValue());
+  EXPECT_TRUE(query.IsSame(struct_type));
+  EXPECT_NE(0u, type_mgr->GetId(&query));
+  EXPECT_EQ(struct_type, type_mgr->GetRegisteredType(&query));
+
+  // A copy of an interned type is not interned.
+  std::unique_ptr<Type> copy = struct_type->Clone();
+  EXPECT_FALSE(copy->IsInternedBy(type_mgr));
+  EXPECT_TRUE(copy->IsSame(struct_type));
+  EXPECT_EQ(copy->HashValue(), struct_type->HashValue());
+
+  // Distinct interned types are different.
+  Type* uint_type = type_mgr->GetRegisteredType(&uint_32);
+  EXPECT_TRUE(uint_type->IsInternedBy(type_mgr));
+  EXPECT_FALSE(uint_type->IsSame(struct_type));
+}
+
 }  // namespace
 }  // namespace analysis
 }  // namespace opt
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "test/opt/pass_fixture.h"
 #include "test/opt/pass_utils.h"
@@ -1351,6 +1353,50 @@ OpFunctionEnd
   SinglePassRunAndMatch<VectorDCE>(text, true);
 }
 
+TEST_F(VectorDCETest, ParallelRunMatchesSerialRun) {
+  // Each function has a dead insert.  Finding the live components of several
+  // functions at the same time must give the same module as finding them one
+  // function at a time.
+  std::string text = R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+OpEntryPoint Fragment %main "main"
+OpExecutionMode %main OriginUpperLeft
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%float = OpTypeFloat 32
+%float_fn = OpTypeFunction %float
+%v2float = OpTypeVector %float 2
+%float_0 = OpConstant %float 0
+%float_1 = OpConstant %float 1
+%undef = OpUndef %v2float
+%main = OpFunction %void None %void_fn
+%main_label = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+  for (int i = 0; i < 16; ++i) {
+    const std::string n = std::to_string(i);
+    text += "%f" + n + " = OpFunction %float None %float_fn\n" + "%l" + n +
+            " = OpLabel\n" + "%a" + n +
+            " = OpCompositeInsert %v2float %float_1 %undef 0\n" + "%b" + n +
+            " = OpCompositeInsert %v2float %float_0 %a" + n + " 0\n" + "%c" +
+            n + " = OpCompositeExtract %float %b" + n + " 0\n" +
+            "OpReturnValue %c" + n + "\n" + "OpFunctionEnd\n";
+  }
+
+  std::vector<uint32_t> binaries[2];
+  for (uint32_t num_threads : {1u, 4u}) {
+    std::unique_ptr<IRContext> context =
+        BuildModule(SPV_ENV_UNIVERSAL_1_2, nullptr, text);
+    ASSERT_NE(nullptr, context);
+    context->set_num_threads(num_threads);
+    VectorDCE pass;
+    EXPECT_EQ(Pass::Status::SuccessWithChange, pass.Run(context.get()));
+    context->module()->ToBinary(&binaries[num_threads == 1 ? 0 : 1], false);
+  }
+  EXPECT_EQ(binaries[0], binaries[1]);
+}
+
 }  // namespace
 }  // namespace opt
 }  // namespace spvtools
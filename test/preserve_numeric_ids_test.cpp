@@ -155,5 +155,86 @@ OpFunctionEnd
   EXPECT_EQ(expected, after);
 }
 
+TEST(TextHandler, PreserveNumericIdsThatAppearAfterNamedIds) {
+  // The named ids are seen first, but must still avoid the numeric ids that
+  // appear later in the text.
+  const std::string before =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%fn = OpTypeFunction %void
+%main = OpFunction %void None %fn
+%1 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  const std::string expected =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+%2 = OpTypeVoid
+%4 = OpTypeFunction %2
+%5 = OpFunction %2 None %4
+%1 = OpLabel
+OpBranch %3
+%3 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  std::string after;
+  EXPECT_EQ(SPV_SUCCESS,
+            ToBinaryAndBack(before, &after,
+                            SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS,
+                            SPV_BINARY_TO_TEXT_OPTION_NO_HEADER));
+
+  EXPECT_EQ(expected, after);
+}
+
+TEST(TextHandler, PreserveNumericIdsSetsBoundFromLargestId) {
+  const std::string text =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%50 = OpTypeFunction %void
+)";
+
+  ScopedContext ctx;
+  spv_binary binary = nullptr;
+  ASSERT_EQ(SPV_SUCCESS,
+            spvTextToBinaryWithOptions(
+                ctx.context, text.c_str(), text.size(),
+                SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS, &binary,
+                nullptr));
+  EXPECT_EQ(51u, binary->code[SPV_INDEX_BOUND]);
+  spvBinaryDestroy(binary);
+}
+
+TEST(TextHandler, PreserveNumericIdsTreatsEqualValuesAsOneId) {
+  const std::string before =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+%7 = OpTypeVoid
+%fn = OpTypeFunction %007
+)";
+
+  const std::string expected =
+      R"(OpCapability Shader
+OpMemoryModel Logical GLSL450
+%7 = OpTypeVoid
+%1 = OpTypeFunction %7
+)";
+
+  std::string after;
+  EXPECT_EQ(SPV_SUCCESS,
+            ToBinaryAndBack(before, &after,
+                            SPV_TEXT_TO_BINARY_OPTION_PRESERVE_NUMERIC_IDS,
+                            SPV_BINARY_TO_TEXT_OPTION_NO_HEADER));
+
+  EXPECT_EQ(expected, after);
+}
+
 }  // namespace
 }  // namespace spvtools
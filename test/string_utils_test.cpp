@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -50,6 +51,41 @@ TEST(ToString, Double) {
   EXPECT_EQ("-1.5", ToString(-1.5));
 }
 
+TEST(AppendUnsigned, MatchesToString) {
+  for (uint64_t value : {uint64_t(0), uint64_t(7), uint64_t(10), uint64_t(1000),
+                         uint64_t(0xffffffff), ~uint64_t(0)}) {
+    std::string text = "x";
+    AppendUnsigned(value, &text);
+    EXPECT_EQ("x" + ToString(value), text);
+  }
+}
+
+TEST(AppendSigned, MatchesToString) {
+  for (int64_t value :
+       {int64_t(0), int64_t(-1), int64_t(1000), int64_t(-2147483648LL),
+        std::numeric_limits<int64_t>::min(),
+        std::numeric_limits<int64_t>::max()}) {
+    std::string text;
+    AppendSigned(value, &text);
+    EXPECT_EQ(ToString(value), text);
+  }
+}
+
+TEST(AppendHex, PadsToMinimumDigits) {
+  std::string text;
+  AppendHex(0, 8, &text);
+  EXPECT_EQ("00000000", text);
+  text.clear();
+  AppendHex(0xbeef, 8, &text);
+  EXPECT_EQ("0000beef", text);
+  text.clear();
+  AppendHex(0x123456789aULL, 8, &text);
+  EXPECT_EQ("123456789a", text);
+  text.clear();
+  AppendHex(0, 0, &text);
+  EXPECT_EQ("0", text);
+}
+
 TEST(CardinalToOrdinal, Test) {
   EXPECT_EQ("1st", CardinalToOrdinal(1));
   EXPECT_EQ("2nd", CardinalToOrdinal(2));
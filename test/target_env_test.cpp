@@ -12,10 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <thread>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "source/spirv_target_env.h"
+#include "source/table.h"
 #include "test/unit_spirv.h"
 
 namespace spvtools {
@@ -34,6 +36,32 @@ TEST_P(TargetEnvTest, CreateContext) {
   spvContextDestroy(context);  // Avoid leaking
 }
 
+TEST_P(TargetEnvTest, SharedContextIsCreatedOnce) {
+  spv_target_env env = GetParam();
+  spv_const_context context = GetSharedContext(env);
+  ASSERT_NE(nullptr, context);
+  EXPECT_EQ(env, context->target_env);
+  EXPECT_FALSE(context->consumer);
+  EXPECT_EQ(context, GetSharedContext(env));
+}
+
+TEST_P(TargetEnvTest, CreatedContextCopiesSharedContext) {
+  spv_target_env env = GetParam();
+  spv_const_context shared = GetSharedContext(env);
+  spv_context context = spvContextCreate(env);
+  ASSERT_NE(nullptr, context);
+  EXPECT_NE(shared, context);
+  EXPECT_EQ(shared->opcode_table, context->opcode_table);
+  EXPECT_EQ(shared->operand_table, context->operand_table);
+  EXPECT_EQ(shared->ext_inst_table, context->ext_inst_table);
+
+  // Setting the consumer of the copy leaves the shared context alone.
+  SetContextMessageConsumer(context, [](spv_message_level_t, const char*,
+                                        const spv_position_t&, const char*) {});
+  EXPECT_FALSE(shared->consumer);
+  spvContextDestroy(context);
+}
+
 TEST_P(TargetEnvTest, ValidDescription) {
   const char* description = spvTargetEnvDescription(GetParam());
   ASSERT_NE(nullptr, description);
@@ -54,6 +82,28 @@ TEST(GetContextTest, InvalidTargetEnvProducesNull) {
   EXPECT_EQ(context, nullptr);
 }
 
+TEST(GetContextTest, NewestTargetEnvHasSharedContext) {
+  EXPECT_NE(nullptr, GetSharedContext(SPV_ENV_VULKAN_1_2));
+}
+
+TEST(GetContextTest, InvalidTargetEnvHasNoSharedContext) {
+  EXPECT_EQ(nullptr, GetSharedContext(static_cast<spv_target_env>(30)));
+  EXPECT_EQ(nullptr, GetSharedContext(SPV_ENV_WEBGPU_0));
+}
+
+TEST(GetContextTest, SharedContextIsTheSameInEveryThread) {
+  std::vector<spv_const_context> contexts(8, nullptr);
+  std::vector<std::thread> threads;
+  for (auto& context : contexts) {
+    threads.emplace_back(
+        [&context]() { context = GetSharedContext(SPV_ENV_UNIVERSAL_1_3); });
+  }
+  for (auto& thread : threads) thread.join();
+  for (auto context : contexts) {
+    EXPECT_EQ(GetSharedContext(SPV_ENV_UNIVERSAL_1_3), context);
+  }
+}
+
 // A test case for parsing an environment string.
 struct ParseCase {
   const char* input;
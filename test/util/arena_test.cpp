@@ -0,0 +1,86 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/util/arena.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(ArenaTest, AllocatesNothingUntilFirstUse) {
+  Arena arena;
+  EXPECT_EQ(arena.capacity(), 0u);
+  EXPECT_EQ(arena.Allocate<uint32_t>(0), nullptr);
+  EXPECT_EQ(arena.capacity(), 0u);
+}
+
+TEST(ArenaTest, AllocationsDoNotOverlap) {
+  Arena arena(Arena::kMinBlockSize);
+  std::vector<std::pair<uint32_t*, uint32_t>> arrays;
+  for (uint32_t i = 1; i < 200; ++i) {
+    uint32_t* array = arena.Allocate<uint32_t>(i);
+    for (uint32_t j = 0; j < i; ++j) array[j] = i;
+    arrays.emplace_back(array, i);
+  }
+  for (const auto& array : arrays) {
+    for (uint32_t j = 0; j < array.second; ++j) {
+      EXPECT_EQ(array.first[j], array.second);
+    }
+  }
+}
+
+TEST(ArenaTest, AllocationsAreAligned) {
+  Arena arena;
+  arena.Allocate<char>(1);
+  uint64_t* value = arena.Allocate<uint64_t>(1);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(value) % alignof(uint64_t), 0u);
+  arena.Allocate<uint16_t>(3);
+  double* other = arena.Allocate<double>(2);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(other) % alignof(double), 0u);
+}
+
+TEST(ArenaTest, FirstBlockHasInitialSize) {
+  Arena arena(1000);
+  arena.Allocate<char>(1);
+  EXPECT_EQ(arena.capacity(), 1000u);
+  arena.Allocate<char>(900);
+  EXPECT_EQ(arena.capacity(), 1000u);
+  arena.Allocate<char>(200);
+  EXPECT_EQ(arena.capacity(), 3000u);
+}
+
+TEST(ArenaTest, LargeAllocationGetsItsOwnBlock) {
+  Arena arena(Arena::kMinBlockSize);
+  char* data = arena.Allocate<char>(10000);
+  data[9999] = 'x';
+  EXPECT_GE(arena.capacity(), 10000u);
+}
+
+TEST(ArenaTest, Copy) {
+  Arena arena;
+  const uint32_t words[] = {1, 2, 3, 4};
+  uint32_t* copy = arena.Copy(words, 4);
+  EXPECT_NE(copy, words);
+  EXPECT_THAT(std::vector<uint32_t>(copy, copy + 4),
+              ::testing::ElementsAre(1, 2, 3, 4));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
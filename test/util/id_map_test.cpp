@@ -0,0 +1,95 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/util/id_map.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+// Returns the (id, value) pairs of |map| in iteration order.
+std::vector<std::pair<uint32_t, int>> Entries(const IdMap<int>& map) {
+  std::vector<std::pair<uint32_t, int>> entries;
+  for (const auto& entry : map) {
+    entries.emplace_back(entry.first, entry.second);
+  }
+  return entries;
+}
+
+TEST(IdMapTest, Empty) {
+  IdMap<int> map(10);
+  EXPECT_EQ(0, map.Get(3));
+  EXPECT_EQ(0, map.Get(1000));
+  EXPECT_TRUE(map.begin() == map.end());
+}
+
+TEST(IdMapTest, DenseIds) {
+  IdMap<int> map(10);
+  map[9] = 90;
+  map[2] = 20;
+  EXPECT_EQ(20, map.Get(2));
+  EXPECT_EQ(90, map.Get(9));
+  EXPECT_EQ(0, map.Get(3));
+  EXPECT_THAT(Entries(map), ElementsAre(Pair(2, 20), Pair(9, 90)));
+}
+
+TEST(IdMapTest, SparseIds) {
+  IdMap<int> map;
+  map[1000] = 1;
+  map[7] = 2;
+  EXPECT_EQ(1, map.Get(1000));
+  EXPECT_EQ(2, map.Get(7));
+  EXPECT_EQ(0, map.Get(8));
+  EXPECT_THAT(Entries(map), ElementsAre(Pair(7, 2), Pair(1000, 1)));
+}
+
+TEST(IdMapTest, IteratesInIdOrder) {
+  IdMap<int> map(4);
+  map[100] = 4;
+  map[3] = 3;
+  map[10] = 5;
+  map[0] = 1;
+  EXPECT_THAT(Entries(map), ElementsAre(Pair(0, 1), Pair(3, 3), Pair(10, 5),
+                                        Pair(100, 4)));
+}
+
+TEST(IdMapTest, SkipsEmptyValues) {
+  IdMap<int> map(4);
+  map[1] = 0;
+  map[2] = 2;
+  map[50] = 0;
+  EXPECT_THAT(Entries(map), ElementsAre(Pair(2, 2)));
+}
+
+TEST(IdMapTest, Reset) {
+  IdMap<int> map(4);
+  map[1] = 1;
+  map[5] = 5;
+  map.Reset(8);
+  EXPECT_EQ(0, map.Get(1));
+  EXPECT_EQ(0, map.Get(5));
+  map[5] = 6;
+  EXPECT_THAT(Entries(map), ElementsAre(Pair(5, 6)));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
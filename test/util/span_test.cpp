@@ -0,0 +1,63 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/util/span.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(SpanTest, Empty) {
+  Span<uint32_t> span;
+  EXPECT_TRUE(span.empty());
+  EXPECT_EQ(span.size(), 0u);
+  EXPECT_EQ(span.begin(), span.end());
+}
+
+TEST(SpanTest, ViewsTheArray) {
+  const uint32_t words[] = {5, 6, 7};
+  Span<uint32_t> span(words, 3);
+  EXPECT_FALSE(span.empty());
+  EXPECT_EQ(span.size(), 3u);
+  EXPECT_EQ(span.data(), words);
+  EXPECT_EQ(span[1], 6u);
+  EXPECT_EQ(span.front(), 5u);
+  EXPECT_EQ(span.back(), 7u);
+  EXPECT_THAT(std::vector<uint32_t>(span.begin(), span.end()),
+              ::testing::ElementsAre(5, 6, 7));
+}
+
+TEST(SpanTest, FromVector) {
+  const std::vector<uint32_t> vec = {1, 2};
+  Span<uint32_t> span(vec);
+  EXPECT_EQ(span.data(), vec.data());
+  EXPECT_EQ(span.size(), 2u);
+}
+
+TEST(SpanTest, Equality) {
+  const std::vector<uint32_t> a = {1, 2};
+  const std::vector<uint32_t> b = {1, 2};
+  const std::vector<uint32_t> c = {1, 3};
+  EXPECT_TRUE(Span<uint32_t>(a) == Span<uint32_t>(b));
+  EXPECT_TRUE(Span<uint32_t>(a) != Span<uint32_t>(c));
+  EXPECT_TRUE(Span<uint32_t>(a) != Span<uint32_t>(a.data(), 1));
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
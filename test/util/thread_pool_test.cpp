@@ -0,0 +1,83 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+
+#include "source/util/thread_pool.h"
+
+namespace spvtools {
+namespace utils {
+namespace {
+
+TEST(ThreadPoolTest, ZeroThreadsUsesDefault) {
+  ThreadPool pool(0);
+  EXPECT_EQ(ThreadPool::DefaultNumThreads(), pool.num_threads());
+  EXPECT_LE(1u, pool.num_threads());
+}
+
+TEST(ThreadPoolTest, RunsEveryTaskOnce) {
+  ThreadPool pool(4);
+  std::vector<int> counts(1000, 0);
+  for (size_t i = 0; i < counts.size(); ++i) {
+    pool.Submit([&counts, i]() { ++counts[i]; });
+  }
+  pool.Wait();
+  for (int count : counts) EXPECT_EQ(1, count);
+}
+
+TEST(ThreadPoolTest, TasksCanSubmitTasks) {
+  ThreadPool pool(3);
+  std::atomic<int> total(0);
+  for (int i = 0; i < 10; ++i) {
+    pool.Submit([&pool, &total]() {
+      for (int j = 0; j < 10; ++j) {
+        pool.Submit([&total]() { ++total; });
+      }
+      ++total;
+    });
+  }
+  pool.Wait();
+  EXPECT_EQ(110, total.load());
+}
+
+TEST(ThreadPoolTest, CanWaitSeveralTimes) {
+  ThreadPool pool(2);
+  std::atomic<int> total(0);
+  pool.Wait();
+  pool.Submit([&total]() { ++total; });
+  pool.Wait();
+  EXPECT_EQ(1, total.load());
+  pool.Submit([&total]() { ++total; });
+  pool.Submit([&total]() { ++total; });
+  pool.Wait();
+  EXPECT_EQ(3, total.load());
+}
+
+TEST(ThreadPoolTest, DestructorFinishesQueuedTasks) {
+  std::atomic<int> total(0);
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 100; ++i) {
+      pool.Submit([&total]() { ++total; });
+    }
+  }
+  EXPECT_EQ(100, total.load());
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace spvtools
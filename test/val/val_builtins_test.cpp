@@ -3197,7 +3197,9 @@ OpStore %position %f32vec4_0123
   ASSERT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_0));
 }
 
-TEST_F(ValidateBuiltIns, FragmentPositionTwoEntryPoints) {
+// Returns a module where a function that writes BuiltIn Position is called
+// from both a Vertex and a Fragment entry point.
+CodeGenerator GetPositionTwoEntryPointsGenerator() {
   CodeGenerator generator = CodeGenerator::GetDefaultShaderCodeGenerator();
   generator.before_types_ = R"(
 OpMemberDecorate %output_type 0 BuiltIn Position
@@ -3237,7 +3239,12 @@ OpReturn
 OpFunctionEnd
 )";
 
-  CompileSuccessfully(generator.Build(), SPV_ENV_VULKAN_1_0);
+  return generator;
+}
+
+TEST_F(ValidateBuiltIns, FragmentPositionTwoEntryPoints) {
+  CompileSuccessfully(GetPositionTwoEntryPointsGenerator().Build(),
+                      SPV_ENV_VULKAN_1_0);
   ASSERT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions(SPV_ENV_VULKAN_1_0));
   EXPECT_THAT(getDiagnosticString(),
               HasSubstr("Vulkan spec allows BuiltIn Position to be used only "
@@ -3247,6 +3254,88 @@ OpFunctionEnd
               HasSubstr("called with execution model Fragment"));
 }
 
+TEST_F(ValidateBuiltIns, FragmentPositionTwoEntryPointsLargeIdBound) {
+  // The built-in rules are only kept in vectors for the ids below the number
+  // of words, so a large id bound in the header costs no memory.
+  CompileSuccessfully(GetPositionTwoEntryPointsGenerator().Build(),
+                      SPV_ENV_VULKAN_1_0);
+  OverwriteAssembledBinary(3, 0x3FFFFF);
+  ASSERT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("called with execution model Fragment"));
+}
+
+TEST_F(ValidateBuiltIns, StructuralProfileSkipsBuiltIns) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                spv_validator_profile_structural);
+  CompileSuccessfully(GetPositionTwoEntryPointsGenerator().Build(),
+                      SPV_ENV_VULKAN_1_0);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions(SPV_ENV_VULKAN_1_0))
+      << getDiagnosticString();
+}
+
+// Returns |count| additions whose results are named after |prefix|.  The
+// validator checks functions on several threads only once they have more
+// instructions in total than its minimum task size, 1024.
+std::string GenerateAdds(const std::string& prefix, uint32_t count) {
+  std::ostringstream text;
+  for (uint32_t i = 0; i < count; ++i) {
+    text << "%" << prefix << i << " = OpIAdd %u32 %u32_1 %u32_1\n";
+  }
+  return text.str();
+}
+
+TEST_F(ValidateBuiltIns, VertexPointSizeInputInCalledFunctionParallel) {
+  CodeGenerator generator = CodeGenerator::GetDefaultShaderCodeGenerator();
+  generator.before_types_ = R"(
+OpMemberDecorate %input_type 0 BuiltIn PointSize
+)";
+
+  generator.after_types_ = R"(
+%input_type = OpTypeStruct %f32
+%input_ptr = OpTypePointer Input %input_type
+%input = OpVariable %input_ptr Input
+%input_f32_ptr = OpTypePointer Input %f32
+)";
+
+  EntryPoint entry_point;
+  entry_point.name = "fmain";
+  entry_point.execution_model = "Fragment";
+  entry_point.execution_modes = "OpExecutionMode %fmain OriginUpperLeft";
+  generator.entry_points_.push_back(std::move(entry_point));
+
+  entry_point.name = "vmain";
+  entry_point.execution_model = "Vertex";
+  entry_point.interfaces = "%input";
+  entry_point.execution_modes = "";
+  // Both the caller and the callee are large enough to be checked in tasks
+  // of their own.
+  entry_point.body = GenerateAdds("vmain_add", 1100) + R"(
+%val = OpFunctionCall %void %foo
+)";
+  generator.entry_points_.push_back(std::move(entry_point));
+
+  generator.add_at_the_end_ = R"(
+%foo = OpFunction %void None %func
+%foo_entry = OpLabel
+)" + GenerateAdds("foo_add", 1100) + R"(
+%point_size = OpAccessChain %input_f32_ptr %input %u32_0
+%load = OpLoad %f32 %point_size
+OpReturn
+OpFunctionEnd
+)";
+
+  CompileSuccessfully(generator.Build(), SPV_ENV_VULKAN_1_0);
+  spvValidatorOptionsSetParallel(getValidatorOptions(), true);
+  ASSERT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions(SPV_ENV_VULKAN_1_0));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Vulkan spec doesn't allow BuiltIn PointSize to be "
+                        "used for variables with Input storage class if "
+                        "execution model is Vertex."));
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("called with execution model Vertex"));
+}
+
 CodeGenerator GetNoDepthReplacingGenerator() {
   CodeGenerator generator = CodeGenerator::GetDefaultShaderCodeGenerator();
 
@@ -14,6 +14,7 @@
 
 // Validation tests for Control Flow Graph
 
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <iterator>
@@ -4299,6 +4300,132 @@ OpFunctionEnd
   ASSERT_FALSE(b11->reachable());
 }
 
+TEST_F(ValidateCFG, DominanceMatchesDominatorChains) {
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpTypeBool
+%4 = OpUndef %3
+%5 = OpFunction %1 None %2
+%6 = OpLabel
+OpBranch %7
+%7 = OpLabel
+OpLoopMerge %8 %9 None
+OpBranchConditional %4 %10 %8
+%10 = OpLabel
+OpSelectionMerge %11 None
+OpBranchConditional %4 %12 %13
+%12 = OpLabel
+OpBranch %11
+%13 = OpLabel
+OpBranch %11
+%11 = OpLabel
+OpBranch %9
+%9 = OpLabel
+OpBranch %7
+%8 = OpLabel
+OpReturn
+%14 = OpLabel
+OpUnreachable
+OpFunctionEnd
+)";
+
+  CompileSuccessfully(text);
+  EXPECT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  auto f = vstate_->function(5);
+  std::vector<const BasicBlock*> blocks(f->ordered_blocks().begin(),
+                                        f->ordered_blocks().end());
+  blocks.push_back(f->pseudo_entry_block());
+  blocks.push_back(f->pseudo_exit_block());
+  for (auto a : blocks) {
+    for (auto b : blocks) {
+      const bool in_dom_chain =
+          std::find(b->dom_begin(), b->dom_end(), a) != b->dom_end();
+      const bool in_pdom_chain =
+          std::find(b->pdom_begin(), b->pdom_end(), a) != b->pdom_end();
+      EXPECT_EQ(a == b || in_dom_chain, a->dominates(*b))
+          << a->id() << " dominates " << b->id();
+      EXPECT_EQ(a == b || in_pdom_chain, a->postdominates(*b))
+          << a->id() << " postdominates " << b->id();
+    }
+  }
+
+  auto b7 = f->GetBlock(7).first;
+  auto b8 = f->GetBlock(8).first;
+  auto b11 = f->GetBlock(11).first;
+  auto b12 = f->GetBlock(12).first;
+  EXPECT_TRUE(b7->dominates(*b12));
+  EXPECT_FALSE(b12->dominates(*b11));
+  EXPECT_TRUE(b11->postdominates(*b12));
+  EXPECT_TRUE(b8->postdominates(*b7));
+  EXPECT_FALSE(b12->postdominates(*b7));
+}
+
+TEST_F(ValidateCFG, NoDominanceAcrossFunctions) {
+  // The two functions have the same shape, so their blocks get the same
+  // numbers in their dominator trees.
+  const std::string text = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpTypeBool
+%4 = OpUndef %3
+%5 = OpFunction %1 None %2
+%6 = OpLabel
+OpSelectionMerge %7 None
+OpBranchConditional %4 %8 %7
+%8 = OpLabel
+OpBranch %7
+%7 = OpLabel
+OpReturn
+OpFunctionEnd
+%9 = OpFunction %1 None %2
+%10 = OpLabel
+OpSelectionMerge %11 None
+OpBranchConditional %4 %12 %11
+%12 = OpLabel
+OpBranch %11
+%11 = OpLabel
+OpReturn
+OpFunctionEnd
+)";
+
+  CompileSuccessfully(text);
+  EXPECT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  auto blocks_of = [](const Function* f) {
+    std::vector<const BasicBlock*> blocks(f->ordered_blocks().begin(),
+                                          f->ordered_blocks().end());
+    blocks.push_back(f->pseudo_entry_block());
+    blocks.push_back(f->pseudo_exit_block());
+    return blocks;
+  };
+  const auto blocks5 = blocks_of(vstate_->function(5));
+  const auto blocks9 = blocks_of(vstate_->function(9));
+  for (auto a : blocks5) {
+    for (auto b : blocks9) {
+      EXPECT_FALSE(a->dominates(*b)) << a->id() << " dominates " << b->id();
+      EXPECT_FALSE(b->dominates(*a)) << b->id() << " dominates " << a->id();
+      EXPECT_FALSE(a->postdominates(*b))
+          << a->id() << " postdominates " << b->id();
+      EXPECT_FALSE(b->postdominates(*a))
+          << b->id() << " postdominates " << a->id();
+    }
+  }
+
+  // Within each function the numbers still decide dominance.
+  EXPECT_TRUE(vstate_->function(5)->GetBlock(6).first->dominates(
+      *vstate_->function(5)->GetBlock(8).first));
+  EXPECT_TRUE(vstate_->function(9)->GetBlock(11).first->postdominates(
+      *vstate_->function(9)->GetBlock(12).first));
+}
+
 TEST_F(ValidateCFG, PhiInstructionWithDuplicateIncomingEdges) {
   const std::string text = R"(
                OpCapability Shader
@@ -3344,6 +3344,49 @@ TEST_F(ValidateDecorations, StorageBufferStorageClassArrayBadAlignmentBad) {
           "member 1 at offset 7 is not aligned to 4"));
 }
 
+TEST_F(ValidateDecorations, StructLaidOutForStorageBufferUsedInUniformBad) {
+  // The layout of %S is valid with storage buffer rules, which are checked
+  // first, but not with uniform buffer rules.
+  std::string spirv = R"(
+               OpCapability Shader
+               OpExtension "SPV_KHR_storage_buffer_storage_class"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Vertex %main "main"
+               OpSource GLSL 450
+               OpDecorate %_arr_float_uint_2 ArrayStride 4
+               OpMemberDecorate %S 0 Offset 0
+               OpMemberDecorate %S 1 Offset 8
+               OpDecorate %S Block
+               OpDecorate %ssbo DescriptorSet 0
+               OpDecorate %ssbo Binding 0
+               OpDecorate %ubo DescriptorSet 0
+               OpDecorate %ubo Binding 1
+       %void = OpTypeVoid
+          %3 = OpTypeFunction %void
+      %float = OpTypeFloat 32
+    %v2float = OpTypeVector %float 2
+       %uint = OpTypeInt 32 0
+     %uint_2 = OpConstant %uint 2
+%_arr_float_uint_2 = OpTypeArray %float %uint_2
+          %S = OpTypeStruct %v2float %_arr_float_uint_2
+%_ptr_StorageBuffer_S = OpTypePointer StorageBuffer %S
+       %ssbo = OpVariable %_ptr_StorageBuffer_S StorageBuffer
+%_ptr_Uniform_S = OpTypePointer Uniform %S
+        %ubo = OpVariable %_ptr_Uniform_S Uniform
+       %main = OpFunction %void None %3
+          %5 = OpLabel
+               OpReturn
+               OpFunctionEnd
+  )";
+
+  CompileSuccessfully(spirv);
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateAndRetrieveValidationState());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("decorated as Block for variable in Uniform storage "
+                        "class must follow standard uniform buffer layout "
+                        "rules: member 1 at offset 8 is not aligned to 16"));
+}
+
 TEST_F(ValidateDecorations, BufferBlockStandardStorageBufferLayout) {
   std::string spirv = R"(
                OpCapability Shader
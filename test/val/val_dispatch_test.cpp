@@ -0,0 +1,107 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests that the per-instruction passes that ValidateInstruction skips for
+// an opcode have no checks for it.
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "source/opcode.h"
+#include "source/spirv_validator_options.h"
+#include "source/table.h"
+#include "source/val/instruction.h"
+#include "source/val/validate.h"
+#include "source/val/validation_state.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+// This is all we need for these tests.
+static uint32_t kFakeBinary[] = {0};
+
+// The number of operands given to each instruction, which is more than any
+// pass reads.
+const uint16_t kNumOperands = 16;
+
+class ValidateDispatch : public testing::Test {
+ public:
+  ValidateDispatch()
+      : context_(spvContextCreate(SPV_ENV_UNIVERSAL_1_0)),
+        options_(spvValidatorOptionsCreate()) {
+    SetContextMessageConsumer(
+        context_, [this](spv_message_level_t, const char*,
+                         const spv_position_t&, const char* message) {
+          messages_.push_back(message);
+        });
+  }
+
+  ~ValidateDispatch() override {
+    spvContextDestroy(context_);
+    spvValidatorOptionsDestroy(options_);
+  }
+
+ protected:
+  spv_context context_;
+  spv_validator_options options_;
+  std::vector<std::string> messages_;
+};
+
+TEST_F(ValidateDispatch, SkippedPassesHaveNoChecks) {
+  ValidationState_t state(context_, options_, kFakeBinary, 0, 1);
+
+  spv_opcode_table table = nullptr;
+  ASSERT_EQ(SPV_SUCCESS, spvOpcodeTableGet(&table, SPV_ENV_UNIVERSAL_1_0));
+  for (uint32_t i = 0; i < table->count; ++i) {
+    const SpvOp opcode = table->entries[i].opcode;
+
+    // Every operand is a one-word id of 0, which no instruction defines, so
+    // any check that a pass makes on the instruction fails.
+    std::vector<uint32_t> words(kNumOperands + 1, 0);
+    words[0] = spvOpcodeMake(uint16_t(words.size()), opcode);
+    std::vector<spv_parsed_operand_t> operands(kNumOperands);
+    for (uint16_t j = 0; j < kNumOperands; ++j) {
+      operands[j] = {uint16_t(j + 1), 1, SPV_OPERAND_TYPE_ID,
+                     SPV_NUMBER_NONE, 0};
+    }
+    const spv_parsed_instruction_t parsed = {words.data(),
+                                             uint16_t(words.size()),
+                                             uint16_t(opcode),
+                                             SPV_EXT_INST_TYPE_NONE,
+                                             0,
+                                             0,
+                                             operands.data(),
+                                             kNumOperands};
+    const Instruction inst(&parsed, words.data(), operands.data());
+
+    for (auto pass : GetSkippedInstructionPasses(opcode)) {
+      EXPECT_EQ(SPV_SUCCESS, pass(state, &inst))
+          << "A skipped pass has checks for Op" << spvOpcodeString(opcode);
+    }
+    EXPECT_TRUE(messages_.empty())
+        << "A skipped pass reported for Op" << spvOpcodeString(opcode) << ": "
+        << messages_.front();
+    messages_.clear();
+  }
+}
+
+TEST_F(ValidateDispatch, EveryPassRunsForUnknownOpcode) {
+  EXPECT_TRUE(GetSkippedInstructionPasses(SpvOpMax).empty());
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
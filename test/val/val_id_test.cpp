@@ -5509,6 +5509,38 @@ OpFunctionEnd
           "9[%9]"));
 }
 
+// The blocks are numbered so that the defining block would dominate the using
+// block if both were in the same function.
+TEST_F(ValidateIdWithMessage, ResultIdUsedInLaterBlockOfOtherFunctionBad) {
+  std::string spirv = kGLSL450MemoryModel + R"(
+%1 = OpTypeVoid
+%2 = OpTypeFunction %1
+%3 = OpTypeInt 32 0
+%4 = OpTypePointer Function %3
+%5 = OpFunction %1 None %2
+%6 = OpLabel
+%7 = OpVariable %4 Function
+OpBranch %11
+%11 = OpLabel
+OpReturn
+OpFunctionEnd
+%8 = OpFunction %1 None %2
+%9 = OpLabel
+OpBranch %12
+%12 = OpLabel
+%10 = OpLoad %3 %7
+OpReturn
+OpFunctionEnd
+  )";
+  CompileSuccessfully(spirv.c_str());
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(
+      getDiagnosticString(),
+      HasSubstr(
+          "ID 7[%7] defined in block 6[%6] does not dominate its use in block "
+          "12[%12]"));
+}
+
 TEST_F(ValidateIdWithMessage, SpecIdTargetNotSpecializationConstant) {
   std::string spirv = kGLSL450MemoryModel + R"(
 OpDecorate %1 SpecId 200
@@ -0,0 +1,273 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for validating a module again after some of its functions changed.
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "source/val/validate.h"
+#include "spirv-tools/libspirv.hpp"
+#include "test/test_fixture.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+using spvtest::ScopedContext;
+
+const char kHeader[] = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%float = OpTypeFloat 32
+%uint_1 = OpConstant %uint 1
+%float_1 = OpConstant %float 1
+)";
+
+// Returns a function named |name| whose body has the instruction |body|,
+// which defines an id named after the function.
+std::string Function(const std::string& name, const std::string& body) {
+  return "%" + name + " = OpFunction %void None %void_fn\n%" + name +
+         "_entry = OpLabel\n%" + name + "_result" + body +
+         "OpReturn\nOpFunctionEnd\n";
+}
+
+const char kValidBody[] = " = OpIAdd %uint %uint_1 %uint_1\n";
+const char kInvalidBody[] = " = OpIAdd %uint %float_1 %uint_1\n";
+
+class ValidateIncrementally : public ::testing::Test {
+ protected:
+  std::vector<uint32_t> Assemble(const std::string& text) {
+    SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+    std::vector<uint32_t> binary;
+    EXPECT_TRUE(tools.Assemble(text, &binary));
+    return binary;
+  }
+
+  spv_result_t Validate(
+      const std::vector<uint32_t>& binary, ModuleFingerprint* fingerprint,
+      const std::unordered_set<uint32_t>* changed_functions = nullptr) {
+    spv_diagnostic diagnostic = nullptr;
+    const spv_result_t result = ValidateBinaryIncrementally(
+        context_.context, options_, binary.data(), binary.size(), fingerprint,
+        &diagnostic, changed_functions);
+    diagnostic_ = diagnostic ? diagnostic->error : "";
+    spvDiagnosticDestroy(diagnostic);
+    return result;
+  }
+
+  ScopedContext context_;
+  ValidatorOptions options_;
+  std::string diagnostic_;
+};
+
+TEST_F(ValidateIncrementally, FirstCallChecksEverything) {
+  const auto binary = Assemble(std::string(kHeader) +
+                               Function("f", kValidBody) +
+                               Function("g", kInvalidBody));
+  ModuleFingerprint fingerprint;
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, Validate(binary, &fingerprint));
+  EXPECT_THAT(diagnostic_, HasSubstr("Expected int scalar or vector type"));
+  EXPECT_FALSE(fingerprint.valid);
+}
+
+TEST_F(ValidateIncrementally, SuccessRecordsFingerprint) {
+  const auto binary = Assemble(std::string(kHeader) +
+                               Function("f", kValidBody) +
+                               Function("g", kValidBody));
+  ModuleFingerprint fingerprint;
+  EXPECT_EQ(SPV_SUCCESS, Validate(binary, &fingerprint));
+  EXPECT_TRUE(fingerprint.valid);
+  EXPECT_EQ(2u, fingerprint.function_hashes.size());
+  EXPECT_EQ(SPV_SUCCESS, Validate(binary, &fingerprint));
+}
+
+TEST_F(ValidateIncrementally, ChangedFunctionIsChecked) {
+  ModuleFingerprint fingerprint;
+  EXPECT_EQ(SPV_SUCCESS,
+            Validate(Assemble(std::string(kHeader) + Function("f", kValidBody) +
+                              Function("g", kValidBody)),
+                     &fingerprint));
+  const ModuleFingerprint before = fingerprint;
+
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA,
+            Validate(Assemble(std::string(kHeader) + Function("f", kValidBody) +
+                              Function("g", kInvalidBody)),
+                     &fingerprint));
+  EXPECT_THAT(diagnostic_, HasSubstr("Expected int scalar or vector type"));
+  // A failure keeps the fingerprint of the last valid module.
+  EXPECT_EQ(before.module_hash, fingerprint.module_hash);
+  EXPECT_EQ(before.function_hashes, fingerprint.function_hashes);
+}
+
+TEST_F(ValidateIncrementally, UnchangedFunctionIsNotChecked) {
+  // Pretend that a module with an invalid function was validated before, to
+  // observe that the function is not checked again.
+  const auto binary = Assemble(std::string(kHeader) +
+                               Function("f", kValidBody) +
+                               Function("g", kInvalidBody));
+  ModuleFingerprint fingerprint = ComputeModuleFingerprint(binary.data(),
+                                                           binary.size());
+  ASSERT_TRUE(fingerprint.valid);
+  EXPECT_EQ(SPV_SUCCESS, Validate(binary, &fingerprint));
+}
+
+TEST_F(ValidateIncrementally, ChangeOutsideFunctionsChecksEverything) {
+  const auto binary = Assemble(std::string(kHeader) +
+                               Function("f", kValidBody) +
+                               Function("g", kInvalidBody));
+  ModuleFingerprint fingerprint = ComputeModuleFingerprint(binary.data(),
+                                                           binary.size());
+  const auto changed = Assemble(std::string(kHeader) +
+                                "%uint_2 = OpConstant %uint 2\n" +
+                                Function("f", kValidBody) +
+                                Function("g", kInvalidBody));
+  EXPECT_NE(fingerprint.module_hash,
+            ComputeModuleFingerprint(changed.data(), changed.size())
+                .module_hash);
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, Validate(changed, &fingerprint));
+}
+
+TEST_F(ValidateIncrementally, LowerIdBoundChecksEverything) {
+  const auto binary = Assemble(std::string(kHeader) +
+                               Function("f", kValidBody) +
+                               Function("g", kInvalidBody));
+  ModuleFingerprint fingerprint = ComputeModuleFingerprint(binary.data(),
+                                                           binary.size());
+  // The ids of the functions might not be below a lower bound.
+  ++fingerprint.id_bound;
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, Validate(binary, &fingerprint));
+}
+
+TEST_F(ValidateIncrementally, FingerprintSeparatesFunctions) {
+  const auto binary = Assemble(std::string(kHeader) +
+                               Function("f", kValidBody) +
+                               Function("g", kValidBody));
+  const auto changed =
+      Assemble(std::string(kHeader) + Function("f", kValidBody) +
+               Function("g", std::string(kValidBody) +
+                                 "%g_sum = OpIAdd %uint %g_result %uint_1\n"));
+  const ModuleFingerprint before =
+      ComputeModuleFingerprint(binary.data(), binary.size());
+  const ModuleFingerprint after =
+      ComputeModuleFingerprint(changed.data(), changed.size());
+  ASSERT_TRUE(before.valid);
+  ASSERT_TRUE(after.valid);
+  EXPECT_EQ(before.module_hash, after.module_hash);
+  EXPECT_LT(before.id_bound, after.id_bound);
+  ASSERT_EQ(2u, after.function_hashes.size());
+  uint32_t num_changed = 0;
+  for (const auto& function : after.function_hashes) {
+    if (before.function_hashes.at(function.first) != function.second) {
+      ++num_changed;
+    }
+  }
+  EXPECT_EQ(1u, num_changed);
+}
+
+TEST_F(ValidateIncrementally, ReportedChangedFunctionIsChecked) {
+  ModuleFingerprint fingerprint;
+  EXPECT_EQ(SPV_SUCCESS,
+            Validate(Assemble(std::string(kHeader) + Function("f", kValidBody) +
+                              Function("g", kValidBody)),
+                     &fingerprint));
+  const ModuleFingerprint before = fingerprint;
+
+  const auto changed = Assemble(std::string(kHeader) +
+                                Function("f", kValidBody) +
+                                Function("g", kInvalidBody));
+  std::unordered_set<uint32_t> all_functions;
+  for (const auto& function : fingerprint.function_hashes) {
+    all_functions.insert(function.first);
+  }
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA,
+            Validate(changed, &fingerprint, &all_functions));
+  EXPECT_THAT(diagnostic_, HasSubstr("Expected int scalar or vector type"));
+
+  // The functions that are not reported as changed are not compared with the
+  // last module, and not checked again.
+  const std::unordered_set<uint32_t> no_functions;
+  EXPECT_EQ(SPV_SUCCESS, Validate(changed, &fingerprint, &no_functions));
+  // Their hashes are kept from the last module.
+  EXPECT_EQ(before.function_hashes, fingerprint.function_hashes);
+}
+
+TEST_F(ValidateIncrementally, UnchangedFunctionSkipsControlFlowChecks) {
+  ModuleFingerprint fingerprint;
+  EXPECT_EQ(SPV_SUCCESS,
+            Validate(Assemble(std::string(kHeader) + Function("f", kValidBody)),
+                     &fingerprint));
+
+  // The block %third appears before its dominator %second.
+  const auto changed = Assemble(std::string(kHeader) + R"(
+%f = OpFunction %void None %void_fn
+%f_entry = OpLabel
+OpBranch %second
+%third = OpLabel
+OpReturn
+%second = OpLabel
+OpBranch %third
+OpFunctionEnd
+)");
+  const std::unordered_set<uint32_t> no_functions;
+  ModuleFingerprint copy = fingerprint;
+  EXPECT_EQ(SPV_SUCCESS, Validate(changed, &copy, &no_functions));
+  EXPECT_EQ(SPV_ERROR_INVALID_CFG, Validate(changed, &fingerprint));
+  EXPECT_THAT(diagnostic_,
+              HasSubstr("appears in the binary before its dominator"));
+}
+
+TEST_F(ValidateIncrementally, UseOfUnchangedFunctionIdIsChecked) {
+  ModuleFingerprint fingerprint;
+  EXPECT_EQ(SPV_SUCCESS,
+            Validate(Assemble(std::string(kHeader) + Function("f", kValidBody) +
+                              Function("g", kValidBody)),
+                     &fingerprint));
+
+  // The changed function uses an id of the unchanged function.
+  const auto changed = Assemble(
+      std::string(kHeader) + Function("f", kValidBody) +
+      Function("g", " = OpIAdd %uint %f_result %uint_1\n"));
+  const ModuleFingerprint changed_fingerprint =
+      ComputeModuleFingerprint(changed.data(), changed.size());
+  std::unordered_set<uint32_t> changed_functions;
+  for (const auto& function : changed_fingerprint.function_hashes) {
+    if (fingerprint.function_hashes.at(function.first) != function.second) {
+      changed_functions.insert(function.first);
+    }
+  }
+  ASSERT_EQ(1u, changed_functions.size());
+  EXPECT_EQ(SPV_ERROR_INVALID_ID,
+            Validate(changed, &fingerprint, &changed_functions));
+  EXPECT_THAT(diagnostic_, HasSubstr("does not dominate its use"));
+}
+
+TEST_F(ValidateIncrementally, MalformedBinaryHasNoFingerprint) {
+  auto binary = Assemble(std::string(kHeader) + Function("f", kValidBody));
+  // Drop the OpFunctionEnd.
+  binary.pop_back();
+  EXPECT_FALSE(ComputeModuleFingerprint(binary.data(), binary.size()).valid);
+  EXPECT_FALSE(ComputeModuleFingerprint(binary.data(), 3).valid);
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -0,0 +1,212 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for validating the functions of a module on several threads.
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "spirv-tools/libspirv.hpp"
+#include "test/unit_spirv.h"
+#include "test/val/val_fixtures.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::Eq;
+using ::testing::HasSubstr;
+
+using ValidateParallel = spvtest::ValidateBase<bool>;
+
+// Returns a module with |num_functions| functions that each have
+// |num_adds| additions.  The functions whose index is in |invalid_functions|
+// also have an addition with operands of the wrong type, whose result is
+// named after the function.  |globals| is added after the types.
+std::string GenerateModule(uint32_t num_functions, uint32_t num_adds,
+                           const std::vector<uint32_t>& invalid_functions,
+                           const std::string& globals = "") {
+  std::ostringstream text;
+  text << R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+)";
+  for (uint32_t invalid : invalid_functions) {
+    text << "OpName %bad" << invalid << " \"bad" << invalid << "\"\n";
+  }
+  text << R"(
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%float = OpTypeFloat 32
+%uint_1 = OpConstant %uint 1
+%float_1 = OpConstant %float 1
+)" << globals;
+  for (uint32_t f = 0; f < num_functions; ++f) {
+    text << "%func" << f << " = OpFunction %void None %void_fn\n"
+         << "%entry" << f << " = OpLabel\n";
+    for (uint32_t i = 0; i < num_adds; ++i) {
+      text << "%add" << f << "_" << i << " = OpIAdd %uint %uint_1 %uint_1\n";
+    }
+    for (uint32_t invalid : invalid_functions) {
+      if (invalid == f) {
+        text << "%bad" << f << " = OpIAdd %uint %float_1 %uint_1\n";
+      }
+    }
+    text << "OpReturn\nOpFunctionEnd\n";
+  }
+  return text.str();
+}
+
+// Validates |text| on one thread and then on several, and expects the same
+// result and messages.  Returns the messages.
+std::vector<std::string> ExpectSameAsSerial(const std::string& text) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_0);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary));
+
+  std::vector<std::string> messages;
+  tools.SetMessageConsumer([&messages](spv_message_level_t, const char*,
+                                       const spv_position_t&,
+                                       const char* message) {
+    messages.push_back(message);
+  });
+
+  ValidatorOptions options;
+  const bool serial_result =
+      tools.Validate(binary.data(), binary.size(), options);
+  const std::vector<std::string> serial_messages = messages;
+
+  messages.clear();
+  options.SetParallel(true);
+  EXPECT_THAT(tools.Validate(binary.data(), binary.size(), options),
+              Eq(serial_result));
+  EXPECT_THAT(messages, Eq(serial_messages));
+  return messages;
+}
+
+TEST_F(ValidateParallel, ValidModule) {
+  CompileSuccessfully(GenerateModule(40, 100, {}));
+  spvValidatorOptionsSetParallel(getValidatorOptions(), true);
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), Eq(""));
+}
+
+TEST_F(ValidateParallel, ReportsFirstInvalidFunction) {
+  CompileSuccessfully(GenerateModule(40, 100, {15, 35}));
+  spvValidatorOptionsSetParallel(getValidatorOptions(), true);
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Expected int scalar or vector type as operand"));
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("%bad15"));
+}
+
+TEST_F(ValidateParallel, SameMessagesAsSerial) {
+  const auto messages = ExpectSameAsSerial(GenerateModule(40, 100, {35, 15}));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0], HasSubstr("%bad15"));
+}
+
+TEST_F(ValidateParallel, SameMessagesAsSerialWithErrorInLastFunction) {
+  const auto messages = ExpectSameAsSerial(GenerateModule(40, 100, {39}));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0], HasSubstr("%bad39"));
+}
+
+TEST_F(ValidateParallel, SameMessagesAsSerialWithSmallModule) {
+  const auto messages = ExpectSameAsSerial(GenerateModule(3, 2, {1}));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0], HasSubstr("%bad1"));
+}
+
+TEST_F(ValidateParallel, ErrorBeforeTheFunctions) {
+  const auto messages = ExpectSameAsSerial(
+      GenerateModule(40, 100, {20},
+                     "%v2uint = OpTypeVector %uint 2\n"
+                     "%bad = OpConstantComposite %v2uint %uint_1\n"));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0],
+              HasSubstr("Constituent <id> count does not match"));
+}
+
+// Returns |module| with a use that its definition does not dominate in each
+// function whose index is in |functions|.  The definition is named after the
+// function.  |module| must have been generated with kBoolGlobals.
+std::string AddUndominatedUses(std::string module,
+                               const std::vector<uint32_t>& functions) {
+  for (uint32_t f : functions) {
+    std::ostringstream name;
+    name << "OpName %def" << f << " \"def" << f << "\"\n";
+    const std::string header = "OpMemoryModel Logical GLSL450\n";
+    module.insert(module.find(header) + header.size(), name.str());
+
+    std::ostringstream blocks;
+    blocks << "OpSelectionMerge %merge" << f << " None\n"
+           << "OpBranchConditional %true %then" << f << " %merge" << f << "\n"
+           << "%then" << f << " = OpLabel\n"
+           << "%def" << f << " = OpIAdd %uint %uint_1 %uint_1\n"
+           << "OpBranch %merge" << f << "\n"
+           << "%merge" << f << " = OpLabel\n"
+           << "%use" << f << " = OpIAdd %uint %def" << f << " %uint_1\n";
+    std::ostringstream entry;
+    entry << "%entry" << f << " = OpLabel\n";
+    module.insert(module.find(entry.str()) + entry.str().size(), blocks.str());
+  }
+  return module;
+}
+
+const char kBoolGlobals[] =
+    "%bool = OpTypeBool\n"
+    "%true = OpConstantTrue %bool\n";
+
+TEST_F(ValidateParallel, SameMessagesAsSerialWithDominanceError) {
+  const auto messages = ExpectSameAsSerial(
+      AddUndominatedUses(GenerateModule(40, 100, {}, kBoolGlobals), {35, 15}));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0], HasSubstr("%def15"));
+  EXPECT_THAT(messages[0], HasSubstr("does not dominate its use"));
+}
+
+TEST_F(ValidateParallel, SameMessagesAsSerialWithDominanceErrorAfterOpcodes) {
+  // The opcode checks of all the functions come before the dominance checks.
+  const auto messages = ExpectSameAsSerial(AddUndominatedUses(
+      GenerateModule(40, 100, {30}, kBoolGlobals), {10}));
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0], HasSubstr("%bad30"));
+}
+
+TEST_F(ValidateParallel, SameMessagesAsSerialWithCfgError) {
+  // A block that appears before its dominator is found by the CFG checks.
+  std::string module = GenerateModule(40, 100, {}, kBoolGlobals);
+  const std::string entry = "%entry20 = OpLabel\n";
+  module.replace(module.find(entry), entry.size(),
+                 entry +
+                     "OpBranch %second20\n"
+                     "%third20 = OpLabel\n"
+                     "OpReturn\n"
+                     "%second20 = OpLabel\n"
+                     "OpBranch %third20\n"
+                     "%unused20 = OpLabel\n");
+  const auto messages = ExpectSameAsSerial(module);
+  ASSERT_THAT(messages.size(), Eq(1u));
+  EXPECT_THAT(messages[0],
+              HasSubstr("appears in the binary before its dominator"));
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
@@ -0,0 +1,136 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the validator profiles, which select the checks to run.
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "source/spirv_validator_options.h"
+#include "test/unit_spirv.h"
+#include "test/val/val_fixtures.h"
+
+namespace spvtools {
+namespace val {
+namespace {
+
+using ::testing::HasSubstr;
+
+using ValidateProfile = spvtest::ValidateBase<bool>;
+
+// Returns a module with a function whose body is |body|.
+std::string Module(const std::string& body) {
+  return R"(
+OpCapability Shader
+OpCapability Linkage
+%glsl = OpExtInstImport "GLSL.std.450"
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%uint = OpTypeInt 32 0
+%float = OpTypeFloat 32
+%uint_1 = OpConstant %uint 1
+%float_1 = OpConstant %float 1
+%func = OpFunction %void None %void_fn
+%entry = OpLabel
+)" + body + R"(
+OpReturn
+OpFunctionEnd
+)";
+}
+
+// An extended instruction with a result type it does not allow.
+const char kBadExtInst[] = "%abs = OpExtInst %uint %glsl FAbs %uint_1";
+
+TEST_F(ValidateProfile, FullIsTheDefault) {
+  CompileSuccessfully(Module(kBadExtInst));
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("GLSL.std.450 FAbs: expected Result Type to be a "
+                        "16 or 32-bit scalar or vector float type"));
+}
+
+TEST_F(ValidateProfile, StructuralSkipsExtendedInstructions) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                spv_validator_profile_structural);
+  CompileSuccessfully(Module(kBadExtInst));
+  EXPECT_EQ(SPV_SUCCESS, ValidateInstructions()) << getDiagnosticString();
+}
+
+TEST_F(ValidateProfile, StructuralChecksImageTypes) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                spv_validator_profile_structural);
+  const std::string module = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+%void = OpTypeVoid
+%void_fn = OpTypeFunction %void
+%image = OpTypeImage %void_fn 2D 0 0 0 1 Unknown
+)";
+  CompileSuccessfully(module);
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Expected Sampled Type to be either void or "
+                        "numerical scalar type"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksExtInstImports) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                spv_validator_profile_structural);
+  const std::string module = R"(
+OpCapability Shader
+OpCapability Linkage
+%ext = OpExtInstImport "NonSemantic.Testing"
+OpMemoryModel Logical GLSL450
+)";
+  CompileSuccessfully(module);
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("NonSemantic extended instruction sets cannot be "
+                        "declared without SPV_KHR_non_semantic_info."));
+}
+
+TEST_F(ValidateProfile, StructuralChecksOperandTypes) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                spv_validator_profile_structural);
+  CompileSuccessfully(Module("%bad = OpIAdd %uint %float_1 %uint_1"));
+  EXPECT_EQ(SPV_ERROR_INVALID_DATA, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(),
+              HasSubstr("Expected int scalar or vector type"));
+}
+
+TEST_F(ValidateProfile, StructuralChecksIds) {
+  spvValidatorOptionsSetProfile(getValidatorOptions(),
+                                spv_validator_profile_structural);
+  CompileSuccessfully(Module("%bad = OpIAdd %uint %undefined %uint_1"));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, ValidateInstructions());
+  EXPECT_THAT(getDiagnosticString(), HasSubstr("has not been defined"));
+}
+
+TEST(ValidatorProfile, Parse) {
+  spv_validator_profile profile = spv_validator_profile_structural;
+  EXPECT_TRUE(spvParseValidatorProfile("full", &profile));
+  EXPECT_EQ(spv_validator_profile_full, profile);
+  EXPECT_TRUE(spvParseValidatorProfile("structural", &profile));
+  EXPECT_EQ(spv_validator_profile_structural, profile);
+  EXPECT_FALSE(spvParseValidatorProfile("vulkan", &profile));
+  EXPECT_FALSE(spvParseValidatorProfile("", &profile));
+  EXPECT_FALSE(spvParseValidatorProfile(nullptr, &profile));
+  EXPECT_EQ(spv_validator_profile_structural, profile);
+}
+
+}  // namespace
+}  // namespace val
+}  // namespace spvtools
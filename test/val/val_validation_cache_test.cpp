@@ -0,0 +1,255 @@
+// Copyright (c) 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests for the cache of validation results.
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "spirv-tools/libspirv.hpp"
+
+namespace spvtools {
+namespace {
+
+using ::testing::HasSubstr;
+
+const char kValidModule[] = R"(
+OpCapability Shader
+OpCapability Linkage
+OpMemoryModel Logical GLSL450
+)";
+
+const char kInvalidModule[] = R"(
+OpCapability Shader
+OpCapability Linkage
+)";
+
+std::vector<uint32_t> Assemble(const char* text) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_3);
+  std::vector<uint32_t> binary;
+  EXPECT_TRUE(tools.Assemble(text, &binary));
+  return binary;
+}
+
+ValidationCache::Result MakeResult(spv_result_t status,
+                                   const std::string& message) {
+  ValidationCache::Result result;
+  result.status = status;
+  result.position = {0, 0, 5};
+  result.message = message;
+  return result;
+}
+
+TEST(ValidationCache, LookupFindsInsertedResult) {
+  const std::vector<uint32_t> binary = Assemble(kValidModule);
+  ValidatorOptions options;
+  ValidationCache cache;
+  ValidationCache::Result result;
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                            binary.size(), options, &result));
+
+  cache.Insert(SPV_ENV_UNIVERSAL_1_3, binary.data(), binary.size(), options,
+               MakeResult(SPV_ERROR_INVALID_ID, "message"));
+  EXPECT_EQ(1u, cache.size());
+  ASSERT_TRUE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                           binary.size(), options, &result));
+  EXPECT_EQ(SPV_ERROR_INVALID_ID, result.status);
+  EXPECT_EQ(5u, result.position.index);
+  EXPECT_EQ("message", result.message);
+}
+
+TEST(ValidationCache, KeyCoversWordsEnvAndOptions) {
+  std::vector<uint32_t> binary = Assemble(kValidModule);
+  ValidatorOptions options;
+  ValidationCache cache;
+  cache.Insert(SPV_ENV_UNIVERSAL_1_3, binary.data(), binary.size(), options,
+               MakeResult(SPV_SUCCESS, ""));
+  ValidationCache::Result result;
+
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_VULKAN_1_1, binary.data(), binary.size(),
+                            options, &result));
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                            binary.size() - 1, options, &result));
+
+  ValidatorOptions relaxed;
+  relaxed.SetRelaxBlockLayout(true);
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                            binary.size(), relaxed, &result));
+
+  ValidatorOptions limited;
+  limited.SetUniversalLimit(spv_validator_limit_max_id_bound, 100);
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                            binary.size(), limited, &result));
+
+  // Running on several threads gives the same result.
+  ValidatorOptions parallel;
+  parallel.SetParallel(true);
+  EXPECT_TRUE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                           binary.size(), parallel, &result));
+
+  binary.back() ^= 1;
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_3, binary.data(),
+                            binary.size(), options, &result));
+}
+
+TEST(ValidationCache, EvictsLeastRecentlyUsed) {
+  const std::vector<uint32_t> binary = Assemble(kValidModule);
+  ValidatorOptions options;
+  ValidationCache cache(2);
+  ValidationCache::Result result = MakeResult(SPV_SUCCESS, "");
+  cache.Insert(SPV_ENV_UNIVERSAL_1_0, binary.data(), binary.size(), options,
+               result);
+  cache.Insert(SPV_ENV_UNIVERSAL_1_1, binary.data(), binary.size(), options,
+               result);
+  // Using the first entry makes the second one the least recently used.
+  EXPECT_TRUE(cache.Lookup(SPV_ENV_UNIVERSAL_1_0, binary.data(),
+                           binary.size(), options, &result));
+  cache.Insert(SPV_ENV_UNIVERSAL_1_2, binary.data(), binary.size(), options,
+               result);
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.Lookup(SPV_ENV_UNIVERSAL_1_0, binary.data(),
+                           binary.size(), options, &result));
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_1, binary.data(),
+                            binary.size(), options, &result));
+  EXPECT_TRUE(cache.Lookup(SPV_ENV_UNIVERSAL_1_2, binary.data(),
+                           binary.size(), options, &result));
+}
+
+TEST(ValidationCache, SaveAndLoad) {
+  const std::string filename = "val_validation_cache_test.cache";
+  const std::vector<uint32_t> binary = Assemble(kValidModule);
+  ValidatorOptions options;
+  {
+    ValidationCache cache;
+    cache.Insert(SPV_ENV_UNIVERSAL_1_0, binary.data(), binary.size(), options,
+                 MakeResult(SPV_SUCCESS, ""));
+    cache.Insert(SPV_ENV_UNIVERSAL_1_1, binary.data(), binary.size(), options,
+                 MakeResult(SPV_ERROR_INVALID_CFG, "bad block"));
+    ASSERT_TRUE(cache.Save(filename));
+  }
+
+  ValidationCache cache(1);
+  ASSERT_TRUE(cache.Load(filename));
+  // Only the most recently used entry fits.
+  EXPECT_EQ(1u, cache.size());
+  ValidationCache::Result result;
+  EXPECT_FALSE(cache.Lookup(SPV_ENV_UNIVERSAL_1_0, binary.data(),
+                            binary.size(), options, &result));
+  ASSERT_TRUE(cache.Lookup(SPV_ENV_UNIVERSAL_1_1, binary.data(),
+                           binary.size(), options, &result));
+  EXPECT_EQ(SPV_ERROR_INVALID_CFG, result.status);
+  EXPECT_EQ(5u, result.position.index);
+  EXPECT_EQ("bad block", result.message);
+
+  // A damaged file is rejected as a whole.
+  {
+    std::fstream file(filename,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(20);
+    file.put('x');
+  }
+  ValidationCache damaged;
+  EXPECT_FALSE(damaged.Load(filename));
+  EXPECT_EQ(0u, damaged.size());
+
+  std::remove(filename.c_str());
+  EXPECT_FALSE(damaged.Load(filename));
+}
+
+TEST(ValidationCache, ValidateStoresAndReusesResults) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_3);
+  std::vector<std::string> messages;
+  tools.SetMessageConsumer([&messages](spv_message_level_t, const char*,
+                                       const spv_position_t&,
+                                       const char* message) {
+    messages.push_back(message);
+  });
+  const std::vector<uint32_t> valid = Assemble(kValidModule);
+  const std::vector<uint32_t> invalid = Assemble(kInvalidModule);
+  ValidatorOptions options;
+  ValidationCache cache;
+
+  EXPECT_TRUE(tools.Validate(valid.data(), valid.size(), options, &cache));
+  EXPECT_FALSE(
+      tools.Validate(invalid.data(), invalid.size(), options, &cache));
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_THAT(messages[0], HasSubstr("OpMemoryModel"));
+  EXPECT_EQ(2u, cache.size());
+
+  // The stored diagnostic is reported again.
+  EXPECT_FALSE(
+      tools.Validate(invalid.data(), invalid.size(), options, &cache));
+  ASSERT_EQ(2u, messages.size());
+  EXPECT_EQ(messages[0], messages[1]);
+
+  // A stored result is trusted without validating.
+  cache.Insert(SPV_ENV_UNIVERSAL_1_3, valid.data(), valid.size(), options,
+               MakeResult(SPV_ERROR_INVALID_DATA, "from the cache"));
+  EXPECT_FALSE(tools.Validate(valid.data(), valid.size(), options, &cache));
+  ASSERT_EQ(3u, messages.size());
+  EXPECT_EQ("from the cache", messages[2]);
+}
+
+TEST(ValidationCache, ConcurrentSavesWriteWholeFiles) {
+  const std::string filename = "val_validation_cache_test_concurrent.cache";
+  const std::vector<uint32_t> binary = Assemble(kValidModule);
+  ValidatorOptions options;
+  ValidationCache cache;
+  cache.Insert(SPV_ENV_UNIVERSAL_1_0, binary.data(), binary.size(), options,
+               MakeResult(SPV_ERROR_INVALID_CFG, "bad block"));
+
+  // Each save writes its own temporary file before renaming it.
+  std::vector<std::thread> threads;
+  std::atomic<int> num_saved(0);
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&cache, &filename, &num_saved]() {
+      if (cache.Save(filename)) ++num_saved;
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(4, num_saved.load());
+
+  ValidationCache loaded;
+  ASSERT_TRUE(loaded.Load(filename));
+  EXPECT_EQ(1u, loaded.size());
+  std::remove(filename.c_str());
+}
+
+TEST(ValidationCache, ValidateWithoutCache) {
+  SpirvTools tools(SPV_ENV_UNIVERSAL_1_3);
+  std::vector<std::string> messages;
+  tools.SetMessageConsumer([&messages](spv_message_level_t, const char*,
+                                       const spv_position_t&,
+                                       const char* message) {
+    messages.push_back(message);
+  });
+  const std::vector<uint32_t> valid = Assemble(kValidModule);
+  const std::vector<uint32_t> invalid = Assemble(kInvalidModule);
+  ValidatorOptions options;
+
+  EXPECT_TRUE(tools.Validate(valid.data(), valid.size(), options, nullptr));
+  EXPECT_FALSE(
+      tools.Validate(invalid.data(), invalid.size(), options, nullptr));
+  ASSERT_EQ(1u, messages.size());
+  EXPECT_THAT(messages[0], HasSubstr("OpMemoryModel"));
+}
+
+}  // namespace
+}  // namespace spvtools
@@ -282,6 +282,60 @@ TEST_F(ValidationStateTest, CheckVulkanIndirectlyRecursiveBodyBad) {
                         " %1 = OpFunction %void Pure|Const %3\n"));
 }
 
+// Returns true if |words| point into |binary|.
+bool IsInBinary(utils::Span<uint32_t> words, spv_const_binary binary) {
+  return words.data() >= binary->code &&
+         words.data() + words.size() <= binary->code + binary->wordCount;
+}
+
+TEST_F(ValidationStateTest, InstructionWordsAreThoseOfTheModule) {
+  CompileSuccessfully(std::string(kHeader) + kVoidFVoid);
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+  ASSERT_FALSE(vstate_->ordered_instructions().empty());
+  for (const auto& inst : vstate_->ordered_instructions()) {
+    EXPECT_TRUE(IsInBinary(inst.words(), get_const_binary()));
+  }
+}
+
+TEST_F(ValidationStateTest, InstructionWordsOfOtherEndiannessAreCopied) {
+  CompileSuccessfully(std::string(kHeader) + kVoidFVoid);
+  for (size_t i = 0; i < get_const_binary()->wordCount; ++i) {
+    const uint32_t word = get_const_binary()->code[i];
+    OverwriteAssembledBinary(
+        uint32_t(i), (word >> 24) | ((word >> 8) & 0xff00) |
+                         ((word << 8) & 0xff0000) | (word << 24));
+  }
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+  ASSERT_FALSE(vstate_->ordered_instructions().empty());
+  for (const auto& inst : vstate_->ordered_instructions()) {
+    EXPECT_FALSE(IsInBinary(inst.words(), get_const_binary()));
+    EXPECT_EQ(inst.words()[0] & SpvOpCodeMask, uint32_t(inst.opcode()));
+  }
+}
+
+TEST_F(ValidationStateTest, UsesAreInModuleOrder) {
+  std::string spirv = std::string(kHeader) + " %int = OpTypeInt 32 0 ";
+  for (int i = 0; i < 20; ++i) {
+    spirv += " %c" + std::to_string(i) + " = OpConstant %int " +
+             std::to_string(i) + " ";
+  }
+  CompileSuccessfully(spirv);
+  ASSERT_EQ(SPV_SUCCESS, ValidateAndRetrieveValidationState());
+
+  const Instruction* int_type = nullptr;
+  for (const auto& inst : vstate_->ordered_instructions()) {
+    if (inst.opcode() == SpvOpTypeInt) int_type = &inst;
+  }
+  ASSERT_NE(int_type, nullptr);
+  ASSERT_EQ(int_type->uses().size(), 20u);
+  for (size_t i = 0; i < int_type->uses().size(); ++i) {
+    const auto& use = int_type->uses()[i];
+    EXPECT_EQ(use.first->opcode(), SpvOpConstant);
+    EXPECT_EQ(use.first->GetOperandAs<uint32_t>(2), i);
+    EXPECT_EQ(use.second, 1u);
+  }
+}
+
 }  // namespace
 }  // namespace val
 }  // namespace spvtools
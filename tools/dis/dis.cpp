@@ -58,6 +58,10 @@ Options:
   --offsets       Show byte offsets for each instruction.
 
   --comment       Add comments to make reading easier
+
+  --parallel      Format the instructions on several threads.  The output
+                  is the same.  Has no effect when printing to a terminal
+                  in color.
 )",
       argv0, argv0);
 }
@@ -82,6 +86,7 @@ int main(int argc, char** argv) {
   bool no_header = false;
   bool friendly_names = true;
   bool comments = false;
+  bool parallel = false;
 
   for (int argi = 1; argi < argc; ++argi) {
     if ('-' == argv[argi][0]) {
@@ -107,6 +112,8 @@ int main(int argc, char** argv) {
             force_color = true;
           } else if (0 == strcmp(argv[argi], "--comment")) {
             comments = true;
+          } else if (0 == strcmp(argv[argi], "--parallel")) {
+            parallel = true;
           } else if (0 == strcmp(argv[argi], "--no-indent")) {
             allow_indent = false;
           } else if (0 == strcmp(argv[argi], "--offsets")) {
@@ -163,6 +170,8 @@ int main(int argc, char** argv) {
 
   if (comments) options |= SPV_BINARY_TO_TEXT_OPTION_COMMENT;
 
+  if (parallel) options |= SPV_BINARY_TO_TEXT_OPTION_PARALLEL;
+
   if (!outFile || (0 == strcmp("-", outFile))) {
     // Print to standard output.
     options |= SPV_BINARY_TO_TEXT_OPTION_PRINT;
@@ -176,11 +185,17 @@ int main(int argc, char** argv) {
         options |= SPV_BINARY_TO_TEXT_OPTION_COLOR;
       }
     }
+
+    // Without color, the text can just as well be made in memory first,
+    // which allows it to be made in parallel.
+    if (parallel && !(options & SPV_BINARY_TO_TEXT_OPTION_COLOR)) {
+      options &= ~uint32_t(SPV_BINARY_TO_TEXT_OPTION_PRINT);
+    }
   }
 
   // Read the input binary.
-  std::vector<uint32_t> contents;
-  if (!ReadBinaryFile<uint32_t>(inFile, &contents)) return 1;
+  BinaryFileContents<uint32_t> contents;
+  if (!ReadBinaryFile(inFile, &contents)) return 1;
 
   // If printing to standard output, then spvBinaryToText should
   // do the printing.  In particular, colour printing on Windows is
@@ -31,6 +31,17 @@
 #define SET_STDIN_TO_TEXT_MODE()
 #endif
 
+#if defined(SPIRV_ANDROID) || defined(SPIRV_LINUX) || defined(SPIRV_MAC) || \
+    defined(SPIRV_IOS) || defined(SPIRV_FREEBSD) ||                         \
+    defined(SPIRV_EMSCRIPTEN) || defined(SPIRV_FUCHSIA)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SPIRV_TOOLS_CAN_MAP_FILES
+#endif
+
 // Appends the contents of the |file| to |data|, assuming each element in the
 // file is of type |T|.
 template <typename T>
@@ -89,10 +100,89 @@ bool ReadBinaryFile(const char* filename, std::vector<T>* data) {
 
   ReadFile(fp, data);
   bool succeeded = WasFileCorrectlyRead<T>(fp, filename);
-  if (use_file) fclose(fp);
+  if (use_file && fp) fclose(fp);
   return succeeded;
 }
 
+// The contents of a binary file read by ReadBinaryFile(), as an array of
+// elements of type |T|.  When possible, the file is mapped into memory, so
+// that the elements are used in place instead of being copied.
+template <typename T>
+class BinaryFileContents {
+ public:
+  BinaryFileContents() : mapping_(nullptr), mapping_size_(0) {}
+  ~BinaryFileContents() { Unmap(); }
+
+  BinaryFileContents(const BinaryFileContents&) = delete;
+  BinaryFileContents& operator=(const BinaryFileContents&) = delete;
+
+  // Returns a pointer to the first element.
+  const T* data() const {
+    return mapping_ ? static_cast<const T*>(mapping_) : buffer_.data();
+  }
+
+  // Returns the number of elements.
+  size_t size() const {
+    return mapping_ ? mapping_size_ / sizeof(T) : buffer_.size();
+  }
+
+  // Maps the file named |filename| into memory.  Returns false, with nothing
+  // mapped, if the file cannot be mapped: for example, if it is not a regular
+  // file, if it is empty, or if its size is not a multiple of the size of |T|.
+  bool Map(const char* filename) {
+    Unmap();
+#if defined(SPIRV_TOOLS_CAN_MAP_FILES)
+    const int fd = open(filename, O_RDONLY);
+    if (fd == -1) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+        info.st_size % sizeof(T) == 0) {
+      const size_t size = static_cast<size_t>(info.st_size);
+      void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        mapping_ = mapping;
+        mapping_size_ = size;
+      }
+    }
+    close(fd);
+#else
+    (void)filename;
+#endif
+    return mapping_ != nullptr;
+  }
+
+  // Returns the buffer holding the elements when the file is not mapped.
+  std::vector<T>* buffer() { return &buffer_; }
+
+ private:
+  void Unmap() {
+#if defined(SPIRV_TOOLS_CAN_MAP_FILES)
+    if (mapping_) munmap(mapping_, mapping_size_);
+#endif
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+  }
+
+  // The memory the file is mapped to, or nullptr if it is not mapped.
+  void* mapping_;
+  // The size in bytes of |mapping_|.
+  size_t mapping_size_;
+  // The elements of the file when it is not mapped.
+  std::vector<T> buffer_;
+};
+
+// Reads the file named |filename| into |contents|, assuming each element in the
+// file is of type |T|.  Regular files are mapped into memory when the platform
+// allows it; otherwise the file is read as by the overload above.  If any error
+// occurs, writes error messages to standard error and returns false.
+template <typename T>
+bool ReadBinaryFile(const char* filename, BinaryFileContents<T>* contents) {
+  const bool use_file = filename && strcmp("-", filename);
+  if (use_file && contents->Map(filename)) return true;
+  contents->buffer()->clear();
+  return ReadBinaryFile(filename, contents->buffer());
+}
+
 // Appends the contents of the file named |filename| to |data|, assuming
 // each element in the file is of type |T|. The file is opened as a text file
 // If |filename| is nullptr or "-", reads from the standard input, but
@@ -111,7 +201,7 @@ bool ReadTextFile(const char* filename, std::vector<T>* data) {
 
   ReadFile(fp, data);
   bool succeeded = WasFileCorrectlyRead<T>(fp, filename);
-  if (use_file) fclose(fp);
+  if (use_file && fp) fclose(fp);
   return succeeded;
 }
 
@@ -24,6 +24,7 @@
 
 #include "source/opt/log.h"
 #include "source/spirv_target_env.h"
+#include "source/util/parse_number.h"
 #include "source/util/string_utils.h"
 #include "spirv-tools/libspirv.hpp"
 #include "spirv-tools/optimizer.hpp"
@@ -86,22 +87,35 @@ void PrintUsage(const char* program) {
       R"(%s - Optimize a SPIR-V binary file.
 
 USAGE: %s [options] [<input>] -o <output>
+       %s [options] --batch=<list> [-j <n>]
 
 The SPIR-V binary is read from <input>. If no file is specified,
 or if <input> is "-", then the binary is read from standard input.
 if <output> is "-", then the optimized output is written to
 standard output.
 
+With --batch, each binary named in <list> is optimized, and the
+result is written next to it.
+
 NOTE: The optimizer is a work in progress.
 
 Options (in lexicographical order):)",
-      program, program);
+      program, program, program);
   printf(R"(
   --amd-ext-to-khr
                Replaces the extensions VK_AMD_shader_ballot, VK_AMD_gcn_shader,
                and VK_AMD_shader_trinary_minmax with equivalent code using core
                instructions and capabilities.)");
   printf(R"(
+  --batch=<list>
+               Optimizes all the binaries named in the file <list>, which has
+               one file name per line.  Empty lines and lines starting with
+               '#' are ignored.  The optimized binary for "<name>.spv" is
+               written to "<name>.opt.spv", in the same directory.  The
+               diagnostics of each binary are prefixed with its file name,
+               and are printed in the order of <list>.  May not be used
+               together with <input> or -o.)");
+  printf(R"(
   --before-hlsl-legalization
                Forwards this option to the validator.  See the validator help
                for details.)");
@@ -235,6 +249,10 @@ Options (in lexicographical order):)",
                functions. Currently does not inline calls to functions with
                early return in a loop.)");
   printf(R"(
+  -j <n>
+               With --batch, optimizes up to <n> binaries at the same time.
+               The default, 0, uses one thread per hardware thread.)");
+  printf(R"(
   --legalize-hlsl
                Runs a series of optimizations that attempts to take SPIR-V
                generated by an HLSL front-end and generates legal Vulkan SPIR-V.
@@ -563,20 +581,22 @@ bool ReadFlagsFromFile(const char* oconfig_flag,
 
 OptStatus ParseFlags(int argc, const char** argv,
                      spvtools::Optimizer* optimizer, const char** in_file,
-                     const char** out_file,
+                     const char** out_file, const char** batch_file,
+                     uint32_t* num_threads,
                      spvtools::ValidatorOptions* validator_options,
                      spvtools::OptimizerOptions* optimizer_options);
 
 // Parses and handles the -Oconfig flag. |prog_name| contains the name of
 // the spirv-opt binary (used to build a new argv vector for the recursive
 // invocation to ParseFlags). |opt_flag| contains the -Oconfig=FILENAME flag.
-// |optimizer|, |in_file|, |out_file|, |validator_options|, and
-// |optimizer_options| are as in ParseFlags.
+// |optimizer|, |in_file|, |out_file|, |batch_file|, |num_threads|,
+// |validator_options|, and |optimizer_options| are as in ParseFlags.
 //
 // This returns the same OptStatus instance returned by ParseFlags.
 OptStatus ParseOconfigFlag(const char* prog_name, const char* opt_flag,
                            spvtools::Optimizer* optimizer, const char** in_file,
-                           const char** out_file,
+                           const char** out_file, const char** batch_file,
+                           uint32_t* num_threads,
                            spvtools::ValidatorOptions* validator_options,
                            spvtools::OptimizerOptions* optimizer_options) {
   std::vector<std::string> flags;
@@ -603,7 +623,8 @@ OptStatus ParseOconfigFlag(const char* prog_name, const char* opt_flag,
 
   auto ret_val =
       ParseFlags(static_cast<int>(flags.size()), new_argv, optimizer, in_file,
-                 out_file, validator_options, optimizer_options);
+                 out_file, batch_file, num_threads, validator_options,
+                 optimizer_options);
   delete[] new_argv;
   return ret_val;
 }
@@ -653,12 +674,14 @@ std::string CanonicalizeFlag(const char** argv, int argc, int* argi) {
 // Optimizer instance used to optimize the program.
 //
 // On return, this function stores the name of the input program in |in_file|.
-// The name of the output file in |out_file|. The return value indicates whether
-// optimization should continue and a status code indicating an error or
-// success.
+// The name of the output file in |out_file|. The name of the file listing the
+// inputs of a batch in |batch_file|, and the number of threads used to optimize
+// the batch in |num_threads|. The return value indicates whether optimization
+// should continue and a status code indicating an error or success.
 OptStatus ParseFlags(int argc, const char** argv,
                      spvtools::Optimizer* optimizer, const char** in_file,
-                     const char** out_file,
+                     const char** out_file, const char** batch_file,
+                     uint32_t* num_threads,
                      spvtools::ValidatorOptions* validator_options,
                      spvtools::OptimizerOptions* optimizer_options) {
   std::vector<std::string> pass_flags;
@@ -691,10 +714,24 @@ OptStatus ParseFlags(int argc, const char** argv,
       } else if (0 == strncmp(cur_arg, "-Oconfig=", sizeof("-Oconfig=") - 1)) {
         OptStatus status =
             ParseOconfigFlag(argv[0], cur_arg, optimizer, in_file, out_file,
-                             validator_options, optimizer_options);
+                             batch_file, num_threads, validator_options,
+                             optimizer_options);
         if (status.action != OPT_CONTINUE) {
           return status;
         }
+      } else if (0 == strncmp(cur_arg, "--batch=", sizeof("--batch=") - 1)) {
+        *batch_file = cur_arg + sizeof("--batch=") - 1;
+      } else if (0 == strcmp(cur_arg, "-j")) {
+        uint32_t threads = 0;
+        if (argi + 1 < argc &&
+            spvtools::utils::ParseNumber(argv[argi + 1], &threads)) {
+          *num_threads = threads;
+          ++argi;
+        } else {
+          spvtools::Error(opt_diagnostic, nullptr, {},
+                          "-j requires a non-negative number of threads");
+          return {OPT_STOP, 1};
+        }
       } else if (0 == strcmp(cur_arg, "--skip-validation")) {
         optimizer_options->set_run_validator(false);
       } else if (0 == strcmp(cur_arg, "--print-all")) {
@@ -780,11 +817,109 @@ OptStatus ParseFlags(int argc, const char** argv,
   return {OPT_CONTINUE, 0};
 }
 
+// Reads the names of the binaries to optimize from |batch_file| into
+// |in_files|.  Returns true on success.
+bool ReadBatchFile(const char* batch_file, std::vector<std::string>* in_files) {
+  std::ifstream input_file;
+  input_file.open(batch_file);
+  if (input_file.fail()) {
+    fprintf(stderr, "error: Could not open file '%s'\n", batch_file);
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(input_file, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    // Ignore empty lines and lines starting with the comment marker '#'.
+    if (line.empty() || line[0] == '#') continue;
+    in_files->push_back(line);
+  }
+  return true;
+}
+
+// Returns the name of the file receiving the optimized binary for |in_file| in
+// batch mode: "<name>.spv" becomes "<name>.opt.spv", and any other name gets
+// ".opt.spv" appended.
+std::string GetBatchOutputFile(const std::string& in_file) {
+  const std::string extension = ".spv";
+  if (in_file.size() > extension.size() &&
+      in_file.compare(in_file.size() - extension.size(), extension.size(),
+                      extension) == 0) {
+    return in_file.substr(0, in_file.size() - extension.size()) + ".opt.spv";
+  }
+  return in_file + ".opt.spv";
+}
+
+// Prints |message|, emitted while optimizing |in_file|, in the same format as
+// CLIMessageConsumer but prefixed with the file name.
+void PrintBatchMessage(const std::string& in_file,
+                       const spvtools::Optimizer::BatchMessage& message) {
+  switch (message.level) {
+    case SPV_MSG_FATAL:
+    case SPV_MSG_INTERNAL_ERROR:
+    case SPV_MSG_ERROR:
+      std::cerr << in_file << ": error: line " << message.position.index
+                << ": " << message.message << std::endl;
+      break;
+    case SPV_MSG_WARNING:
+      std::cout << in_file << ": warning: line " << message.position.index
+                << ": " << message.message << std::endl;
+      break;
+    case SPV_MSG_INFO:
+      std::cout << in_file << ": info: line " << message.position.index
+                << ": " << message.message << std::endl;
+      break;
+    default:
+      break;
+  }
+}
+
+// Optimizes all the binaries listed in |batch_file| with |optimizer|, using
+// |num_threads| threads, and writes each result next to its input.  Returns the
+// exit code of the tool.
+int RunBatch(const spvtools::Optimizer& optimizer, const char* batch_file,
+             uint32_t num_threads,
+             const spvtools::OptimizerOptions& optimizer_options) {
+  std::vector<std::string> in_files;
+  if (!ReadBatchFile(batch_file, &in_files)) {
+    return 1;
+  }
+
+  std::vector<std::vector<uint32_t>> binaries(in_files.size());
+  for (size_t i = 0; i < in_files.size(); ++i) {
+    if (!ReadBinaryFile<uint32_t>(in_files[i].c_str(), &binaries[i])) {
+      return 1;
+    }
+  }
+
+  const auto results =
+      optimizer.RunBatch(binaries, num_threads, optimizer_options);
+
+  int code = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    for (const auto& message : results[i].messages) {
+      PrintBatchMessage(in_files[i], message);
+    }
+    if (!results[i].success) {
+      code = 1;
+      continue;
+    }
+    const auto& binary = results[i].binary;
+    if (!WriteFile<uint32_t>(GetBatchOutputFile(in_files[i]).c_str(), "wb",
+                             binary.data(), binary.size())) {
+      code = 1;
+    }
+  }
+  return code;
+}
+
 }  // namespace
 
 int main(int argc, const char** argv) {
   const char* in_file = nullptr;
   const char* out_file = nullptr;
+  const char* batch_file = nullptr;
+  uint32_t num_threads = 0;
 
   spv_target_env target_env = kDefaultEnvironment;
 
@@ -794,27 +929,40 @@ int main(int argc, const char** argv) {
   spvtools::ValidatorOptions validator_options;
   spvtools::OptimizerOptions optimizer_options;
   OptStatus status = ParseFlags(argc, argv, &optimizer, &in_file, &out_file,
-                                &validator_options, &optimizer_options);
+                                &batch_file, &num_threads, &validator_options,
+                                &optimizer_options);
   optimizer_options.set_validator_options(validator_options);
 
   if (status.action == OPT_STOP) {
     return status.code;
   }
 
+  if (batch_file != nullptr) {
+    if (in_file != nullptr || out_file != nullptr) {
+      spvtools::Error(opt_diagnostic, nullptr, {},
+                      "--batch may not be used with an input file or -o");
+      return 1;
+    }
+    return RunBatch(optimizer, batch_file, num_threads, optimizer_options);
+  }
+
   if (out_file == nullptr) {
     spvtools::Error(opt_diagnostic, nullptr, {}, "-o required");
     return 1;
   }
 
-  std::vector<uint32_t> binary;
-  if (!ReadBinaryFile<uint32_t>(in_file, &binary)) {
+  BinaryFileContents<uint32_t> contents;
+  if (!ReadBinaryFile(in_file, &contents)) {
     return 1;
   }
 
-  // By using the same vector as input and output, we save time in the case
-  // that there was no change.
-  bool ok =
-      optimizer.Run(binary.data(), binary.size(), &binary, optimizer_options);
+  std::vector<uint32_t> binary;
+  bool ok = optimizer.Run(contents.data(), contents.size(), &binary,
+                          optimizer_options);
+  if (!ok) {
+    // When optimization fails, the unmodified input is written out.
+    binary.assign(contents.data(), contents.data() + contents.size());
+  }
 
   if (!WriteFile<uint32_t>(out_file, "wb", binary.data(), binary.size())) {
     return 1;
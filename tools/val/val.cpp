@@ -16,6 +16,7 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "source/spirv_target_env.h"
@@ -66,6 +67,18 @@ Options:
                                    members.
   --before-hlsl-legalization       Allows code patterns that are intended to be
                                    fixed by spirv-opt's legalization passes.
+  --parallel                       Check the functions on several threads.
+                                   The diagnostics are the same.
+  --profile                        {full|structural}
+                                   Select the checks to run.  The default, full, runs
+                                   every check.  structural checks the structure of the
+                                   module, its ids, types and control flow, and skips
+                                   the checks of image operations, extended
+                                   instructions and built-ins.
+  --cache-dir                      <directory in which to keep validation results>
+                                   A binary already validated with the same options
+                                   is not validated again: its stored result is
+                                   reported instead.
   --version                        Display validator version information.
   --target-env                     {%s}
                                    Use validation rules from the specified environment.
@@ -75,6 +88,7 @@ Options:
 
 int main(int argc, char** argv) {
   const char* inFile = nullptr;
+  const char* cache_dir = nullptr;
   spv_target_env target_env = SPV_ENV_UNIVERSAL_1_5;
   spvtools::ValidatorOptions options;
   bool continue_processing = true;
@@ -155,6 +169,32 @@ int main(int argc, char** argv) {
         options.SetSkipBlockLayout(true);
       } else if (0 == strcmp(cur_arg, "--relax-struct-store")) {
         options.SetRelaxStructStore(true);
+      } else if (0 == strcmp(cur_arg, "--parallel")) {
+        options.SetParallel(true);
+      } else if (0 == strcmp(cur_arg, "--profile")) {
+        if (argi + 1 < argc) {
+          const auto profile_str = argv[++argi];
+          spv_validator_profile profile;
+          if (spvParseValidatorProfile(profile_str, &profile)) {
+            options.SetProfile(profile);
+          } else {
+            fprintf(stderr, "error: Unrecognized profile: %s\n", profile_str);
+            continue_processing = false;
+            return_code = 1;
+          }
+        } else {
+          fprintf(stderr, "error: Missing argument to --profile\n");
+          continue_processing = false;
+          return_code = 1;
+        }
+      } else if (0 == strcmp(cur_arg, "--cache-dir")) {
+        if (argi + 1 < argc) {
+          cache_dir = argv[++argi];
+        } else {
+          fprintf(stderr, "error: Missing argument to --cache-dir\n");
+          continue_processing = false;
+          return_code = 1;
+        }
       } else if (0 == cur_arg[1]) {
         // Setting a filename of "-" to indicate stdin.
         if (!inFile) {
@@ -185,13 +225,27 @@ int main(int argc, char** argv) {
     return return_code;
   }
 
-  std::vector<uint32_t> contents;
-  if (!ReadBinaryFile<uint32_t>(inFile, &contents)) return 1;
+  BinaryFileContents<uint32_t> contents;
+  if (!ReadBinaryFile(inFile, &contents)) return 1;
 
   spvtools::SpirvTools tools(target_env);
   tools.SetMessageConsumer(spvtools::utils::CLIMessageConsumer);
 
-  bool succeed = tools.Validate(contents.data(), contents.size(), options);
+  bool succeed;
+  if (cache_dir) {
+    // The cache is saved even when the result was found in it, to record that
+    // the entry was used most recently.
+    const std::string cache_file = std::string(cache_dir) + "/spirv-val.cache";
+    spvtools::ValidationCache cache;
+    cache.Load(cache_file);
+    succeed = tools.Validate(contents.data(), contents.size(), options, &cache);
+    if (!cache.Save(cache_file)) {
+      fprintf(stderr, "warning: Could not write the validation cache %s\n",
+              cache_file.c_str());
+    }
+  } else {
+    succeed = tools.Validate(contents.data(), contents.size(), options);
+  }
 
   return !succeed;
 }
@@ -146,6 +146,124 @@ def generate_extension_arrays(extensions):
     return '\n'.join(arrays)
 
 
+def format_int_list(values, per_line=12):
+    """Returns the given integers as the body of a C array initializer, with
+    |per_line| integers per line."""
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append('  ' + ', '.join(
+            [str(v) for v in values[i:i + per_line]]))
+    return ',\n'.join(lines)
+
+
+def name_hash(seed, name):
+    """Returns the 32-bit hash of |name| for the given |seed|.
+
+    This must match NameHash() in source/table.cpp.
+    """
+    h = 0x811c9dc5 ^ seed
+    for c in bytearray(name.encode('utf-8')):
+        h = ((h ^ c) * 0x01000193) & 0xffffffff
+    h ^= h >> 16
+    h = (h * 0x7feb352d) & 0xffffffff
+    h ^= h >> 15
+    return h
+
+
+def generate_name_index(var_name, names):
+    """Returns the C definition of a minimal perfect hash index, named
+    |var_name|, that maps each of the given names to its index in |names|.
+
+    The names are split into as many buckets as there are names, by their hash
+    with seed 0.  Each bucket has a displacement.  For a bucket holding one
+    name, the displacement d is negative and the name is in slot -d - 1.  For
+    a larger bucket, the displacement is a seed that hashes each of its names
+    to a different slot.  Buckets are placed largest first, which is what
+    makes finding seeds quick.
+
+    Arguments:
+      - var_name: the name of the spv_name_index_t variable to define
+      - names: a sequence of distinct names
+    """
+    assert len(set(names)) == len(names), \
+        'duplicate names in {}'.format(var_name)
+    assert len(names) < 0xffff, 'too many names in {}'.format(var_name)
+
+    count = len(names)
+    if count == 0:
+        return ('static const spv_name_index_t {} = '
+                '{{0, nullptr, nullptr}};'.format(var_name))
+
+    buckets = [[] for _ in range(count)]
+    for index, name in enumerate(names):
+        buckets[name_hash(0, name) % count].append(index)
+
+    displacements = [0] * count
+    slots = [None] * count
+    by_size = sorted(range(count), key=lambda b: -len(buckets[b]))
+    for bucket in by_size:
+        keys = buckets[bucket]
+        if len(keys) < 2:
+            break
+        seed = 1
+        while True:
+            positions = [name_hash(seed, names[k]) % count for k in keys]
+            if (len(set(positions)) == len(positions) and
+                    all(slots[p] is None for p in positions)):
+                break
+            seed += 1
+        displacements[bucket] = seed
+        for key, position in zip(keys, positions):
+            slots[position] = key
+
+    free_slots = [p for p in range(count) if slots[p] is None]
+    for bucket in by_size:
+        keys = buckets[bucket]
+        if len(keys) != 1:
+            continue
+        position = free_slots.pop()
+        displacements[bucket] = -position - 1
+        slots[position] = keys[0]
+
+    template = ['static const int32_t {name}_displacements[] = {{',
+                '{displacements}', '}};',
+                'static const uint16_t {name}_slots[] = {{',
+                '{slots}', '}};',
+                'static const spv_name_index_t {name} = {{',
+                '  {count}, {name}_displacements, {name}_slots}};']
+    return '\n'.join(template).format(
+        name=var_name, count=count,
+        displacements=format_int_list(displacements),
+        slots=format_int_list(slots))
+
+
+def generate_value_index(var_name, values):
+    """Returns the C definition of a dense index, named |var_name|, that maps
+    each value to the index of the first of the given values equal to it, or
+    to 0xffff for values not in the list.
+
+    Arguments:
+      - var_name: the name of the spv_value_index_t variable to define
+      - values: a sequence of small non-negative integers in ascending order
+    """
+    assert len(values) < 0xffff, 'too many values in {}'.format(var_name)
+    if not values:
+        return 'static const spv_value_index_t {} = {{0, nullptr}};'.format(
+            var_name)
+
+    entries = [0xffff] * (max(values) + 1)
+    for index, value in reversed(list(enumerate(values))):
+        entries[value] = index
+
+    template = ['static const uint16_t {name}_entries[] = {{',
+                '{entries}', '}};',
+                'static const spv_value_index_t {name} = {{',
+                '  {count}, {name}_entries}};']
+    return '\n'.join(template).format(
+        name=var_name, count=len(entries),
+        entries=format_int_list(entries))
+
+
 def convert_operand_kind(operand_tuple):
     """Returns the corresponding operand type used in spirv-tools for the given
     operand kind and quantifier used in the JSON grammar.
@@ -357,7 +475,14 @@ def generate_instruction_table(inst_table):
     insts = ['static const spv_opcode_desc_t kOpcodeTableEntries[] = {{\n'
              '  {}\n}};'.format(',\n  '.join(insts))]
 
-    return '{}\n\n{}\n\n{}'.format(caps_arrays, exts_arrays, '\n'.join(insts))
+    # The entries are named without the "Op" prefix.
+    name_index = generate_name_index(
+        'kOpcodeTableNameIndex', [inst['opname'][2:] for inst in inst_table])
+    value_index = generate_value_index(
+        'kOpcodeTableValueIndex', [inst['opcode'] for inst in inst_table])
+
+    return '{}\n\n{}\n\n{}\n\n{}\n\n{}'.format(
+        caps_arrays, exts_arrays, '\n'.join(insts), name_index, value_index)
 
 
 def generate_extended_instruction_table(json_grammar, set_name, operand_kind_prefix=""):
@@ -383,7 +508,15 @@ def generate_extended_instruction_table(json_grammar, set_name, operand_kind_pre
     insts = ['static const spv_ext_inst_desc_t {}_entries[] = {{\n'
              '  {}\n}};'.format(set_name, ',\n  '.join(insts))]
 
-    return '{}\n\n{}'.format(caps_arrays, '\n'.join(insts))
+    name_index = generate_name_index(
+        '{}_name_index'.format(set_name),
+        [inst['opname'] for inst in inst_table])
+    value_index = generate_value_index(
+        '{}_value_index'.format(set_name),
+        [inst['opcode'] for inst in inst_table])
+
+    return '{}\n\n{}\n\n{}\n\n{}'.format(
+        caps_arrays, '\n'.join(insts), name_index, value_index)
 
 
 class EnumerantInitializer(object):
@@ -495,16 +628,31 @@ def generate_enum_operand_kind(enum, synthetic_exts_list):
     synthetic_exts_list.extend(extension_map.values())
 
     name = '{}_{}Entries'.format(PYGEN_VARIABLE_PREFIX, kind)
+    name_index = '{}_{}NameIndex'.format(PYGEN_VARIABLE_PREFIX, kind)
+    definitions = [generate_name_index(
+        name_index, [e.get('enumerant') for e in entries])]
+    # The values of a BitEnum are masks, which are too sparse for a dense
+    # index.  Those are found by binary search instead.
+    if (enum.get('category') == 'ValueEnum' and
+            all(e.get('value') < 0x10000 for e in entries)):
+        value_index = '{}_{}ValueIndex'.format(PYGEN_VARIABLE_PREFIX, kind)
+        definitions.append(generate_value_index(
+            value_index, [e.get('value') for e in entries]))
+        value_index = '&' + value_index
+    else:
+        value_index = 'nullptr'
+
     entries = ['  {}'.format(generate_enum_operand_kind_entry(e, extension_map))
                for e in entries]
 
     template = ['static const spv_operand_desc_t {name}[] = {{',
-                '{entries}', '}};']
+                '{entries}', '}};', '{definitions}']
     entries = '\n'.join(template).format(
         name=name,
-        entries=',\n'.join(entries))
+        entries=',\n'.join(entries),
+        definitions='\n'.join(definitions))
 
-    return kind, name, entries
+    return kind, name, entries, '&' + name_index, value_index
 
 
 def generate_operand_kind_table(enums):
@@ -529,15 +677,17 @@ def generate_operand_kind_table(enums):
     three_optional_enums = [e for e in enums if e[0] in three_optional_enums]
     enums.extend(three_optional_enums)
 
-    enum_kinds, enum_names, enum_entries = zip(*enums)
+    enum_kinds, enum_names, enum_entries, name_indices, value_indices = \
+        zip(*enums)
     # Mark the last three as optional ones.
     enum_quantifiers = [''] * (len(enums) - 3) + ['?'] * 3
     # And we don't want redefinition of them.
     enum_entries = enum_entries[:-3]
     enum_kinds = [convert_operand_kind(e)
                   for e in zip(enum_kinds, enum_quantifiers)]
-    table_entries = zip(enum_kinds, enum_names, enum_names)
-    table_entries = ['  {{{}, ARRAY_SIZE({}), {}}}'.format(*e)
+    table_entries = zip(enum_kinds, enum_names, enum_names, name_indices,
+                        value_indices)
+    table_entries = ['  {{{}, ARRAY_SIZE({}), {}, {}, {}}}'.format(*e)
                      for e in table_entries]
 
     template = [